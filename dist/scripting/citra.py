@@ -5,28 +5,98 @@
 import struct
 import random
 import enum
+import select
 import socket
 
 CURRENT_REQUEST_VERSION = 1
 MAX_REQUEST_DATA_SIZE = 1024
 MAX_PACKET_SIZE = 1024 + 0x10
+# TCP connections allow much larger packets, see MAX_STREAM_PACKET_DATA_SIZE in packet.h
+MAX_STREAM_REQUEST_DATA_SIZE = 32 * 1024 * 1024
+HEADER_SIZE = 0x10
 
 class RequestType(enum.IntEnum):
     ReadMemory = 1,
     WriteMemory = 2,
     ProcessList = 3,
     SetGetProcess = 4,
+    Trace = 5,
+    BulkReadMemory = 6,
+    ScatterReadMemory = 7,
+    Subscribe = 8,
+    Unsubscribe = 9,
+    SubscriptionUpdate = 10,
+    MemorySearch = 11,
+
+class SearchValueType(enum.IntEnum):
+    U8 = 0,
+    U16 = 1,
+    U32 = 2,
+    Float = 3,
+
+class SearchComparison(enum.IntEnum):
+    Equal = 0,
+    Range = 1,
+    Changed = 2,
+    Unchanged = 3,
 
 CITRA_PORT = 45987
 
 class Citra:
-    def __init__(self, address="127.0.0.1", port=CITRA_PORT):
-        self.socket = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    def __init__(self, address="127.0.0.1", port=CITRA_PORT, use_tcp=False):
+        """Connects to the RPC server. TCP connections are required for subscriptions and allow
+        reading large memory regions with a single request."""
         self.address = address
+        self.port = port
+        self.use_tcp = use_tcp
+        # Subscription updates received while waiting for the reply to a request
+        self.pending_updates = []
+        if use_tcp:
+            self.socket = socket.create_connection((address, port))
+            self.socket.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        else:
+            self.socket = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
 
     def is_connected(self):
         return self.socket is not None
 
+    def max_request_data_size(self):
+        return MAX_STREAM_REQUEST_DATA_SIZE if self.use_tcp else MAX_REQUEST_DATA_SIZE
+
+    def _recv_exact(self, size):
+        data = bytearray()
+        while len(data) < size:
+            chunk = self.socket.recv(size - len(data))
+            if not chunk:
+                raise ConnectionError("The RPC server closed the connection")
+            data += chunk
+        return bytes(data)
+
+    def _recv_packet(self):
+        if not self.use_tcp:
+            return self.socket.recv(MAX_PACKET_SIZE)
+        header = self._recv_exact(HEADER_SIZE)
+        data_size = struct.unpack("IIII", header)[3]
+        return header + self._recv_exact(data_size)
+
+    def _request(self, request_type, request_data):
+        """Sends a request and returns the data of its reply, or None if the reply is invalid"""
+        request, request_id = self._generate_header(request_type, len(request_data))
+        request += request_data
+        if self.use_tcp:
+            self.socket.sendall(request)
+        else:
+            self.socket.sendto(request, (self.address, self.port))
+
+        while True:
+            raw_reply = self._recv_packet()
+            # Updates may be pushed before the reply, keep them for read_subscription_updates
+            update = self._parse_subscription_update(raw_reply)
+            if update is not None:
+                self.pending_updates.append(update)
+                continue
+            return self._read_and_validate_header(raw_reply, request_id, request_type)
+
     def _generate_header(self, request_type, data_size):
         request_id = random.getrandbits(32)
         return (struct.pack("IIII", CURRENT_REQUEST_VERSION, request_id, request_type, data_size), request_id)
@@ -45,12 +115,7 @@ class Citra:
         read_processes = 0
         while True:
             request_data = struct.pack("II", read_processes, 0x7FFFFFFF)
-            request, request_id = self._generate_header(RequestType.ProcessList, len(request_data))
-            request += request_data
-            self.socket.sendto(request, (self.address, CITRA_PORT))
-
-            raw_reply = self.socket.recv(MAX_PACKET_SIZE)
-            reply_data = self._read_and_validate_header(raw_reply, request_id, RequestType.ProcessList)
+            reply_data = self._request(RequestType.ProcessList, request_data)
 
             if reply_data:
                 read_count = struct.unpack("I", reply_data[0:4])[0]
@@ -69,12 +134,7 @@ class Citra:
 
     def get_process(self):
         request_data = struct.pack("II", 0, 0)
-        request, request_id = self._generate_header(RequestType.SetGetProcess, len(request_data))
-        request += request_data
-        self.socket.sendto(request, (self.address, CITRA_PORT))
-
-        raw_reply = self.socket.recv(MAX_PACKET_SIZE)
-        reply_data = self._read_and_validate_header(raw_reply, request_id, RequestType.SetGetProcess)
+        reply_data = self._request(RequestType.SetGetProcess, request_data)
 
         if reply_data:
             return struct.unpack("I", reply_data)[0]
@@ -83,11 +143,7 @@ class Citra:
 
     def set_process(self, process_id):
         request_data = struct.pack("II", 1, process_id)
-        request, request_id = self._generate_header(RequestType.SetGetProcess, len(request_data))
-        request += request_data
-        self.socket.sendto(request, (self.address, CITRA_PORT))
-
-        self.socket.recv(MAX_PACKET_SIZE)
+        self._request(RequestType.SetGetProcess, request_data)
 
     def read_memory(self, read_address, read_size):
         """
@@ -98,12 +154,7 @@ class Citra:
         while read_size > 0:
             temp_read_size = min(read_size, MAX_REQUEST_DATA_SIZE)
             request_data = struct.pack("II", read_address, temp_read_size)
-            request, request_id = self._generate_header(RequestType.ReadMemory, len(request_data))
-            request += request_data
-            self.socket.sendto(request, (self.address, CITRA_PORT))
-
-            raw_reply = self.socket.recv(MAX_PACKET_SIZE)
-            reply_data = self._read_and_validate_header(raw_reply, request_id, RequestType.ReadMemory)
+            reply_data = self._request(RequestType.ReadMemory, request_data)
 
             if reply_data:
                 result += reply_data
@@ -130,12 +181,7 @@ class Citra:
             temp_write_size = min(write_size, MAX_REQUEST_DATA_SIZE - 8)
             request_data = struct.pack("II", write_address, temp_write_size)
             request_data += write_contents[:temp_write_size]
-            request, request_id = self._generate_header(RequestType.WriteMemory, len(request_data))
-            request += request_data
-            self.socket.sendto(request, (self.address, CITRA_PORT))
-
-            raw_reply = self.socket.recv(MAX_PACKET_SIZE)
-            reply_data = self._read_and_validate_header(raw_reply, request_id, RequestType.WriteMemory)
+            reply_data = self._request(RequestType.WriteMemory, request_data)
 
             if None != reply_data:
                 write_address += temp_write_size
@@ -145,6 +191,123 @@ class Citra:
                 return False
         return True
 
+    def bulk_read_memory(self, read_address, read_size):
+        """Reads a memory region with a single request, up to max_request_data_size() bytes
+
+        >>> c.bulk_read_memory(0x100000, 4)
+        b'\\x07\\x00\\x00\\xeb'
+        """
+        request_data = struct.pack("II", read_address, read_size)
+        reply_data = self._request(RequestType.BulkReadMemory, request_data)
+        if reply_data is None or len(reply_data) != read_size:
+            return None
+        return reply_data
+
+    def scatter_read_memory(self, regions):
+        """Reads a list of (address, size) regions with a single request, returns their contents
+
+        >>> c.scatter_read_memory([(0x100000, 2), (0x100002, 2)])
+        [b'\\x07\\x00', b'\\x00\\xeb']
+        """
+        request_data = struct.pack("II", len(regions), 0)
+        for address, size in regions:
+            request_data += struct.pack("II", address, size)
+        reply_data = self._request(RequestType.ScatterReadMemory, request_data)
+        if reply_data is None or len(reply_data) != sum(size for _, size in regions):
+            return None
+        result = []
+        for _, size in regions:
+            result.append(reply_data[:size])
+            reply_data = reply_data[size:]
+        return result
+
+    def subscribe(self, address, size):
+        """Asks for the changes of a memory region to be sent every frame, returns the
+        subscription id. Only available on TCP connections, the first update holds the whole
+        region. The server limits the combined size of the subscribed regions."""
+        request_data = struct.pack("II", address, size)
+        reply_data = self._request(RequestType.Subscribe, request_data)
+        if reply_data:
+            return struct.unpack("I", reply_data)[0]
+        return None
+
+    def unsubscribe(self, subscription_id):
+        request_data = struct.pack("II", subscription_id, 0)
+        return self._request(RequestType.Unsubscribe, request_data) is not None
+
+    def _parse_subscription_update(self, raw_packet):
+        reply_id, reply_type = struct.unpack("II", raw_packet[4:12])
+        if reply_type != RequestType.SubscriptionUpdate:
+            return None
+        changes = []
+        data = raw_packet[HEADER_SIZE:]
+        while data:
+            address, size = struct.unpack("II", data[:8])
+            changes.append((address, data[8:8 + size]))
+            data = data[8 + size:]
+        return (reply_id, changes)
+
+    def read_subscription_updates(self, timeout=None):
+        """Returns a list of (subscription_id, [(address, data)]) with the changed parts of the
+        subscribed regions. Waits up to timeout seconds for an update if none was received yet."""
+        # Only wait for the start of a packet, so that a timeout cannot split one
+        if not self.pending_updates and select.select([self.socket], [], [], timeout)[0]:
+            update = self._parse_subscription_update(self._recv_packet())
+            if update is not None:
+                self.pending_updates.append(update)
+        updates = self.pending_updates
+        self.pending_updates = []
+        return updates
+
+    def _trace_request(self, operation, events_per_thread=0):
+        request_data = struct.pack("II", operation, events_per_thread)
+        return self._request(RequestType.Trace, request_data)
+
+    def start_trace(self, events_per_thread=0):
+        """Starts recording a trace, keeping up to events_per_thread events for each thread"""
+        return self._trace_request(1, events_per_thread) is not None
+
+    def stop_trace(self):
+        return self._trace_request(0) is not None
+
+    def dump_trace(self):
+        """Writes the recorded trace to the log directory and returns the path of the file"""
+        reply_data = self._trace_request(2)
+        if reply_data:
+            return reply_data.decode("utf-8")
+        return None
+
+    def _search_request(self, operation, argument, first=0, second=0):
+        request_data = struct.pack("IIII", operation, argument, first, second)
+        return self._request(RequestType.MemorySearch, request_data)
+
+    def start_search(self, value_type):
+        """Starts searching the memory of the selected process, returns the number of candidates"""
+        reply_data = self._search_request(0, value_type)
+        if reply_data:
+            return struct.unpack("I", reply_data)[0]
+        return None
+
+    def search(self, comparison, first=0, second=0):
+        """Keeps the candidates matching the comparison, returns the number of candidates left
+
+        Float operands are passed as their bits, e.g. struct.unpack("I", struct.pack("f", 1.5))[0]
+        """
+        reply_data = self._search_request(1, comparison, first, second)
+        if reply_data:
+            return struct.unpack("I", reply_data)[0]
+        return None
+
+    def search_results(self, first_index=0):
+        """Returns a list of (address, value) of the candidates, starting from first_index"""
+        reply_data = self._search_request(2, first_index)
+        if reply_data is None:
+            return None
+        return list(struct.iter_unpack("II", reply_data))
+
+    def reset_search(self):
+        return self._search_request(3, 0) is not None
+
 if "__main__" == __name__:
     import doctest
     doctest.testmod(extraglobs={'c': Citra()})
@@ -113,6 +113,10 @@ async_shader_compilation =
 # 0: GLSL, 1: SPIR-V (default)
 spirv_shader_gen =
 
+# Whether to emit PICA vertex and geometry shaders using SPIRV or GLSL (Vulkan only, experimental)
+# 0 (default): GLSL, 1: SPIR-V
+spirv_vertex_shader_gen =
+
 # Whether to disable the SPIRV optimizer. Disabling it reduces stutter, but may slightly worsen performance
 # 0: Enabled, 1: Disabled (default)
 disable_spirv_optimizer =
@@ -139,6 +143,11 @@ texture_sampling =
 # 0: Off, 1 (default): On
 use_vsync_new =
 
+# How the frame limiter waits for the next frame
+# 0 (default): Sleep (lowest CPU usage), 1: Precise (sleeps, then spins briefly near the deadline)
+# 2: VSync aligned (like Precise, but lines frames up with the host display refresh)
+frame_pacing =
+
 # Reduce stuttering by storing and loading generated shaders to disk
 # 0: Off, 1 (default. On)
 use_disk_shader_cache =
@@ -344,6 +353,11 @@ enable_audio_stretching =
 # 0 (default): No, 1: Yes
 enable_realtime_audio =
 
+# Whether to adapt the audio latency to the host: the latency grows after the audio output runs
+# out of samples, and shrinks back while it does not.
+# 0 (default): No, 1: Yes
+enable_adaptive_audio_latency =
+
 # Output volume.
 # 1.0 (default): 100%, 0.0; mute
 volume =
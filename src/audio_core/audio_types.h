@@ -4,9 +4,11 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
-#include <deque>
+#include <span>
+#include <vector>
 #include "common/common_types.h"
 
 namespace AudioCore {
@@ -23,8 +25,61 @@ using StereoFrame16 = std::array<std::array<s16, 2>, samples_per_frame>;
 /// The DSP is quadraphonic internally.
 using QuadFrame32 = std::array<std::array<s32, 4>, samples_per_frame>;
 
-/// A variable length buffer of signed PCM16 stereo samples.
-using StereoBuffer16 = std::deque<std::array<s16, 2>>;
+/**
+ * A variable length buffer of signed PCM16 stereo samples, consumed from the front.
+ *
+ * The samples are contiguous, and the storage is kept from one buffer to the next, so that once
+ * the largest buffer of a source was decoded no more allocations happen. Three slots are kept
+ * before the unread samples for the history of the interpolation.
+ */
+class StereoBuffer16 {
+public:
+    using Sample = std::array<s16, 2>;
+
+    /// Number of samples that can be placed before the unread ones
+    static constexpr std::size_t HistorySize = 3;
+
+    /// Discards the samples and returns the storage where the next `size` samples are decoded.
+    std::span<Sample> Reset(std::size_t size) {
+        data.resize(HistorySize + size);
+        read_position = HistorySize;
+        return std::span{data}.subspan(HistorySize);
+    }
+
+    void Clear() {
+        read_position = data.size();
+    }
+
+    /// Returns the unread samples.
+    std::span<const Sample> Samples() const {
+        return std::span{data}.subspan(read_position);
+    }
+
+    /// Returns the unread samples preceded by the given history samples.
+    std::span<const Sample> WithHistory(const Sample& xn3, const Sample& xn2, const Sample& xn1) {
+        data[read_position - 3] = xn3;
+        data[read_position - 2] = xn2;
+        data[read_position - 1] = xn1;
+        return std::span{data}.subspan(read_position - HistorySize);
+    }
+
+    /// Drops up to `count` samples from the front.
+    void Consume(std::size_t count) {
+        read_position += std::min(count, size());
+    }
+
+    std::size_t size() const {
+        return data.size() - read_position;
+    }
+
+    bool empty() const {
+        return read_position == data.size();
+    }
+
+private:
+    std::vector<Sample> data = std::vector<Sample>(HistorySize);
+    std::size_t read_position = HistorySize;
+};
 
 constexpr std::size_t num_dsp_pipe = 8;
 enum class DspPipe {
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cstddef>
 #include "audio_core/dsp_interface.h"
 #include "audio_core/sink.h"
@@ -13,7 +14,8 @@
 
 namespace AudioCore {
 
-DspInterface::DspInterface(Core::System& system_) : system(system_) {}
+DspInterface::DspInterface(Core::System& system_)
+    : system(system_), stretch_input(2 * fifo_capacity) {}
 
 DspInterface::~DspInterface() = default;
 
@@ -21,6 +23,8 @@ void DspInterface::SetSink(AudioCore::SinkType sink_type, std::string_view audio
     // Dispose of the current sink first to avoid contention.
     sink.reset();
 
+    latency_target.Reset();
+
     sink = AudioCore::GetSinkDetails(sink_type).create_sink(audio_device);
     sink->SetCallback(
         [this](s16* buffer, std::size_t num_frames) { OutputCallback(buffer, num_frames); });
@@ -36,12 +40,29 @@ void DspInterface::EnableStretching(bool enable) {
     enable_time_stretching = enable;
 }
 
+void DspInterface::EnableAdaptiveLatency(bool enable) {
+    enable_adaptive_latency = enable;
+}
+
+AudioOutputStats DspInterface::GetOutputStats() const {
+    return {
+        .underruns = underruns.load(std::memory_order_relaxed),
+        .overrun_frames = overrun_frames.load(std::memory_order_relaxed),
+        .skipped_frames = skipped_frames.load(std::memory_order_relaxed),
+        .queued_frames = fifo.Size(),
+        .target_frames = enable_adaptive_latency ? latency_target.GetTarget() : 0,
+    };
+}
+
 void DspInterface::OutputFrame(StereoFrame16 frame) {
     if (!sink) {
         return;
     }
 
-    fifo.Push(frame.data(), frame.size());
+    const std::size_t pushed = fifo.Push(frame.data(), frame.size());
+    if (pushed < frame.size()) {
+        overrun_frames.fetch_add(frame.size() - pushed, std::memory_order_relaxed);
+    }
 
     auto video_dumper = system.GetVideoDumper();
     if (video_dumper && video_dumper->IsDumping()) {
@@ -54,7 +75,9 @@ void DspInterface::OutputSample(std::array<s16, 2> sample) {
         return;
     }
 
-    fifo.Push(&sample, 1);
+    if (fifo.Push(&sample, 1) == 0) {
+        overrun_frames.fetch_add(1, std::memory_order_relaxed);
+    }
 
     auto video_dumper = system.GetVideoDumper();
     if (video_dumper && video_dumper->IsDumping()) {
@@ -74,9 +97,9 @@ void DspInterface::OutputCallback(s16* buffer, std::size_t num_frames) {
 
     std::size_t frames_written = 0;
     if (performing_time_stretching) {
-        const std::vector<s16> in{fifo.Pop()};
-        const std::size_t num_in{in.size() / 2};
-        frames_written = time_stretcher.Process(in.data(), num_in, buffer, num_frames);
+        // The stretcher keeps its own backlog, so all the queued frames are passed on.
+        const std::size_t num_in = fifo.Pop(stretch_input.data(), fifo_capacity);
+        frames_written = time_stretcher.Process(stretch_input.data(), num_in, buffer, num_frames);
     } else {
         if (flushing_time_stretcher) {
             time_stretcher.Flush();
@@ -87,7 +110,17 @@ void DspInterface::OutputCallback(s16* buffer, std::size_t num_frames) {
             // so that they do not bleed into the next time the stretcher is enabled.
             time_stretcher.Clear();
         }
-        frames_written += fifo.Pop(buffer, num_frames - frames_written);
+        if (enable_adaptive_latency) {
+            const std::size_t excess =
+                latency_target.GetExcessFrames(fifo.Size(), num_frames - frames_written);
+            if (excess > 0) {
+                skipped_frames.fetch_add(fifo.Discard(excess), std::memory_order_relaxed);
+            }
+        }
+        frames_written += fifo.Pop(buffer + 2 * frames_written, num_frames - frames_written);
+    }
+    if (latency_target.Update(frames_written, num_frames, enable_adaptive_latency)) {
+        underruns.fetch_add(1, std::memory_order_relaxed);
     }
 
     if (frames_written > 0) {
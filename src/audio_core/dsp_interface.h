@@ -4,10 +4,13 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <span>
+#include <vector>
 #include <boost/serialization/access.hpp>
 #include "audio_core/audio_types.h"
+#include "audio_core/latency_target.h"
 #include "audio_core/time_stretch.h"
 #include "common/common_types.h"
 #include "common/ring_buffer.h"
@@ -26,6 +29,20 @@ namespace AudioCore {
 class Sink;
 enum class SinkType : u32;
 
+/// Statistics of the audio output, for diagnosing crackling and latency.
+struct AudioOutputStats {
+    /// Number of times the sink ran out of samples while playing
+    u64 underruns;
+    /// Number of frames dropped because the output FIFO was full
+    u64 overrun_frames;
+    /// Number of frames skipped to bring the latency back to the target
+    u64 skipped_frames;
+    /// Number of frames waiting in the output FIFO, which is the latency added by the emulator
+    std::size_t queued_frames;
+    /// Latency targeted by the adaptive latency mode in frames, or 0 when it is disabled
+    std::size_t target_frames;
+};
+
 class DspInterface {
 public:
     DspInterface(Core::System& system_);
@@ -105,6 +122,10 @@ public:
     Sink& GetSink();
     /// Enable/Disable audio stretching.
     void EnableStretching(bool enable);
+    /// Enable/Disable the adaptive latency mode.
+    void EnableAdaptiveLatency(bool enable);
+    /// Returns the statistics of the audio output.
+    AudioOutputStats GetOutputStats() const;
 
 protected:
     void OutputFrame(StereoFrame16 frame);
@@ -114,14 +135,28 @@ private:
     void FlushResidualStretcherAudio();
     void OutputCallback(s16* buffer, std::size_t num_frames);
 
+    /// Number of stereo frames the output FIFO holds
+    static constexpr std::size_t fifo_capacity = 0x2000;
+
     Core::System& system;
 
     std::atomic<bool> enable_time_stretching = false;
     std::atomic<bool> performing_time_stretching = false;
     std::atomic<bool> flushing_time_stretcher = false;
-    Common::RingBuffer<s16, 0x2000, 2> fifo;
+    std::atomic<bool> enable_adaptive_latency = false;
+    Common::RingBuffer<s16, fifo_capacity, 2> fifo;
     std::array<s16, 2> last_frame{};
     TimeStretcher time_stretcher;
+    /// Where the FIFO is popped when stretching, allocated once so that the sink thread does not
+    /// allocate
+    std::vector<s16> stretch_input;
+
+    // Output statistics
+    std::atomic<u64> underruns{};
+    std::atomic<u64> overrun_frames{};
+    std::atomic<u64> skipped_frames{};
+    LatencyTarget latency_target;
+
     std::unique_ptr<Sink> sink;
 
     template <class Archive>
@@ -0,0 +1,284 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstddef>
+#include "audio_core/hle/mix_kernels.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MIX_KERNELS_SSE2
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define MIX_KERNELS_NEON
+#endif
+
+namespace AudioCore::HLE::MixKernels {
+
+namespace {
+
+s16 ClampToS16(s32 value) {
+    return static_cast<s16>(std::clamp(value, -32768, 32767));
+}
+
+s16 AddAndClampToS16(s16 a, s16 b) {
+    return ClampToS16(static_cast<s32>(a) + static_cast<s32>(b));
+}
+
+} // Anonymous namespace
+
+namespace Scalar {
+
+void MixStereoIntoQuad(QuadFrame32& dest, const StereoFrame16& source,
+                       const std::array<float, 4>& gains) {
+    for (std::size_t i = 0; i < samples_per_frame; i++) {
+        dest[i][0] += static_cast<s32>(gains[0] * source[i][0]);
+        dest[i][1] += static_cast<s32>(gains[1] * source[i][1]);
+        dest[i][2] += static_cast<s32>(gains[2] * source[i][0]);
+        dest[i][3] += static_cast<s32>(gains[3] * source[i][1]);
+    }
+}
+
+void DownmixStereoInto(StereoFrame16& dest, const QuadFrame32& source, float gain) {
+    for (std::size_t i = 0; i < samples_per_frame; i++) {
+        const auto& sample = source[i];
+        const s16 left = ClampToS16(static_cast<s32>(gain * sample[0] + gain * sample[2]));
+        const s16 right = ClampToS16(static_cast<s32>(gain * sample[1] + gain * sample[3]));
+        dest[i][0] = AddAndClampToS16(dest[i][0], left);
+        dest[i][1] = AddAndClampToS16(dest[i][1], right);
+    }
+}
+
+void DownmixMonoInto(StereoFrame16& dest, const QuadFrame32& source, float gain) {
+    for (std::size_t i = 0; i < samples_per_frame; i++) {
+        const auto& sample = source[i];
+        const s16 mono = ClampToS16(static_cast<s32>(
+            (gain * sample[0] + gain * sample[1] + gain * sample[2] + gain * sample[3]) / 2));
+        dest[i][0] = AddAndClampToS16(dest[i][0], mono);
+        dest[i][1] = AddAndClampToS16(dest[i][1], mono);
+    }
+}
+
+void ToPlanar(PlanarQuadFrame32& dest, const QuadFrame32& source) {
+    for (std::size_t i = 0; i < samples_per_frame; i++) {
+        for (std::size_t channel = 0; channel < 4; channel++) {
+            dest[channel][i] = source[i][channel];
+        }
+    }
+}
+
+void FromPlanar(QuadFrame32& dest, const PlanarQuadFrame32& source) {
+    for (std::size_t i = 0; i < samples_per_frame; i++) {
+        for (std::size_t channel = 0; channel < 4; channel++) {
+            dest[i][channel] = source[channel][i];
+        }
+    }
+}
+
+} // namespace Scalar
+
+#if defined(MIX_KERNELS_SSE2)
+
+// The conversions to float round to nearest and the conversions back truncate, like the casts of
+// the scalar kernels. The float operations are done in the same order, so the results are equal.
+
+namespace {
+
+/// Adds a quadraphonic sample scaled by the gains to out.
+void MixQuad(__m128i* out, __m128i quad, __m128 gain) {
+    const __m128i scaled = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(quad), gain));
+    _mm_storeu_si128(out, _mm_add_epi32(_mm_loadu_si128(out), scaled));
+}
+
+/// Loads four quadraphonic samples scaled by gain, transposed so that each vector is a channel.
+void LoadChannels(const QuadFrame32& source, std::size_t i, __m128 gain, __m128& c0, __m128& c1,
+                  __m128& c2, __m128& c3) {
+    const auto* in = reinterpret_cast<const __m128i*>(&source[i]);
+    c0 = _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128(in)), gain);
+    c1 = _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128(in + 1)), gain);
+    c2 = _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128(in + 2)), gain);
+    c3 = _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128(in + 3)), gain);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+}
+
+/// Adds four stereo samples, given as interleaved 16-bit values, to dest with saturation.
+void AddSaturated(StereoFrame16& dest, std::size_t i, __m128i samples) {
+    auto* out = reinterpret_cast<__m128i*>(&dest[i]);
+    _mm_storeu_si128(out, _mm_adds_epi16(_mm_loadu_si128(out), samples));
+}
+
+} // Anonymous namespace
+
+void MixStereoIntoQuad(QuadFrame32& dest, const StereoFrame16& source,
+                       const std::array<float, 4>& gains) {
+    const __m128 gain = _mm_loadu_ps(gains.data());
+    for (std::size_t i = 0; i < samples_per_frame; i += 2) {
+        // Two stereo samples, sign-extended to 32 bits.
+        __m128i stereo = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&source[i]));
+        stereo = _mm_srai_epi32(_mm_unpacklo_epi16(stereo, stereo), 16);
+
+        auto* out = reinterpret_cast<__m128i*>(&dest[i]);
+        MixQuad(out, _mm_shuffle_epi32(stereo, _MM_SHUFFLE(1, 0, 1, 0)), gain);
+        MixQuad(out + 1, _mm_shuffle_epi32(stereo, _MM_SHUFFLE(3, 2, 3, 2)), gain);
+    }
+}
+
+void DownmixStereoInto(StereoFrame16& dest, const QuadFrame32& source, float gain) {
+    const __m128 gains = _mm_set1_ps(gain);
+    for (std::size_t i = 0; i < samples_per_frame; i += 4) {
+        __m128 c0, c1, c2, c3;
+        LoadChannels(source, i, gains, c0, c1, c2, c3);
+        const __m128i left = _mm_cvttps_epi32(_mm_add_ps(c0, c2));
+        const __m128i right = _mm_cvttps_epi32(_mm_add_ps(c1, c3));
+        AddSaturated(dest, i,
+                     _mm_packs_epi32(_mm_unpacklo_epi32(left, right),
+                                     _mm_unpackhi_epi32(left, right)));
+    }
+}
+
+void DownmixMonoInto(StereoFrame16& dest, const QuadFrame32& source, float gain) {
+    const __m128 gains = _mm_set1_ps(gain);
+    const __m128 half = _mm_set1_ps(0.5f);
+    for (std::size_t i = 0; i < samples_per_frame; i += 4) {
+        __m128 c0, c1, c2, c3;
+        LoadChannels(source, i, gains, c0, c1, c2, c3);
+        // Halving is exact, so multiplying by 0.5 gives the same result as dividing by 2.
+        const __m128 sum = _mm_add_ps(_mm_add_ps(_mm_add_ps(c0, c1), c2), c3);
+        const __m128i mono = _mm_cvttps_epi32(_mm_mul_ps(sum, half));
+        const __m128i packed = _mm_packs_epi32(mono, mono);
+        AddSaturated(dest, i, _mm_unpacklo_epi16(packed, packed));
+    }
+}
+
+void ToPlanar(PlanarQuadFrame32& dest, const QuadFrame32& source) {
+    for (std::size_t i = 0; i < samples_per_frame; i += 4) {
+        const auto* in = reinterpret_cast<const float*>(&source[i]);
+        __m128 c0 = _mm_loadu_ps(in);
+        __m128 c1 = _mm_loadu_ps(in + 4);
+        __m128 c2 = _mm_loadu_ps(in + 8);
+        __m128 c3 = _mm_loadu_ps(in + 12);
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+        _mm_storeu_ps(reinterpret_cast<float*>(&dest[0][i]), c0);
+        _mm_storeu_ps(reinterpret_cast<float*>(&dest[1][i]), c1);
+        _mm_storeu_ps(reinterpret_cast<float*>(&dest[2][i]), c2);
+        _mm_storeu_ps(reinterpret_cast<float*>(&dest[3][i]), c3);
+    }
+}
+
+void FromPlanar(QuadFrame32& dest, const PlanarQuadFrame32& source) {
+    for (std::size_t i = 0; i < samples_per_frame; i += 4) {
+        __m128 s0 = _mm_loadu_ps(reinterpret_cast<const float*>(&source[0][i]));
+        __m128 s1 = _mm_loadu_ps(reinterpret_cast<const float*>(&source[1][i]));
+        __m128 s2 = _mm_loadu_ps(reinterpret_cast<const float*>(&source[2][i]));
+        __m128 s3 = _mm_loadu_ps(reinterpret_cast<const float*>(&source[3][i]));
+        _MM_TRANSPOSE4_PS(s0, s1, s2, s3);
+        auto* out = reinterpret_cast<float*>(&dest[i]);
+        _mm_storeu_ps(out, s0);
+        _mm_storeu_ps(out + 4, s1);
+        _mm_storeu_ps(out + 8, s2);
+        _mm_storeu_ps(out + 12, s3);
+    }
+}
+
+#elif defined(MIX_KERNELS_NEON)
+
+void MixStereoIntoQuad(QuadFrame32& dest, const StereoFrame16& source,
+                       const std::array<float, 4>& gains) {
+    const float32x4_t gain = vld1q_f32(gains.data());
+    for (std::size_t i = 0; i < samples_per_frame; i += 2) {
+        const int32x4_t stereo = vmovl_s16(vld1_s16(&source[i][0]));
+        const int32x4_t quad0 = vcombine_s32(vget_low_s32(stereo), vget_low_s32(stereo));
+        const int32x4_t quad1 = vcombine_s32(vget_high_s32(stereo), vget_high_s32(stereo));
+        s32* out = &dest[i][0];
+        vst1q_s32(out, vaddq_s32(vld1q_s32(out),
+                                 vcvtq_s32_f32(vmulq_f32(vcvtq_f32_s32(quad0), gain))));
+        vst1q_s32(out + 4, vaddq_s32(vld1q_s32(out + 4),
+                                     vcvtq_s32_f32(vmulq_f32(vcvtq_f32_s32(quad1), gain))));
+    }
+}
+
+namespace {
+
+float32x4_t ScaleChannel(int32x4_t channel, float gain) {
+    return vmulq_n_f32(vcvtq_f32_s32(channel), gain);
+}
+
+} // Anonymous namespace
+
+void DownmixStereoInto(StereoFrame16& dest, const QuadFrame32& source, float gain) {
+    for (std::size_t i = 0; i < samples_per_frame; i += 4) {
+        const int32x4x4_t channels = vld4q_s32(&source[i][0]);
+        const float32x4_t left = vaddq_f32(ScaleChannel(channels.val[0], gain),
+                                           ScaleChannel(channels.val[2], gain));
+        const float32x4_t right = vaddq_f32(ScaleChannel(channels.val[1], gain),
+                                            ScaleChannel(channels.val[3], gain));
+        int16x4x2_t out = vld2_s16(&dest[i][0]);
+        out.val[0] = vqadd_s16(out.val[0], vqmovn_s32(vcvtq_s32_f32(left)));
+        out.val[1] = vqadd_s16(out.val[1], vqmovn_s32(vcvtq_s32_f32(right)));
+        vst2_s16(&dest[i][0], out);
+    }
+}
+
+void DownmixMonoInto(StereoFrame16& dest, const QuadFrame32& source, float gain) {
+    for (std::size_t i = 0; i < samples_per_frame; i += 4) {
+        const int32x4x4_t channels = vld4q_s32(&source[i][0]);
+        const float32x4_t sum = vaddq_f32(
+            vaddq_f32(vaddq_f32(ScaleChannel(channels.val[0], gain),
+                                ScaleChannel(channels.val[1], gain)),
+                      ScaleChannel(channels.val[2], gain)),
+            ScaleChannel(channels.val[3], gain));
+        // Halving is exact, so multiplying by 0.5 gives the same result as dividing by 2.
+        const int16x4_t mono = vqmovn_s32(vcvtq_s32_f32(vmulq_n_f32(sum, 0.5f)));
+        int16x4x2_t out = vld2_s16(&dest[i][0]);
+        out.val[0] = vqadd_s16(out.val[0], mono);
+        out.val[1] = vqadd_s16(out.val[1], mono);
+        vst2_s16(&dest[i][0], out);
+    }
+}
+
+void ToPlanar(PlanarQuadFrame32& dest, const QuadFrame32& source) {
+    for (std::size_t i = 0; i < samples_per_frame; i += 4) {
+        const int32x4x4_t channels = vld4q_s32(&source[i][0]);
+        for (std::size_t channel = 0; channel < 4; channel++) {
+            vst1q_s32(&dest[channel][i], channels.val[channel]);
+        }
+    }
+}
+
+void FromPlanar(QuadFrame32& dest, const PlanarQuadFrame32& source) {
+    for (std::size_t i = 0; i < samples_per_frame; i += 4) {
+        int32x4x4_t channels;
+        for (std::size_t channel = 0; channel < 4; channel++) {
+            channels.val[channel] = vld1q_s32(&source[channel][i]);
+        }
+        vst4q_s32(&dest[i][0], channels);
+    }
+}
+
+#else
+
+void MixStereoIntoQuad(QuadFrame32& dest, const StereoFrame16& source,
+                       const std::array<float, 4>& gains) {
+    Scalar::MixStereoIntoQuad(dest, source, gains);
+}
+
+void DownmixStereoInto(StereoFrame16& dest, const QuadFrame32& source, float gain) {
+    Scalar::DownmixStereoInto(dest, source, gain);
+}
+
+void DownmixMonoInto(StereoFrame16& dest, const QuadFrame32& source, float gain) {
+    Scalar::DownmixMonoInto(dest, source, gain);
+}
+
+void ToPlanar(PlanarQuadFrame32& dest, const QuadFrame32& source) {
+    Scalar::ToPlanar(dest, source);
+}
+
+void FromPlanar(QuadFrame32& dest, const PlanarQuadFrame32& source) {
+    Scalar::FromPlanar(dest, source);
+}
+
+#endif
+
+} // namespace AudioCore::HLE::MixKernels
@@ -0,0 +1,50 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include "audio_core/audio_types.h"
+#include "common/common_types.h"
+
+/**
+ * Per-frame mixing kernels of the HLE DSP, vectorized with SSE2 on x86-64 and NEON on AArch64.
+ *
+ * The vectorized kernels produce exactly the same samples as the scalar ones, which are kept as
+ * the reference implementation and as the fallback for the other architectures.
+ */
+namespace AudioCore::HLE::MixKernels {
+
+/// A quadraphonic frame stored channel by channel, as in the intermediate mix shared memory.
+using PlanarQuadFrame32 = s32[4][samples_per_frame];
+
+/**
+ * Adds a stereo frame to a quadraphonic mix, each channel scaled by its gain. The left samples
+ * go to the channels 0 and 2, the right samples to the channels 1 and 3.
+ */
+void MixStereoIntoQuad(QuadFrame32& dest, const StereoFrame16& source,
+                       const std::array<float, 4>& gains);
+
+/// Downmixes a quadraphonic frame scaled by gain to stereo, and adds it to dest with saturation.
+void DownmixStereoInto(StereoFrame16& dest, const QuadFrame32& source, float gain);
+
+/// Downmixes a quadraphonic frame scaled by gain to mono, and adds it to dest with saturation.
+void DownmixMonoInto(StereoFrame16& dest, const QuadFrame32& source, float gain);
+
+void ToPlanar(PlanarQuadFrame32& dest, const QuadFrame32& source);
+void FromPlanar(QuadFrame32& dest, const PlanarQuadFrame32& source);
+
+/// The scalar implementations of the kernels.
+namespace Scalar {
+
+void MixStereoIntoQuad(QuadFrame32& dest, const StereoFrame16& source,
+                       const std::array<float, 4>& gains);
+void DownmixStereoInto(StereoFrame16& dest, const QuadFrame32& source, float gain);
+void DownmixMonoInto(StereoFrame16& dest, const QuadFrame32& source, float gain);
+void ToPlanar(PlanarQuadFrame32& dest, const QuadFrame32& source);
+void FromPlanar(QuadFrame32& dest, const PlanarQuadFrame32& source);
+
+} // namespace Scalar
+
+} // namespace AudioCore::HLE::MixKernels
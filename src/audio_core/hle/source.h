@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <deque>
 #include <vector>
 #include <boost/serialization/array.hpp>
 #include <boost/serialization/deque.hpp>
@@ -137,7 +139,7 @@ private:
 
         u32 current_sample_number = 0;
         PAddr current_buffer_physical_address = 0;
-        AudioInterp::StereoBuffer16 current_buffer = {};
+        StereoBuffer16 current_buffer = {};
 
         // buffer_id state
 
@@ -171,7 +173,16 @@ private:
             ar & format;
             ar & current_sample_number;
             ar & current_buffer_physical_address;
-            ar & current_buffer;
+            // The unread samples are saved as a deque, which is what the buffer used to be.
+            std::deque<StereoBuffer16::Sample> samples;
+            if (Archive::is_saving::value) {
+                const auto unread = current_buffer.Samples();
+                samples.assign(unread.begin(), unread.end());
+            }
+            ar & samples;
+            if (Archive::is_loading::value) {
+                std::ranges::copy(samples, current_buffer.Reset(samples.size()).begin());
+            }
             ar & buffer_update;
             ar & current_buffer_id;
             ar & adpcm_coeffs;
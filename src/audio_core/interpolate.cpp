@@ -3,74 +3,303 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+#include <type_traits>
 #include "audio_core/interpolate.h"
 #include "common/assert.h"
 
+#if defined(__x86_64__) || defined(_M_X64)
+#include <emmintrin.h>
+#define INTERPOLATE_SSE2
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define INTERPOLATE_NEON
+#endif
+
 namespace AudioCore::AudioInterp {
 
+using Sample = StereoBuffer16::Sample;
+
 // Calculations are done in fixed point with 24 fractional bits.
 // (This is not verified. This was chosen for minimal error.)
 constexpr u64 scale_factor = 1 << 24;
 constexpr u64 scale_mask = scale_factor - 1;
 
+/// Number of samples computed at once by the block functions.
+constexpr std::size_t block_size = 4;
+
+/// Number of phases of the polyphase filter. The fraction is rounded to the nearest phase.
+constexpr std::size_t num_phases = 128;
+constexpr u64 phase_shift = 17;
+static_assert(scale_factor >> phase_shift == num_phases);
+
 /// Here we step over the input in steps of rate, until we consume all of the input.
-/// Three adjacent samples are passed to fn each step.
-template <typename Function>
+/// The four samples around each step are passed to fn: the step is between x[1] and x[2].
+/// When possible, block_fn computes block_size samples at once instead.
+template <typename Function, typename BlockFunction>
 static void StepOverSamples(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
-                            std::size_t& outputi, Function fn) {
+                            std::size_t& outputi, Function fn, BlockFunction block_fn) {
     ASSERT(rate > 0);
 
     if (input.empty())
         return;
 
-    input.insert(input.begin(), {state.xn2, state.xn1});
+    const auto samples = input.WithHistory(state.xn3, state.xn2, state.xn1);
 
     const u64 step_size = static_cast<u64>(rate * scale_factor);
     u64 fposition = state.fposition;
     std::size_t inputi = 0;
 
     while (outputi < output.size()) {
+        if constexpr (!std::is_same_v<BlockFunction, std::nullptr_t>) {
+            const u64 last_fposition = fposition + (block_size - 1) * step_size;
+            const auto last_inputi = static_cast<std::size_t>(last_fposition / scale_factor);
+            if (outputi + block_size <= output.size() && last_inputi + 3 < samples.size()) {
+                block_fn(samples.data(), fposition, step_size, &output[outputi]);
+                outputi += block_size;
+                fposition += block_size * step_size;
+                inputi = last_inputi;
+                continue;
+            }
+        }
+
         inputi = static_cast<std::size_t>(fposition / scale_factor);
 
-        if (inputi + 2 >= input.size()) {
-            inputi = input.size() - 2;
+        if (inputi + 3 >= samples.size()) {
+            inputi = samples.size() - 3;
             break;
         }
 
         u64 fraction = fposition & scale_mask;
-        output[outputi++] = fn(fraction, input[inputi], input[inputi + 1], input[inputi + 2]);
+        output[outputi++] = fn(fraction, &samples[inputi]);
 
         fposition += step_size;
     }
 
-    state.xn2 = input[inputi];
-    state.xn1 = input[inputi + 1];
+    state.xn3 = samples[inputi];
+    state.xn2 = samples[inputi + 1];
+    state.xn1 = samples[inputi + 2];
     state.fposition = fposition - inputi * scale_factor;
 
-    input.erase(input.begin(), std::next(input.begin(), inputi + 2));
+    // The three samples before the input are the history, so input[inputi] is the new x[n-3].
+    input.Consume(inputi);
+}
+
+static Sample LinearSample(u64 fraction, const Sample* x) {
+    // Note on accuracy: Some values that this produces are +/- 1 from the actual firmware.
+    const Sample& x0 = x[1];
+    const Sample& x1 = x[2];
+
+    // This is a saturated subtraction. (Verified by black-box fuzzing.)
+    s64 delta0 = std::clamp<s64>(x1[0] - x0[0], -32768, 32767);
+    s64 delta1 = std::clamp<s64>(x1[1] - x0[1], -32768, 32767);
+
+    return Sample{
+        static_cast<s16>(x0[0] + fraction * delta0 / scale_factor),
+        static_cast<s16>(x0[1] + fraction * delta1 / scale_factor),
+    };
+}
+
+/// The filter coefficients of each phase, each one repeated for the two channels.
+using PolyphaseTable = std::array<std::array<float, 8>, num_phases + 1>;
+
+static const PolyphaseTable& GetPolyphaseTable() {
+    static const PolyphaseTable table = [] {
+        // Lanczos kernel with a = 2, whose support covers the four taps.
+        const auto lanczos = [](double t) {
+            if (t == std::round(t)) {
+                return t == 0.0 ? 1.0 : 0.0;
+            }
+            const double pi_t = std::numbers::pi * t;
+            return 2.0 * std::sin(pi_t) * std::sin(pi_t / 2.0) / (pi_t * pi_t);
+        };
+
+        PolyphaseTable result;
+        for (std::size_t phase = 0; phase <= num_phases; phase++) {
+            const double position = static_cast<double>(phase) / num_phases;
+            std::array<double, 4> taps;
+            for (std::size_t tap = 0; tap < 4; tap++) {
+                taps[tap] = lanczos(position + 1.0 - static_cast<double>(tap));
+            }
+            // Normalize to unity gain at DC.
+            const double sum = taps[0] + taps[1] + taps[2] + taps[3];
+            for (std::size_t tap = 0; tap < 4; tap++) {
+                result[phase][tap * 2] = static_cast<float>(taps[tap] / sum);
+                result[phase][tap * 2 + 1] = static_cast<float>(taps[tap] / sum);
+            }
+        }
+        return result;
+    }();
+    return table;
+}
+
+static const std::array<float, 8>& PolyphaseCoefficients(u64 fraction) {
+    return GetPolyphaseTable()[(fraction + (1 << (phase_shift - 1))) >> phase_shift];
+}
+
+static Sample PolyphaseSampleScalar(u64 fraction, const Sample* x) {
+    const auto& c = PolyphaseCoefficients(fraction);
+    Sample result;
+    for (std::size_t i = 0; i < 2; i++) {
+        // Summed in the same order as the vectorized implementations.
+        const float y = (x[0][i] * c[0] + x[2][i] * c[4]) + (x[1][i] * c[2] + x[3][i] * c[6]);
+        result[i] = static_cast<s16>(std::clamp<long>(std::lrint(y), -32768, 32767));
+    }
+    return result;
+}
+
+#if defined(INTERPOLATE_SSE2)
+
+/// Linear interpolation of block_size samples. Computes the same values as LinearSample.
+static void LinearBlock(const Sample* samples, u64 fposition, u64 step_size, Sample* output) {
+    alignas(16) std::array<Sample, block_size> x0, x1;
+    alignas(16) std::array<u16, block_size * 2> fraction_high, fraction_low;
+    for (std::size_t i = 0; i < block_size; i++, fposition += step_size) {
+        const Sample* x = samples + fposition / scale_factor;
+        x0[i] = x[1];
+        x1[i] = x[2];
+        const u64 fraction = fposition & scale_mask;
+        fraction_high[i * 2] = fraction_high[i * 2 + 1] = static_cast<u16>(fraction >> 8);
+        fraction_low[i * 2] = fraction_low[i * 2 + 1] = static_cast<u16>(fraction & 0xFF);
+    }
+
+    const __m128i start = _mm_load_si128(reinterpret_cast<const __m128i*>(x0.data()));
+    const __m128i end = _mm_load_si128(reinterpret_cast<const __m128i*>(x1.data()));
+    const __m128i high = _mm_load_si128(reinterpret_cast<const __m128i*>(fraction_high.data()));
+    const __m128i low = _mm_load_si128(reinterpret_cast<const __m128i*>(fraction_low.data()));
+    const __m128i delta = _mm_subs_epi16(end, start);
+
+    // fraction * delta is split in (fraction_high * delta << 8) + fraction_low * delta, whose
+    // 32-bit products are assembled from their 16-bit halves. _mm_mulhi_epi16 takes the unsigned
+    // fraction_high as signed, which is corrected by adding delta where its top bit is set.
+    const __m128i high_product_lo = _mm_mullo_epi16(delta, high);
+    const __m128i high_product_hi = _mm_add_epi16(_mm_mulhi_epi16(delta, high),
+                                                  _mm_and_si128(delta, _mm_srai_epi16(high, 15)));
+    const __m128i low_product_lo = _mm_mullo_epi16(delta, low);
+    const __m128i low_product_hi = _mm_mulhi_epi16(delta, low);
+
+    // x0 + (fraction * delta >> 24), with an arithmetic shift like the scalar implementation.
+    const auto interpolate = [](__m128i x0, __m128i high_product, __m128i low_product) {
+        const __m128i product = _mm_add_epi32(high_product, _mm_srai_epi32(low_product, 8));
+        return _mm_add_epi32(x0, _mm_srai_epi32(product, 16));
+    };
+    const __m128i result_lo =
+        interpolate(_mm_srai_epi32(_mm_unpacklo_epi16(start, start), 16),
+                    _mm_unpacklo_epi16(high_product_lo, high_product_hi),
+                    _mm_unpacklo_epi16(low_product_lo, low_product_hi));
+    const __m128i result_hi =
+        interpolate(_mm_srai_epi32(_mm_unpackhi_epi16(start, start), 16),
+                    _mm_unpackhi_epi16(high_product_lo, high_product_hi),
+                    _mm_unpackhi_epi16(low_product_lo, low_product_hi));
+
+    // The results are between x0 and x1, so the saturation of the packing never happens.
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output), _mm_packs_epi32(result_lo, result_hi));
 }
 
+static Sample PolyphaseSample(u64 fraction, const Sample* x) {
+    const float* c = PolyphaseCoefficients(fraction).data();
+    const __m128i taps = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x));
+    const __m128 taps_lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(taps, taps), 16));
+    const __m128 taps_hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(taps, taps), 16));
+    const __m128 products = _mm_add_ps(_mm_mul_ps(taps_lo, _mm_loadu_ps(c)),
+                                       _mm_mul_ps(taps_hi, _mm_loadu_ps(c + 4)));
+    const __m128 sum = _mm_add_ps(products, _mm_movehl_ps(products, products));
+    const __m128i rounded = _mm_cvtps_epi32(sum);
+
+    const u32 packed = static_cast<u32>(_mm_cvtsi128_si32(_mm_packs_epi32(rounded, rounded)));
+    Sample result;
+    std::memcpy(result.data(), &packed, sizeof(packed));
+    return result;
+}
+
+#elif defined(INTERPOLATE_NEON)
+
+/// Linear interpolation of block_size samples. Computes the same values as LinearSample.
+static void LinearBlock(const Sample* samples, u64 fposition, u64 step_size, Sample* output) {
+    std::array<Sample, block_size> x0, x1;
+    std::array<s32, block_size * 2> fraction_high, fraction_low;
+    for (std::size_t i = 0; i < block_size; i++, fposition += step_size) {
+        const Sample* x = samples + fposition / scale_factor;
+        x0[i] = x[1];
+        x1[i] = x[2];
+        const u64 fraction = fposition & scale_mask;
+        fraction_high[i * 2] = fraction_high[i * 2 + 1] = static_cast<s32>(fraction >> 8);
+        fraction_low[i * 2] = fraction_low[i * 2 + 1] = static_cast<s32>(fraction & 0xFF);
+    }
+
+    const int16x8_t start = vld1q_s16(&x0[0][0]);
+    const int16x8_t delta = vqsubq_s16(vld1q_s16(&x1[0][0]), start);
+
+    // x0 + (fraction * delta >> 24), computed as in the SSE2 implementation.
+    const auto interpolate = [](int16x4_t x0, int16x4_t delta, const s32* high, const s32* low) {
+        const int32x4_t wide_delta = vmovl_s16(delta);
+        const int32x4_t high_product = vmulq_s32(wide_delta, vld1q_s32(high));
+        const int32x4_t low_product = vmulq_s32(wide_delta, vld1q_s32(low));
+        const int32x4_t product = vaddq_s32(high_product, vshrq_n_s32(low_product, 8));
+        return vaddq_s32(vmovl_s16(x0), vshrq_n_s32(product, 16));
+    };
+    const int32x4_t result_lo = interpolate(vget_low_s16(start), vget_low_s16(delta),
+                                            fraction_high.data(), fraction_low.data());
+    const int32x4_t result_hi = interpolate(vget_high_s16(start), vget_high_s16(delta),
+                                            fraction_high.data() + 4, fraction_low.data() + 4);
+
+    vst1q_s16(&output[0][0], vcombine_s16(vqmovn_s32(result_lo), vqmovn_s32(result_hi)));
+}
+
+static Sample PolyphaseSample(u64 fraction, const Sample* x) {
+    const float* c = PolyphaseCoefficients(fraction).data();
+    const int16x8_t taps = vld1q_s16(&x[0][0]);
+    const float32x4_t taps_lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(taps)));
+    const float32x4_t taps_hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(taps)));
+    const float32x4_t products =
+        vaddq_f32(vmulq_f32(taps_lo, vld1q_f32(c)), vmulq_f32(taps_hi, vld1q_f32(c + 4)));
+    const float32x2_t sum = vadd_f32(vget_low_f32(products), vget_high_f32(products));
+    const int32x2_t rounded = vcvtn_s32_f32(sum);
+    const int16x4_t packed = vqmovn_s32(vcombine_s32(rounded, rounded));
+    return Sample{vget_lane_s16(packed, 0), vget_lane_s16(packed, 1)};
+}
+
+#else
+
+static constexpr std::nullptr_t LinearBlock = nullptr;
+
+static Sample PolyphaseSample(u64 fraction, const Sample* x) {
+    return PolyphaseSampleScalar(fraction, x);
+}
+
+#endif
+
 void None(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
           std::size_t& outputi) {
     StepOverSamples(
         state, input, rate, output, outputi,
-        [](u64 fraction, const auto& x0, const auto& x1, const auto& x2) { return x0; });
+        [](u64 fraction, const Sample* x) { return x[1]; }, nullptr);
 }
 
 void Linear(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
             std::size_t& outputi) {
-    // Note on accuracy: Some values that this produces are +/- 1 from the actual firmware.
-    StepOverSamples(state, input, rate, output, outputi,
-                    [](u64 fraction, const auto& x0, const auto& x1, const auto& x2) {
-                        // This is a saturated subtraction. (Verified by black-box fuzzing.)
-                        s64 delta0 = std::clamp<s64>(x1[0] - x0[0], -32768, 32767);
-                        s64 delta1 = std::clamp<s64>(x1[1] - x0[1], -32768, 32767);
-
-                        return std::array<s16, 2>{
-                            static_cast<s16>(x0[0] + fraction * delta0 / scale_factor),
-                            static_cast<s16>(x0[1] + fraction * delta1 / scale_factor),
-                        };
-                    });
+    StepOverSamples(state, input, rate, output, outputi, LinearSample, LinearBlock);
+}
+
+void Polyphase(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
+               std::size_t& outputi) {
+    StepOverSamples(state, input, rate, output, outputi, PolyphaseSample, nullptr);
+}
+
+namespace Scalar {
+
+void Linear(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
+            std::size_t& outputi) {
+    StepOverSamples(state, input, rate, output, outputi, LinearSample, nullptr);
 }
 
+void Polyphase(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
+               std::size_t& outputi) {
+    StepOverSamples(state, input, rate, output, outputi, PolyphaseSampleScalar, nullptr);
+}
+
+} // namespace Scalar
+
 } // namespace AudioCore::AudioInterp
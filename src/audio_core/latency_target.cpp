@@ -0,0 +1,52 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include "audio_core/latency_target.h"
+
+namespace AudioCore {
+
+std::size_t LatencyTarget::GetExcessFrames(std::size_t queued_frames,
+                                           std::size_t num_frames) const {
+    // A frame of slack avoids skipping a few frames on every callback because of the jitter of the
+    // emulation. The frames are only skipped when the emulation runs ahead of the audio output.
+    const std::size_t limit = GetTarget() + num_frames;
+    if (queued_frames > limit + Step) {
+        return queued_frames - limit;
+    }
+    return 0;
+}
+
+bool LatencyTarget::Update(std::size_t frames_written, std::size_t num_frames, bool adaptive) {
+    const std::size_t current = GetTarget();
+    if (frames_written < num_frames) {
+        // Only count the callback where the output ran dry, not every callback while the emulation
+        // is paused.
+        const bool underrun = !starved;
+        if (underrun && adaptive) {
+            target.store(std::min(current + Step, MaxTarget), std::memory_order_relaxed);
+        }
+        starved = true;
+        frames_since_underrun = 0;
+        return underrun;
+    }
+
+    starved = false;
+    if (!adaptive) {
+        return false;
+    }
+    frames_since_underrun += num_frames;
+    if (frames_since_underrun >= DecreasePeriod && current > MinTarget) {
+        target.store(current - Step, std::memory_order_relaxed);
+        frames_since_underrun = 0;
+    }
+    return false;
+}
+
+void LatencyTarget::Reset() {
+    starved = false;
+    frames_since_underrun = 0;
+}
+
+} // namespace AudioCore
@@ -0,0 +1,55 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include "audio_core/audio_types.h"
+
+namespace AudioCore {
+
+/**
+ * Tracks the underruns of the audio output and the latency it targets in the adaptive latency
+ * mode. Each underrun raises the target by one DSP frame, and the target comes back down after
+ * five seconds without underruns. Only GetTarget may be called from other threads than the sink
+ * thread.
+ */
+class LatencyTarget {
+public:
+    /// Step of the target, one DSP frame
+    static constexpr std::size_t Step = samples_per_frame;
+    static constexpr std::size_t MinTarget = 2 * samples_per_frame;
+    static constexpr std::size_t MaxTarget = 0x1000;
+    /// Number of frames output without underrun before the target is lowered, 5 seconds
+    static constexpr std::size_t DecreasePeriod = native_sample_rate * 5;
+
+    /// Returns the number of queued frames the output aims for.
+    std::size_t GetTarget() const {
+        return target.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Returns how many of the queued frames to skip before a callback that outputs num_frames, to
+     * bring the latency back to the target.
+     */
+    std::size_t GetExcessFrames(std::size_t queued_frames, std::size_t num_frames) const;
+
+    /**
+     * Records a callback that wrote frames_written of the num_frames requested.
+     * @param adaptive Whether the target adapts to the underruns
+     * @returns true if the output ran dry in this callback, after having frames in the previous one
+     */
+    bool Update(std::size_t frames_written, std::size_t num_frames, bool adaptive);
+
+    /// Forgets the state of the previous callbacks, when the sink changes.
+    void Reset();
+
+private:
+    std::atomic<std::size_t> target{MinTarget};
+    bool starved = false;
+    std::size_t frames_since_underrun = 0;
+};
+
+} // namespace AudioCore
@@ -2,8 +2,11 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <thread>
 #include <teakra/teakra.h>
 #include "audio_core/lle/lle.h"
@@ -121,7 +124,7 @@ static u8 PipeIndexToSlotIndex(u8 pipe_index, PipeDirection direction) {
 }
 
 struct DspLle::Impl final {
-    Impl(Core::Timing& timing, bool multithread) : core_timing(timing), multithread(multithread) {
+    Impl(Core::Timing& timing, LleThreading threading) : core_timing(timing), threading(threading) {
         teakra_slice_event = core_timing.RegisterEvent(
             "DSP slice", [this](u64, int late) { TeakraSliceEvent(static_cast<u64>(late)); });
     }
@@ -140,15 +143,34 @@ struct DspLle::Impl final {
     Core::TimingEventType* teakra_slice_event;
     std::atomic<bool> loaded = false;
 
-    const bool multithread;
+    const LleThreading threading;
     std::thread teakra_thread;
     Common::Barrier teakra_slice_barrier{2};
     std::atomic<bool> stop_signal = false;
     std::size_t stop_generation;
 
+    // Run-ahead state, guarded by run_ahead_mutex
+    std::mutex run_ahead_mutex;
+    std::condition_variable budget_raised;
+    std::condition_variable cycles_run;
+    /// DSP cycles the emulated time has given to the DSP
+    u64 granted_cycles = 0;
+    /// DSP cycles run by the DSP thread
+    u64 executed_cycles = 0;
+    /// Length of the slices run by the DSP thread, adapted to the pipe traffic
+    u32 slice_cycles = TeakraSlice;
+    /// Number of times the emulator thread waited for the DSP since the last slice event
+    u32 waits_since_slice_event = 0;
+    bool stop_run_ahead = false;
+
     static constexpr u32 DspDataOffset = 0x40000;
     static constexpr u32 TeakraSlice = 16384;
 
+    /// How far the DSP may run ahead of, or fall behind, the emulated time
+    static constexpr u64 MaxRunAheadCycles = TeakraSlice * 4;
+    static constexpr u32 MinSliceCycles = TeakraSlice / 8;
+    static constexpr u32 MaxSliceCycles = TeakraSlice * 2;
+
     void TeakraThread() {
         while (true) {
             teakra.Run(TeakraSlice);
@@ -161,25 +183,110 @@ struct DspLle::Impl final {
         stop_signal = false;
     }
 
+    /// Runs the DSP as long as it is less than MaxRunAheadCycles ahead of the emulated time.
+    void RunAheadThread() {
+        std::unique_lock lock{run_ahead_mutex};
+        while (true) {
+            budget_raised.wait(lock, [this] {
+                return stop_run_ahead || executed_cycles < granted_cycles + MaxRunAheadCycles;
+            });
+            if (stop_run_ahead) {
+                break;
+            }
+            const u32 cycles = static_cast<u32>(std::min<u64>(
+                slice_cycles, granted_cycles + MaxRunAheadCycles - executed_cycles));
+            lock.unlock();
+            teakra.Run(cycles);
+            lock.lock();
+            executed_cycles += cycles;
+            cycles_run.notify_all();
+        }
+        stop_run_ahead = false;
+    }
+
+    void StartTeakraThread() {
+        if (threading == LleThreading::Lockstep) {
+            teakra_thread = std::thread(&Impl::TeakraThread, this);
+        } else if (threading == LleThreading::RunAhead) {
+            granted_cycles = executed_cycles = 0;
+            slice_cycles = TeakraSlice;
+            waits_since_slice_event = 0;
+            teakra_thread = std::thread(&Impl::RunAheadThread, this);
+        }
+    }
+
     void StopTeakraThread() {
-        if (teakra_thread.joinable()) {
+        if (!teakra_thread.joinable()) {
+            return;
+        }
+        if (threading == LleThreading::RunAhead) {
+            {
+                std::scoped_lock lock{run_ahead_mutex};
+                stop_run_ahead = true;
+            }
+            budget_raised.notify_one();
+        } else {
             stop_generation = teakra_slice_barrier.Generation() + 1;
             stop_signal = true;
             teakra_slice_barrier.Sync();
-            teakra_thread.join();
         }
+        teakra_thread.join();
     }
 
+    /// Lets the DSP run further, when an access needs a value it has not produced yet.
     void RunTeakraSlice() {
-        if (multithread) {
+        switch (threading) {
+        case LleThreading::None:
+            teakra.Run(TeakraSlice);
+            break;
+        case LleThreading::Lockstep:
             teakra_slice_barrier.Sync();
+            break;
+        case LleThreading::RunAhead:
+            WaitForDspProgress();
+            break;
+        }
+    }
+
+    void WaitForDspProgress() {
+        std::unique_lock lock{run_ahead_mutex};
+        ++waits_since_slice_event;
+        const u64 start = executed_cycles;
+        if (start >= granted_cycles + MaxRunAheadCycles) {
+            // The DSP is as far ahead as the emulated time allows, but the value is needed now.
+            granted_cycles = start + slice_cycles - MaxRunAheadCycles;
+            budget_raised.notify_one();
+        }
+        cycles_run.wait(lock, [this, start] { return executed_cycles != start; });
+    }
+
+    /// Gives the DSP the cycles of a slice of emulated time, only waiting for it when it falls
+    /// behind by more than MaxRunAheadCycles.
+    void GrantTeakraSlice() {
+        std::unique_lock lock{run_ahead_mutex};
+        granted_cycles += TeakraSlice;
+
+        // Accesses waiting for the DSP get their values sooner with short slices, otherwise long
+        // slices lower the synchronization overhead.
+        if (waits_since_slice_event > 0) {
+            slice_cycles = std::max(slice_cycles / 2, MinSliceCycles);
         } else {
-            teakra.Run(TeakraSlice);
+            slice_cycles = std::min(slice_cycles * 2, MaxSliceCycles);
         }
+        waits_since_slice_event = 0;
+
+        budget_raised.notify_one();
+        cycles_run.wait(lock, [this] {
+            return executed_cycles + MaxRunAheadCycles >= granted_cycles || stop_run_ahead;
+        });
     }
 
     void TeakraSliceEvent(u64 late) {
-        RunTeakraSlice();
+        if (threading == LleThreading::RunAhead) {
+            GrantTeakraSlice();
+        } else {
+            RunTeakraSlice();
+        }
         u64 next = TeakraSlice * 2; // DSP runs at clock rate half of the CPU rate
         if (next < late)
             next = 0;
@@ -328,9 +435,7 @@ struct DspLle::Impl final {
 
         core_timing.ScheduleEvent(TeakraSlice, teakra_slice_event, 0);
 
-        if (multithread) {
-            teakra_thread = std::thread(&Impl::TeakraThread, this);
-        }
+        StartTeakraThread();
 
         // Wait for initialization
         if (dsp.recv_data_on_start) {
@@ -464,12 +569,12 @@ void DspLle::UnloadComponent() {
     impl->UnloadComponent();
 }
 
-DspLle::DspLle(Core::System& system, bool multithread)
-    : DspLle(system, system.Memory(), system.CoreTiming(), multithread) {}
+DspLle::DspLle(Core::System& system, LleThreading threading)
+    : DspLle(system, system.Memory(), system.CoreTiming(), threading) {}
 
 DspLle::DspLle(Core::System& system, Memory::MemorySystem& memory, Core::Timing& timing,
-               bool multithread)
-    : DspInterface(system), impl(std::make_unique<Impl>(timing, multithread)) {
+               LleThreading threading)
+    : DspInterface(system), impl(std::make_unique<Impl>(timing, threading)) {
     Teakra::AHBMCallback ahbm;
     ahbm.read8 = [&memory](u32 address) -> u8 {
         return *memory.GetFCRAMPointer(address - Memory::FCRAM_PADDR);
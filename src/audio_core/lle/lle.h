@@ -17,11 +17,21 @@ class MemorySystem;
 
 namespace AudioCore {
 
+/// How the DSP is run relative to the emulated CPU.
+enum class LleThreading {
+    /// On the emulator thread, a slice at a time
+    None,
+    /// On its own thread, in lockstep with the emulator thread
+    Lockstep,
+    /// On its own thread, up to a few slices ahead of the emulated time
+    RunAhead,
+};
+
 class DspLle final : public DspInterface {
 public:
-    explicit DspLle(Core::System& system, bool multithread);
+    explicit DspLle(Core::System& system, LleThreading threading);
     explicit DspLle(Core::System& system, Memory::MemorySystem& memory, Core::Timing& timing,
-                    bool multithread);
+                    LleThreading threading);
     ~DspLle() override;
 
     u16 RecvData(u32 register_number) override;
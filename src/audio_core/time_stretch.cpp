@@ -18,7 +18,21 @@
 
 namespace AudioCore {
 
-TimeStretcher::TimeStretcher() : sound_touch(std::make_unique<soundtouch::SoundTouch>()) {
+/// Number of frames the conversion buffers are allocated for, more than any sink callback asks
+constexpr std::size_t initial_scratch_frames = 0x2000;
+
+struct TimeStretcher::Scratch {
+    std::vector<soundtouch::SAMPLETYPE> in;
+    std::vector<soundtouch::SAMPLETYPE> out;
+};
+
+TimeStretcher::TimeStretcher()
+    : sound_touch(std::make_unique<soundtouch::SoundTouch>()),
+      scratch(std::make_unique<Scratch>()) {
+    if constexpr (std::is_floating_point<soundtouch::SAMPLETYPE>()) {
+        scratch->in.resize(2 * initial_scratch_frames);
+        scratch->out.resize(2 * initial_scratch_frames);
+    }
     sound_touch->setChannels(2);
     sound_touch->setSampleRate(native_sample_rate);
     sound_touch->setPitch(1.0);
@@ -66,10 +80,16 @@ std::size_t TimeStretcher::Process(const s16* in, std::size_t num_in, s16* out,
               backlog_fullness);
 
     if constexpr (std::is_floating_point<soundtouch::SAMPLETYPE>()) {
-        // The SoundTouch library on most systems expects float samples
-        // use this vector to store input if soundtouch::SAMPLETYPE is a float
-        std::vector<soundtouch::SAMPLETYPE> float_in(2 * num_in);
-        std::vector<soundtouch::SAMPLETYPE> float_out(2 * num_out);
+        // The SoundTouch library on most systems expects float samples,
+        // which are converted in buffers kept from one call to the next.
+        auto& float_in = scratch->in;
+        auto& float_out = scratch->out;
+        if (float_in.size() < 2 * num_in) {
+            float_in.resize(2 * num_in);
+        }
+        if (float_out.size() < 2 * num_out) {
+            float_out.resize(2 * num_out);
+        }
 
         for (std::size_t i = 0; i < (2 * num_in); i++) {
             // Conventional integer PCM uses a range of -32768 to 32767,
@@ -85,7 +105,7 @@ std::size_t TimeStretcher::Process(const s16* in, std::size_t num_in, s16* out,
             sound_touch->receiveSamples(float_out.data(), static_cast<u32>(num_out));
 
         // Converting output samples back to shorts so we can use them
-        for (std::size_t i = 0; i < (2 * num_out); i++) {
+        for (std::size_t i = 0; i < (2 * samples_received); i++) {
             const s16 temp = static_cast<s16>(float_out[i] * std::numeric_limits<s16>::max());
             out[i] = temp;
         }
@@ -15,6 +15,8 @@ class SoundTouch;
 
 namespace AudioCore {
 
+/// Stretches audio to match the emulation speed. Processing does not allocate once the buffers
+/// have grown to the largest callback size.
 class TimeStretcher {
 public:
     TimeStretcher();
@@ -34,7 +36,11 @@ public:
     void Flush();
 
 private:
+    /// Conversion buffers for SoundTouch builds using float samples
+    struct Scratch;
+
     std::unique_ptr<soundtouch::SoundTouch> sound_touch;
+    std::unique_ptr<Scratch> scratch;
     double stretch_ratio = 1.0;
 };
 
@@ -22,6 +22,11 @@ constexpr char help_string[] =
 #ifdef ENABLE_SDL2_FRONTEND
     "-n, --no-gui                Use the lightweight SDL frontend instead of the usual Qt "
     "frontend\n"
+    "-b, --benchmark [frames]    Run the given number of frames headless with the software "
+    "renderer and no frame limit, then print a JSON report (implies --no-gui, use alongside "
+    "--movie-play for deterministic input)\n"
+    "-o, --benchmark-report [path]   Write the benchmark report to the given file path instead "
+    "of stdout\n"
     // TODO: Move -m outside of this check when it is implemented in Qt frontend
     "-m, --multiplayer [nick:password@address:port]   Nickname, password, address and port for "
     "multiplayer (currently only usable with SDL frontend)\n"
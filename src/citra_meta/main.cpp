@@ -95,6 +95,10 @@ int main(int argc, char* argv[]) {
         if (strcmp(argv[i], "--no-gui") == 0 || strcmp(argv[i], "-n") == 0) {
             no_gui = true;
         }
+        // Benchmarks run headless, which only the SDL frontend supports
+        if (strcmp(argv[i], "--benchmark") == 0 || strcmp(argv[i], "-b") == 0) {
+            no_gui = true;
+        }
     }
 
     if (!no_gui) {
@@ -62,6 +62,7 @@ static GMainWindow* GetMainWindow() {
 
 void EmuThread::run() {
     MicroProfileOnThreadCreate("EmuThread");
+    Common::Tracing::SetThreadName("EmuThread");
     const auto scope = core_context.Acquire();
 
     if (Settings::values.preload_textures) {
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <clocale>
+#include <cmath>
 #include <iostream>
 #include <memory>
 #include <optional>
@@ -3428,14 +3429,28 @@ void GMainWindow::UpdateStatusBar() {
     }
     game_fps_label->setText(tr("App: %1 FPS").arg(results.game_fps, 0, 'f', 0));
     if (UISettings::values.show_advanced_frametime_info) {
-        emu_frametime_label->setText(
-            tr("Frame: %1 ms (GPU: [CMD: %2 ms, SWP: %3 ms], IPC: %4 ms, SVC: %5 ms, Rem: %6 ms)")
+        QString frametime_info =
+            tr("Frame: %1 ms (GPU: [CMD: %2 ms, SWP: %3 ms], IPC: %4 ms, SVC: %5 ms, Rem: %6 ms, "
+               "Input: %7 ms, P99: %8 ms, Jitter: %9 ms)")
                 .arg(results.time_vblank_interval * 1000.0, 2, 'f', 2)
                 .arg(results.time_gpu * 1000.0, 2, 'f', 2)
                 .arg(results.time_swap * 1000.0, 2, 'f', 2)
                 .arg(results.time_hle_ipc * 1000.0, 2, 'f', 2)
                 .arg(results.time_hle_svc * 1000.0, 2, 'f', 2)
-                .arg(results.time_remaining * 1000.0, 2, 'f', 2));
+                .arg(results.time_remaining * 1000.0, 2, 'f', 2)
+                .arg(results.input_latency * 1000.0, 2, 'f', 2)
+                .arg(results.frametime_p99 * 1000.0, 2, 'f', 2)
+                .arg(std::sqrt(results.frametime_variance) * 1000.0, 2, 'f', 2);
+        if (results.uds_frames > 0) {
+            frametime_info += tr(" UDS: %1 frames/s, Delay: %2 ms")
+                                  .arg(results.uds_frames, 0, 'f', 0)
+                                  .arg(results.uds_queue_delay * 1000.0, 2, 'f', 2);
+        }
+        frametime_info += tr(" Audio: %1 ms, Underruns: %2/s, Dropped: %3 frames/s")
+                              .arg(results.audio_latency * 1000.0, 2, 'f', 2)
+                              .arg(results.audio_underruns, 0, 'f', 1)
+                              .arg(results.audio_dropped_frames, 0, 'f', 0);
+        emu_frametime_label->setText(frametime_info);
     } else {
         emu_frametime_label->setText(
             tr("Frame: %1 ms").arg(results.time_vblank_interval * 1000.0, 2, 'f', 2));
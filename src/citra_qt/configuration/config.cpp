@@ -285,6 +285,7 @@ void QtConfig::ReadAudioValues() {
     ReadGlobalSetting(Settings::values.volume);
 
     if (global) {
+        ReadBasicSetting(Settings::values.enable_adaptive_audio_latency);
         ReadBasicSetting(Settings::values.output_type);
         ReadBasicSetting(Settings::values.output_device);
         ReadBasicSetting(Settings::values.input_type);
@@ -702,6 +703,8 @@ void QtConfig::ReadRendererValues() {
 
     if (global) {
         ReadBasicSetting(Settings::values.use_shader_jit);
+        ReadBasicSetting(Settings::values.frame_pacing);
+        ReadBasicSetting(Settings::values.spirv_vertex_shader_gen);
     }
 
     qt_config->endGroup();
@@ -778,6 +781,8 @@ void QtConfig::ReadVideoDumpingValues() {
 
     Settings::values.video_bitrate =
         ReadSetting(QStringLiteral("video_bitrate"), 2500000).toULongLong();
+    Settings::values.drop_video_frames =
+        ReadSetting(QStringLiteral("drop_video_frames"), false).toBool();
 
     Settings::values.audio_encoder =
         ReadSetting(QStringLiteral("audio_encoder"), QStringLiteral("libvorbis"))
@@ -917,6 +922,7 @@ void QtConfig::SaveAudioValues() {
     WriteGlobalSetting(Settings::values.volume);
 
     if (global) {
+        WriteBasicSetting(Settings::values.enable_adaptive_audio_latency);
         WriteBasicSetting(Settings::values.output_type);
         WriteBasicSetting(Settings::values.output_device);
         WriteBasicSetting(Settings::values.input_type);
@@ -1234,6 +1240,8 @@ void QtConfig::SaveRendererValues() {
     if (global) {
         WriteSetting(QStringLiteral("use_shader_jit"), Settings::values.use_shader_jit.GetValue(),
                      true);
+        WriteBasicSetting(Settings::values.frame_pacing);
+        WriteBasicSetting(Settings::values.spirv_vertex_shader_gen);
     }
 
     qt_config->endGroup();
@@ -1296,6 +1304,7 @@ void QtConfig::SaveVideoDumpingValues() {
                  DEFAULT_VIDEO_ENCODER_OPTIONS);
     WriteSetting(QStringLiteral("video_bitrate"),
                  static_cast<unsigned long long>(Settings::values.video_bitrate), 2500000);
+    WriteSetting(QStringLiteral("drop_video_frames"), Settings::values.drop_video_frames, false);
     WriteSetting(QStringLiteral("audio_encoder"),
                  QString::fromStdString(Settings::values.audio_encoder),
                  QStringLiteral("libvorbis"));
@@ -150,6 +150,8 @@ void ConfigureGraphics::SetConfiguration() {
 
     if (Settings::IsConfiguringGlobal()) {
         ui->toggle_shader_jit->setChecked(Settings::values.use_shader_jit.GetValue());
+        ui->frame_pacing_combobox->setCurrentIndex(
+            static_cast<int>(Settings::values.frame_pacing.GetValue()));
     }
 }
 
@@ -182,6 +184,8 @@ void ConfigureGraphics::ApplyConfiguration() {
 
     if (Settings::IsConfiguringGlobal()) {
         Settings::values.use_shader_jit = ui->toggle_shader_jit->isChecked();
+        Settings::values.frame_pacing =
+            static_cast<Settings::FramePacing>(ui->frame_pacing_combobox->currentIndex());
     }
 }
 
@@ -216,6 +220,7 @@ void ConfigureGraphics::SetupPerGameUI() {
     });
 
     ui->toggle_shader_jit->setVisible(false);
+    ui->widget_frame_pacing->setVisible(false);
 
     ConfigurationShared::SetColoredComboBox(
         ui->graphics_api_combo, ui->graphics_api_group,
@@ -202,6 +202,7 @@ void DumpingDialog::SetConfiguration() {
         QString::fromStdString(Settings::values.audio_encoder_options));
     last_path = UISettings::values.video_dumping_path;
     ui->videoBitrateSpinBox->setValue(static_cast<int>(Settings::values.video_bitrate));
+    ui->dropVideoFramesCheckBox->setChecked(Settings::values.drop_video_frames);
     ui->audioBitrateSpinBox->setValue(static_cast<int>(Settings::values.audio_bitrate));
 }
 
@@ -212,6 +213,7 @@ void DumpingDialog::ApplyConfiguration() {
         video_encoders.at(ui->videoEncoderComboBox->currentData().toUInt()).name;
     Settings::values.video_encoder_options = ui->videoEncoderOptionsLineEdit->text().toStdString();
     Settings::values.video_bitrate = ui->videoBitrateSpinBox->value();
+    Settings::values.drop_video_frames = ui->dropVideoFramesCheckBox->isChecked();
     Settings::values.audio_encoder =
         audio_encoders.at(ui->audioEncoderComboBox->currentData().toUInt()).name;
     Settings::values.audio_encoder_options = ui->audioEncoderOptionsLineEdit->text().toStdString();
@@ -0,0 +1,233 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <vector>
+#include <fmt/format.h>
+#include <json.hpp>
+#include "audio_core/sink_details.h"
+#include "citra_sdl/benchmark.h"
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/scm_rev.h"
+#include "common/settings.h"
+#include "core/core.h"
+#include "core/frontend/emu_window.h"
+#include "core/loader/loader.h"
+#include "core/movie.h"
+#include "input_common/main.h"
+#include "network/network.h"
+#include "video_core/gpu.h"
+#include "video_core/renderer_base.h"
+
+#ifdef _WIN32
+#include <windows.h>
+
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+/// Frames run before the measurement starts, to leave the boot overhead out of the results
+constexpr u32 WarmupFrames = 5;
+
+using Clock = std::chrono::steady_clock;
+
+/// Window that never presents anything, the renderer runs without a surface
+class EmuWindow_Headless : public Frontend::EmuWindow {
+public:
+    void PollEvents() override {}
+};
+
+u64 GetPeakResidentSetSize() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return counters.PeakWorkingSetSize;
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<u64>(usage.ru_maxrss);
+#else
+    return static_cast<u64>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+/// Returns the value below which the given fraction of the sorted samples fall
+double Percentile(const std::vector<double>& sorted, double fraction) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    const auto rank = static_cast<std::size_t>(std::ceil(fraction * sorted.size()));
+    return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+}
+
+nlohmann::json MakeReport(Core::System& system, const BenchmarkOptions& options,
+                          std::vector<double> frame_times_ms, double wall_time,
+                          const Core::PerfStats::Results& stats) {
+    std::sort(frame_times_ms.begin(), frame_times_ms.end());
+    const double mean_ms =
+        frame_times_ms.empty()
+            ? 0.0
+            : std::accumulate(frame_times_ms.begin(), frame_times_ms.end(), 0.0) /
+                  static_cast<double>(frame_times_ms.size());
+    const auto fps = [](double frame_time_ms) {
+        return frame_time_ms > 0.0 ? 1000.0 / frame_time_ms : 0.0;
+    };
+
+    u64 program_id{};
+    system.GetAppLoader().ReadProgramId(program_id);
+
+    nlohmann::json report;
+    report["version"] = std::string(Common::g_build_fullname);
+    report["title_id"] = fmt::format("{:016X}", program_id);
+    report["movie"] = options.movie_path;
+    report["frames"] = frame_times_ms.size();
+    report["wall_time_s"] = wall_time;
+    report["emulation_speed"] = stats.emulation_speed;
+    // Low percentiles of the frame rate come from the high percentiles of the frame time
+    report["fps"] = {
+        {"mean", fps(mean_ms)},
+        {"p1", fps(Percentile(frame_times_ms, 0.99))},
+        {"p5", fps(Percentile(frame_times_ms, 0.95))},
+        {"p50", fps(Percentile(frame_times_ms, 0.50))},
+        {"p95", fps(Percentile(frame_times_ms, 0.05))},
+        {"min", fps(frame_times_ms.empty() ? 0.0 : frame_times_ms.back())},
+    };
+    report["frame_time_ms"] = {
+        {"mean", mean_ms},
+        {"p50", Percentile(frame_times_ms, 0.50)},
+        {"p90", Percentile(frame_times_ms, 0.90)},
+        {"p99", Percentile(frame_times_ms, 0.99)},
+        {"max", frame_times_ms.empty() ? 0.0 : frame_times_ms.back()},
+    };
+    report["time_per_frame_ms"] = {
+        {"hle_svc", stats.time_hle_svc * 1000.0}, {"hle_ipc", stats.time_hle_ipc * 1000.0},
+        {"gpu", stats.time_gpu * 1000.0},         {"swap", stats.time_swap * 1000.0},
+        {"remaining", stats.time_remaining * 1000.0},
+    };
+    report["peak_rss_bytes"] = GetPeakResidentSetSize();
+    return report;
+}
+
+} // Anonymous namespace
+
+void ApplyBenchmarkSettings() {
+#ifdef ENABLE_SOFTWARE_RENDERER
+    Settings::values.graphics_api = Settings::GraphicsAPI::Software;
+#endif
+    Settings::values.frame_limit = 0;
+    Settings::values.output_type = AudioCore::SinkType::Null;
+    Settings::values.record_frame_times = false;
+}
+
+int RunBenchmark(Core::System& system, const std::string& filepath,
+                 const BenchmarkOptions& options) {
+#ifndef ENABLE_SOFTWARE_RENDERER
+    LOG_CRITICAL(Frontend, "Benchmark mode requires the software renderer");
+    return -1;
+#else
+    InputCommon::Init();
+    Network::Init();
+
+    EmuWindow_Headless emu_window;
+    const Core::System::ResultStatus load_result = system.Load(emu_window, filepath);
+    if (load_result != Core::System::ResultStatus::Success) {
+        LOG_CRITICAL(Frontend, "Failed to load {}: {}", filepath, system.GetStatusDetails());
+        return -1;
+    }
+
+    auto& movie = system.Movie();
+    std::atomic_bool movie_finished{false};
+    if (!options.movie_path.empty()) {
+        movie.SetPlaybackCompletionCallback([&movie_finished] { movie_finished = true; });
+        movie.StartPlayback(options.movie_path);
+    }
+
+    const auto& renderer = system.GPU().Renderer();
+    const s32 end_frame = static_cast<s32>(WarmupFrames + options.frames);
+    s32 last_frame = renderer.GetCurrentFrame();
+    std::vector<double> frame_times_ms;
+    frame_times_ms.reserve(options.frames);
+
+    std::optional<Clock::time_point> start_time;
+    Clock::time_point last_frame_time{};
+    bool failed = false;
+    while (last_frame < end_frame && !movie_finished) {
+        const auto result = system.RunLoop();
+        if (result == Core::System::ResultStatus::ShutdownRequested) {
+            break;
+        }
+        if (result != Core::System::ResultStatus::Success) {
+            LOG_ERROR(Frontend, "Error in main run loop: {}", system.GetStatusDetails());
+            failed = true;
+            break;
+        }
+
+        const s32 frame = renderer.GetCurrentFrame();
+        if (frame == last_frame) {
+            continue;
+        }
+
+        const auto now = Clock::now();
+        if (last_frame >= static_cast<s32>(WarmupFrames)) {
+            // A single slice may span several frames, spread its duration evenly between them.
+            const s32 num_frames = frame - last_frame;
+            const double slice_ms =
+                std::chrono::duration<double, std::milli>(now - last_frame_time).count();
+            frame_times_ms.insert(frame_times_ms.end(), num_frames, slice_ms / num_frames);
+        } else if (frame >= static_cast<s32>(WarmupFrames)) {
+            start_time = now;
+            [[maybe_unused]] const auto warmup_stats = system.GetAndResetPerfStats();
+        }
+        last_frame_time = now;
+        last_frame = frame;
+    }
+
+    if (!start_time) {
+        // Without a completed warm-up there is no measurement to report.
+        LOG_ERROR(Frontend, "Emulation stopped before the {} warm-up frames completed",
+                  WarmupFrames);
+        failed = true;
+    } else {
+        const double wall_time =
+            std::chrono::duration<double>(Clock::now() - *start_time).count();
+        const auto stats = system.GetAndResetPerfStats();
+        if (movie_finished) {
+            LOG_INFO(Frontend, "Movie ended after {} measured frames", frame_times_ms.size());
+        }
+
+        const std::string report =
+            MakeReport(system, options, std::move(frame_times_ms), wall_time, stats).dump(4);
+        if (options.report_path.empty()) {
+            std::cout << report << std::endl;
+        } else if (FileUtil::WriteStringToFile(true, options.report_path, report) !=
+                   report.size()) {
+            LOG_ERROR(Frontend, "Failed to write the benchmark report to {}",
+                      options.report_path);
+            failed = true;
+        }
+    }
+
+    movie.Shutdown();
+    Network::Shutdown();
+    InputCommon::Shutdown();
+    system.Shutdown();
+    return failed ? -1 : 0;
+#endif
+}
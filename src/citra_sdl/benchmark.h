@@ -0,0 +1,33 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+#include "common/common_types.h"
+
+namespace Core {
+class System;
+}
+
+struct BenchmarkOptions {
+    /// Number of frames measured after the warm-up frames
+    u32 frames = 0;
+    /// Movie replayed to drive the title, optional
+    std::string movie_path;
+    /// File the JSON report is written to, stdout if empty
+    std::string report_path;
+};
+
+/// Overrides the settings that would make a benchmark run depend on the host, like the frame
+/// limiter, the audio device or the graphics API. Must be called before the title is loaded.
+void ApplyBenchmarkSettings();
+
+/**
+ * Boots a title without any window, runs it for a fixed number of frames as fast as possible
+ * and writes a JSON report with the frame timing statistics.
+ * @returns the process exit code
+ */
+int RunBenchmark(Core::System& system, const std::string& filepath,
+                 const BenchmarkOptions& options);
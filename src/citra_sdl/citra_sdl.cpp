@@ -11,6 +11,7 @@
 // This needs to be included before getopt.h because the latter #defines symbols used by it
 #include "common/microprofile.h"
 
+#include "citra_sdl/benchmark.h"
 #include "citra_sdl/config.h"
 #include "citra_sdl/emu_window/emu_window_sdl2.h"
 #ifdef ENABLE_OPENGL
@@ -184,6 +185,8 @@ void LaunchSdlFrontend(int argc, char** argv) {
     std::string movie_record_author;
     std::string movie_play;
     std::string dump_video;
+    u32 benchmark_frames = 0;
+    std::string benchmark_report;
 
     char* endarg;
 #ifdef _WIN32
@@ -205,6 +208,8 @@ void LaunchSdlFrontend(int argc, char** argv) {
     u16 port = Network::DefaultRoomPort;
 
     static struct option long_options[] = {
+        {"benchmark", required_argument, 0, 'b'},
+        {"benchmark-report", required_argument, 0, 'o'},
         {"dump-video", required_argument, 0, 'd'},
         {"fullscreen", no_argument, 0, 'f'},
         {"gdbport", required_argument, 0, 'g'},
@@ -220,9 +225,22 @@ void LaunchSdlFrontend(int argc, char** argv) {
     };
 
     while (optind < argc) {
-        int arg = getopt_long(argc, argv, "d:fg:hi:p:r:a:m:nvw", long_options, &option_index);
+        int arg = getopt_long(argc, argv, "b:o:d:fg:hi:p:r:a:m:nvw", long_options, &option_index);
         if (arg != -1) {
             switch (static_cast<char>(arg)) {
+            case 'b':
+                errno = 0;
+                benchmark_frames = strtoul(optarg, &endarg, 0);
+                if (endarg == optarg || benchmark_frames == 0)
+                    errno = EINVAL;
+                if (errno != 0) {
+                    perror("--benchmark");
+                    exit(1);
+                }
+                break;
+            case 'o':
+                benchmark_report = optarg;
+                break;
             case 'd':
                 dump_video = optarg;
                 break;
@@ -317,6 +335,7 @@ void LaunchSdlFrontend(int argc, char** argv) {
 #endif
 
     MicroProfileOnThreadCreate("EmuThread");
+    Common::Tracing::SetThreadName("EmuThread");
     SCOPE_EXIT({ MicroProfileShutdown(); });
 
     if (filepath.empty()) {
@@ -342,8 +361,26 @@ void LaunchSdlFrontend(int argc, char** argv) {
     // Apply the command line arguments
     Settings::values.gdbstub_port = gdb_port;
     Settings::values.use_gdbstub = use_gdbstub;
+    if (benchmark_frames != 0) {
+        ApplyBenchmarkSettings();
+    }
     system.ApplySettings();
 
+    if (benchmark_frames != 0) {
+        if (!movie_record.empty()) {
+            LOG_CRITICAL(Frontend, "Cannot record a movie while benchmarking");
+            exit(-1);
+        }
+        const BenchmarkOptions benchmark_options{
+            .frames = benchmark_frames,
+            .movie_path = movie_play,
+            .report_path = benchmark_report,
+        };
+        const int result = RunBenchmark(system, filepath, benchmark_options);
+        detached_tasks.WaitForAllTasks();
+        exit(result);
+    }
+
     // Register frontend applets
     Frontend::RegisterDefaultApplets(system);
 
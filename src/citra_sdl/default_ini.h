@@ -118,11 +118,20 @@ shaders_accurate_mul =
 # 0: Interpreter (slow), 1 (default): JIT (fast)
 use_shader_jit =
 
+# Whether to emit PICA vertex and geometry shaders using SPIRV or GLSL (Vulkan only, experimental)
+# 0 (default): GLSL, 1: SPIR-V
+spirv_vertex_shader_gen =
+
 # Forces VSync on the display thread. Usually doesn't impact performance, but on some drivers it can
 # so only turn this off if you notice a speed difference.
 # 0: Off, 1 (default): On
 use_vsync_new =
 
+# How the frame limiter waits for the next frame
+# 0 (default): Sleep (lowest CPU usage), 1: Precise (sleeps, then spins briefly near the deadline)
+# 2: VSync aligned (like Precise, but lines frames up with the host display refresh)
+frame_pacing =
+
 # Reduce stuttering by storing and loading generated shaders to disk
 # 0: Off, 1 (default. On)
 use_disk_shader_cache =
@@ -253,6 +262,11 @@ enable_audio_stretching =
 # 0 (default): No, 1: Yes
 enable_realtime_audio =
 
+# Whether to adapt the audio latency to the host: the latency grows after the audio output runs
+# out of samples, and shrinks back while it does not.
+# 0 (default): No, 1: Yes
+enable_adaptive_audio_latency =
+
 # Output volume.
 # 1.0 (default): 100%, 0.0; mute
 volume =
@@ -389,6 +403,10 @@ video_encoder_options =
 # Video bitrate, default: 2500000
 video_bitrate =
 
+# What to do with the video frames when the encoder falls behind
+# 0 (default): Slow down the emulation, 1: Drop frames, repeating the previous ones in the video
+drop_video_frames =
+
 # Audio encoder used, default: libvorbis
 audio_encoder =
 
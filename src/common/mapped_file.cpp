@@ -0,0 +1,151 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <limits>
+#include "common/error.h"
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/mapped_file.h"
+
+namespace FileUtil {
+
+namespace {
+
+/// Returns the alignment of the file offset a view can start at.
+u64 GetAllocationGranularity() {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwAllocationGranularity;
+#else
+    return static_cast<u64>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+} // Anonymous namespace
+
+MappedFile::MappedFile(IOFile& file)
+    : MappedFile(file, 0, std::numeric_limits<u64>::max()) {}
+
+MappedFile::MappedFile(IOFile& file, u64 offset_, u64 length) {
+    if (!file.IsOpen() || file.IsCrypto() || file.IsCompressed()) {
+        return;
+    }
+    const int fd = file.GetFd();
+    const u64 file_size = file.GetSize();
+    if (fd == -1 || offset_ >= file_size || length == 0) {
+        return;
+    }
+    const u64 range_size = std::min(length, file_size - offset_);
+    const u64 aligned_offset = offset_ & ~(GetAllocationGranularity() - 1);
+    const u64 aligned_size = range_size + (offset_ - aligned_offset);
+    if (aligned_size > std::numeric_limits<std::size_t>::max()) {
+        return;
+    }
+
+#ifdef _WIN32
+    const HANDLE file_handle = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+    if (file_handle == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_handle == nullptr) {
+        LOG_WARNING(Common_Filesystem, "CreateFileMapping failed for {}: {}", file.Filename(),
+                    Common::GetLastErrorMsg());
+        return;
+    }
+    view = static_cast<u8*>(MapViewOfFile(mapping_handle, FILE_MAP_READ,
+                                          static_cast<DWORD>(aligned_offset >> 32),
+                                          static_cast<DWORD>(aligned_offset),
+                                          static_cast<SIZE_T>(aligned_size)));
+    if (view == nullptr) {
+        LOG_WARNING(Common_Filesystem, "MapViewOfFile failed for {}: {}", file.Filename(),
+                    Common::GetLastErrorMsg());
+        CloseHandle(mapping_handle);
+        mapping_handle = nullptr;
+        return;
+    }
+#else
+    void* ptr = mmap(nullptr, static_cast<std::size_t>(aligned_size), PROT_READ, MAP_SHARED, fd,
+                     static_cast<off_t>(aligned_offset));
+    if (ptr == MAP_FAILED) {
+        LOG_WARNING(Common_Filesystem, "mmap failed for {}: {}", file.Filename(),
+                    Common::GetLastErrorMsg());
+        return;
+    }
+    view = static_cast<u8*>(ptr);
+#endif
+    view_size = static_cast<std::size_t>(aligned_size);
+    data = view + (offset_ - aligned_offset);
+    offset = offset_;
+    size = range_size;
+}
+
+MappedFile::~MappedFile() {
+    if (view == nullptr) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(view);
+    CloseHandle(mapping_handle);
+#else
+    munmap(view, view_size);
+#endif
+}
+
+std::span<const u8> MappedFile::Span(u64 file_offset, u64 length) const {
+    if (file_offset < offset || file_offset - offset >= size) {
+        return {};
+    }
+    const u64 start = file_offset - offset;
+    return {data + start, static_cast<std::size_t>(std::min(length, size - start))};
+}
+
+void MappedFile::Advise(u64 file_offset, u64 length, AccessHint hint) const {
+    const auto range = Span(file_offset, length);
+    if (range.empty()) {
+        return;
+    }
+#ifdef _WIN32
+    // Windows only supports prefetching, access pattern hints are handled by the cache manager.
+    if (hint == AccessHint::WillNeed) {
+        WIN32_MEMORY_RANGE_ENTRY entry{const_cast<u8*>(range.data()), range.size()};
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &entry, 0);
+    }
+#else
+    // madvise requires a page aligned start address.
+    static const auto page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const auto start = reinterpret_cast<uintptr_t>(range.data());
+    const auto aligned_start = start & ~(page_size - 1);
+    const std::size_t aligned_length = range.size() + (start - aligned_start);
+
+    int advice = MADV_NORMAL;
+    switch (hint) {
+    case AccessHint::Normal:
+        advice = MADV_NORMAL;
+        break;
+    case AccessHint::Sequential:
+        advice = MADV_SEQUENTIAL;
+        break;
+    case AccessHint::Random:
+        advice = MADV_RANDOM;
+        break;
+    case AccessHint::WillNeed:
+        advice = MADV_WILLNEED;
+        break;
+    }
+    madvise(reinterpret_cast<void*>(aligned_start), aligned_length, advice);
+#endif
+}
+
+} // namespace FileUtil
@@ -0,0 +1,77 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <span>
+#include "common/common_funcs.h"
+#include "common/common_types.h"
+
+namespace FileUtil {
+
+class IOFile;
+
+/**
+ * Read-only memory mapping of a file, or of a range of it. Reads from the mapping are served
+ * straight from the host page cache, avoiding a syscall and an extra copy per access.
+ */
+class MappedFile : NonCopyable {
+public:
+    enum class AccessHint {
+        Normal,
+        Sequential,
+        Random,
+        WillNeed,
+    };
+
+    /**
+     * Maps the file currently opened by the given IOFile. The mapping stays valid after the
+     * IOFile is closed. Crypto and compressed files cannot be mapped.
+     */
+    explicit MappedFile(IOFile& file);
+
+    /**
+     * Maps the range [offset, offset + length) of the file, clamped to its end. The offsets given
+     * to Span and Advise stay relative to the start of the file.
+     */
+    MappedFile(IOFile& file, u64 offset, u64 length);
+
+    ~MappedFile();
+
+    [[nodiscard]] bool IsOpen() const {
+        return data != nullptr;
+    }
+
+    /// Returns the offset in the file of the first mapped byte.
+    [[nodiscard]] u64 GetOffset() const {
+        return offset;
+    }
+
+    [[nodiscard]] u64 GetSize() const {
+        return size;
+    }
+
+    /**
+     * Returns the mapped bytes in [offset, offset + length), clamped to the end of the mapping.
+     * The span is empty when offset is outside of the mapping.
+     */
+    [[nodiscard]] std::span<const u8> Span(u64 offset, u64 length) const;
+
+    /// Hints the host kernel how the given range of the mapping is going to be accessed.
+    void Advise(u64 offset, u64 length, AccessHint hint) const;
+
+private:
+    /// Start of the view, aligned down to the allocation granularity of the host
+    u8* view = nullptr;
+    std::size_t view_size = 0;
+    /// First mapped byte of the requested range
+    u8* data = nullptr;
+    u64 offset = 0;
+    u64 size = 0;
+#ifdef _WIN32
+    void* mapping_handle = nullptr;
+#endif
+};
+
+} // namespace FileUtil
@@ -23,3 +23,33 @@ typedef void* HANDLE;
 #include <microprofile.h>
 
 #define MP_RGB(r, g, b) ((r) << 16 | (g) << 8 | (b) << 0)
+
+// Also record the profiled scopes with the trace recorder, so that they can be captured in builds
+// without the profiler and written to a trace file.
+#include "common/tracing.h"
+
+#define CITRA_TRACE_TOKEN_PASTE0(a, b) a##b
+#define CITRA_TRACE_TOKEN_PASTE(a, b) CITRA_TRACE_TOKEN_PASTE0(a, b)
+
+#undef MICROPROFILE_DECLARE
+#undef MICROPROFILE_DEFINE
+#undef MICROPROFILE_SCOPE
+
+#if MICROPROFILE_ENABLED
+#define MICROPROFILE_DECLARE(var)                                                                  \
+    extern MicroProfileToken g_mp_##var;                                                           \
+    extern Common::Tracing::Category g_trace_##var
+#define MICROPROFILE_DEFINE(var, group, name, color)                                               \
+    MicroProfileToken g_mp_##var = MicroProfileGetToken(group, name, color,                        \
+                                                        MicroProfileTokenTypeCpu);                 \
+    Common::Tracing::Category g_trace_##var{group, name}
+#define MICROPROFILE_SCOPE(var)                                                                    \
+    MicroProfileScopeHandler CITRA_TRACE_TOKEN_PASTE(foo, __LINE__)(g_mp_##var);                   \
+    Common::Tracing::Scope CITRA_TRACE_TOKEN_PASTE(trace_scope, __LINE__)(g_trace_##var)
+#else
+#define MICROPROFILE_DECLARE(var) extern Common::Tracing::Category g_trace_##var
+#define MICROPROFILE_DEFINE(var, group, name, color)                                               \
+    Common::Tracing::Category g_trace_##var{group, name}
+#define MICROPROFILE_SCOPE(var)                                                                    \
+    Common::Tracing::Scope CITRA_TRACE_TOKEN_PASTE(trace_scope, __LINE__)(g_trace_##var)
+#endif
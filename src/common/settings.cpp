@@ -20,6 +20,8 @@ std::string_view GetAudioEmulationName(AudioEmulation emulation) {
         return "LLE";
     case AudioEmulation::LLEMultithreaded:
         return "LLE Multithreaded";
+    case AudioEmulation::LLERunAhead:
+        return "LLE Run-ahead";
     default:
         return "Invalid";
     }
@@ -70,6 +72,19 @@ std::string_view GetTextureSamplingName(TextureSampling sampling) {
     }
 }
 
+std::string_view GetFramePacingName(FramePacing pacing) {
+    switch (pacing) {
+    case FramePacing::Sleep:
+        return "Sleep";
+    case FramePacing::Precise:
+        return "Precise";
+    case FramePacing::VSyncAligned:
+        return "VSyncAligned";
+    default:
+        return "Invalid";
+    }
+}
+
 } // Anonymous namespace
 
 Values values = {};
@@ -91,6 +106,7 @@ void LogSettings() {
     log_setting("Renderer_AsyncShaders", values.async_shader_compilation.GetValue());
     log_setting("Renderer_AsyncPresentation", values.async_presentation.GetValue());
     log_setting("Renderer_SpirvShaderGen", values.spirv_shader_gen.GetValue());
+    log_setting("Renderer_SpirvVertexShaderGen", values.spirv_vertex_shader_gen.GetValue());
     log_setting("Renderer_DisableSpirvOptimizer", values.disable_spirv_optimizer.GetValue());
     log_setting("Renderer_Debug", values.renderer_debug.GetValue());
     log_setting("Renderer_UseHwShader", values.use_hw_shader.GetValue());
@@ -98,6 +114,7 @@ void LogSettings() {
     log_setting("Renderer_UseShaderJit", values.use_shader_jit.GetValue());
     log_setting("Renderer_UseResolutionFactor", values.resolution_factor.GetValue());
     log_setting("Renderer_FrameLimit", values.frame_limit.GetValue());
+    log_setting("Renderer_FramePacing", GetFramePacingName(values.frame_pacing.GetValue()));
     log_setting("Renderer_VSyncNew", values.use_vsync_new.GetValue());
     log_setting("Renderer_PostProcessingShader", values.pp_shader_name.GetValue());
     log_setting("Renderer_FilterMode", values.filter_mode.GetValue());
@@ -132,6 +149,7 @@ void LogSettings() {
     log_setting("Audio_InputDevice", values.input_device.GetValue());
     log_setting("Audio_EnableAudioStretching", values.enable_audio_stretching.GetValue());
     log_setting("Audio_EnableRealtime", values.enable_realtime_audio.GetValue());
+    log_setting("Audio_EnableAdaptiveLatency", values.enable_adaptive_audio_latency.GetValue());
     using namespace Service::CAM;
     log_setting("Camera_OuterRightName", values.camera_name[OuterRightCamera]);
     log_setting("Camera_OuterRightConfig", values.camera_config[OuterRightCamera]);
@@ -90,6 +90,7 @@ enum class AudioEmulation : u32 {
     HLE = 0,
     LLE = 1,
     LLEMultithreaded = 2,
+    LLERunAhead = 3,
 };
 
 enum class TextureFilter : u32 {
@@ -107,6 +108,12 @@ enum class TextureSampling : u32 {
     Linear = 2,
 };
 
+enum class FramePacing : u32 {
+    Sleep = 0,
+    Precise = 1,
+    VSyncAligned = 2,
+};
+
 enum class AspectRatio : u32 {
     Default = 0,
     R16_9 = 1,
@@ -500,6 +507,7 @@ struct Values {
     Setting<bool> renderer_debug{false, "renderer_debug"};
     Setting<bool> dump_command_buffers{false, "dump_command_buffers"};
     SwitchableSetting<bool> spirv_shader_gen{true, "spirv_shader_gen"};
+    Setting<bool> spirv_vertex_shader_gen{false, "spirv_vertex_shader_gen"};
     SwitchableSetting<bool> disable_spirv_optimizer{true, "disable_spirv_optimizer"};
     SwitchableSetting<bool> async_shader_compilation{false, "async_shader_compilation"};
     SwitchableSetting<bool> async_presentation{true, "async_presentation"};
@@ -511,6 +519,7 @@ struct Values {
     SwitchableSetting<u32, true> resolution_factor{1, 0, 10, "resolution_factor"};
     SwitchableSetting<double, true> frame_limit{100, 0, 1000, "frame_limit"};
     SwitchableSetting<double, true> turbo_limit{200, 0, 1000, "turbo_limit"};
+    Setting<FramePacing> frame_pacing{FramePacing::Sleep, "frame_pacing"};
     SwitchableSetting<TextureFilter> texture_filter{TextureFilter::NoFilter, "texture_filter"};
     SwitchableSetting<TextureSampling> texture_sampling{TextureSampling::GameControlled,
                                                         "texture_sampling"};
@@ -583,6 +592,7 @@ struct Values {
     SwitchableSetting<AudioEmulation> audio_emulation{AudioEmulation::HLE, "audio_emulation"};
     SwitchableSetting<bool> enable_audio_stretching{true, "enable_audio_stretching"};
     SwitchableSetting<bool> enable_realtime_audio{false, "enable_realtime_audio"};
+    Setting<bool> enable_adaptive_audio_latency{false, "enable_adaptive_audio_latency"};
     SwitchableSetting<float, true> volume{1.f, 0.f, 1.f, "volume"};
     Setting<AudioCore::SinkType> output_type{AudioCore::SinkType::Auto, "output_type"};
     Setting<std::string> output_device{"Auto", "output_device"};
@@ -614,6 +624,7 @@ struct Values {
     std::string video_encoder;
     std::string video_encoder_options;
     u64 video_bitrate;
+    bool drop_video_frames;
 
     std::string audio_encoder;
     std::string audio_encoder_options;
@@ -158,7 +158,7 @@ public:
     template <typename Arg>
     void Push(Arg&& t) {
         std::scoped_lock lock{write_lock};
-        spsc_queue.Push(t);
+        spsc_queue.Push(std::forward<Arg>(t));
     }
 
     void Pop() {
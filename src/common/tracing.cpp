@@ -0,0 +1,215 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/tracing.h"
+
+namespace Common::Tracing {
+
+namespace Detail {
+std::atomic_bool is_recording{false};
+} // namespace Detail
+
+namespace {
+
+struct Event {
+    const Category* category;
+    u64 begin;
+    u64 end;
+};
+
+/// Ring buffer holding the most recent events of a thread
+struct ThreadBuffer {
+    std::mutex mutex;
+    std::vector<Event> events;
+    std::size_t next{};
+    bool wrapped{};
+    std::string name;
+    u32 id{};
+
+    void Reset(std::size_t capacity) {
+        events.assign(capacity, Event{});
+        next = 0;
+        wrapped = false;
+    }
+
+    void Push(const Event& event) {
+        if (events.empty()) {
+            return;
+        }
+        events[next] = event;
+        if (++next == events.size()) {
+            next = 0;
+            wrapped = true;
+        }
+    }
+
+    /// Returns the recorded events from the oldest to the newest.
+    std::vector<Event> Snapshot() const {
+        std::vector<Event> result;
+        if (wrapped) {
+            result.reserve(events.size());
+            result.insert(result.end(), events.begin() + next, events.end());
+        }
+        result.insert(result.end(), events.begin(), events.begin() + next);
+        return result;
+    }
+};
+
+struct State {
+    std::mutex mutex;
+    /// Buffers of all threads that recorded an event, kept after the threads exit
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::size_t events_per_thread{DefaultEventsPerThread};
+    u64 start_time{};
+    u32 next_thread_id{1};
+};
+
+State& GetState() {
+    static State state;
+    return state;
+}
+
+thread_local std::shared_ptr<ThreadBuffer> thread_buffer;
+thread_local std::string thread_name;
+
+ThreadBuffer& GetThreadBuffer() {
+    if (!thread_buffer) {
+        auto& state = GetState();
+        std::scoped_lock lock{state.mutex};
+        auto buffer = std::make_shared<ThreadBuffer>();
+        buffer->id = state.next_thread_id++;
+        buffer->name = thread_name.empty() ? fmt::format("Thread {}", buffer->id) : thread_name;
+        buffer->Reset(state.events_per_thread);
+        state.buffers.push_back(buffer);
+        thread_buffer = std::move(buffer);
+    }
+    return *thread_buffer;
+}
+
+void AppendEscaped(std::string& out, std::string_view str) {
+    for (const char c : str) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+        }
+        out += c;
+    }
+}
+
+} // Anonymous namespace
+
+u64 Now() {
+    return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now().time_since_epoch())
+                                .count());
+}
+
+void Start(std::size_t events_per_thread) {
+    if (events_per_thread > MaxEventsPerThread) {
+        LOG_WARNING(Common, "Requested {} events per thread, limiting to {}", events_per_thread,
+                    MaxEventsPerThread);
+        events_per_thread = MaxEventsPerThread;
+    }
+
+    auto& state = GetState();
+    {
+        std::scoped_lock lock{state.mutex};
+        // Forget the threads that exited, only their buffers hold a reference to them.
+        std::erase_if(state.buffers, [](const auto& buffer) { return buffer.use_count() == 1; });
+        for (const auto& buffer : state.buffers) {
+            std::scoped_lock buffer_lock{buffer->mutex};
+            buffer->Reset(events_per_thread);
+        }
+        state.events_per_thread = events_per_thread;
+        state.start_time = Now();
+    }
+    Detail::is_recording.store(true, std::memory_order_relaxed);
+    LOG_INFO(Common, "Started recording a trace, {} events per thread", events_per_thread);
+}
+
+void Stop() {
+    Detail::is_recording.store(false, std::memory_order_relaxed);
+    LOG_INFO(Common, "Stopped recording the trace");
+}
+
+bool Dump(const std::string& path) {
+    auto& state = GetState();
+    std::string out = R"({"displayTimeUnit":"ms","traceEvents":[)";
+    bool first = true;
+    const auto separator = [&first, &out] {
+        if (!first) {
+            out += ",\n";
+        }
+        first = false;
+    };
+
+    std::size_t num_events = 0;
+    {
+        std::scoped_lock lock{state.mutex};
+        for (const auto& buffer : state.buffers) {
+            std::vector<Event> events;
+            {
+                std::scoped_lock buffer_lock{buffer->mutex};
+                events = buffer->Snapshot();
+                separator();
+                out += R"({"name":"thread_name","ph":"M","pid":1,"tid":)";
+                fmt::format_to(std::back_inserter(out), R"({},"args":{{"name":")", buffer->id);
+                AppendEscaped(out, buffer->name);
+                out += R"("}})";
+            }
+
+            for (const Event& event : events) {
+                if (event.begin < state.start_time) {
+                    continue;
+                }
+                separator();
+                out += R"({"name":")";
+                AppendEscaped(out, event.category->name);
+                out += R"(","cat":")";
+                AppendEscaped(out, event.category->group);
+                fmt::format_to(std::back_inserter(out),
+                               R"(","ph":"X","pid":1,"tid":{},"ts":{:.3f},"dur":{:.3f}}})",
+                               buffer->id, (event.begin - state.start_time) / 1000.0,
+                               (event.end - event.begin) / 1000.0);
+            }
+            num_events += events.size();
+        }
+    }
+    out += "]}\n";
+
+    FileUtil::IOFile file(path, "w");
+    if (!file.IsOpen() || file.WriteString(out) != out.size()) {
+        LOG_ERROR(Common, "Failed to write the trace to {}", path);
+        return false;
+    }
+    LOG_INFO(Common, "Wrote {} trace events to {}", num_events, path);
+    return true;
+}
+
+void SetThreadName(const char* name) {
+    thread_name = name;
+    if (thread_buffer) {
+        std::scoped_lock lock{thread_buffer->mutex};
+        thread_buffer->name = thread_name;
+    }
+}
+
+void RecordComplete(const Category& category, u64 begin, u64 end) {
+    if (!IsRecording()) {
+        return;
+    }
+    ThreadBuffer& buffer = GetThreadBuffer();
+    std::scoped_lock lock{buffer.mutex};
+    buffer.Push(Event{&category, begin, end});
+}
+
+} // namespace Common::Tracing
@@ -0,0 +1,89 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include "common/common_types.h"
+
+/**
+ * A lightweight recorder for timed scopes, meant to capture traces of long sessions without the
+ * Qt profiler widget. Each thread records into its own fixed size ring buffer, so only the most
+ * recent events are kept. The recorded events can be dumped in the Chrome trace event format,
+ * which can be opened with chrome://tracing or the Perfetto UI.
+ *
+ * All the MICROPROFILE_SCOPE scopes are recorded automatically, see common/microprofile.h.
+ */
+namespace Common::Tracing {
+
+/// Identifies a kind of event. Must outlive the recording, usually it is a global.
+struct Category {
+    const char* group;
+    const char* name;
+};
+
+/// Number of events kept for each thread by default, about 1.5 MB per thread
+constexpr std::size_t DefaultEventsPerThread = 64 * 1024;
+
+/// Largest number of events that can be kept for each thread, about 24 MB per thread
+constexpr std::size_t MaxEventsPerThread = 1024 * 1024;
+
+namespace Detail {
+extern std::atomic_bool is_recording;
+} // namespace Detail
+
+/// Returns whether events are being recorded.
+[[nodiscard]] inline bool IsRecording() {
+    return Detail::is_recording.load(std::memory_order_relaxed);
+}
+
+/// Returns the current time in nanoseconds, in the time base used by the recorded events.
+[[nodiscard]] u64 Now();
+
+/**
+ * Starts recording events, discarding the events of a previous recording.
+ * @param events_per_thread Number of events kept for each thread before the oldest are dropped,
+ *                          clamped to MaxEventsPerThread.
+ */
+void Start(std::size_t events_per_thread = DefaultEventsPerThread);
+
+/// Stops recording events. The recorded events are kept until the next recording starts.
+void Stop();
+
+/**
+ * Writes the recorded events to a file in the Chrome trace event JSON format.
+ * Can be called while recording.
+ * @returns whether the file was written successfully.
+ */
+bool Dump(const std::string& path);
+
+/// Sets the name of the calling thread shown in the trace.
+void SetThreadName(const char* name);
+
+/// Records an event of the calling thread that lasted from begin to end, as returned by Now().
+void RecordComplete(const Category& category, u64 begin, u64 end);
+
+/// Records the duration of the enclosing scope while a recording is active.
+class Scope {
+public:
+    explicit Scope(const Category& category_)
+        : category{category_}, begin{IsRecording() ? Now() : 0} {}
+
+    ~Scope() {
+        if (begin != 0) {
+            RecordComplete(category, begin, Now());
+        }
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const Category& category;
+    u64 begin;
+};
+
+} // namespace Common::Tracing
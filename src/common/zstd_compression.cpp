@@ -7,10 +7,17 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstring>
 #include <ctime>
 #include <format>
+#include <limits>
+#include <list>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <sstream>
 #include <zstd.h>
 #include <zstd/contrib/seekable_format/zstd_seekable.h>
@@ -21,7 +28,9 @@
 #include "common/archives.h"
 #include "common/assert.h"
 #include "common/logging/log.h"
+#include "common/polyfill_thread.h"
 #include "common/scm_rev.h"
+#include "common/thread.h"
 #include "common/zstd_compression.h"
 
 namespace Common::Compression {
@@ -455,7 +464,9 @@ struct Z3DSReadIOFile::Z3DSReadIOFileImpl {
             LOG_ERROR(Common_Filesystem, "ZSTD_seekable_initCStream() error : {}",
                       ZSTD_getErrorName(init_result));
             m_good = false;
+            return;
         }
+        num_frames = ZSTD_seekable_getNumFrames(seekable);
     }
 
     int OnZSTDRead(void* buffer, size_t n) {
@@ -475,32 +486,198 @@ struct Z3DSReadIOFile::Z3DSReadIOFileImpl {
     }
 
     size_t Read(void* data, std::size_t length) {
-        if (!m_good)
-            return 0;
-        size_t result = ZSTD_seekable_decompress(seekable, data, length, uncompressed_pos);
-        if (ZSTD_isError(result)) {
-            LOG_ERROR(Common_Filesystem, "ZSTD_seekable_decompress() error : {}",
-                      ZSTD_getErrorName(result));
-            return 0;
-        }
+        const size_t result = ReadAt(data, length, uncompressed_pos);
         uncompressed_pos += result;
         return result;
     }
 
     size_t ReadAt(void* data, std::size_t length, size_t pos) {
-        if (!m_good)
+        if (!m_good || pos >= header.uncompressed_size)
             return 0;
-        // ReadAt should be thread safe, but seekable compression is not,
-        // so we are forced to use a lock.
-        std::scoped_lock lock(read_mutex);
+        length = std::min<size_t>(length, header.uncompressed_size - pos);
+
+        u8* out = static_cast<u8*>(data);
+        size_t done = 0;
+        while (done < length) {
+            const u64 offset = pos + done;
+            const u32 frame_index = FrameIndexAt(offset);
+            const u64 frame_start = FrameOffset(frame_index);
+            const size_t frame_size = FrameSize(frame_index);
+            if (frame_size == 0) {
+                break;
+            }
+            const size_t in_frame = static_cast<size_t>(offset - frame_start);
+            const size_t to_copy = std::min(length - done, frame_size - in_frame);
+
+            if (in_frame == 0 && to_copy == frame_size) {
+                // The read covers the whole frame, decompress straight into the destination
+                // instead of polluting the cache with data that will likely not be read again.
+                if (const FrameData frame = LookupFrame(frame_index)) {
+                    std::memcpy(out + done, frame->data(), frame_size);
+                    cache_stats.hits++;
+                } else if (DecompressFrame(frame_index, out + done, frame_size)) {
+                    cache_stats.bypasses++;
+                } else {
+                    break;
+                }
+            } else {
+                const FrameData frame = GetFrame(frame_index);
+                if (!frame) {
+                    break;
+                }
+                std::memcpy(out + done, frame->data() + in_frame, to_copy);
+            }
+            done += to_copy;
+            OnFrameAccess(frame_index);
+        }
+        return done;
+    }
+
+    u32 FrameIndexAt(u64 offset) {
+        std::scoped_lock lock(seekable_mutex);
+        return ZSTD_seekable_offsetToFrameIndex(seekable, offset);
+    }
+
+    u64 FrameOffset(u32 frame_index) {
+        std::scoped_lock lock(seekable_mutex);
+        return ZSTD_seekable_getFrameDecompressedOffset(seekable, frame_index);
+    }
 
-        size_t result = ZSTD_seekable_decompress(seekable, data, length, pos);
+    size_t FrameSize(u32 frame_index) {
+        std::scoped_lock lock(seekable_mutex);
+        const size_t size = ZSTD_seekable_getFrameDecompressedSize(seekable, frame_index);
+        return ZSTD_isError(size) ? 0 : size;
+    }
+
+    bool DecompressFrame(u32 frame_index, u8* dest, size_t size) {
+        // The seekable context and the underlying file position are shared state,
+        // so every decompression has to be serialized.
+        std::scoped_lock lock(seekable_mutex);
+        const size_t result = ZSTD_seekable_decompressFrame(seekable, dest, size, frame_index);
         if (ZSTD_isError(result)) {
-            LOG_ERROR(Common_Filesystem, "ZSTD_seekable_decompress() error : {}",
+            LOG_ERROR(Common_Filesystem, "ZSTD_seekable_decompressFrame() error : {}",
                       ZSTD_getErrorName(result));
-            return 0;
+            return false;
+        }
+        return result == size;
+    }
+
+    using FrameData = std::shared_ptr<const std::vector<u8>>;
+
+    FrameData LookupFrame(u32 frame_index) {
+        std::scoped_lock lock(cache_mutex);
+        const auto it = frame_map.find(frame_index);
+        if (it == frame_map.end()) {
+            return nullptr;
+        }
+        frame_lru.splice(frame_lru.begin(), frame_lru, it->second);
+        return it->second->second;
+    }
+
+    void InsertFrame(u32 frame_index, FrameData frame) {
+        std::scoped_lock lock(cache_mutex);
+        if (frame_map.contains(frame_index)) {
+            return;
+        }
+        cached_bytes += frame->size();
+        frame_lru.emplace_front(frame_index, std::move(frame));
+        frame_map.emplace(frame_index, frame_lru.begin());
+
+        // Always keep at least the most recent frame, even if it exceeds the budget on its own.
+        while (cached_bytes > cache_budget && frame_lru.size() > 1) {
+            const auto& [index, data] = frame_lru.back();
+            cached_bytes -= data->size();
+            frame_map.erase(index);
+            frame_lru.pop_back();
+            cache_stats.evictions++;
+        }
+    }
+
+    FrameData GetFrame(u32 frame_index) {
+        if (FrameData frame = LookupFrame(frame_index)) {
+            cache_stats.hits++;
+            return frame;
+        }
+
+        // The prefetch thread might be decoding this frame right now. Taking the decoder
+        // lock waits for it, after which the frame is checked again before decoding.
+        std::unique_lock decode_lock(decode_mutex);
+        if (FrameData frame = LookupFrame(frame_index)) {
+            cache_stats.hits++;
+            return frame;
+        }
+        cache_stats.misses++;
+
+        auto frame = std::make_shared<std::vector<u8>>(FrameSize(frame_index));
+        if (!DecompressFrame(frame_index, frame->data(), frame->size())) {
+            return nullptr;
+        }
+        InsertFrame(frame_index, frame);
+        return frame;
+    }
+
+    void OnFrameAccess(u32 frame_index) {
+        const u32 previous = last_frame_index.exchange(frame_index);
+        if (frame_index != previous + 1 && frame_index != previous) {
+            return;
+        }
+        const u32 next = frame_index + 1;
+        if (next >= num_frames || next == last_prefetch_request) {
+            return;
+        }
+        {
+            std::scoped_lock lock(cache_mutex);
+            if (frame_map.contains(next)) {
+                return;
+            }
+        }
+        RequestPrefetch(next);
+    }
+
+    void RequestPrefetch(u32 frame_index) {
+        std::scoped_lock lock(prefetch_mutex);
+        last_prefetch_request = frame_index;
+        prefetch_frame = frame_index;
+        if (!prefetch_thread.joinable()) {
+            prefetch_thread = std::jthread([this](std::stop_token stop_token) {
+                Common::SetCurrentThreadName("Z3DSPrefetch");
+                PrefetchLoop(stop_token);
+            });
+        }
+        prefetch_cv.notify_one();
+    }
+
+    void PrefetchLoop(std::stop_token stop_token) {
+        while (!stop_token.stop_requested()) {
+            u32 frame_index;
+            {
+                std::unique_lock lock(prefetch_mutex);
+                Common::CondvarWait(prefetch_cv, lock, stop_token,
+                                    [this] { return prefetch_frame.has_value(); });
+                if (stop_token.stop_requested()) {
+                    break;
+                }
+                frame_index = *prefetch_frame;
+                prefetch_frame.reset();
+            }
+
+            std::unique_lock decode_lock(decode_mutex);
+            if (LookupFrame(frame_index)) {
+                continue;
+            }
+            auto frame = std::make_shared<std::vector<u8>>(FrameSize(frame_index));
+            if (DecompressFrame(frame_index, frame->data(), frame->size())) {
+                InsertFrame(frame_index, std::move(frame));
+                cache_stats.prefetches++;
+            }
+        }
+    }
+
+    void StopPrefetch() {
+        if (prefetch_thread.joinable()) {
+            prefetch_thread.request_stop();
+            prefetch_thread.join();
         }
-        return result;
     }
 
     bool Seek(s64 off, int origin) {
@@ -526,16 +703,49 @@ struct Z3DSReadIOFile::Z3DSReadIOFileImpl {
     }
 
     void Close() {
+        StopPrefetch();
         ZSTD_seekable_free(seekable);
+        seekable = nullptr;
+        std::scoped_lock lock(cache_mutex);
+        frame_lru.clear();
+        frame_map.clear();
+        cached_bytes = 0;
     }
 
     Z3DSFileHeader header{};
     ZSTD_seekable* seekable = nullptr;
     bool m_good = true;
     IOFile* curr_file = nullptr;
-    std::mutex read_mutex;
     u64 uncompressed_pos = 0;
     Z3DSMetadata metadata;
+
+    // ReadAt should be thread safe, but seekable decompression is not,
+    // so all accesses to the seekable context go through this lock.
+    std::mutex seekable_mutex;
+    // Held while a frame is being decoded into the cache, so a frame is never decoded twice.
+    std::mutex decode_mutex;
+
+    std::mutex cache_mutex;
+    std::list<std::pair<u32, FrameData>> frame_lru;
+    std::unordered_map<u32, std::list<std::pair<u32, FrameData>>::iterator> frame_map;
+    size_t cached_bytes = 0;
+    size_t cache_budget = DEFAULT_CACHE_BUDGET;
+    u32 num_frames = 0;
+
+    std::mutex prefetch_mutex;
+    std::condition_variable_any prefetch_cv;
+    std::optional<u32> prefetch_frame;
+    std::atomic<u32> last_frame_index{std::numeric_limits<u32>::max() - 1};
+    std::atomic<u32> last_prefetch_request{std::numeric_limits<u32>::max()};
+    std::jthread prefetch_thread;
+
+    struct {
+        std::atomic<u64> hits;
+        std::atomic<u64> misses;
+        std::atomic<u64> prefetches;
+        std::atomic<u64> evictions;
+        std::atomic<u64> bypasses;
+    } cache_stats{};
 };
 
 std::optional<u32> Z3DSReadIOFile::GetUnderlyingFileMagic(IOFile* underlying_file) {
@@ -564,6 +774,14 @@ Z3DSReadIOFile::~Z3DSReadIOFile() {
 }
 
 bool Z3DSReadIOFile::Close() {
+    if (impl->seekable) {
+        const CacheStats stats = GetCacheStats();
+        LOG_DEBUG(Common_Filesystem,
+                  "Closing {}: {} hits, {} misses ({:.1f}% hit rate), {} prefetches, "
+                  "{} evictions, {} bypasses",
+                  file->Filename(), stats.hits, stats.misses, stats.HitRate() * 100.0,
+                  stats.prefetches, stats.evictions, stats.bypasses);
+    }
     impl->Close();
     return file->Close();
 }
@@ -649,6 +867,26 @@ const Z3DSMetadata& Z3DSReadIOFile::Metadata() {
     return impl->metadata;
 }
 
+void Z3DSReadIOFile::SetCacheBudget(size_t budget) {
+    std::scoped_lock lock(impl->cache_mutex);
+    impl->cache_budget = budget;
+}
+
+Z3DSReadIOFile::CacheStats Z3DSReadIOFile::GetCacheStats() const {
+    const auto& stats = impl->cache_stats;
+    CacheStats out{
+        .hits = stats.hits.load(std::memory_order_relaxed),
+        .misses = stats.misses.load(std::memory_order_relaxed),
+        .prefetches = stats.prefetches.load(std::memory_order_relaxed),
+        .evictions = stats.evictions.load(std::memory_order_relaxed),
+        .bypasses = stats.bypasses.load(std::memory_order_relaxed),
+        .cached_bytes = 0,
+    };
+    std::scoped_lock lock(impl->cache_mutex);
+    out.cached_bytes = impl->cached_bytes;
+    return out;
+}
+
 template <class Archive>
 void Z3DSReadIOFile::serialize(Archive& ar, const unsigned int) {
     is_serializing = true;
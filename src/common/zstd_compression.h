@@ -195,6 +195,23 @@ private:
 
 class Z3DSReadIOFile : public IOFile {
 public:
+    /// Default amount of memory used to keep decompressed frames around.
+    static constexpr size_t DEFAULT_CACHE_BUDGET = 64 * 1024 * 1024; // 64MiB
+
+    struct CacheStats {
+        u64 hits;         ///< Reads served from an already decompressed frame
+        u64 misses;       ///< Reads that had to decompress a frame on the calling thread
+        u64 prefetches;   ///< Frames decompressed ahead of time by the prefetch thread
+        u64 evictions;    ///< Frames dropped to stay within the memory budget
+        u64 bypasses;     ///< Whole-frame reads decompressed directly into the destination
+        u64 cached_bytes; ///< Current size of the decompressed frame cache
+
+        double HitRate() const {
+            const u64 total = hits + misses;
+            return total ? static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+        }
+    };
+
     static std::optional<u32> GetUnderlyingFileMagic(IOFile* underlying_file);
 
     Z3DSReadIOFile();
@@ -231,6 +248,11 @@ public:
 
     const Z3DSMetadata& Metadata();
 
+    /// Sets the maximum amount of memory used by the decompressed frame cache.
+    void SetCacheBudget(size_t budget);
+
+    CacheStats GetCacheStats() const;
+
 private:
     struct Z3DSReadIOFileImpl;
 
@@ -17,7 +17,7 @@ namespace Cheats {
 // we use the same value
 constexpr u64 run_interval_ticks = 50'000'000;
 
-CheatEngine::CheatEngine(Core::System& system_) : system{system_} {}
+CheatEngine::CheatEngine(Core::System& system_) : system{system_}, memory_scanner{system_} {}
 
 CheatEngine::~CheatEngine() {
     if (system.IsPoweredOn()) {
@@ -10,6 +10,7 @@
 #include <span>
 #include <vector>
 #include "common/common_types.h"
+#include "core/cheats/memory_scanner.h"
 
 namespace Core {
 class System;
@@ -54,6 +55,11 @@ public:
         return process_id;
     }
 
+    /// Returns the scanner used to find the addresses of values in the process memory.
+    MemoryScanner& GetMemoryScanner() {
+        return memory_scanner;
+    }
+
 private:
     /// The cheat execution callback.
     void RunCallback(std::uintptr_t user_data, s64 cycles_late);
@@ -65,5 +71,6 @@ private:
     u32 process_id = 0xFFFFFFFF;
     std::vector<std::shared_ptr<CheatBase>> cheats_list;
     mutable std::shared_mutex cheats_list_mutex;
+    MemoryScanner memory_scanner;
 };
 } // namespace Cheats
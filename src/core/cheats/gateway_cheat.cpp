@@ -3,9 +3,11 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
-#include <cmath>
+#include <array>
+#include <cstring>
 #include <fstream>
 #include <functional>
+#include <optional>
 #include <span>
 #include <string>
 #include <vector>
@@ -16,172 +18,342 @@
 #include "common/string_util.h"
 #include "core/cheats/gateway_cheat.h"
 #include "core/core.h"
+#include "core/hle/kernel/process.h"
 #include "core/hle/service/hid/hid.h"
 #include "core/memory.h"
 
 namespace Cheats {
 
+namespace {
+
 struct State {
     u32 reg = 0;
     u32 offset = 0;
     u32 if_flag = 0;
     u32 loop_count = 0;
-    std::size_t loop_back_line = 0;
-    std::size_t current_line_nr = 0;
+    u32 loop_back = 0;
     bool loop_flag = false;
 };
 
-template <typename T, typename ReadFunction, typename WriteFunction>
-static inline std::enable_if_t<std::is_integral_v<T>> WriteOp(const GatewayCheat::CheatLine& line,
-                                                              const State& state,
-                                                              ReadFunction read_func,
-                                                              WriteFunction write_func,
-                                                              Core::System& system) {
-    u32 addr = line.address + state.offset;
-    T val = read_func(addr);
-    if (val != static_cast<T>(line.value)) {
-        write_func(addr, static_cast<T>(line.value));
-        system.InvalidateCacheRange(addr, sizeof(T));
+struct Instruction;
+
+/// Everything the instructions access during a run of a cheat
+struct Context {
+    /// Running system, null when the cheat runs outside of it
+    Core::System* system;
+    Memory::MemorySystem& memory;
+    const Kernel::Process& process;
+    /// Host pointers of the pages of the process, null for the pages needing special handling
+    const std::array<u8*, Memory::PAGE_TABLE_NUM_ENTRIES>& pointers;
+    std::span<const Instruction> instructions;
+    std::span<const u8> patch_data;
+    std::optional<u32> pad_state{};
+    State state{};
+};
+
+/// Runs an instruction and returns the index of the next one to run.
+using Handler = u32 (*)(Context& context, const Instruction& instruction, u32 pc);
+
+struct Instruction {
+    Handler handler;
+    GatewayCheat::CheatType type;
+    u32 address;
+    u32 value;
+    /// Bits of the memory value taken into account by the comparisons
+    u32 mask;
+    /// Next instruction that has to run while a failed condition skips the instructions, which
+    /// are the conditions and the terminators.
+    u32 skip_target;
+    /// Offset of the bytes written by a patch in the patch data
+    u32 data_offset;
+};
+
+template <typename T>
+T Read(Context& context, VAddr addr) {
+    if (const u8* page = context.pointers[addr >> Memory::CITRA_PAGE_BITS]) {
+        T value;
+        std::memcpy(&value, page + (addr & Memory::CITRA_PAGE_MASK), sizeof(T));
+        return value;
+    }
+    if constexpr (sizeof(T) == 1) {
+        return context.memory.Read8(context.process, addr);
+    } else if constexpr (sizeof(T) == 2) {
+        return context.memory.Read16(context.process, addr);
+    } else {
+        return context.memory.Read32(context.process, addr);
+    }
+}
+
+template <typename T>
+void Write(Context& context, VAddr addr, T value) {
+    if (u8* page = context.pointers[addr >> Memory::CITRA_PAGE_BITS]) {
+        std::memcpy(page + (addr & Memory::CITRA_PAGE_MASK), &value, sizeof(T));
+    } else if constexpr (sizeof(T) == 1) {
+        context.memory.Write8(context.process, addr, value);
+    } else if constexpr (sizeof(T) == 2) {
+        context.memory.Write16(context.process, addr, value);
+    } else {
+        context.memory.Write32(context.process, addr, value);
+    }
+    if (context.system) {
+        context.system->InvalidateCacheRange(addr, sizeof(T));
+    }
+}
+
+/// Enters or goes one level deeper into the skipping of a failed condition.
+u32 Skip(Context& context, const Instruction& instruction) {
+    context.state.if_flag++;
+    return instruction.skip_target;
+}
+
+template <typename T>
+u32 WriteOp(Context& context, const Instruction& instruction, u32 pc) {
+    const u32 addr = instruction.address + context.state.offset;
+    if (Read<T>(context, addr) != static_cast<T>(instruction.value)) {
+        Write<T>(context, addr, static_cast<T>(instruction.value));
     }
+    return pc + 1;
 }
 
-template <typename T, typename ReadFunction, typename CompareFunc>
-static inline std::enable_if_t<std::is_integral_v<T>> CompOp(const GatewayCheat::CheatLine& line,
-                                                             State& state, ReadFunction read_func,
-                                                             CompareFunc comp) {
-    u32 addr = line.address + state.offset;
-    T val = read_func(addr);
-    if (!comp(val)) {
-        state.if_flag++;
+template <typename T, typename Compare>
+u32 CompareOp(Context& context, const Instruction& instruction, u32 pc) {
+    if (context.state.if_flag > 0) {
+        return Skip(context, instruction);
     }
+    const u32 addr = instruction.address + context.state.offset;
+    const u32 value = Read<T>(context, addr) & instruction.mask;
+    return Compare{}(instruction.value, value) ? pc + 1 : Skip(context, instruction);
 }
 
-static inline void LoadOffsetOp(Memory::MemorySystem& memory, const Kernel::Process& process,
-                                const GatewayCheat::CheatLine& line, State& state) {
-    u32 addr = line.address + state.offset;
-    state.offset = memory.Read32(process, addr);
+u32 LoadOffsetOp(Context& context, const Instruction& instruction, u32 pc) {
+    context.state.offset = Read<u32>(context, instruction.address + context.state.offset);
+    return pc + 1;
 }
 
-static inline void LoopOp(const GatewayCheat::CheatLine& line, State& state) {
-    state.loop_flag = state.loop_count < line.value;
+u32 LoopOp(Context& context, const Instruction& instruction, u32 pc) {
+    // TODO(B3N30): Support nested loops if necessary
+    State& state = context.state;
+    state.loop_flag = state.loop_count < instruction.value;
     state.loop_count++;
-    state.loop_back_line = state.current_line_nr;
+    state.loop_back = pc;
+    return pc + 1;
 }
 
-static inline void TerminateOp(State& state) {
-    if (state.if_flag > 0) {
-        state.if_flag--;
+u32 TerminateOp(Context& context, const Instruction& instruction, u32 pc) {
+    State& state = context.state;
+    if (state.if_flag > 0 && --state.if_flag > 0) {
+        return instruction.skip_target;
     }
+    return pc + 1;
 }
 
-static inline void LoopExecuteVariantOp(State& state) {
+u32 LoopExecuteVariantOp(Context& context, const Instruction&, u32 pc) {
+    State& state = context.state;
     if (state.loop_flag) {
-        state.current_line_nr = state.loop_back_line - 1;
-    } else {
-        state.loop_count = 0;
+        return state.loop_back;
     }
+    state.loop_count = 0;
+    return pc + 1;
 }
 
-static inline void FullTerminateOp(State& state) {
+u32 FullTerminateOp(Context& context, const Instruction&, u32 pc) {
+    State& state = context.state;
     if (state.loop_flag) {
-        state.current_line_nr = state.loop_back_line - 1;
-    } else {
-        state.offset = 0;
-        state.reg = 0;
-        state.loop_count = 0;
-        state.if_flag = 0;
-        state.loop_flag = false;
+        // Loops back while still skipping if a condition failed, the loop instruction itself does
+        // not take part in the skipping.
+        return state.if_flag > 0 ? context.instructions[state.loop_back].skip_target
+                                 : state.loop_back;
     }
+    state = State{};
+    return pc + 1;
 }
 
-static inline void SetOffsetOp(const GatewayCheat::CheatLine& line, State& state) {
-    state.offset = line.value;
+u32 SetOffsetOp(Context& context, const Instruction& instruction, u32 pc) {
+    context.state.offset = instruction.value;
+    return pc + 1;
 }
 
-static inline void AddValueOp(const GatewayCheat::CheatLine& line, State& state) {
-    state.reg += line.value;
+u32 AddValueOp(Context& context, const Instruction& instruction, u32 pc) {
+    context.state.reg += instruction.value;
+    return pc + 1;
 }
 
-static inline void SetValueOp(const GatewayCheat::CheatLine& line, State& state) {
-    state.reg = line.value;
+u32 SetValueOp(Context& context, const Instruction& instruction, u32 pc) {
+    context.state.reg = instruction.value;
+    return pc + 1;
 }
 
-template <typename T, typename ReadFunction, typename WriteFunction>
-static inline std::enable_if_t<std::is_integral_v<T>> IncrementiveWriteOp(
-    const GatewayCheat::CheatLine& line, State& state, ReadFunction read_func,
-    WriteFunction write_func, Core::System& system) {
-    u32 addr = line.value + state.offset;
-    T val = read_func(addr);
-    if (val != static_cast<T>(state.reg)) {
-        write_func(addr, static_cast<T>(state.reg));
-        system.InvalidateCacheRange(addr, sizeof(T));
+template <typename T>
+u32 IncrementiveWriteOp(Context& context, const Instruction& instruction, u32 pc) {
+    State& state = context.state;
+    const u32 addr = instruction.value + state.offset;
+    if (Read<T>(context, addr) != static_cast<T>(state.reg)) {
+        Write<T>(context, addr, static_cast<T>(state.reg));
     }
     state.offset += sizeof(T);
+    return pc + 1;
 }
 
-template <typename T, typename ReadFunction>
-static inline std::enable_if_t<std::is_integral_v<T>> LoadOp(const GatewayCheat::CheatLine& line,
-                                                             State& state, ReadFunction read_func) {
-
-    u32 addr = line.value + state.offset;
-    state.reg = read_func(addr);
+template <typename T>
+u32 LoadOp(Context& context, const Instruction& instruction, u32 pc) {
+    context.state.reg = Read<T>(context, instruction.value + context.state.offset);
+    return pc + 1;
 }
 
-static inline void AddOffsetOp(const GatewayCheat::CheatLine& line, State& state) {
-    state.offset += line.value;
+u32 AddOffsetOp(Context& context, const Instruction& instruction, u32 pc) {
+    context.state.offset += instruction.value;
+    return pc + 1;
 }
 
-static inline void JokerOp(const GatewayCheat::CheatLine& line, State& state,
-                           const Core::System& system) {
-    u32 pad_state = system.ServiceManager()
-                        .GetService<Service::HID::Module::Interface>("hid:USER")
-                        ->GetModule()
-                        ->GetState()
-                        .hex;
-    bool pressed = (pad_state & line.value) == line.value;
-    if (!pressed) {
-        state.if_flag++;
+u32 JokerOp(Context& context, const Instruction& instruction, u32 pc) {
+    if (context.state.if_flag > 0) {
+        return Skip(context, instruction);
     }
+    if (!context.pad_state) {
+        context.pad_state = context.system->ServiceManager()
+                                .GetService<Service::HID::Module::Interface>("hid:USER")
+                                ->GetModule()
+                                ->GetState()
+                                .hex;
+    }
+    const bool pressed = (*context.pad_state & instruction.value) == instruction.value;
+    return pressed ? pc + 1 : Skip(context, instruction);
 }
 
-static inline void PatchOp(const GatewayCheat::CheatLine& line, State& state, Core::System& system,
-                           const Kernel::Process& process,
-                           std::span<const GatewayCheat::CheatLine> cheat_lines) {
-    if (state.if_flag > 0) {
-        // Skip over the additional patch lines
-        state.current_line_nr += static_cast<int>(std::ceil(line.value / 8.0));
-        return;
+u32 PatchOp(Context& context, const Instruction& instruction, u32 pc) {
+    const u32 addr = instruction.address + context.state.offset;
+    const auto data = context.patch_data.subspan(instruction.data_offset, instruction.value);
+    if (context.system) {
+        context.system->InvalidateCacheRange(addr, data.size());
     }
-    u32 num_bytes = line.value;
-    u32 addr = line.address + state.offset;
-    system.InvalidateCacheRange(addr, num_bytes);
-
-    bool first = true;
-    u32 bit_offset = 0;
-    if (num_bytes > 0)
-        state.current_line_nr++; // skip over the current code
-    while (num_bytes >= 4) {
-        u32 tmp = first ? cheat_lines[state.current_line_nr].first
-                        : cheat_lines[state.current_line_nr].value;
-        if (!first && num_bytes > 4) {
-            state.current_line_nr++;
-        }
-        first = !first;
-        system.Memory().Write32(process, addr, tmp);
-        addr += 4;
-        num_bytes -= 4;
+    context.memory.WriteBlock(context.process, addr, data.data(), data.size());
+    return pc + 1;
+}
+
+Handler GetHandler(GatewayCheat::CheatType type) {
+    using CheatType = GatewayCheat::CheatType;
+    switch (type) {
+    case CheatType::Write32:
+        // 0XXXXXXX YYYYYYYY - word[XXXXXXX+offset] = YYYYYYYY
+        return &WriteOp<u32>;
+    case CheatType::Write16:
+        // 1XXXXXXX 0000YYYY - half[XXXXXXX+offset] = YYYY
+        return &WriteOp<u16>;
+    case CheatType::Write8:
+        // 2XXXXXXX 000000YY - byte[XXXXXXX+offset] = YY
+        return &WriteOp<u8>;
+    case CheatType::GreaterThan32:
+        // 3XXXXXXX YYYYYYYY - Execute next block IF YYYYYYYY > word[XXXXXXX]   ;unsigned
+        return &CompareOp<u32, std::greater<u32>>;
+    case CheatType::LessThan32:
+        // 4XXXXXXX YYYYYYYY - Execute next block IF YYYYYYYY < word[XXXXXXX]   ;unsigned
+        return &CompareOp<u32, std::less<u32>>;
+    case CheatType::EqualTo32:
+        // 5XXXXXXX YYYYYYYY - Execute next block IF YYYYYYYY == word[XXXXXXX]   ;unsigned
+        return &CompareOp<u32, std::equal_to<u32>>;
+    case CheatType::NotEqualTo32:
+        // 6XXXXXXX YYYYYYYY - Execute next block IF YYYYYYYY != word[XXXXXXX]   ;unsigned
+        return &CompareOp<u32, std::not_equal_to<u32>>;
+    case CheatType::GreaterThan16WithMask:
+        // 7XXXXXXX ZZZZYYYY - Execute next block IF YYYY > ((not ZZZZ) AND half[XXXXXXX])
+        return &CompareOp<u16, std::greater<u32>>;
+    case CheatType::LessThan16WithMask:
+        // 8XXXXXXX ZZZZYYYY - Execute next block IF YYYY < ((not ZZZZ) AND half[XXXXXXX])
+        return &CompareOp<u16, std::less<u32>>;
+    case CheatType::EqualTo16WithMask:
+        // 9XXXXXXX ZZZZYYYY - Execute next block IF YYYY = ((not ZZZZ) AND half[XXXXXXX])
+        return &CompareOp<u16, std::equal_to<u32>>;
+    case CheatType::NotEqualTo16WithMask:
+        // AXXXXXXX ZZZZYYYY - Execute next block IF YYYY <> ((not ZZZZ) AND half[XXXXXXX])
+        return &CompareOp<u16, std::not_equal_to<u32>>;
+    case CheatType::LoadOffset:
+        // BXXXXXXX 00000000 - offset = word[XXXXXXX+offset]
+        return &LoadOffsetOp;
+    case CheatType::Loop:
+        // C0000000 YYYYYYYY - LOOP next block YYYYYYYY times
+        return &LoopOp;
+    case CheatType::Terminator:
+        // D0000000 00000000 - END IF
+        return &TerminateOp;
+    case CheatType::LoopExecuteVariant:
+        // D1000000 00000000 - END LOOP
+        return &LoopExecuteVariantOp;
+    case CheatType::FullTerminator:
+        // D2000000 00000000 - NEXT & Flush
+        return &FullTerminateOp;
+    case CheatType::SetOffset:
+        // D3000000 XXXXXXXX – Sets the offset to XXXXXXXX
+        return &SetOffsetOp;
+    case CheatType::AddValue:
+        // D4000000 XXXXXXXX – reg += XXXXXXXX
+        return &AddValueOp;
+    case CheatType::SetValue:
+        // D5000000 XXXXXXXX – reg = XXXXXXXX
+        return &SetValueOp;
+    case CheatType::IncrementiveWrite32:
+        // D6000000 XXXXXXXX – (32bit) [XXXXXXXX+offset] = reg ; offset += 4
+        return &IncrementiveWriteOp<u32>;
+    case CheatType::IncrementiveWrite16:
+        // D7000000 XXXXXXXX – (16bit) [XXXXXXXX+offset] = reg & 0xffff ; offset += 2
+        return &IncrementiveWriteOp<u16>;
+    case CheatType::IncrementiveWrite8:
+        // D8000000 XXXXXXXX – (16bit) [XXXXXXXX+offset] = reg & 0xff ; offset++
+        return &IncrementiveWriteOp<u8>;
+    case CheatType::Load32:
+        // D9000000 XXXXXXXX – reg = [XXXXXXXX+offset]
+        return &LoadOp<u32>;
+    case CheatType::Load16:
+        // DA000000 XXXXXXXX – reg = [XXXXXXXX+offset] & 0xFFFF
+        return &LoadOp<u16>;
+    case CheatType::Load8:
+        // DB000000 XXXXXXXX – reg = [XXXXXXXX+offset] & 0xFF
+        return &LoadOp<u8>;
+    case CheatType::AddOffset:
+        // DC000000 XXXXXXXX – offset + XXXXXXXX
+        return &AddOffsetOp;
+    case CheatType::Joker:
+        // DD000000 XXXXXXXX – if KEYPAD has value XXXXXXXX execute next block
+        return &JokerOp;
+    case CheatType::Patch:
+        // EXXXXXXX YYYYYYYY
+        // Copies YYYYYYYY bytes from (current code location + 8) to [XXXXXXXX + offset].
+        return &PatchOp;
+    default:
+        return nullptr;
     }
-    while (num_bytes > 0) {
-        u32 tmp = (first ? cheat_lines[state.current_line_nr].first
-                         : cheat_lines[state.current_line_nr].value) >>
-                  bit_offset;
-        system.Memory().Write8(process, addr, static_cast<u8>(tmp));
-        addr += 1;
-        num_bytes -= 1;
-        bit_offset += 8;
+}
+
+/// Returns whether the instruction runs while a failed condition skips the instructions.
+bool RunsWhileSkipping(GatewayCheat::CheatType type) {
+    using CheatType = GatewayCheat::CheatType;
+    switch (type) {
+    case CheatType::GreaterThan32:
+    case CheatType::LessThan32:
+    case CheatType::EqualTo32:
+    case CheatType::NotEqualTo32:
+    case CheatType::GreaterThan16WithMask:
+    case CheatType::LessThan16WithMask:
+    case CheatType::EqualTo16WithMask:
+    case CheatType::NotEqualTo16WithMask:
+    case CheatType::Joker:
+        // Conditions increment the if_flag to handle the end if correctly
+    case CheatType::Terminator:
+    case CheatType::FullTerminator:
+        return true;
+    default:
+        return false;
     }
 }
 
+} // Anonymous namespace
+
+/// Cheat code translated into instructions that run without decoding the cheat lines
+struct GatewayCheat::Program {
+    std::vector<Instruction> instructions;
+    /// Bytes written by the patches, which the cheat stores in the lines following them
+    std::vector<u8> patch_data;
+};
+
 GatewayCheat::CheatLine::CheatLine(const std::string& line) {
     constexpr std::size_t cheat_length = 17;
     if (line.length() != cheat_length) {
@@ -213,6 +385,7 @@ GatewayCheat::CheatLine::CheatLine(const std::string& line) {
 GatewayCheat::GatewayCheat(std::string name_, std::vector<CheatLine> cheat_lines_,
                            std::string comments_)
     : name(std::move(name_)), cheat_lines(std::move(cheat_lines_)), comments(std::move(comments_)) {
+    Compile();
 }
 
 GatewayCheat::GatewayCheat(std::string name_, std::string code, std::string comments_)
@@ -226,214 +399,108 @@ GatewayCheat::GatewayCheat(std::string name_, std::string code, std::string comm
             temp_cheat_lines.emplace_back(line);
     }
     cheat_lines = std::move(temp_cheat_lines);
+    Compile();
 }
 
 GatewayCheat::~GatewayCheat() = default;
 
-void GatewayCheat::Execute(Core::System& system, u32 process_id) const {
-    State state;
-
-    Memory::MemorySystem& memory = system.Memory();
-    std::shared_ptr<Kernel::Process> process = system.Kernel().GetProcessById(process_id);
-    if (!process) {
-        return;
-    }
-
-    auto Read8 = [&memory, &process](VAddr addr) { return memory.Read8(*process, addr); };
-    auto Read16 = [&memory, &process](VAddr addr) { return memory.Read16(*process, addr); };
-    auto Read32 = [&memory, &process](VAddr addr) { return memory.Read32(*process, addr); };
-    auto Write8 = [&memory, &process](VAddr addr, u8 value) {
-        memory.Write8(*process, addr, value);
-    };
-    auto Write16 = [&memory, &process](VAddr addr, u16 value) {
-        memory.Write16(*process, addr, value);
-    };
-    auto Write32 = [&memory, &process](VAddr addr, u32 value) {
-        memory.Write32(*process, addr, value);
-    };
+void GatewayCheat::Compile() {
+    auto compiled = std::make_unique<Program>();
+    auto& instructions = compiled->instructions;
+    auto& patch_data = compiled->patch_data;
 
-    for (state.current_line_nr = 0; state.current_line_nr < cheat_lines.size();
-         state.current_line_nr++) {
-        auto line = cheat_lines[state.current_line_nr];
-        if (state.if_flag > 0) {
-            switch (line.type) {
-            case CheatType::GreaterThan32:
-            case CheatType::LessThan32:
-            case CheatType::EqualTo32:
-            case CheatType::NotEqualTo32:
-            case CheatType::GreaterThan16WithMask:
-            case CheatType::LessThan16WithMask:
-            case CheatType::EqualTo16WithMask:
-            case CheatType::NotEqualTo16WithMask:
-            case CheatType::Joker:
-                // Increment the if_flag to handle the end if correctly
-                state.if_flag++;
-                break;
-            case CheatType::Patch:
-                // EXXXXXXX YYYYYYYY
-                // Copies YYYYYYYY bytes from (current code location + 8) to [XXXXXXXX + offset].
-                // We need to call this here to skip the additional patch lines
-                PatchOp(line, state, system, *process, cheat_lines);
-                break;
-            case CheatType::Terminator:
-                // D0000000 00000000 - ENDIF
-                TerminateOp(state);
-                break;
-            case CheatType::FullTerminator:
-                // D2000000 00000000 - END; offset = 0; reg = 0;
-                FullTerminateOp(state);
-                break;
-            default:
-                break;
-            }
-            // Do not execute any other op code
+    for (std::size_t i = 0; i < cheat_lines.size(); ++i) {
+        const CheatLine& line = cheat_lines[i];
+        const Handler handler = GetHandler(line.type);
+        if (!handler) {
+            // Invalid lines and unknown types do nothing
             continue;
         }
+
+        Instruction& instruction = instructions.emplace_back();
+        instruction.handler = handler;
+        instruction.type = line.type;
+        instruction.address = line.address;
+        instruction.value = line.value;
+        instruction.mask = 0xFFFFFFFF;
+
         switch (line.type) {
-        case CheatType::Null:
-            break;
-        case CheatType::Write32:
-            // 0XXXXXXX YYYYYYYY - word[XXXXXXX+offset] = YYYYYYYY
-            WriteOp<u32>(line, state, Read32, Write32, system);
-            break;
-        case CheatType::Write16:
-            // 1XXXXXXX 0000YYYY - half[XXXXXXX+offset] = YYYY
-            WriteOp<u16>(line, state, Read16, Write16, system);
-            break;
-        case CheatType::Write8:
-            // 2XXXXXXX 000000YY - byte[XXXXXXX+offset] = YY
-            WriteOp<u8>(line, state, Read8, Write8, system);
-            break;
-        case CheatType::GreaterThan32:
-            // 3XXXXXXX YYYYYYYY - Execute next block IF YYYYYYYY > word[XXXXXXX]   ;unsigned
-            CompOp<u32>(line, state, Read32, [&line](u32 val) -> bool { return line.value > val; });
-            break;
-        case CheatType::LessThan32:
-            // 4XXXXXXX YYYYYYYY - Execute next block IF YYYYYYYY < word[XXXXXXX]   ;unsigned
-            CompOp<u32>(line, state, Read32, [&line](u32 val) -> bool { return line.value < val; });
-            break;
-        case CheatType::EqualTo32:
-            // 5XXXXXXX YYYYYYYY - Execute next block IF YYYYYYYY == word[XXXXXXX]   ;unsigned
-            CompOp<u32>(line, state, Read32,
-                        [&line](u32 val) -> bool { return line.value == val; });
-            break;
-        case CheatType::NotEqualTo32:
-            // 6XXXXXXX YYYYYYYY - Execute next block IF YYYYYYYY != word[XXXXXXX]   ;unsigned
-            CompOp<u32>(line, state, Read32,
-                        [&line](u32 val) -> bool { return line.value != val; });
-            break;
         case CheatType::GreaterThan16WithMask:
-            // 7XXXXXXX ZZZZYYYY - Execute next block IF YYYY > ((not ZZZZ) AND half[XXXXXXX])
-            CompOp<u16>(line, state, Read16, [&line](u16 val) -> bool {
-                return static_cast<u16>(line.value) > (static_cast<u16>(~line.value >> 16) & val);
-            });
-            break;
         case CheatType::LessThan16WithMask:
-            // 8XXXXXXX ZZZZYYYY - Execute next block IF YYYY < ((not ZZZZ) AND half[XXXXXXX])
-            CompOp<u16>(line, state, Read16, [&line](u16 val) -> bool {
-                return static_cast<u16>(line.value) < (static_cast<u16>(~line.value >> 16) & val);
-            });
-            break;
         case CheatType::EqualTo16WithMask:
-            // 9XXXXXXX ZZZZYYYY - Execute next block IF YYYY = ((not ZZZZ) AND half[XXXXXXX])
-            CompOp<u16>(line, state, Read16, [&line](u16 val) -> bool {
-                return static_cast<u16>(line.value) == (static_cast<u16>(~line.value >> 16) & val);
-            });
-            break;
         case CheatType::NotEqualTo16WithMask:
-            // AXXXXXXX ZZZZYYYY - Execute next block IF YYYY <> ((not ZZZZ) AND half[XXXXXXX])
-            CompOp<u16>(line, state, Read16, [&line](u16 val) -> bool {
-                return static_cast<u16>(line.value) != (static_cast<u16>(~line.value >> 16) & val);
-            });
-            break;
-        case CheatType::LoadOffset:
-            // BXXXXXXX 00000000 - offset = word[XXXXXXX+offset]
-            LoadOffsetOp(system.Memory(), *process, line, state);
-            break;
-        case CheatType::Loop: {
-            // C0000000 YYYYYYYY - LOOP next block YYYYYYYY times
-            // TODO(B3N30): Support nested loops if necessary
-            LoopOp(line, state);
-            break;
-        }
-        case CheatType::Terminator: {
-            // D0000000 00000000 - END IF
-            TerminateOp(state);
-            break;
-        }
-        case CheatType::LoopExecuteVariant: {
-            // D1000000 00000000 - END LOOP
-            LoopExecuteVariantOp(state);
-            break;
-        }
-        case CheatType::FullTerminator: {
-            // D2000000 00000000 - NEXT & Flush
-            FullTerminateOp(state);
-            break;
-        }
-        case CheatType::SetOffset: {
-            // D3000000 XXXXXXXX – Sets the offset to XXXXXXXX
-            SetOffsetOp(line, state);
-            break;
-        }
-        case CheatType::AddValue: {
-            // D4000000 XXXXXXXX – reg += XXXXXXXX
-            AddValueOp(line, state);
-            break;
-        }
-        case CheatType::SetValue: {
-            // D5000000 XXXXXXXX – reg = XXXXXXXX
-            SetValueOp(line, state);
-            break;
-        }
-        case CheatType::IncrementiveWrite32: {
-            // D6000000 XXXXXXXX – (32bit) [XXXXXXXX+offset] = reg ; offset += 4
-            IncrementiveWriteOp<u32>(line, state, Read32, Write32, system);
-            break;
-        }
-        case CheatType::IncrementiveWrite16: {
-            // D7000000 XXXXXXXX – (16bit) [XXXXXXXX+offset] = reg & 0xffff ; offset += 2
-            IncrementiveWriteOp<u16>(line, state, Read16, Write16, system);
-            break;
-        }
-        case CheatType::IncrementiveWrite8: {
-            // D8000000 XXXXXXXX – (16bit) [XXXXXXXX+offset] = reg & 0xff ; offset++
-            IncrementiveWriteOp<u8>(line, state, Read8, Write8, system);
-            break;
-        }
-        case CheatType::Load32: {
-            // D9000000 XXXXXXXX – reg = [XXXXXXXX+offset]
-            LoadOp<u32>(line, state, Read32);
-            break;
-        }
-        case CheatType::Load16: {
-            // DA000000 XXXXXXXX – reg = [XXXXXXXX+offset] & 0xFFFF
-            LoadOp<u16>(line, state, Read16);
+            instruction.value = line.value & 0xFFFF;
+            instruction.mask = (~line.value >> 16) & 0xFFFF;
             break;
-        }
-        case CheatType::Load8: {
-            // DB000000 XXXXXXXX – reg = [XXXXXXXX+offset] & 0xFF
-            LoadOp<u8>(line, state, Read8);
-            break;
-        }
-        case CheatType::AddOffset: {
-            // DC000000 XXXXXXXX – offset + XXXXXXXX
-            AddOffsetOp(line, state);
-            break;
-        }
-        case CheatType::Joker: {
-            // DD000000 XXXXXXXX – if KEYPAD has value XXXXXXXX execute next block
-            JokerOp(line, state, system);
+        case CheatType::Patch: {
+            // The bytes are stored in the following lines, the first word and then the second
+            // word of each line, in little endian.
+            const std::size_t num_lines =
+                std::min<std::size_t>((u64{line.value} + 7) / 8, cheat_lines.size() - i - 1);
+            instruction.data_offset = static_cast<u32>(patch_data.size());
+            for (std::size_t j = 1; j <= num_lines; ++j) {
+                for (const u32 word : {cheat_lines[i + j].first, cheat_lines[i + j].value}) {
+                    for (u32 shift = 0; shift < 32; shift += 8) {
+                        patch_data.push_back(static_cast<u8>(word >> shift));
+                    }
+                }
+            }
+            if (line.value > num_lines * 8) {
+                LOG_ERROR(Core_Cheats, "Patch of cheat {} is missing {} bytes", name,
+                          line.value - num_lines * 8);
+            }
+            instruction.value = std::min<u32>(line.value, static_cast<u32>(num_lines * 8));
+            i += num_lines;
             break;
         }
-        case CheatType::Patch: {
-            // EXXXXXXX YYYYYYYY
-            // Copies YYYYYYYY bytes from (current code location + 8) to [XXXXXXXX + offset].
-            PatchOp(line, state, system, *process, cheat_lines);
+        default:
             break;
         }
+    }
+
+    // A failed condition jumps to the next condition or terminator instead of stepping through
+    // every line until the matching terminator.
+    u32 skip_target = static_cast<u32>(instructions.size());
+    for (std::size_t i = instructions.size(); i-- > 0;) {
+        instructions[i].skip_target = skip_target;
+        if (RunsWhileSkipping(instructions[i].type)) {
+            skip_target = static_cast<u32>(i);
         }
     }
+
+    program = std::move(compiled);
+}
+
+void GatewayCheat::Execute(Core::System& system, u32 process_id) const {
+    std::shared_ptr<Kernel::Process> process = system.Kernel().GetProcessById(process_id);
+    if (!process) {
+        return;
+    }
+
+    Run(&system, system.Memory(), *process, std::nullopt);
+}
+
+void GatewayCheat::Execute(Memory::MemorySystem& memory, const Kernel::Process& process,
+                           u32 pad_state) const {
+    Run(nullptr, memory, process, pad_state);
+}
+
+void GatewayCheat::Run(Core::System* system, Memory::MemorySystem& memory,
+                       const Kernel::Process& process, std::optional<u32> pad_state) const {
+    Context context{
+        .system = system,
+        .memory = memory,
+        .process = process,
+        .pointers = process.vm_manager.page_table->GetPointerArray(),
+        .instructions = program->instructions,
+        .patch_data = program->patch_data,
+        .pad_state = pad_state,
+    };
+    const auto& instructions = program->instructions;
+    for (u32 pc = 0; pc < instructions.size();) {
+        const Instruction& instruction = instructions[pc];
+        pc = instruction.handler(context, instruction, pc);
+    }
 }
 
 bool GatewayCheat::IsEnabled() const {
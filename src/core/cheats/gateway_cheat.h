@@ -6,10 +6,19 @@
 
 #include <atomic>
 #include <memory>
+#include <optional>
 #include <vector>
 #include "common/common_types.h"
 #include "core/cheats/cheat_base.h"
 
+namespace Kernel {
+class Process;
+}
+
+namespace Memory {
+class MemorySystem;
+}
+
 namespace Cheats {
 class GatewayCheat final : public CheatBase {
 public:
@@ -61,6 +70,14 @@ public:
 
     void Execute(Core::System& system, u32 process_id) const override;
 
+    /**
+     * Runs the cheat on the memory of a process outside of a running system, which leaves the
+     * CPU caches untouched.
+     * @param pad_state Pad buttons checked by the joker conditions.
+     */
+    void Execute(Memory::MemorySystem& memory, const Kernel::Process& process,
+                 u32 pad_state) const;
+
     bool IsEnabled() const override;
     void SetEnabled(bool enabled) override;
 
@@ -80,9 +97,19 @@ public:
     static std::vector<std::shared_ptr<CheatBase>> LoadFile(const std::string& filepath);
 
 private:
+    struct Program;
+
+    /// Translates the cheat lines into the program run by Execute.
+    void Compile();
+
+    /// Runs the program, the pad state is read from the system if not provided.
+    void Run(Core::System* system, Memory::MemorySystem& memory, const Kernel::Process& process,
+             std::optional<u32> pad_state) const;
+
     std::atomic<bool> enabled = false;
     const std::string name;
     std::vector<CheatLine> cheat_lines;
     const std::string comments;
+    std::unique_ptr<const Program> program;
 };
 } // namespace Cheats
@@ -0,0 +1,537 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <type_traits>
+#include "common/logging/log.h"
+#include "core/cheats/memory_scanner.h"
+#include "core/core.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/process.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CITRA_SCANNER_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#define CITRA_SCANNER_NEON
+#include <arm_neon.h>
+#endif
+
+namespace Cheats {
+
+namespace {
+
+/// Number of values covered by a word of the candidate bitsets
+constexpr std::size_t BlockValues = Detail::ScanBlockValues;
+
+#if defined(CITRA_SCANNER_SSE2)
+
+using Vector = __m128i;
+
+Vector Load(const u8* data) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+
+Vector Not(Vector v) {
+    return _mm_xor_si128(v, _mm_set1_epi32(-1));
+}
+
+template <typename T>
+Vector Splat(T value) {
+    if constexpr (std::is_same_v<T, float>) {
+        return _mm_castps_si128(_mm_set1_ps(value));
+    } else if constexpr (sizeof(T) == 1) {
+        return _mm_set1_epi8(static_cast<char>(value));
+    } else if constexpr (sizeof(T) == 2) {
+        return _mm_set1_epi16(static_cast<short>(value));
+    } else {
+        return _mm_set1_epi32(static_cast<int>(value));
+    }
+}
+
+/// Sets the lanes of a and b holding the same bits.
+template <typename T>
+Vector BitsEqual(Vector a, Vector b) {
+    if constexpr (sizeof(T) == 1) {
+        return _mm_cmpeq_epi8(a, b);
+    } else if constexpr (sizeof(T) == 2) {
+        return _mm_cmpeq_epi16(a, b);
+    } else {
+        return _mm_cmpeq_epi32(a, b);
+    }
+}
+
+template <typename T>
+Vector Equal(Vector a, Vector b) {
+    if constexpr (std::is_same_v<T, float>) {
+        return _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+    } else {
+        return BitsEqual<T>(a, b);
+    }
+}
+
+template <typename T>
+Vector InRange(Vector value, Vector low, Vector high) {
+    if constexpr (std::is_same_v<T, float>) {
+        const __m128 v = _mm_castsi128_ps(value);
+        return _mm_castps_si128(_mm_and_ps(_mm_cmpge_ps(v, _mm_castsi128_ps(low)),
+                                           _mm_cmple_ps(v, _mm_castsi128_ps(high))));
+    } else {
+        // SSE2 only has signed comparisons: low <= value <= high is value - low <= high - low
+        // with unsigned wrapping, and flipping the sign bits turns it into a signed comparison.
+        const Vector sign = Splat<T>(static_cast<T>(T{1} << (sizeof(T) * 8 - 1)));
+        if constexpr (sizeof(T) == 1) {
+            const Vector offset = _mm_xor_si128(_mm_sub_epi8(value, low), sign);
+            const Vector span = _mm_xor_si128(_mm_sub_epi8(high, low), sign);
+            return Not(_mm_cmpgt_epi8(offset, span));
+        } else if constexpr (sizeof(T) == 2) {
+            const Vector offset = _mm_xor_si128(_mm_sub_epi16(value, low), sign);
+            const Vector span = _mm_xor_si128(_mm_sub_epi16(high, low), sign);
+            return Not(_mm_cmpgt_epi16(offset, span));
+        } else {
+            const Vector offset = _mm_xor_si128(_mm_sub_epi32(value, low), sign);
+            const Vector span = _mm_xor_si128(_mm_sub_epi32(high, low), sign);
+            return Not(_mm_cmpgt_epi32(offset, span));
+        }
+    }
+}
+
+/// Returns one bit per lane, set for the lanes whose bits are all set.
+template <typename T>
+u32 MoveMask(Vector mask) {
+    if constexpr (sizeof(T) == 1) {
+        return static_cast<u32>(_mm_movemask_epi8(mask));
+    } else if constexpr (sizeof(T) == 2) {
+        return static_cast<u32>(_mm_movemask_epi8(_mm_packs_epi16(mask, _mm_setzero_si128())));
+    } else {
+        return static_cast<u32>(_mm_movemask_ps(_mm_castsi128_ps(mask)));
+    }
+}
+
+#elif defined(CITRA_SCANNER_NEON)
+
+using Vector = uint8x16_t;
+
+Vector Load(const u8* data) {
+    return vld1q_u8(data);
+}
+
+Vector Not(Vector v) {
+    return vmvnq_u8(v);
+}
+
+template <typename T>
+Vector Splat(T value) {
+    if constexpr (std::is_same_v<T, float>) {
+        return vreinterpretq_u8_f32(vdupq_n_f32(value));
+    } else if constexpr (sizeof(T) == 1) {
+        return vdupq_n_u8(value);
+    } else if constexpr (sizeof(T) == 2) {
+        return vreinterpretq_u8_u16(vdupq_n_u16(value));
+    } else {
+        return vreinterpretq_u8_u32(vdupq_n_u32(value));
+    }
+}
+
+/// Sets the lanes of a and b holding the same bits.
+template <typename T>
+Vector BitsEqual(Vector a, Vector b) {
+    if constexpr (sizeof(T) == 1) {
+        return vceqq_u8(a, b);
+    } else if constexpr (sizeof(T) == 2) {
+        return vreinterpretq_u8_u16(vceqq_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)));
+    } else {
+        return vreinterpretq_u8_u32(vceqq_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+    }
+}
+
+template <typename T>
+Vector Equal(Vector a, Vector b) {
+    if constexpr (std::is_same_v<T, float>) {
+        return vreinterpretq_u8_u32(vceqq_f32(vreinterpretq_f32_u8(a), vreinterpretq_f32_u8(b)));
+    } else {
+        return BitsEqual<T>(a, b);
+    }
+}
+
+template <typename T>
+Vector InRange(Vector value, Vector low, Vector high) {
+    if constexpr (std::is_same_v<T, float>) {
+        const float32x4_t v = vreinterpretq_f32_u8(value);
+        return vreinterpretq_u8_u32(vandq_u32(vcgeq_f32(v, vreinterpretq_f32_u8(low)),
+                                              vcleq_f32(v, vreinterpretq_f32_u8(high))));
+    } else if constexpr (sizeof(T) == 1) {
+        return vandq_u8(vcgeq_u8(value, low), vcleq_u8(value, high));
+    } else if constexpr (sizeof(T) == 2) {
+        const uint16x8_t v = vreinterpretq_u16_u8(value);
+        return vreinterpretq_u8_u16(vandq_u16(vcgeq_u16(v, vreinterpretq_u16_u8(low)),
+                                              vcleq_u16(v, vreinterpretq_u16_u8(high))));
+    } else {
+        const uint32x4_t v = vreinterpretq_u32_u8(value);
+        return vreinterpretq_u8_u32(vandq_u32(vcgeq_u32(v, vreinterpretq_u32_u8(low)),
+                                              vcleq_u32(v, vreinterpretq_u32_u8(high))));
+    }
+}
+
+/// Returns one bit per lane, set for the lanes whose bits are all set.
+template <typename T>
+u32 MoveMask(Vector mask) {
+    // NEON has no movemask, weight each lane by its bit and add the lanes together.
+    if constexpr (sizeof(T) == 1) {
+        static constexpr u8 weights[8] = {1, 2, 4, 8, 16, 32, 64, 128};
+        const uint8x8_t w = vld1_u8(weights);
+        return vaddv_u8(vand_u8(vget_low_u8(mask), w)) |
+               (static_cast<u32>(vaddv_u8(vand_u8(vget_high_u8(mask), w))) << 8);
+    } else if constexpr (sizeof(T) == 2) {
+        static constexpr u16 weights[8] = {1, 2, 4, 8, 16, 32, 64, 128};
+        return vaddvq_u16(vandq_u16(vreinterpretq_u16_u8(mask), vld1q_u16(weights)));
+    } else {
+        static constexpr u32 weights[4] = {1, 2, 4, 8};
+        return vaddvq_u32(vandq_u32(vreinterpretq_u32_u8(mask), vld1q_u32(weights)));
+    }
+}
+
+#endif
+
+#if defined(CITRA_SCANNER_SSE2) || defined(CITRA_SCANNER_NEON)
+#define CITRA_SCANNER_SIMD
+constexpr bool HasVectorizedScan = true;
+#else
+constexpr bool HasVectorizedScan = false;
+#endif
+
+// Each matcher compares either single values, or whole vectors when SIMD is available.
+
+template <typename T>
+struct EqualMatcher {
+    explicit EqualMatcher(T value_) : value{value_} {}
+
+    bool operator()(T current, T) const {
+        return current == value;
+    }
+
+    T value;
+#ifdef CITRA_SCANNER_SIMD
+    Vector operator()(Vector current, Vector) const {
+        return Equal<T>(current, value_vector);
+    }
+
+    Vector value_vector = Splat(value);
+#endif
+};
+
+template <typename T>
+struct RangeMatcher {
+    RangeMatcher(T low_, T high_) : low{low_}, high{high_} {}
+
+    bool operator()(T current, T) const {
+        return current >= low && current <= high;
+    }
+
+    T low;
+    T high;
+#ifdef CITRA_SCANNER_SIMD
+    Vector operator()(Vector current, Vector) const {
+        return InRange<T>(current, low_vector, high_vector);
+    }
+
+    Vector low_vector = Splat(low);
+    Vector high_vector = Splat(high);
+#endif
+};
+
+/// Compares the bits of the values with the previous scan, so that unchanged NaNs match.
+template <typename T>
+struct ChangedMatcher {
+    explicit ChangedMatcher(bool changed_) : changed{changed_} {}
+
+    bool operator()(T current, T previous) const {
+        return (std::memcmp(&current, &previous, sizeof(T)) != 0) == changed;
+    }
+
+    bool changed;
+#ifdef CITRA_SCANNER_SIMD
+    Vector operator()(Vector current, Vector previous) const {
+        const Vector same = BitsEqual<T>(current, previous);
+        return changed ? Not(same) : same;
+    }
+#endif
+};
+
+/// Returns the bits of the values of a block matched by the matcher.
+template <typename T, bool Vectorized, typename Matcher>
+u64 MatchBlock(const u8* current, const u8* previous, const Matcher& matcher) {
+    u64 mask = 0;
+#ifdef CITRA_SCANNER_SIMD
+    if constexpr (Vectorized) {
+        constexpr std::size_t Lanes = sizeof(Vector) / sizeof(T);
+        for (std::size_t i = 0; i < BlockValues / Lanes; ++i) {
+            const std::size_t offset = i * sizeof(Vector);
+            const Vector result = matcher(Load(current + offset), Load(previous + offset));
+            mask |= u64{MoveMask<T>(result)} << (i * Lanes);
+        }
+        return mask;
+    }
+#endif
+    for (std::size_t i = 0; i < BlockValues; ++i) {
+        T current_value;
+        T previous_value;
+        std::memcpy(&current_value, current + i * sizeof(T), sizeof(T));
+        std::memcpy(&previous_value, previous + i * sizeof(T), sizeof(T));
+        mask |= u64{matcher(current_value, previous_value)} << i;
+    }
+    return mask;
+}
+
+/// Filters the candidates of a region and copies the blocks still holding candidates.
+template <typename T, typename Matcher>
+void ScanRegion(std::vector<u64>& candidates, u8* snapshot, const u8* memory,
+                const Matcher& matcher) {
+    constexpr std::size_t BlockSize = BlockValues * sizeof(T);
+    for (std::size_t i = 0; i < candidates.size(); ++i) {
+        u64& word = candidates[i];
+        if (word == 0) {
+            continue;
+        }
+        const std::size_t offset = i * BlockSize;
+        word &= MatchBlock<T, HasVectorizedScan>(memory + offset, snapshot + offset, matcher);
+        if (word != 0) {
+            std::memcpy(snapshot + offset, memory + offset, BlockSize);
+        }
+    }
+}
+
+/// Calls func with the matcher implementing the filter.
+template <typename T, typename Func>
+void VisitMatcher(const ScanFilter& filter, Func&& func) {
+    const auto operand = [](u32 bits) {
+        if constexpr (std::is_same_v<T, float>) {
+            return std::bit_cast<float>(bits);
+        } else {
+            return static_cast<T>(bits);
+        }
+    };
+
+    switch (filter.comparison) {
+    case ScanComparison::Equal:
+        func(EqualMatcher<T>{operand(filter.first)});
+        break;
+    case ScanComparison::Range: {
+        const T first = operand(filter.first);
+        const T second = operand(filter.second);
+        func(RangeMatcher<T>{std::min(first, second), std::max(first, second)});
+        break;
+    }
+    case ScanComparison::Changed:
+    case ScanComparison::Unchanged:
+        func(ChangedMatcher<T>{filter.comparison == ScanComparison::Changed});
+        break;
+    }
+}
+
+template <typename T>
+void ScanRegion(std::vector<u64>& candidates, u8* snapshot, const u8* memory,
+                const ScanFilter& filter) {
+    VisitMatcher<T>(filter, [&](const auto& matcher) {
+        ScanRegion<T>(candidates, snapshot, memory, matcher);
+    });
+}
+
+template <bool Vectorized>
+u64 MatchTypedBlock(ScanValueType type, const ScanFilter& filter, const u8* current,
+                    const u8* previous) {
+    u64 mask = 0;
+    const auto match = [&]<typename T>() {
+        VisitMatcher<T>(filter, [&](const auto& matcher) {
+            mask = MatchBlock<T, Vectorized>(current, previous, matcher);
+        });
+    };
+    switch (type) {
+    case ScanValueType::U8:
+        match.template operator()<u8>();
+        break;
+    case ScanValueType::U16:
+        match.template operator()<u16>();
+        break;
+    case ScanValueType::U32:
+        match.template operator()<u32>();
+        break;
+    case ScanValueType::Float:
+        match.template operator()<float>();
+        break;
+    }
+    return mask;
+}
+
+std::size_t ValueSize(ScanValueType type) {
+    switch (type) {
+    case ScanValueType::U8:
+        return sizeof(u8);
+    case ScanValueType::U16:
+        return sizeof(u16);
+    case ScanValueType::U32:
+    case ScanValueType::Float:
+        return sizeof(u32);
+    }
+    return sizeof(u32);
+}
+
+} // Anonymous namespace
+
+namespace Detail {
+
+u64 MatchBlock(ScanValueType type, const ScanFilter& filter, const u8* current,
+               const u8* previous) {
+    return MatchTypedBlock<HasVectorizedScan>(type, filter, current, previous);
+}
+
+u64 MatchBlockScalar(ScanValueType type, const ScanFilter& filter, const u8* current,
+                     const u8* previous) {
+    return MatchTypedBlock<false>(type, filter, current, previous);
+}
+
+} // namespace Detail
+
+MemoryScanner::MemoryScanner(Core::System& system_) : system{system_} {}
+
+MemoryScanner::~MemoryScanner() = default;
+
+std::size_t MemoryScanner::Start(u32 process_id_, ScanValueType type_) {
+    std::scoped_lock lock{mutex};
+    regions.clear();
+    process_id = process_id_;
+    type = type_;
+
+    const auto process = system.Kernel().GetProcessById(process_id);
+    if (!process) {
+        LOG_ERROR(Core_Cheats, "Process {} does not exist", process_id);
+        return 0;
+    }
+
+    const std::size_t block_size = BlockValues * ValueSize(type);
+    for (const auto& [base, vma] : process->vm_manager.vma_map) {
+        const auto read_write = static_cast<u32>(Kernel::VMAPermission::ReadWrite);
+        if (vma.type != Kernel::VMAType::BackingMemory ||
+            vma.meminfo_state == Kernel::MemoryState::IO ||
+            (static_cast<u32>(vma.permissions) & read_write) != read_write) {
+            continue;
+        }
+        // The regions are made of whole pages, so they always hold a whole number of blocks.
+        const u8* memory = vma.backing_memory.GetPtr();
+        Region& region = regions.emplace_back();
+        region.base = vma.base;
+        region.size = vma.size;
+        region.candidates.assign(vma.size / block_size, ~u64{0});
+        region.snapshot.assign(memory, memory + vma.size);
+    }
+
+    const std::size_t count = CountCandidates();
+    LOG_INFO(Core_Cheats, "Started a memory search over {} regions, {} candidates",
+             regions.size(), count);
+    return count;
+}
+
+std::size_t MemoryScanner::Scan(const ScanFilter& filter) {
+    std::scoped_lock lock{mutex};
+    for (Region& region : regions) {
+        const u8* memory = GetRegionPointer(region);
+        if (!memory) {
+            // The region was unmapped, none of its values can be found anymore.
+            region.candidates.clear();
+            region.snapshot.clear();
+            continue;
+        }
+
+        switch (type) {
+        case ScanValueType::U8:
+            ScanRegion<u8>(region.candidates, region.snapshot.data(), memory, filter);
+            break;
+        case ScanValueType::U16:
+            ScanRegion<u16>(region.candidates, region.snapshot.data(), memory, filter);
+            break;
+        case ScanValueType::U32:
+            ScanRegion<u32>(region.candidates, region.snapshot.data(), memory, filter);
+            break;
+        case ScanValueType::Float:
+            ScanRegion<float>(region.candidates, region.snapshot.data(), memory, filter);
+            break;
+        }
+    }
+    return CountCandidates();
+}
+
+std::size_t MemoryScanner::GetCandidateCount() const {
+    std::scoped_lock lock{mutex};
+    return CountCandidates();
+}
+
+std::vector<ScanResult> MemoryScanner::GetResults(std::size_t first,
+                                                  std::size_t max_results) const {
+    std::scoped_lock lock{mutex};
+    const std::size_t value_size = ValueSize(type);
+    std::vector<ScanResult> results;
+    std::size_t skipped = 0;
+    for (const Region& region : regions) {
+        const u8* memory = GetRegionPointer(region);
+        if (!memory) {
+            continue;
+        }
+        for (std::size_t i = 0; i < region.candidates.size(); ++i) {
+            u64 word = region.candidates[i];
+            const auto word_count = static_cast<std::size_t>(std::popcount(word));
+            if (skipped + word_count <= first) {
+                skipped += word_count;
+                continue;
+            }
+            while (word != 0) {
+                const std::size_t index = i * BlockValues + std::countr_zero(word);
+                word &= word - 1;
+                if (skipped++ < first) {
+                    continue;
+                }
+                if (results.size() == max_results) {
+                    return results;
+                }
+                u32 value{};
+                std::memcpy(&value, memory + index * value_size, value_size);
+                results.push_back({static_cast<VAddr>(region.base + index * value_size), value});
+            }
+        }
+    }
+    return results;
+}
+
+void MemoryScanner::Reset() {
+    std::scoped_lock lock{mutex};
+    regions.clear();
+    regions.shrink_to_fit();
+}
+
+const u8* MemoryScanner::GetRegionPointer(const Region& region) const {
+    const auto process = system.Kernel().GetProcessById(process_id);
+    if (!process) {
+        return nullptr;
+    }
+    const auto& vm_manager = process->vm_manager;
+    const auto vma = vm_manager.FindVMA(region.base);
+    if (vma == vm_manager.vma_map.end() || vma->second.type != Kernel::VMAType::BackingMemory ||
+        vma->second.base + vma->second.size < region.base + region.size) {
+        return nullptr;
+    }
+    return vma->second.backing_memory.GetPtr() + (region.base - vma->second.base);
+}
+
+std::size_t MemoryScanner::CountCandidates() const {
+    std::size_t count = 0;
+    for (const Region& region : regions) {
+        for (const u64 word : region.candidates) {
+            count += static_cast<std::size_t>(std::popcount(word));
+        }
+    }
+    return count;
+}
+
+} // namespace Cheats
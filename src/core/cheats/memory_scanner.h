@@ -0,0 +1,125 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Core {
+class System;
+}
+
+namespace Cheats {
+
+enum class ScanValueType : u32 {
+    U8 = 0,
+    U16 = 1,
+    U32 = 2,
+    Float = 3,
+};
+
+enum class ScanComparison : u32 {
+    /// The value is equal to the first operand
+    Equal = 0,
+    /// The value is between the two operands, in any order, both included
+    Range = 1,
+    /// The value is different from the previous scan
+    Changed = 2,
+    /// The value is the same as in the previous scan
+    Unchanged = 3,
+};
+
+struct ScanFilter {
+    ScanComparison comparison;
+    /// Operands, holding the bits of the value for floats
+    u32 first;
+    u32 second;
+};
+
+struct ScanResult {
+    VAddr address;
+    /// Current value, holding the bits of the value for floats
+    u32 value;
+};
+
+namespace Detail {
+
+/// Number of values compared by MatchBlock
+constexpr std::size_t ScanBlockValues = 64;
+
+/**
+ * Returns one bit per value of a block of ScanBlockValues values matching the filter, comparing
+ * the current values with the previous ones. Uses the vectorized comparisons when available.
+ */
+u64 MatchBlock(ScanValueType type, const ScanFilter& filter, const u8* current,
+               const u8* previous);
+
+/// Same as MatchBlock, always comparing the values one by one.
+u64 MatchBlockScalar(ScanValueType type, const ScanFilter& filter, const u8* current,
+                     const u8* previous);
+
+} // namespace Detail
+
+/**
+ * Searches the writable memory of a process for the addresses holding a value, the way cheat
+ * finders do: a search starts with every aligned address as a candidate, and each scan keeps only
+ * the candidates matching a filter.
+ *
+ * The candidates are stored as one bit per aligned value, and the comparisons are vectorized, so
+ * that scanning all the FCRAM mapped by a process takes a few tens of milliseconds. The memory is
+ * copied after each scan for the next Changed and Unchanged comparisons; the blocks without any
+ * candidate left are neither compared nor copied anymore, so the scans get faster as the
+ * candidates are narrowed down.
+ */
+class MemoryScanner {
+public:
+    explicit MemoryScanner(Core::System& system);
+    ~MemoryScanner();
+
+    /**
+     * Starts a new search over the writable memory of a process.
+     * @returns the number of candidates, or 0 if the process does not exist.
+     */
+    std::size_t Start(u32 process_id, ScanValueType type);
+
+    /**
+     * Keeps only the candidates matching the filter.
+     * @returns the number of candidates left.
+     */
+    std::size_t Scan(const ScanFilter& filter);
+
+    /// Returns the number of candidates of the current search.
+    std::size_t GetCandidateCount() const;
+
+    /// Returns up to max_results candidates with their current value, skipping the first ones.
+    std::vector<ScanResult> GetResults(std::size_t first, std::size_t max_results) const;
+
+    /// Ends the current search, releasing its memory.
+    void Reset();
+
+private:
+    struct Region {
+        VAddr base;
+        u32 size;
+        /// One bit per aligned value of the region, set for the candidates
+        std::vector<u64> candidates;
+        /// Contents of the region at the last scan
+        std::vector<u8> snapshot;
+    };
+
+    /// Returns a pointer to the memory of the region, or nullptr if it is not mapped anymore.
+    const u8* GetRegionPointer(const Region& region) const;
+
+    std::size_t CountCandidates() const;
+
+    Core::System& system;
+    mutable std::mutex mutex;
+    u32 process_id{};
+    ScanValueType type{};
+    std::vector<Region> regions;
+};
+
+} // namespace Cheats
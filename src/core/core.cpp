@@ -36,6 +36,7 @@
 #include "core/hle/service/fs/archive.h"
 #include "core/hle/service/gsp/gsp.h"
 #include "core/hle/service/gsp/gsp_gpu.h"
+#include "core/hle/service/ipc_stats.h"
 #include "core/hle/service/ir/ir_rst.h"
 #include "core/hle/service/mic/mic_u.h"
 #include "core/hle/service/plgldr/plgldr.h"
@@ -397,6 +398,7 @@ System::ResultStatus System::Load(Frontend::EmuWindow& emu_window, const std::st
     cheat_engine.Connect(process->process_id);
 
     perf_stats = std::make_unique<PerfStats>(title_id);
+    Service::IPCStats::Reset();
 
     if (Settings::values.dump_textures) {
         custom_tex_manager->PrepareDumping(title_id);
@@ -423,8 +425,17 @@ void System::PrepareReschedule() {
 }
 
 PerfStats::Results System::GetAndResetPerfStats() {
-    return (perf_stats && timing) ? perf_stats->GetAndResetStats(timing->GetGlobalTimeUs())
-                                  : PerfStats::Results{};
+    if (!perf_stats || !timing) {
+        return PerfStats::Results{};
+    }
+    if (dsp_core) {
+        const AudioCore::AudioOutputStats audio = dsp_core->GetOutputStats();
+        const std::chrono::nanoseconds latency{static_cast<s64>(audio.queued_frames) *
+                                               1'000'000'000 / AudioCore::native_sample_rate};
+        perf_stats->SetAudioOutputStats(audio.underruns,
+                                        audio.overrun_frames + audio.skipped_frames, latency);
+    }
+    return perf_stats->GetAndResetStats(timing->GetGlobalTimeUs());
 }
 
 PerfStats::Results System::GetLastPerfStats() {
@@ -492,8 +503,13 @@ System::ResultStatus System::Init(Frontend::EmuWindow& emu_window,
     if (audio_emulation == Settings::AudioEmulation::HLE) {
         dsp_core = std::make_unique<AudioCore::DspHle>(*this);
     } else {
-        const bool multithread = audio_emulation == Settings::AudioEmulation::LLEMultithreaded;
-        dsp_core = std::make_unique<AudioCore::DspLle>(*this, multithread);
+        auto threading = AudioCore::LleThreading::None;
+        if (audio_emulation == Settings::AudioEmulation::LLEMultithreaded) {
+            threading = AudioCore::LleThreading::Lockstep;
+        } else if (audio_emulation == Settings::AudioEmulation::LLERunAhead) {
+            threading = AudioCore::LleThreading::RunAhead;
+        }
+        dsp_core = std::make_unique<AudioCore::DspLle>(*this, threading);
     }
 
     memory->SetDSP(*dsp_core);
@@ -501,6 +517,7 @@ System::ResultStatus System::Init(Frontend::EmuWindow& emu_window,
     dsp_core->SetSink(Settings::values.output_type.GetValue(),
                       Settings::values.output_device.GetValue());
     dsp_core->EnableStretching(Settings::values.enable_audio_stretching.GetValue());
+    dsp_core->EnableAdaptiveLatency(Settings::values.enable_adaptive_audio_latency.GetValue());
 
 #ifdef ENABLE_SCRIPTING
     if (Settings::values.enable_rpc_server.GetValue()) {
@@ -715,6 +732,7 @@ void System::ApplySettings() {
         dsp_core->SetSink(Settings::values.output_type.GetValue(),
                           Settings::values.output_device.GetValue());
         dsp_core->EnableStretching(Settings::values.enable_audio_stretching.GetValue());
+        dsp_core->EnableAdaptiveLatency(Settings::values.enable_adaptive_audio_latency.GetValue());
 
         auto hid = Service::HID::GetModule(*this);
         if (hid) {
@@ -183,6 +183,19 @@ public:
         }
     }
 
+    void ReportInputLatency(std::chrono::nanoseconds latency) {
+        if (perf_stats) {
+            perf_stats->AddInputLatency(latency);
+        }
+    }
+
+    void ReportUDSFrames(u32 frames, std::chrono::nanoseconds total_delay,
+                         std::chrono::nanoseconds max_delay) {
+        if (perf_stats) {
+            perf_stats->AddUDSFrames(frames, total_delay, max_delay);
+        }
+    }
+
     [[nodiscard]] PerfStats::Results GetLastPerfStats();
 
     double GetStableFrameTimeScale();
@@ -11,6 +11,13 @@ VideoFrame::VideoFrame(std::size_t width_, std::size_t height_, u8* data_)
     : width(width_), height(height_), stride(static_cast<u32>(width * 4)),
       data(data_, data_ + width * height * 4) {}
 
+void VideoFrame::CopyFrom(std::size_t width_, std::size_t height_, const u8* data_) {
+    width = width_;
+    height = height_;
+    stride = static_cast<u32>(width * 4);
+    data.assign(data_, data_ + width * height * 4);
+}
+
 Backend::~Backend() = default;
 NullBackend::~NullBackend() = default;
 
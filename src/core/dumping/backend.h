@@ -23,13 +23,17 @@ public:
     std::vector<u8> data;
 
     VideoFrame(std::size_t width_ = 0, std::size_t height_ = 0, u8* data_ = nullptr);
+
+    /// Copies a frame into this one, reusing the storage of the data.
+    void CopyFrom(std::size_t width_, std::size_t height_, const u8* data_);
 };
 
 class Backend {
 public:
     virtual ~Backend();
     virtual bool StartDumping(const std::string& path, const Layout::FramebufferLayout& layout) = 0;
-    virtual void AddVideoFrame(VideoFrame frame) = 0;
+    /// Adds a frame of width x height pixels, copying the data.
+    virtual void AddVideoFrame(std::size_t width, std::size_t height, const u8* data) = 0;
     virtual void AddAudioFrame(AudioCore::StereoFrame16 frame) = 0;
     virtual void AddAudioSample(const std::array<s16, 2>& sample) = 0;
     virtual void StopDumping() = 0;
@@ -44,7 +48,8 @@ public:
                       const Layout::FramebufferLayout& /*layout*/) override {
         return false;
     }
-    void AddVideoFrame(VideoFrame /*frame*/) override {}
+    void AddVideoFrame(std::size_t /*width*/, std::size_t /*height*/,
+                       const u8* /*data*/) override {}
     void AddAudioFrame(AudioCore::StereoFrame16 /*frame*/) override {}
     void AddAudioSample(const std::array<s16, 2>& /*sample*/) override {}
     void StopDumping() override {}
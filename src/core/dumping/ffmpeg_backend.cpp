@@ -149,7 +149,6 @@ bool FFmpegVideoStream::Init(FFmpegMuxer& muxer, const Layout::FramebufferLayout
     }
 
     layout = layout_;
-    frame_count = 0;
 
     // Initialize video codec
     const AVCodec* codec =
@@ -195,6 +194,10 @@ bool FFmpegVideoStream::Init(FFmpegMuxer& muxer, const Layout::FramebufferLayout
         codec_context->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
     }
 
+    // Let the encoder pick its number of threads, unless set in the options
+    codec_context->thread_count = 0;
+    codec_context->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+
     if (FFmpeg::avcodec_open2(codec_context.get(), codec, &options) < 0) {
         LOG_ERROR(Render, "Could not open video codec");
         return false;
@@ -242,7 +245,7 @@ void FFmpegVideoStream::Free() {
     sink_context = nullptr;
 }
 
-void FFmpegVideoStream::ProcessFrame(VideoFrame& frame) {
+void FFmpegVideoStream::ProcessFrame(VideoFrame& frame, u64 frame_number) {
     if (frame.width != layout.width || frame.height != layout.height) {
         LOG_ERROR(Render, "Frame dropped: resolution does not match");
         return;
@@ -253,7 +256,8 @@ void FFmpegVideoStream::ProcessFrame(VideoFrame& frame) {
     current_frame->format = pixel_format;
     current_frame->width = layout.width;
     current_frame->height = layout.height;
-    current_frame->pts = frame_count++;
+    // The fps filter repeats the previous frame in place of the dropped ones
+    current_frame->pts = frame_number;
 
     // Filter the frame
     if (FFmpeg::av_buffersrc_add_frame(source_context, current_frame.get()) < 0) {
@@ -373,6 +377,11 @@ bool FFmpegVideoStream::InitHWContext(const AVCodec* codec) {
 bool FFmpegVideoStream::InitFilters() {
     filter_graph.reset(FFmpeg::avfilter_graph_alloc());
 
+#if LIBAVFILTER_VERSION_MAJOR >= 8 // FFmpeg 5.0, where swscale got its threads option
+    // Let the pixel format conversion inserted by the graph pick its number of threads
+    filter_graph->scale_sws_opts = FFmpeg::av_strdup("threads=0");
+#endif
+
     const AVFilter* source = FFmpeg::avfilter_get_by_name("buffer");
     const AVFilter* sink = FFmpeg::avfilter_get_by_name("buffersink");
     if (!source || !sink) {
@@ -709,8 +718,8 @@ void FFmpegMuxer::Free() {
     format_context.reset();
 }
 
-void FFmpegMuxer::ProcessVideoFrame(VideoFrame& frame) {
-    video_stream.ProcessFrame(frame);
+void FFmpegMuxer::ProcessVideoFrame(VideoFrame& frame, u64 frame_number) {
+    video_stream.ProcessFrame(frame, frame_number);
 }
 
 void FFmpegMuxer::ProcessAudioFrame(const VariableAudioFrame& channel0,
@@ -753,26 +762,24 @@ bool FFmpegBackend::StartDumping(const std::string& path, const Layout::Framebuf
     }
 
     video_layout = layout;
+    video_frame_count = 0;
+    dropped_video_frames = 0;
+    drop_video_frames = Settings::values.drop_video_frames;
+    video_frame_queue.Open(VideoQueueSize);
+
+    audio_block_queue.Open(AudioQueueSize);
+    current_audio_block = nullptr;
 
     if (video_processing_thread.joinable()) {
         video_processing_thread.join();
     }
     video_processing_thread = std::thread([&] {
-        event1.Set();
-        while (true) {
-            event2.Wait();
-            current_buffer = (current_buffer + 1) % 2;
-            next_buffer = (current_buffer + 1) % 2;
-            event1.Set();
-            // Process this frame
-            auto& frame = video_frame_buffers[current_buffer];
-            if (frame.width == 0 && frame.height == 0) {
-                // An empty frame marks the end of frame data
-                ffmpeg.FlushVideo();
-                break;
-            }
-            ffmpeg.ProcessVideoFrame(frame);
+        while (auto* queued = video_frame_queue.GetQueued()) {
+            ffmpeg.ProcessVideoFrame(queued->frame, queued->frame_number);
+            video_frame_queue.Pop();
         }
+        // The queue is closed at the end of frame data
+        ffmpeg.FlushVideo();
         // Finish audio execution first if not done yet
         if (audio_processing_thread.joinable())
             audio_processing_thread.join();
@@ -783,17 +790,12 @@ bool FFmpegBackend::StartDumping(const std::string& path, const Layout::Framebuf
         audio_processing_thread.join();
     }
     audio_processing_thread = std::thread([&] {
-        VariableAudioFrame channel0, channel1;
-        while (true) {
-            channel0 = audio_frame_queues[0].PopWait();
-            channel1 = audio_frame_queues[1].PopWait();
-            if (channel0.empty()) {
-                // An empty frame marks the end of frame data
-                ffmpeg.FlushAudio();
-                break;
-            }
-            ffmpeg.ProcessAudioFrame(channel0, channel1);
+        while (auto* block = audio_block_queue.GetQueued()) {
+            ffmpeg.ProcessAudioFrame(block->channel0, block->channel1);
+            audio_block_queue.Pop();
         }
+        // The queue is closed at the end of frame data
+        ffmpeg.FlushAudio();
     });
 
     renderer.PrepareVideoDumping();
@@ -802,43 +804,74 @@ bool FFmpegBackend::StartDumping(const std::string& path, const Layout::Framebuf
     return true;
 }
 
-void FFmpegBackend::AddVideoFrame(VideoFrame frame) {
-    event1.Wait();
-    video_frame_buffers[next_buffer] = std::move(frame);
-    event2.Set();
+void FFmpegBackend::AddVideoFrame(std::size_t width, std::size_t height, const u8* data) {
+    const u64 frame_number = video_frame_count++;
+    auto* queued = video_frame_queue.GetFree(!drop_video_frames);
+    if (!queued) {
+        ++dropped_video_frames;
+        return;
+    }
+    queued->frame.CopyFrom(width, height, data);
+    queued->frame_number = frame_number;
+    video_frame_queue.Push();
 }
 
-void FFmpegBackend::AddAudioFrame(AudioCore::StereoFrame16 frame) {
-    std::array<VariableAudioFrame, 2> refactored_frame;
-    for (auto& channel : refactored_frame) {
-        channel.resize(frame.size());
+void FFmpegBackend::AppendAudioSample(const std::array<s16, 2>& sample) {
+    if (!current_audio_block) {
+        // Audio is never dropped, this only waits when the encoder is far behind
+        current_audio_block = audio_block_queue.GetFree(true);
+        if (!current_audio_block) {
+            return;
+        }
+        current_audio_block->channel0.reserve(AudioBlockSize);
+        current_audio_block->channel1.reserve(AudioBlockSize);
+        current_audio_block->channel0.clear();
+        current_audio_block->channel1.clear();
     }
-    for (std::size_t i = 0; i < frame.size(); i++) {
-        refactored_frame[0][i] = frame[i][0];
-        refactored_frame[1][i] = frame[i][1];
+    current_audio_block->channel0.push_back(sample[0]);
+    current_audio_block->channel1.push_back(sample[1]);
+    if (current_audio_block->channel0.size() == AudioBlockSize) {
+        QueueAudioBlock();
     }
+}
 
-    audio_frame_queues[0].Push(std::move(refactored_frame[0]));
-    audio_frame_queues[1].Push(std::move(refactored_frame[1]));
+void FFmpegBackend::QueueAudioBlock() {
+    if (current_audio_block && !current_audio_block->channel0.empty()) {
+        audio_block_queue.Push();
+    }
+    current_audio_block = nullptr;
+}
+
+void FFmpegBackend::AddAudioFrame(AudioCore::StereoFrame16 frame) {
+    std::scoped_lock lock{audio_block_mutex};
+    for (const auto& sample : frame) {
+        AppendAudioSample(sample);
+    }
 }
 
 void FFmpegBackend::AddAudioSample(const std::array<s16, 2>& sample) {
-    audio_frame_queues[0].Push(VariableAudioFrame{sample[0]});
-    audio_frame_queues[1].Push(VariableAudioFrame{sample[1]});
+    std::scoped_lock lock{audio_block_mutex};
+    AppendAudioSample(sample);
 }
 
 void FFmpegBackend::StopDumping() {
     is_dumping = false;
     renderer.CleanupVideoDumping();
 
-    // Flush the video processing queue
-    AddVideoFrame(VideoFrame());
-    for (auto i : {0, 1}) {
-        // Flush the audio processing queue
-        audio_frame_queues[i].Push(VariableAudioFrame());
+    // Flush the processing queues
+    {
+        std::scoped_lock lock{audio_block_mutex};
+        QueueAudioBlock();
+        audio_block_queue.Close();
     }
+    video_frame_queue.Close();
     // Wait until processing ends
     processing_ended.Wait();
+
+    if (dropped_video_frames > 0) {
+        LOG_INFO(Render, "Dropped {} of {} video frames", dropped_video_frames.load(),
+                 video_frame_count.load());
+    }
 }
 
 bool FFmpegBackend::IsDumping() const {
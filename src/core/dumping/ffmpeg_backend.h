@@ -15,7 +15,6 @@
 #include "common/common_types.h"
 #include "common/dynamic_library/ffmpeg.h"
 #include "common/thread.h"
-#include "common/threadsafe_queue.h"
 #include "core/dumping/backend.h"
 
 namespace VideoCore {
@@ -78,14 +77,13 @@ public:
 
     bool Init(FFmpegMuxer& muxer, const Layout::FramebufferLayout& layout);
     void Free();
-    void ProcessFrame(VideoFrame& frame);
+    /// Processes the frame_number-th frame. The numbers of the dropped frames are skipped.
+    void ProcessFrame(VideoFrame& frame, u64 frame_number);
 
 private:
     bool InitHWContext(const AVCodec* codec);
     bool InitFilters();
 
-    u64 frame_count{};
-
     std::unique_ptr<AVFrame, AVFrameDeleter> current_frame{};
     std::unique_ptr<AVFrame, AVFrameDeleter> filtered_frame{};
     std::unique_ptr<AVFrame, AVFrameDeleter> hw_frame{};
@@ -157,7 +155,7 @@ public:
 
     bool Init(const std::string& path, const Layout::FramebufferLayout& layout);
     void Free();
-    void ProcessVideoFrame(VideoFrame& frame);
+    void ProcessVideoFrame(VideoFrame& frame, u64 frame_number);
     void ProcessAudioFrame(const VariableAudioFrame& channel0, const VariableAudioFrame& channel1);
     void FlushVideo();
     void FlushAudio();
@@ -179,16 +177,100 @@ private:
     friend class FFmpegStream;
 };
 
+/**
+ * A bounded queue of buffers passed from a producer thread to a consumer thread. The buffers are
+ * reused, so that they keep their storage from one use to the next.
+ */
+template <typename T>
+class BufferQueue {
+public:
+    /// Empties and reopens the queue, with room for capacity buffers.
+    void Open(std::size_t capacity) {
+        std::scoped_lock lock{mutex};
+        buffers.resize(capacity);
+        read_index = write_index = 0;
+        closed = false;
+    }
+
+    /// Closes the queue. The consumer still gets the queued buffers, and the producer gets none.
+    void Close() {
+        {
+            std::scoped_lock lock{mutex};
+            closed = true;
+        }
+        buffer_pushed.notify_all();
+        buffer_popped.notify_all();
+    }
+
+    /**
+     * Gets the next free buffer to fill, then pushed with Push.
+     * @param wait Whether to wait for a buffer when they are all queued, instead of returning null
+     * @returns The free buffer, or null if there is none or the queue is closed
+     */
+    T* GetFree(bool wait) {
+        std::unique_lock lock{mutex};
+        if (wait) {
+            buffer_popped.wait(lock, [this] { return closed || !IsFull(); });
+        }
+        if (closed || IsFull()) {
+            return nullptr;
+        }
+        return &buffers[write_index % buffers.size()];
+    }
+
+    /// Queues the buffer returned by GetFree.
+    void Push() {
+        {
+            std::scoped_lock lock{mutex};
+            ++write_index;
+        }
+        buffer_pushed.notify_one();
+    }
+
+    /// Waits for the next queued buffer, then released with Pop. Returns null once the queue is
+    /// closed and empty.
+    T* GetQueued() {
+        std::unique_lock lock{mutex};
+        buffer_pushed.wait(lock, [this] { return closed || read_index != write_index; });
+        if (read_index == write_index) {
+            return nullptr;
+        }
+        return &buffers[read_index % buffers.size()];
+    }
+
+    /// Releases the buffer returned by GetQueued.
+    void Pop() {
+        {
+            std::scoped_lock lock{mutex};
+            ++read_index;
+        }
+        buffer_popped.notify_one();
+    }
+
+private:
+    bool IsFull() const {
+        return write_index - read_index == buffers.size();
+    }
+
+    std::mutex mutex;
+    std::condition_variable buffer_pushed;
+    std::condition_variable buffer_popped;
+    std::vector<T> buffers;
+    std::size_t read_index = 0;
+    std::size_t write_index = 0;
+    bool closed = false;
+};
+
 /**
  * FFmpeg video dumping backend.
- * This class implements a double buffer.
+ * The frames are queued in pooled buffers, and processed by a video and an audio thread.
  */
 class FFmpegBackend : public Backend {
 public:
     FFmpegBackend(VideoCore::RendererBase& renderer);
     ~FFmpegBackend() override;
     bool StartDumping(const std::string& path, const Layout::FramebufferLayout& layout) override;
-    void AddVideoFrame(VideoFrame frame) override;
+    void AddVideoFrame(std::size_t width, std::size_t height, const u8* data) override;
     void AddAudioFrame(AudioCore::StereoFrame16 frame) override;
     void AddAudioSample(const std::array<s16, 2>& sample) override;
     void StopDumping() override;
@@ -196,6 +278,26 @@ public:
     Layout::FramebufferLayout GetLayout() const override;
 
 private:
+    struct QueuedVideoFrame {
+        VideoFrame frame;
+        u64 frame_number;
+    };
+
+    struct AudioBlock {
+        VariableAudioFrame channel0;
+        VariableAudioFrame channel1;
+    };
+
+    /// Number of video frames that can wait for the encoder
+    static constexpr std::size_t VideoQueueSize = 4;
+    /// Number of samples of the audio blocks, the audio is queued a block at a time
+    static constexpr std::size_t AudioBlockSize = 1024;
+    /// Number of audio blocks that can wait for the encoder
+    static constexpr std::size_t AudioQueueSize = 16;
+
+    /// Adds a sample to the current audio block, queuing the block once it is full.
+    void AppendAudioSample(const std::array<s16, 2>& sample);
+    void QueueAudioBlock();
     void EndDumping();
 
     VideoCore::RendererBase& renderer;
@@ -204,12 +306,15 @@ private:
     FFmpegMuxer ffmpeg{};
 
     Layout::FramebufferLayout video_layout;
-    std::array<VideoFrame, 2> video_frame_buffers;
-    u32 current_buffer = 0, next_buffer = 1;
-    Common::Event event1, event2;
+    BufferQueue<QueuedVideoFrame> video_frame_queue;
+    std::atomic<u64> video_frame_count = 0;
+    std::atomic<u64> dropped_video_frames = 0;
+    bool drop_video_frames = false;
     std::thread video_processing_thread;
 
-    std::array<Common::SPSCQueue<VariableAudioFrame>, 2> audio_frame_queues;
+    BufferQueue<AudioBlock> audio_block_queue;
+    std::mutex audio_block_mutex;
+    AudioBlock* current_audio_block = nullptr; ///< Guarded by audio_block_mutex
     std::thread audio_processing_thread;
 
     Common::Event processing_ended;
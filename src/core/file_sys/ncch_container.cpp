@@ -353,7 +353,7 @@ Loader::ResultStatus NCCHContainer::Load() {
         // DLC can have an ExeFS and a RomFS but no extended header
         if (ncch_header.exefs_size) {
             exefs_offset = ncch_header.exefs_offset * block_size;
-            u32 exefs_size = ncch_header.exefs_size * block_size;
+            exefs_size = ncch_header.exefs_size * block_size;
 
             LOG_DEBUG(Service_FS, "ExeFS offset:                0x{:08X}", exefs_offset);
             LOG_DEBUG(Service_FS, "ExeFS size:                  0x{:08X}", exefs_size);
@@ -397,6 +397,7 @@ Loader::ResultStatus NCCHContainer::LoadOverrides() {
         if (exefs_file->ReadBytes(&exefs_header, sizeof(ExeFs_Header)) == sizeof(ExeFs_Header)) {
             LOG_DEBUG(Service_FS, "Loading ExeFS section from {}", exefs_override);
             exefs_offset = 0;
+            exefs_size = exefs_file->GetSize();
             is_tainted = true;
             has_exefs = true;
         } else {
@@ -484,14 +485,12 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
             s64 section_offset =
                 is_proto ? section.offset
                          : (section.offset + exefs_offset + sizeof(ExeFs_Header) + ncch_offset);
-            exefs_file->Seek(section_offset, SEEK_SET);
-
             size_t section_size = is_proto ? Common::AlignUp(section.size, 0x10) : section.size;
 
             if (strcmp(section.name, ".code") == 0 && is_compressed) {
                 // Section is compressed, read compressed .code section...
                 std::vector<u8> temp_buffer(section_size);
-                if (exefs_file->ReadBytes(temp_buffer.data(), temp_buffer.size()) !=
+                if (ReadExeFS(temp_buffer.data(), temp_buffer.size(), section_offset) !=
                     temp_buffer.size())
                     return Loader::ResultStatus::Error;
 
@@ -503,7 +502,7 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
             } else {
                 // Section is uncompressed...
                 buffer.resize(section_size);
-                if (exefs_file->ReadBytes(buffer.data(), section_size) != section_size)
+                if (ReadExeFS(buffer.data(), section_size, section_offset) != section_size)
                     return Loader::ResultStatus::Error;
             }
 
@@ -641,8 +640,16 @@ Loader::ResultStatus NCCHContainer::ReadRomFS(std::shared_ptr<RomFSReader>& romf
     if (!romfs_file_inner->IsOpen())
         return Loader::ResultStatus::Error;
 
+    // Plain images can be served straight from a memory mapping, everything else
+    // (compressed or crypto files) has to go through the IOFile.
     std::shared_ptr<RomFSReader> direct_romfs =
-        std::make_shared<DirectRomFSReader>(std::move(romfs_file_inner), romfs_offset, romfs_size);
+        MappedRomFSReader::TryCreate(*romfs_file_inner, romfs_offset, romfs_size);
+    if (direct_romfs) {
+        LOG_DEBUG(Service_FS, "Using memory mapped RomFS for {}", filepath);
+    } else {
+        direct_romfs = std::make_shared<DirectRomFSReader>(std::move(romfs_file_inner),
+                                                           romfs_offset, romfs_size);
+    }
 
     const auto path =
         fmt::format("{}mods/{:016X}/", FileUtil::GetUserPath(FileUtil::UserPath::LoadDir),
@@ -766,6 +773,35 @@ bool NCCHContainer::HasExHeader() {
     return has_exheader;
 }
 
+std::size_t NCCHContainer::ReadExeFS(u8* buffer, std::size_t length, std::size_t offset) {
+    if (!exefs_mapping_attempted) {
+        exefs_mapping_attempted = true;
+        // Only the ExeFS is mapped, the RomFS reader maps the rest of the image on its own.
+        exefs_mapping = std::make_unique<FileUtil::MappedFile>(
+            *exefs_file, exefs_offset + ncch_offset, exefs_size);
+        if (exefs_mapping->IsOpen()) {
+            // The ExeFS is only read once while booting, from start to end.
+            exefs_mapping->Advise(exefs_mapping->GetOffset(), exefs_mapping->GetSize(),
+                                  FileUtil::MappedFile::AccessHint::Sequential);
+        } else {
+            exefs_mapping.reset();
+        }
+    }
+
+    // Sections of prototype images are not always located inside the ExeFS, those are read from
+    // the file.
+    if (exefs_mapping) {
+        const auto src = exefs_mapping->Span(offset, length);
+        if (src.size() == length) {
+            std::memcpy(buffer, src.data(), src.size());
+            return src.size();
+        }
+    }
+
+    exefs_file->Seek(offset, SEEK_SET);
+    return exefs_file->ReadBytes(buffer, length);
+}
+
 std::unique_ptr<FileUtil::IOFile> NCCHContainer::Reopen(
     const std::unique_ptr<FileUtil::IOFile>& orig_file, const std::string& new_filename) {
     const bool is_compressed = orig_file->IsCompressed();
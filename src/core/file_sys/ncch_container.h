@@ -11,6 +11,7 @@
 #include "common/bit_field.h"
 #include "common/common_types.h"
 #include "common/file_util.h"
+#include "common/mapped_file.h"
 #include "common/swap.h"
 #include "core/file_sys/romfs_reader.h"
 #include "core/loader/loader.h"
@@ -353,6 +354,12 @@ private:
     std::unique_ptr<FileUtil::IOFile> Reopen(const std::unique_ptr<FileUtil::IOFile>& orig_file,
                                              const std::string& new_filename = "");
 
+    /**
+     * Reads data from the ExeFS file, directly from a memory mapping of it when possible.
+     * @returns the amount of bytes read.
+     */
+    std::size_t ReadExeFS(u8* buffer, std::size_t length, std::size_t offset);
+
     bool has_header = false;
     bool has_exheader = false;
     bool has_exefs = false;
@@ -366,11 +373,14 @@ private:
 
     u32 ncch_offset = 0; // Offset to NCCH header, can be 0 for NCCHs or non-zero for CIAs/NCSDs
     u32 exefs_offset = 0;
+    u64 exefs_size = 0;
     u32 partition = 0;
 
     std::string filepath;
     std::unique_ptr<FileUtil::IOFile> file;
     std::unique_ptr<FileUtil::IOFile> exefs_file;
+    std::unique_ptr<FileUtil::MappedFile> exefs_mapping;
+    bool exefs_mapping_attempted = false;
 };
 
 } // namespace FileSys
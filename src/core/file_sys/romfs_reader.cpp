@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <cstring>
 #include <vector>
 #include <cryptopp/aes.h>
 #include <cryptopp/modes.h>
@@ -15,6 +16,7 @@
 #include "core/loader/loader.h"
 
 SERIALIZE_EXPORT_IMPL(FileSys::DirectRomFSReader)
+SERIALIZE_EXPORT_IMPL(FileSys::MappedRomFSReader)
 
 namespace FileSys {
 
@@ -107,6 +109,48 @@ std::vector<std::pair<std::size_t, std::size_t>> DirectRomFSReader::BreakupRead(
     return ret;
 }
 
+MappedRomFSReader::MappedRomFSReader(std::shared_ptr<FileUtil::MappedFile> mapping_,
+                                     std::size_t file_offset, std::size_t data_size)
+    : mapping(std::move(mapping_)), file_offset(file_offset), data_size(data_size) {
+    // RomFS accesses jump around the whole image, so avoid useless kernel readahead.
+    mapping->Advise(file_offset, data_size, FileUtil::MappedFile::AccessHint::Random);
+}
+
+std::shared_ptr<MappedRomFSReader> MappedRomFSReader::TryCreate(FileUtil::IOFile& file,
+                                                                std::size_t file_offset,
+                                                                std::size_t data_size) {
+    auto mapping = std::make_shared<FileUtil::MappedFile>(file);
+    if (!mapping->IsOpen() || mapping->GetSize() < file_offset + data_size) {
+        return nullptr;
+    }
+    auto reader = std::make_shared<MappedRomFSReader>(std::move(mapping), file_offset, data_size);
+    reader->filename = file.Filename();
+    return reader;
+}
+
+std::size_t MappedRomFSReader::ReadFile(std::size_t offset, std::size_t length, u8* buffer) {
+    if (offset >= data_size)
+        return 0;
+    length = std::min(length, static_cast<std::size_t>(data_size) - offset);
+
+    const auto src = mapping->Span(file_offset + offset, length);
+    if (length > async_read_threshold) {
+        // Large reads are mostly whole files being streamed, let the kernel read ahead.
+        mapping->Advise(file_offset + offset, length, FileUtil::MappedFile::AccessHint::WillNeed);
+    }
+    std::memcpy(buffer, src.data(), src.size());
+    LOG_TRACE(Service_FS, "RomFS mapped read: offset={}, length={}", offset, src.size());
+    return src.size();
+}
+
+bool MappedRomFSReader::AllowsCachedReads() const {
+    return true;
+}
+
+bool MappedRomFSReader::CacheReady(std::size_t file_offset, std::size_t length) {
+    return length <= async_read_threshold;
+}
+
 ArticRomFSReader::ArticRomFSReader(std::shared_ptr<Network::ArticBase::Client>& cli,
                                    bool is_update_romfs)
     : client(cli), cache(cli) {
@@ -12,6 +12,7 @@
 #include "common/alignment.h"
 #include "common/common_types.h"
 #include "common/file_util.h"
+#include "common/mapped_file.h"
 #include "common/static_lru_cache.h"
 #include "core/file_sys/artic_cache.h"
 #include "network/artic_base/artic_base_client.h"
@@ -93,6 +94,61 @@ private:
     friend class boost::serialization::access;
 };
 
+/**
+ * A RomFS reader that serves reads straight from a memory mapping of the RomFS file.
+ * Only usable for files that are neither compressed nor encrypted.
+ */
+class MappedRomFSReader : public RomFSReader {
+public:
+    MappedRomFSReader(std::shared_ptr<FileUtil::MappedFile> mapping, std::size_t file_offset,
+                      std::size_t data_size);
+
+    ~MappedRomFSReader() override = default;
+
+    /**
+     * Maps the given file and creates a reader for it.
+     * @returns nullptr if the file cannot be mapped, in which case a DirectRomFSReader
+     * should be used instead.
+     */
+    static std::shared_ptr<MappedRomFSReader> TryCreate(FileUtil::IOFile& file,
+                                                        std::size_t file_offset,
+                                                        std::size_t data_size);
+
+    std::size_t GetSize() const override {
+        return data_size;
+    }
+
+    std::size_t ReadFile(std::size_t offset, std::size_t length, u8* buffer) override;
+
+    bool AllowsCachedReads() const override;
+
+    bool CacheReady(std::size_t file_offset, std::size_t length) override;
+
+private:
+    // Reads bigger than this may fault in many pages, so they are done asynchronously
+    static constexpr std::size_t async_read_threshold = (1 << 13); // About 8KB
+
+    std::shared_ptr<FileUtil::MappedFile> mapping;
+    std::string filename;
+    u64 file_offset = 0;
+    u64 data_size = 0;
+
+    MappedRomFSReader() = default;
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int) {
+        ar& boost::serialization::base_object<RomFSReader>(*this);
+        ar& FileUtil::Path::make(filename);
+        ar & file_offset;
+        ar & data_size;
+        if (Archive::is_loading::value) {
+            FileUtil::IOFile file(filename, "rb");
+            mapping = std::make_shared<FileUtil::MappedFile>(file);
+        }
+    }
+    friend class boost::serialization::access;
+};
+
 /**
  * A RomFS reader that reads from an artic base server.
  */
@@ -142,4 +198,5 @@ private:
 } // namespace FileSys
 
 BOOST_CLASS_EXPORT_KEY(FileSys::DirectRomFSReader)
+BOOST_CLASS_EXPORT_KEY(FileSys::MappedRomFSReader)
 BOOST_CLASS_EXPORT_KEY(FileSys::ArticRomFSReader)
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <tuple>
@@ -15,6 +16,9 @@
 
 namespace Input {
 
+/// The monotonic clock timestamping the status changes of the input devices.
+using Clock = std::chrono::steady_clock;
+
 /// An abstract class template for an input device (a button, an analog input, etc.).
 template <typename StatusType>
 class InputDevice {
@@ -23,6 +27,11 @@ public:
     virtual StatusType GetStatus() const {
         return {};
     }
+    /// Returns when the backend received the last change of the status, or the epoch if the
+    /// device does not keep track of it.
+    virtual Clock::time_point GetLastChangeTime() const {
+        return {};
+    }
 };
 
 /// An abstract class template for a factory that can create input devices.
@@ -12,6 +12,8 @@
 #include <cstring>
 #include <map>
 #include <numeric>
+#include <string_view>
+#include <vector>
 #include <fcntl.h>
 #include <fmt/format.h>
 
@@ -31,6 +33,7 @@
 #endif
 
 #include "common/logging/log.h"
+#include "common/scope_exit.h"
 #include "core/arm/arm_interface.h"
 #include "core/core.h"
 #include "core/gdbstub/gdbstub.h"
@@ -40,12 +43,15 @@
 
 namespace GDBStub {
 namespace {
-constexpr int GDB_BUFFER_SIZE = 10000;
+constexpr int GDB_BUFFER_SIZE = 0x10000;
+constexpr int GDB_RECEIVE_BUFFER_SIZE = 0x1000;
 
 constexpr char GDB_STUB_START = '$';
 constexpr char GDB_STUB_END = '#';
 constexpr char GDB_STUB_ACK = '+';
 constexpr char GDB_STUB_NACK = '-';
+constexpr char GDB_STUB_ESCAPE = '}';
+constexpr u8 GDB_STUB_ESCAPE_XOR = 0x20;
 
 #ifndef SIGTRAP
 constexpr u32 SIGTRAP = 5;
@@ -125,6 +131,17 @@ bool defer_start = false;
 u8 command_buffer[GDB_BUFFER_SIZE];
 u32 command_length;
 
+// Bytes received from the client that were not consumed yet
+u8 receive_buffer[GDB_RECEIVE_BUFFER_SIZE];
+std::size_t receive_position = 0;
+std::size_t receive_size = 0;
+
+// Bytes waiting to be sent to the client, flushed once per handled packet
+std::vector<u8> send_buffer;
+
+// Set once the client asked to stop acknowledging packets with QStartNoAckMode
+bool no_ack_mode = false;
+
 u32 latest_signal = 0;
 bool memory_break = false;
 
@@ -356,16 +373,29 @@ static u64 GdbHexToLong(const u8* src) {
     return output;
 }
 
-/// Read a byte from the gdb client.
+/// Read a byte from the gdb client, receiving as many bytes as are available at once.
 static u8 ReadByte() {
-    u8 c;
-    std::size_t received_size = recv(gdbserver_socket, reinterpret_cast<char*>(&c), 1, MSG_WAITALL);
-    if (received_size != 1) {
-        LOG_ERROR(Debug_GDBStub, "recv failed : {}", received_size);
-        Shutdown();
+    if (receive_position == receive_size) {
+        const auto received_size = recv(gdbserver_socket, reinterpret_cast<char*>(receive_buffer),
+                                        sizeof(receive_buffer), 0);
+        if (received_size <= 0) {
+            LOG_ERROR(Debug_GDBStub, "recv failed : {}", received_size);
+            Shutdown();
+            return 0;
+        }
+        receive_position = 0;
+        receive_size = static_cast<std::size_t>(received_size);
     }
 
-    return c;
+    return receive_buffer[receive_position++];
+}
+
+/// Reset the state of the connection with the gdb client.
+static void ResetConnectionState() {
+    receive_position = 0;
+    receive_size = 0;
+    send_buffer.clear();
+    no_ack_mode = false;
 }
 
 /// Calculate the checksum of the current command buffer.
@@ -479,46 +509,52 @@ bool CheckBreakpoint(VAddr addr, BreakpointType type) {
  * @param packet Packet to be sent to client.
  */
 static void SendPacket(const char packet) {
-    std::size_t sent_size = send(gdbserver_socket, &packet, 1, 0);
-    if (sent_size != 1) {
-        LOG_ERROR(Debug_GDBStub, "send failed");
-    }
+    send_buffer.push_back(static_cast<u8>(packet));
 }
 
-void SendReply(const char* reply) {
+/// Send the pending acknowledgements and replies to the gdb client.
+static void Flush() {
     if (!IsConnected()) {
+        send_buffer.clear();
         return;
     }
 
-    std::memset(command_buffer, 0, sizeof(command_buffer));
-
-    command_length = static_cast<u32>(strlen(reply));
-    if (command_length + 4 > sizeof(command_buffer)) {
-        LOG_ERROR(Debug_GDBStub, "command_buffer overflow in SendReply");
-        return;
-    }
-
-    std::memcpy(command_buffer + 1, reply, command_length);
-
-    u8 checksum = CalculateChecksum(command_buffer, command_length + 1);
-    command_buffer[0] = GDB_STUB_START;
-    command_buffer[command_length + 1] = GDB_STUB_END;
-    command_buffer[command_length + 2] = NibbleToHex(checksum >> 4);
-    command_buffer[command_length + 3] = NibbleToHex(checksum);
-
-    u8* ptr = command_buffer;
-    u32 left = command_length + 4;
-    while (left > 0) {
-        s32 sent_size =
-            static_cast<s32>(send(gdbserver_socket, reinterpret_cast<char*>(ptr), left, 0));
+    std::size_t sent = 0;
+    while (sent < send_buffer.size()) {
+        const auto sent_size =
+            send(gdbserver_socket, reinterpret_cast<const char*>(send_buffer.data() + sent),
+                 static_cast<u32>(send_buffer.size() - sent), 0);
         if (sent_size < 0) {
             LOG_ERROR(Debug_GDBStub, "gdb: send failed");
+            send_buffer.clear();
             return Shutdown();
         }
+        sent += static_cast<std::size_t>(sent_size);
+    }
+    send_buffer.clear();
+}
 
-        left -= sent_size;
-        ptr += sent_size;
+/**
+ * Send a reply that may contain binary data to the gdb client.
+ *
+ * @param reply Reply to be sent to client, with the special characters already escaped.
+ */
+static void SendReplyData(std::string_view reply) {
+    if (!IsConnected()) {
+        return;
     }
+
+    const u8 checksum = CalculateChecksum(reinterpret_cast<const u8*>(reply.data()), reply.size());
+    send_buffer.push_back(GDB_STUB_START);
+    send_buffer.insert(send_buffer.end(), reply.begin(), reply.end());
+    send_buffer.push_back(GDB_STUB_END);
+    send_buffer.push_back(NibbleToHex(checksum >> 4));
+    send_buffer.push_back(NibbleToHex(checksum));
+    Flush();
+}
+
+void SendReply(const char* reply) {
+    SendReplyData(reply);
 }
 
 /// Handle query command from gdb client.
@@ -530,7 +566,11 @@ static void HandleQuery() {
         SendReply("T0");
     } else if (strncmp(query, "Supported", strlen("Supported")) == 0) {
         // PacketSize needs to be large enough for target xml
-        SendReply("PacketSize=2000;qXfer:features:read+;qXfer:threads:read+");
+        const std::string features = fmt::format("PacketSize={:x};qXfer:features:read+;"
+                                                  "qXfer:threads:read+;QStartNoAckMode+;"
+                                                  "binary-upload+",
+                                                  GDB_BUFFER_SIZE);
+        SendReply(features.c_str());
     } else if (strncmp(query, "Xfer:features:read:target.xml:",
                        strlen("Xfer:features:read:target.xml:")) == 0) {
         SendReply(target_xml);
@@ -568,6 +608,20 @@ static void HandleQuery() {
     }
 }
 
+/// Handle general set command from gdb client.
+static void HandleSetQuery() {
+    const char* query = reinterpret_cast<const char*>(command_buffer + 1);
+    LOG_DEBUG(Debug_GDBStub, "gdb: set query '{}'\n", query);
+
+    if (strcmp(query, "StartNoAckMode") == 0) {
+        // This reply is still acknowledged by the client, the following packets are not.
+        SendReply("OK");
+        no_ack_mode = true;
+    } else {
+        SendReply("");
+    }
+}
+
 /// Handle set thread command from gdb client.
 static void HandleSetThread() {
     int thread_id = -1;
@@ -656,6 +710,10 @@ static void ReadCommand() {
     }
 
     while ((c = ReadByte()) != GDB_STUB_END) {
+        if (!IsConnected()) {
+            command_length = 0;
+            return;
+        }
         if (command_length >= sizeof(command_buffer)) {
             LOG_ERROR(Debug_GDBStub, "gdb: command_buffer overflow\n");
             SendPacket(GDB_STUB_NACK);
@@ -678,11 +736,15 @@ static void ReadCommand() {
 
         command_length = 0;
 
-        SendPacket(GDB_STUB_NACK);
+        if (!no_ack_mode) {
+            SendPacket(GDB_STUB_NACK);
+        }
         return;
     }
 
-    SendPacket(GDB_STUB_ACK);
+    if (!no_ack_mode) {
+        SendPacket(GDB_STUB_ACK);
+    }
 }
 
 /// Check if there is data to be read from the gdb client.
@@ -691,6 +753,10 @@ static bool IsDataAvailable() {
         return false;
     }
 
+    if (receive_position != receive_size) {
+        return true;
+    }
+
     fd_set fd_socket;
 
     FD_ZERO(&fd_socket);
@@ -820,62 +886,145 @@ static void WriteRegisters() {
     SendReply("OK");
 }
 
-/// Read location in memory specified by gdb client.
-static void ReadMemory() {
-    static u8 reply[GDB_BUFFER_SIZE - 4];
-
-    auto start_offset = command_buffer + 1;
-    auto addr_pos = std::find(start_offset, command_buffer + command_length, ',');
-    VAddr addr = HexToInt(start_offset, static_cast<u32>(addr_pos - start_offset));
+/**
+ * Parse the address and length of a memory command from the gdb client.
+ *
+ * @param delimiter Character ending the length, or 0 if the length ends the command.
+ * @returns Position of the delimiter in the command buffer.
+ */
+static const u8* ParseMemoryCommand(VAddr& addr, u32& len, u8 delimiter = 0) {
+    const u8* command_end = command_buffer + command_length;
+    const u8* start_offset = command_buffer + 1;
+    const u8* addr_pos = std::find(start_offset, command_end, ',');
+    addr = HexToInt(start_offset, static_cast<u32>(addr_pos - start_offset));
 
     start_offset = addr_pos + 1;
-    u32 len =
-        HexToInt(start_offset, static_cast<u32>((command_buffer + command_length) - start_offset));
+    const u8* len_pos =
+        delimiter != 0 ? std::find(start_offset, command_end, delimiter) : command_end;
+    len = HexToInt(start_offset, static_cast<u32>(len_pos - start_offset));
+    return len_pos;
+}
+
+/// Check that the memory accessed by the gdb client belongs to the current process.
+static bool IsValidMemoryAccess(VAddr addr) {
+    auto& system = Core::System::GetInstance();
+    return system.Memory().IsValidVirtualAddress(*system.Kernel().GetCurrentProcess(), addr);
+}
+
+/// Read location in memory specified by gdb client.
+static void ReadMemory() {
+    VAddr addr;
+    u32 len;
+    ParseMemoryCommand(addr, len);
 
     LOG_DEBUG(Debug_GDBStub, "ReadMemory addr: {:08x} len: {:08x}", addr, len);
 
-    if (len * 2 > sizeof(reply)) {
-        SendReply("E01");
+    // Each byte takes two hex digits, compare before doubling so that a huge length cannot wrap.
+    if (len > (GDB_BUFFER_SIZE - 4) / 2) {
+        return SendReply("E01");
     }
 
-    auto& memory = Core::System::GetInstance().Memory();
-    if (!memory.IsValidVirtualAddress(*Core::System::GetInstance().Kernel().GetCurrentProcess(),
-                                      addr)) {
+    if (!IsValidMemoryAccess(addr)) {
         return SendReply("E00");
     }
 
     std::vector<u8> data(len);
-    memory.ReadBlock(addr, data.data(), len);
+    Core::System::GetInstance().Memory().ReadBlock(addr, data.data(), len);
+
+    std::string reply(len * 2, '\0');
+    MemToGdbHex(reinterpret_cast<u8*>(reply.data()), data.data(), len);
+
+    LOG_TRACE(Debug_GDBStub, "ReadMemory result: {}", reply);
+    SendReplyData(reply);
+}
 
-    MemToGdbHex(reply, data.data(), len);
-    reply[len * 2] = '\0';
+/// Read location in memory specified by gdb client, replying with binary data.
+static void ReadMemoryBinary() {
+    VAddr addr;
+    u32 len;
+    ParseMemoryCommand(addr, len);
 
-    auto reply_str = reinterpret_cast<char*>(reply);
+    LOG_DEBUG(Debug_GDBStub, "ReadMemoryBinary addr: {:08x} len: {:08x}", addr, len);
 
-    LOG_DEBUG(Debug_GDBStub, "ReadMemory result: {}", reply_str);
-    SendReply(reply_str);
+    if (len > GDB_BUFFER_SIZE) {
+        return SendReply("E01");
+    }
+
+    if (len != 0 && !IsValidMemoryAccess(addr)) {
+        return SendReply("E00");
+    }
+
+    std::vector<u8> data(len);
+    Core::System::GetInstance().Memory().ReadBlock(addr, data.data(), len);
+
+    std::string reply;
+    reply.reserve(len + len / 8 + 1);
+    reply += 'b';
+    for (const u8 byte : data) {
+        if (byte == GDB_STUB_START || byte == GDB_STUB_END || byte == GDB_STUB_ESCAPE ||
+            byte == '*') {
+            reply += GDB_STUB_ESCAPE;
+            reply += static_cast<char>(byte ^ GDB_STUB_ESCAPE_XOR);
+        } else {
+            reply += static_cast<char>(byte);
+        }
+    }
+    SendReplyData(reply);
 }
 
 /// Modify location in memory with data received from the gdb client.
 static void WriteMemory() {
-    auto start_offset = command_buffer + 1;
-    auto addr_pos = std::find(start_offset, command_buffer + command_length, ',');
-    VAddr addr = HexToInt(start_offset, static_cast<u32>(addr_pos - start_offset));
+    VAddr addr;
+    u32 len;
+    const u8* len_pos = ParseMemoryCommand(addr, len, ':');
 
-    start_offset = addr_pos + 1;
-    auto len_pos = std::find(start_offset, command_buffer + command_length, ':');
-    u32 len = HexToInt(start_offset, static_cast<u32>(len_pos - start_offset));
+    // Each byte takes two hex digits, compare in 64 bits so that a huge length cannot wrap around.
+    if (u64{len} * 2 > static_cast<u64>(command_buffer + command_length - (len_pos + 1))) {
+        return SendReply("E01");
+    }
 
-    auto& memory = Core::System::GetInstance().Memory();
-    if (!memory.IsValidVirtualAddress(*Core::System::GetInstance().Kernel().GetCurrentProcess(),
-                                      addr)) {
+    if (!IsValidMemoryAccess(addr)) {
         return SendReply("E00");
     }
 
     std::vector<u8> data(len);
 
     GdbHexToMem(data.data(), len_pos + 1, len);
-    memory.WriteBlock(addr, data.data(), len);
+    Core::System::GetInstance().Memory().WriteBlock(addr, data.data(), len);
+    Core::GetRunningCore().ClearInstructionCache();
+    SendReply("OK");
+}
+
+/// Modify location in memory with binary data received from the gdb client.
+static void WriteMemoryBinary() {
+    VAddr addr;
+    u32 len;
+    const u8* len_pos = ParseMemoryCommand(addr, len, ':');
+
+    std::vector<u8> data;
+    data.reserve(len);
+    for (const u8* it = len_pos + 1; it < command_buffer + command_length; ++it) {
+        if (*it == GDB_STUB_ESCAPE && it + 1 < command_buffer + command_length) {
+            data.push_back(*++it ^ GDB_STUB_ESCAPE_XOR);
+        } else {
+            data.push_back(*it);
+        }
+    }
+
+    if (data.size() != len) {
+        return SendReply("E01");
+    }
+
+    // GDB probes for binary download support with an empty write
+    if (len == 0) {
+        return SendReply("OK");
+    }
+
+    if (!IsValidMemoryAccess(addr)) {
+        return SendReply("E00");
+    }
+
+    Core::System::GetInstance().Memory().WriteBlock(addr, data.data(), len);
     Core::GetRunningCore().ClearInstructionCache();
     SendReply("OK");
 }
@@ -1052,6 +1201,9 @@ void HandlePacket(Core::System& system) {
         return;
     }
 
+    // Acknowledgements are only queued, make sure they are sent even without a reply.
+    SCOPE_EXIT({ Flush(); });
+
     ReadCommand();
     if (command_length == 0) {
         return;
@@ -1063,6 +1215,9 @@ void HandlePacket(Core::System& system) {
     case 'q':
         HandleQuery();
         break;
+    case 'Q':
+        HandleSetQuery();
+        break;
     case 'H':
         HandleSetThread();
         break;
@@ -1096,6 +1251,12 @@ void HandlePacket(Core::System& system) {
     case 'M':
         WriteMemory();
         break;
+    case 'x':
+        ReadMemoryBinary();
+        break;
+    case 'X':
+        WriteMemoryBinary();
+        break;
     case 's':
         Step();
         return;
@@ -1210,6 +1371,7 @@ static void Init(u16 port) {
         LOG_ERROR(Debug_GDBStub, "Failed to accept gdb client");
     } else {
         LOG_INFO(Debug_GDBStub, "Client connected.\n");
+        ResetConnectionState();
         saddr_client.sin_addr.s_addr = ntohl(saddr_client.sin_addr.s_addr);
     }
 
@@ -1234,6 +1396,7 @@ void Shutdown() {
         shutdown(gdbserver_socket, SHUT_RDWR);
         gdbserver_socket = -1;
     }
+    ResetConnectionState();
 
 #ifdef _WIN32
     WSACleanup();
@@ -20,6 +20,7 @@
 #include "core/hle/ipc.h"
 #include "core/hle/kernel/object.h"
 #include "core/hle/kernel/server_session.h"
+#include "core/hle/service/ipc_stats.h"
 
 namespace Service {
 class ServiceFrameworkBase;
@@ -302,19 +303,26 @@ public:
     void RunAsync(AsyncFunctor async_section, ResultFunctor result_function,
                   bool really_async = true) {
 
+        // The async section may run on another thread, remember which command started it.
+        const Service::IPCStats::Call stats_call = Service::IPCStats::CurrentCall();
+        const auto timed_async_section = [this, async_section, stats_call] {
+            const Service::IPCStats::ScopedAsync stats_async{stats_call};
+            return async_section(*this);
+        };
+
         if (!Settings::values.deterministic_async_operations && really_async) {
             kernel.ReportAsyncState(true);
             this->SleepClientThread(
                 "RunAsync", std::chrono::nanoseconds(-1),
                 std::make_shared<AsyncWakeUpCallback<ResultFunctor>>(
                     kernel, result_function,
-                    std::move(std::async(std::launch::async, [this, async_section] {
-                        s64 sleep_for = async_section(*this);
+                    std::move(std::async(std::launch::async, [this, timed_async_section] {
+                        s64 sleep_for = timed_async_section();
                         this->thread->WakeAfterDelay(sleep_for, true);
                     }))));
 
         } else {
-            s64 sleep_for = async_section(*this);
+            s64 sleep_for = timed_async_section();
             if (sleep_for > 0) {
                 kernel.ReportAsyncState(true);
                 auto parallel_wakeup = std::make_shared<AsyncWakeUpCallback<ResultFunctor>>(
@@ -642,8 +642,11 @@ Result SVC::ConnectToPort(Handle* out_handle, VAddr port_name_address) {
     return kernel.GetCurrentProcess()->handle_table.Create(out_handle, client_session);
 }
 
+MICROPROFILE_DEFINE(Kernel_IPC, "Kernel", "IPC Request", MP_RGB(200, 70, 70));
+
 /// Makes a blocking IPC call to an OS service.
 Result SVC::SendSyncRequest(Handle handle) {
+    MICROPROFILE_SCOPE(Kernel_IPC);
     std::shared_ptr<ClientSession> session =
         kernel.GetCurrentProcess()->handle_table.Get<ClientSession>(handle);
     R_UNLESS(session, ResultInvalidHandle);
@@ -133,6 +133,23 @@ void Module::LoadInputDevices() {
     }
 }
 
+void Module::ReportInputLatency() {
+    Input::Clock::time_point last_change = circle_pad->GetLastChangeTime();
+    for (const auto& button : buttons) {
+        last_change = std::max(last_change, button->GetLastChangeTime());
+    }
+    last_change = std::max(last_change, touch_device->GetLastChangeTime());
+    if (touch_btn_device) {
+        last_change = std::max(last_change, touch_btn_device->GetLastChangeTime());
+    }
+
+    // Devices that do not track their changes stay at the epoch, and are never reported
+    if (last_change > last_latched_change) {
+        last_latched_change = last_change;
+        system.ReportInputLatency(Input::Clock::now() - last_change);
+    }
+}
+
 void Module::UpdatePadCallback(std::uintptr_t user_data, s64 cycles_late) {
     SharedMem* mem = reinterpret_cast<SharedMem*>(shared_mem->GetPointer());
 
@@ -283,6 +300,10 @@ void Module::UpdatePadCallback(std::uintptr_t user_data, s64 cycles_late) {
         touch_entry.valid.Assign(pressed ? 1 : 0);
 
         system.Movie().HandleTouchStatus(touch_entry);
+
+        // The devices were sampled just now, so this measures how long the changes waited for
+        // the pad update.
+        ReportInputLatency();
     }
 
     // TODO(bunnei): We're not doing anything with offset 0xA8 + 0x18 of HID SharedMemory, which
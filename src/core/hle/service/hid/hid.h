@@ -345,6 +345,8 @@ public:
 
 private:
     void LoadInputDevices();
+    /// Reports the latency of the newest input device change, if the pad update latched it.
+    void ReportInputLatency();
     void UpdatePadCallback(std::uintptr_t user_data, s64 cycles_late);
     void UpdateAccelerometerCallback(std::uintptr_t user_data, s64 cycles_late);
     void UpdateGyroscopeCallback(std::uintptr_t user_data, s64 cycles_late);
@@ -392,6 +394,8 @@ private:
     std::unique_ptr<Input::MotionDevice> motion_device;
     std::unique_ptr<Input::TouchDevice> touch_device;
     std::unique_ptr<Input::TouchDevice> touch_btn_device;
+    /// Time of the newest input device change latched by a pad update
+    Input::Clock::time_point last_latched_change{};
 
     std::shared_ptr<ArticBaseController> artic_controller;
     std::shared_ptr<Network::ArticBase::Client> artic_client;
@@ -0,0 +1,315 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+#include "common/logging/log.h"
+#include "core/hle/service/ipc_stats.h"
+
+namespace Service::IPCStats {
+
+namespace {
+
+/// Interval between two logged summaries, in nanoseconds
+constexpr u64 LogInterval = 10'000'000'000;
+
+/// Number of commands included in the logged summaries
+constexpr std::size_t LoggedCommands = 10;
+
+std::size_t BucketIndex(u64 duration_ns) {
+    return std::min<std::size_t>(std::bit_width(duration_ns / 1000), NumBuckets - 1);
+}
+
+/// Histogram updated by a single thread and read by any thread
+struct Counters {
+    std::atomic<u64> count{};
+    std::atomic<u64> total_ns{};
+    std::atomic<u64> max_ns{};
+    std::array<std::atomic<u64>, NumBuckets> buckets{};
+
+    void Add(u64 duration_ns) {
+        // Only the owning thread writes, so there is no need for read-modify-write operations.
+        const auto increment = [](std::atomic<u64>& value, u64 amount) {
+            value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        };
+        increment(count, 1);
+        increment(total_ns, duration_ns);
+        increment(buckets[BucketIndex(duration_ns)], 1);
+        if (duration_ns > max_ns.load(std::memory_order_relaxed)) {
+            max_ns.store(duration_ns, std::memory_order_relaxed);
+        }
+    }
+
+    Histogram Load() const {
+        Histogram histogram;
+        histogram.count = count.load(std::memory_order_relaxed);
+        histogram.total_ns = total_ns.load(std::memory_order_relaxed);
+        histogram.max_ns = max_ns.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < NumBuckets; ++i) {
+            histogram.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+        }
+        return histogram;
+    }
+};
+
+struct Entry {
+    const char* function{};
+    Counters handler;
+    Counters async;
+};
+
+struct ThreadTable {
+    /// Taken by the owning thread to add entries, and by the readers
+    std::mutex mutex;
+    std::unordered_map<u64, Entry> entries;
+    u64 epoch{};
+};
+
+struct State {
+    std::mutex mutex;
+    std::vector<std::string> service_names;
+    std::vector<ThreadTable*> tables;
+    /// Statistics of the threads that exited
+    std::unordered_map<u64, CommandStats> retired;
+    std::atomic<u64> epoch{};
+};
+
+State& GetState() {
+    static State state;
+    return state;
+}
+
+u64 MakeKey(u32 service_id, u32 command_id) {
+    return static_cast<u64>(service_id) << 32 | command_id;
+}
+
+void Accumulate(std::unordered_map<u64, CommandStats>& stats, u64 key, const Entry& entry) {
+    auto [it, is_new] = stats.try_emplace(key);
+    auto& command = it->second;
+    if (is_new) {
+        command.function = entry.function;
+        command.command_id = static_cast<u32>(key);
+    }
+    command.handler.Merge(entry.handler.Load());
+    command.async.Merge(entry.async.Load());
+}
+
+class ThreadTableHolder {
+public:
+    ~ThreadTableHolder() {
+        if (!table) {
+            return;
+        }
+        auto& state = GetState();
+        std::scoped_lock lock{state.mutex};
+        if (table->epoch == state.epoch.load(std::memory_order_relaxed)) {
+            for (const auto& [key, entry] : table->entries) {
+                Accumulate(state.retired, key, entry);
+            }
+        }
+        std::erase(state.tables, table.get());
+    }
+
+    ThreadTable& Get() {
+        auto& state = GetState();
+        if (!table) {
+            table = std::make_unique<ThreadTable>();
+            std::scoped_lock lock{state.mutex};
+            table->epoch = state.epoch.load(std::memory_order_relaxed);
+            state.tables.push_back(table.get());
+        }
+        const u64 epoch = state.epoch.load(std::memory_order_relaxed);
+        if (table->epoch != epoch) {
+            std::scoped_lock lock{table->mutex};
+            table->entries.clear();
+            table->epoch = epoch;
+        }
+        return *table;
+    }
+
+private:
+    std::unique_ptr<ThreadTable> table;
+};
+
+thread_local ThreadTableHolder thread_table;
+thread_local Call current_call;
+thread_local u64 next_log_time{};
+
+Entry* GetEntry(const Call& call) {
+    if (call.service_id == InvalidServiceId) {
+        return nullptr;
+    }
+    ThreadTable& table = thread_table.Get();
+    const u64 key = MakeKey(call.service_id, call.command_id);
+    auto it = table.entries.find(key);
+    if (it == table.entries.end()) {
+        std::scoped_lock lock{table.mutex};
+        it = table.entries.try_emplace(key).first;
+        it->second.function = call.function;
+    }
+    return &it->second;
+}
+
+void FormatHistogram(std::string& out, const Histogram& histogram) {
+    fmt::format_to(std::back_inserter(out),
+                   R"({{"count":{},"total_ns":{},"max_ns":{},"buckets":[{}]}})", histogram.count,
+                   histogram.total_ns, histogram.max_ns, fmt::join(histogram.buckets, ","));
+}
+
+} // Anonymous namespace
+
+void Histogram::Merge(const Histogram& other) {
+    count += other.count;
+    total_ns += other.total_ns;
+    max_ns = std::max(max_ns, other.max_ns);
+    for (std::size_t i = 0; i < NumBuckets; ++i) {
+        buckets[i] += other.buckets[i];
+    }
+}
+
+u64 Histogram::PercentileUs(double fraction) const {
+    const auto target = static_cast<u64>(fraction * static_cast<double>(count));
+    u64 seen = 0;
+    for (std::size_t i = 0; i < NumBuckets - 1; ++i) {
+        seen += buckets[i];
+        if (seen > target) {
+            return u64{1} << i;
+        }
+    }
+    return max_ns / 1000;
+}
+
+u32 RegisterService(const std::string& name) {
+    auto& state = GetState();
+    std::scoped_lock lock{state.mutex};
+    const auto it = std::ranges::find(state.service_names, name);
+    if (it != state.service_names.end()) {
+        return static_cast<u32>(std::distance(state.service_names.begin(), it));
+    }
+    state.service_names.push_back(name);
+    return static_cast<u32>(state.service_names.size() - 1);
+}
+
+u64 Now() {
+    return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now().time_since_epoch())
+                                .count());
+}
+
+Call CurrentCall() {
+    return current_call;
+}
+
+void RecordHandler(const Call& call, u64 duration_ns) {
+    if (Entry* entry = GetEntry(call)) {
+        entry->handler.Add(duration_ns);
+    }
+}
+
+void RecordAsync(const Call& call, u64 duration_ns) {
+    if (Entry* entry = GetEntry(call)) {
+        entry->async.Add(duration_ns);
+    }
+}
+
+std::vector<CommandStats> GetStats() {
+    auto& state = GetState();
+    std::vector<CommandStats> result;
+    {
+        std::scoped_lock lock{state.mutex};
+        auto combined = state.retired;
+        const u64 epoch = state.epoch.load(std::memory_order_relaxed);
+        for (ThreadTable* table : state.tables) {
+            std::scoped_lock table_lock{table->mutex};
+            if (table->epoch != epoch) {
+                continue;
+            }
+            for (const auto& [key, entry] : table->entries) {
+                Accumulate(combined, key, entry);
+            }
+        }
+
+        result.reserve(combined.size());
+        for (auto& [key, command] : combined) {
+            command.service = state.service_names[key >> 32];
+            result.push_back(std::move(command));
+        }
+    }
+
+    std::ranges::sort(result, [](const CommandStats& a, const CommandStats& b) {
+        return a.handler.total_ns + a.async.total_ns > b.handler.total_ns + b.async.total_ns;
+    });
+    return result;
+}
+
+void Reset() {
+    auto& state = GetState();
+    std::scoped_lock lock{state.mutex};
+    state.retired.clear();
+    state.epoch.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::string DumpJson() {
+    std::string out = R"({"commands":[)";
+    bool first = true;
+    for (const auto& command : GetStats()) {
+        if (!first) {
+            out += ",\n";
+        }
+        first = false;
+        fmt::format_to(std::back_inserter(out),
+                       R"({{"service":"{}","function":"{}","command_id":{},"handler":)",
+                       command.service, command.function, command.command_id);
+        FormatHistogram(out, command.handler);
+        out += R"(,"async":)";
+        FormatHistogram(out, command.async);
+        out += '}';
+    }
+    out += "]}\n";
+    return out;
+}
+
+void LogSummary(std::size_t max_commands) {
+    const auto stats = GetStats();
+    LOG_DEBUG(Service, "IPC statistics of the {} most expensive commands:",
+              std::min(max_commands, stats.size()));
+    for (std::size_t i = 0; i < std::min(max_commands, stats.size()); ++i) {
+        const auto& command = stats[i];
+        const auto& handler = command.handler;
+        LOG_DEBUG(Service,
+                  "{}::{} (0x{:04X}): {} calls, {:.3f} ms total, p99 < {} us, max {} us, "
+                  "async {} calls, {:.3f} ms total",
+                  command.service, command.function, command.command_id, handler.count,
+                  handler.total_ns / 1e6, handler.PercentileUs(0.99), handler.max_ns / 1000,
+                  command.async.count, command.async.total_ns / 1e6);
+    }
+}
+
+ScopedCall::ScopedCall(const Call& call_)
+    : call{call_}, previous_call{current_call}, begin{Now()} {
+    current_call = call;
+}
+
+ScopedCall::~ScopedCall() {
+    const u64 end = Now();
+    RecordHandler(call, end - begin);
+    current_call = previous_call;
+
+    if (end >= next_log_time) {
+        if (next_log_time != 0) {
+            LogSummary(LoggedCommands);
+        }
+        next_log_time = end + LogInterval;
+    }
+}
+
+} // namespace Service::IPCStats
@@ -0,0 +1,113 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <limits>
+#include <string>
+#include <vector>
+#include "common/common_types.h"
+
+/**
+ * Wall time statistics of the HLE service commands, to find out which services cost frame time.
+ *
+ * Each thread accumulates its own counters, so recording a call takes no lock once the command
+ * was seen for the first time by the thread. The counters of all threads are only combined when
+ * the statistics are requested.
+ */
+namespace Service::IPCStats {
+
+/// Number of histogram buckets. Bucket i counts the calls that took less than 2^i microseconds,
+/// the last bucket counts all the longer calls.
+constexpr std::size_t NumBuckets = 16;
+
+constexpr u32 InvalidServiceId = std::numeric_limits<u32>::max();
+
+struct Histogram {
+    u64 count{};
+    u64 total_ns{};
+    u64 max_ns{};
+    std::array<u64, NumBuckets> buckets{};
+
+    void Merge(const Histogram& other);
+
+    /// Returns the upper bound in microseconds of the bucket holding the given fraction of calls.
+    [[nodiscard]] u64 PercentileUs(double fraction) const;
+};
+
+struct CommandStats {
+    std::string service;
+    std::string function;
+    u32 command_id;
+    /// Time spent in the command handler on the emulator thread
+    Histogram handler;
+    /// Time spent in the async sections started by the command with RunAsync
+    Histogram async;
+};
+
+/// Identifies the command being handled.
+struct Call {
+    u32 service_id = InvalidServiceId;
+    u32 command_id{};
+    const char* function{};
+};
+
+/// Returns the id used to record the commands of the named service.
+u32 RegisterService(const std::string& name);
+
+/// Returns the current time in nanoseconds.
+[[nodiscard]] u64 Now();
+
+/// Returns the command handled by the calling thread, if any.
+[[nodiscard]] Call CurrentCall();
+
+void RecordHandler(const Call& call, u64 duration_ns);
+void RecordAsync(const Call& call, u64 duration_ns);
+
+/// Returns the statistics of all the recorded commands, the most expensive first.
+[[nodiscard]] std::vector<CommandStats> GetStats();
+
+/// Clears the statistics. Threads drop their counters the next time they record a call.
+void Reset();
+
+/// Returns the statistics as a JSON document.
+[[nodiscard]] std::string DumpJson();
+
+/// Logs the commands that took the most time.
+void LogSummary(std::size_t max_commands);
+
+/// Times a command handler and marks it as the current call of the thread while it runs.
+class ScopedCall {
+public:
+    explicit ScopedCall(const Call& call);
+    ~ScopedCall();
+
+    ScopedCall(const ScopedCall&) = delete;
+    ScopedCall& operator=(const ScopedCall&) = delete;
+
+private:
+    Call call;
+    Call previous_call;
+    u64 begin;
+};
+
+/// Times the async section of a command started with RunAsync.
+class ScopedAsync {
+public:
+    explicit ScopedAsync(const Call& call_) : call{call_}, begin{Now()} {}
+
+    ~ScopedAsync() {
+        RecordAsync(call, Now() - begin);
+    }
+
+    ScopedAsync(const ScopedAsync&) = delete;
+    ScopedAsync& operator=(const ScopedAsync&) = delete;
+
+private:
+    Call call;
+    u64 begin;
+};
+
+} // namespace Service::IPCStats
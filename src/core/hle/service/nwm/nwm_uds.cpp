@@ -58,6 +58,9 @@ constexpr u16 BroadcastNetworkNodeId = 0xFFFF;
 // The Host has always dest_node_id 1
 constexpr u16 HostDestNodeId = 1;
 
+// Time to gather the received packets for before handing them to the emulated system at once.
+constexpr u64 PacketDeliveryIntervalUs = 1000;
+
 std::list<Network::WifiPacket> NWM_UDS::GetReceivedBeacons(const MacAddress& sender) {
     std::scoped_lock lock(beacon_mutex);
     if (sender != Network::BroadcastMac) {
@@ -148,7 +151,6 @@ void NWM_UDS::HandleNodeMapPacket(const Network::WifiPacket& packet) {
 }
 
 void NWM_UDS::HandleBeaconFrame(const Network::WifiPacket& packet) {
-    std::scoped_lock lock(beacon_mutex);
     const auto unique_beacon =
         std::find_if(received_beacons.begin(), received_beacons.end(),
                      [&packet](const Network::WifiPacket& new_packet) {
@@ -255,7 +257,7 @@ void NWM_UDS::HandleEAPoLPacket(const Network::WifiPacket& packet) {
 
         SendPacket(eapol_logoff);
 
-        connection_status_event->Signal();
+        connection_status_changed = true;
     } else if (connection_status.status == NetworkStatus::Connecting) {
         auto logoff = ParseEAPoLLogoffFrame(packet.data);
 
@@ -288,7 +290,7 @@ void NWM_UDS::HandleEAPoLPacket(const Network::WifiPacket& packet) {
         // Some games require ConnectToNetwork to block, for now it doesn't
         // If blocking is implemented this lock needs to be changed,
         // otherwise it might cause deadlocks
-        connection_status_event->Signal();
+        connection_status_changed = true;
         connection_event->Signal();
     } else if (connection_status.status == NetworkStatus::ConnectedAsClient) {
         // TODO(B3N30): Remove that section and send/receive a proper connection_status packet
@@ -319,13 +321,12 @@ void NWM_UDS::HandleEAPoLPacket(const Network::WifiPacket& packet) {
         }
         connection_status.changed_nodes = old_bitmask ^ connection_status.node_bitmask;
 
-        connection_status_event->Signal();
+        connection_status_changed = true;
     }
 }
 
 void NWM_UDS::HandleSecureDataPacket(const Network::WifiPacket& packet) {
     const auto secure_data = ParseSecureDataHeader(packet.data);
-    std::scoped_lock lock{connection_status_mutex, system.Kernel().GetHLELock()};
 
     if (connection_status.status != NetworkStatus::ConnectedAsHost &&
         connection_status.status != NetworkStatus::ConnectedAsClient) {
@@ -380,8 +381,8 @@ void NWM_UDS::HandleSecureDataPacket(const Network::WifiPacket& packet) {
     // Add the received packet to the data queue.
     channel_info->second.received_packets.emplace_back(packet.data);
 
-    // Signal the data event. We can do this directly because we locked hle_lock
-    channel_info->second.event->Signal();
+    // The data event is signaled once for all the packets of the delivery
+    channel_info->second.signal_pending = true;
 }
 
 void NWM_UDS::StartConnectionSequence(const MacAddress& server) {
@@ -505,7 +506,7 @@ void NWM_UDS::HandleDeauthenticationFrame(const Network::WifiPacket& packet) {
 
     node_it->Reset();
 
-    connection_status_event->Signal();
+    connection_status_changed = true;
 }
 
 void NWM_UDS::HandleDataFrame(const Network::WifiPacket& packet) {
@@ -513,21 +514,21 @@ void NWM_UDS::HandleDataFrame(const Network::WifiPacket& packet) {
     case EtherType::EAPoL:
         HandleEAPoLPacket(packet);
         break;
-    case EtherType::SecureData:
+    case EtherType::SecureData: {
+        std::scoped_lock lock{connection_status_mutex, system.Kernel().GetHLELock()};
         HandleSecureDataPacket(packet);
         break;
     }
+    }
 }
 
-/// Callback to parse and handle a received wifi packet.
-void NWM_UDS::OnWifiPacketReceived(const Network::WifiPacket& packet) {
-    if (!initialized) {
-        return;
-    }
+void NWM_UDS::HandleWifiPacket(const Network::WifiPacket& packet) {
     switch (packet.type) {
-    case Network::WifiPacket::PacketType::Beacon:
+    case Network::WifiPacket::PacketType::Beacon: {
+        std::scoped_lock lock(beacon_mutex);
         HandleBeaconFrame(packet);
         break;
+    }
     case Network::WifiPacket::PacketType::Authentication:
         HandleAuthenticationFrame(packet);
         break;
@@ -546,6 +547,78 @@ void NWM_UDS::OnWifiPacketReceived(const Network::WifiPacket& packet) {
     }
 }
 
+void NWM_UDS::OnWifiPacketReceived(const Network::WifiPacket& packet) {
+    if (!initialized) {
+        return;
+    }
+
+    // Taking the connection and HLE locks from the network thread for every packet stalls the
+    // emulation when games stream many small frames, so the packets are handed to the emulation
+    // thread in batches instead.
+    received_packets.Push(packet);
+}
+
+void NWM_UDS::DeliverReceivedPackets(std::uintptr_t user_data, s64 cycles_late) {
+    received_packets.Take(delivered_packets);
+    if (!delivered_packets.empty()) {
+        const auto now = std::chrono::steady_clock::now();
+        std::chrono::nanoseconds total_delay{};
+        std::chrono::nanoseconds max_delay{};
+        for (const auto& received : delivered_packets) {
+            const auto delay = now - received.received_time;
+            total_delay += delay;
+            max_delay = std::max<std::chrono::nanoseconds>(max_delay, delay);
+        }
+        system.ReportUDSFrames(static_cast<u32>(delivered_packets.size()), total_delay,
+                               max_delay);
+
+        // Consecutive beacon and SecureData frames, the bulk of the traffic, are handled under a
+        // single lock.
+        ForEachPacketBatch(delivered_packets, [this](PacketBatchType type,
+                                                     std::span<const ReceivedPacket> batch) {
+            switch (type) {
+            case PacketBatchType::Beacon: {
+                std::scoped_lock lock(beacon_mutex);
+                for (const auto& received : batch) {
+                    HandleBeaconFrame(received.packet);
+                }
+                break;
+            }
+            case PacketBatchType::SecureData: {
+                std::scoped_lock lock{connection_status_mutex, system.Kernel().GetHLELock()};
+                for (const auto& received : batch) {
+                    HandleSecureDataPacket(received.packet);
+                }
+                break;
+            }
+            case PacketBatchType::Single:
+                HandleWifiPacket(batch.front().packet);
+                break;
+            }
+        });
+        delivered_packets.clear();
+
+        SignalPendingEvents();
+    }
+
+    system.CoreTiming().ScheduleEvent(usToCycles(PacketDeliveryIntervalUs) - cycles_late,
+                                      packet_delivery_event);
+}
+
+void NWM_UDS::SignalPendingEvents() {
+    std::scoped_lock lock{connection_status_mutex, system.Kernel().GetHLELock()};
+    if (connection_status_changed) {
+        connection_status_changed = false;
+        connection_status_event->Signal();
+    }
+    for (auto& [channel, bind_node] : channel_data) {
+        if (bind_node.signal_pending) {
+            bind_node.signal_pending = false;
+            bind_node.event->Signal();
+        }
+    }
+}
+
 boost::optional<Network::MacAddress> NWM_UDS::GetNodeMacAddress(u16 dest_node_id, u8 flags) {
     constexpr u8 BroadcastFlag = 0x2;
     if ((flags & BroadcastFlag) || dest_node_id == BroadcastNetworkNodeId) {
@@ -571,6 +644,9 @@ void NWM_UDS::Shutdown(Kernel::HLERequestContext& ctx) {
 
     initialized = false;
 
+    system.CoreTiming().UnscheduleEvent(packet_delivery_event, 0);
+    received_packets.Clear();
+
     for (auto& bind_node : channel_data) {
         bind_node.second.event->Signal();
     }
@@ -656,6 +732,9 @@ ResultVal<std::shared_ptr<Kernel::Event>> NWM_UDS::Initialize(
     current_node = node;
     initialized = true;
 
+    system.CoreTiming().UnscheduleEvent(packet_delivery_event, 0);
+    system.CoreTiming().ScheduleEvent(usToCycles(PacketDeliveryIntervalUs), packet_delivery_event);
+
     recv_buffer_memory = std::move(sharedmem);
     ASSERT_MSG(recv_buffer_memory->GetSize() == sharedmem_size, "Invalid shared memory size.");
 
@@ -1497,6 +1576,10 @@ NWM_UDS::NWM_UDS(Core::System& system) : ServiceFramework("nwm::UDS"), system(sy
         "UDS::BeaconBroadcastCallback", [this](std::uintptr_t user_data, s64 cycles_late) {
             BeaconBroadcastCallback(user_data, cycles_late);
         });
+    packet_delivery_event = system.CoreTiming().RegisterEvent(
+        "UDS::DeliverReceivedPackets", [this](std::uintptr_t user_data, s64 cycles_late) {
+            DeliverReceivedPackets(user_data, cycles_late);
+        });
 
     MacAddress mac;
 
@@ -1527,6 +1610,7 @@ NWM_UDS::~NWM_UDS() {
         room_member->Unbind(wifi_packet_received);
 
     system.CoreTiming().UnscheduleEvent(beacon_broadcast_event, 0);
+    system.CoreTiming().UnscheduleEvent(packet_delivery_event, 0);
 }
 
 } // namespace Service::NWM
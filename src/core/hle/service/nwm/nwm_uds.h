@@ -18,6 +18,7 @@
 #include <boost/serialization/export.hpp>
 #include "common/common_types.h"
 #include "common/swap.h"
+#include "core/hle/service/nwm/uds_packet_queue.h"
 #include "core/hle/service/service.h"
 #include "network/network.h"
 
@@ -471,9 +472,17 @@ private:
 
     void BroadcastNodeMap();
     void HandleNodeMapPacket(const Network::WifiPacket& packet);
+
+    /// Stores a received beacon frame. The caller must hold the beacon mutex.
     void HandleBeaconFrame(const Network::WifiPacket& packet);
+
     void HandleAssociationResponseFrame(const Network::WifiPacket& packet);
     void HandleEAPoLPacket(const Network::WifiPacket& packet);
+
+    /**
+     * Queues a SecureData packet addressed to us on its bind node. The caller must hold the
+     * connection status and HLE locks, the bind node event is signaled by SignalPendingEvents.
+     */
     void HandleSecureDataPacket(const Network::WifiPacket& packet);
 
     /*
@@ -499,9 +508,19 @@ private:
 
     void HandleDataFrame(const Network::WifiPacket& packet);
 
-    /// Callback to parse and handle a received wifi packet.
+    /// Parses and handles a received wifi packet.
+    void HandleWifiPacket(const Network::WifiPacket& packet);
+
+    /// Callback of the network thread, queues a received wifi packet for the next delivery.
     void OnWifiPacketReceived(const Network::WifiPacket& packet);
 
+    /// Handles all the wifi packets received since the last delivery, on the emulation thread.
+    /// Reschedules itself until Shutdown.
+    void DeliverReceivedPackets(std::uintptr_t user_data, s64 cycles_late);
+
+    /// Signals the events of the connection status and bind nodes the delivered packets changed.
+    void SignalPendingEvents();
+
     boost::optional<Network::MacAddress> GetNodeMacAddress(u16 dest_node_id, u8 flags);
 
     // Event that is signaled every time the connection status changes.
@@ -533,6 +552,7 @@ private:
                              /// network node will be received.
         std::shared_ptr<Kernel::Event> event;         ///< Receive event for this bind node.
         std::deque<std::vector<u8>> received_packets; ///< List of packets received on this channel.
+        bool signal_pending = false;                  ///< Signal the event after the delivery.
     };
 
     // Mapping of data channels to their internal data.
@@ -580,6 +600,19 @@ private:
     // List of the last <MaxBeaconFrames> beacons received from the network.
     std::list<Network::WifiPacket> received_beacons;
 
+    // Whether the delivered packets changed the connection status.
+    bool connection_status_changed = false;
+
+    // Recurring event that hands the received packets to the emulated system in batches, scheduled
+    // between Initialize and Shutdown.
+    Core::TimingEventType* packet_delivery_event;
+
+    // Packets received from the network that wait for the next delivery.
+    ReceivedPacketQueue received_packets;
+
+    // Packets being delivered, kept to reuse their storage.
+    std::vector<ReceivedPacket> delivered_packets;
+
     template <class Archive>
     void serialize(Archive& ar, const unsigned int);
     friend class boost::serialization::access;
@@ -0,0 +1,41 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "core/hle/service/nwm/nwm_uds.h"
+#include "core/hle/service/nwm/uds_data.h"
+#include "core/hle/service/nwm/uds_packet_queue.h"
+
+namespace Service::NWM {
+
+PacketBatchType GetPacketBatchType(const Network::WifiPacket& packet) {
+    switch (packet.type) {
+    case Network::WifiPacket::PacketType::Beacon:
+        return PacketBatchType::Beacon;
+    case Network::WifiPacket::PacketType::Data:
+        if (GetFrameEtherType(packet.data) == EtherType::SecureData) {
+            return PacketBatchType::SecureData;
+        }
+        return PacketBatchType::Single;
+    default:
+        return PacketBatchType::Single;
+    }
+}
+
+void ReceivedPacketQueue::Push(const Network::WifiPacket& packet) {
+    std::scoped_lock lock(mutex);
+    packets.push_back({packet, std::chrono::steady_clock::now()});
+}
+
+void ReceivedPacketQueue::Take(std::vector<ReceivedPacket>& out_packets) {
+    out_packets.clear();
+    std::scoped_lock lock(mutex);
+    packets.swap(out_packets);
+}
+
+void ReceivedPacketQueue::Clear() {
+    std::scoped_lock lock(mutex);
+    packets.clear();
+}
+
+} // namespace Service::NWM
@@ -0,0 +1,77 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <mutex>
+#include <span>
+#include <vector>
+#include "network/room_member.h"
+
+namespace Service::NWM {
+
+/// Wifi packet received from the network, along with the time it was received at.
+struct ReceivedPacket {
+    Network::WifiPacket packet;
+    std::chrono::steady_clock::time_point received_time;
+};
+
+/// Kind of the consecutive received packets that are handled together.
+enum class PacketBatchType {
+    Beacon,     ///< Beacon frames, handled under the beacon lock.
+    SecureData, ///< SecureData frames, handled under the connection status and HLE locks.
+    Single,     ///< Any other frame, handled on its own.
+};
+
+/// Returns the kind of batch the specified packet belongs to.
+PacketBatchType GetPacketBatchType(const Network::WifiPacket& packet);
+
+/**
+ * Splits the packets into batches of consecutive packets of the same kind, and calls func with
+ * the kind and the packets of each batch, in the order they were received. Packets of the Single
+ * kind always make a batch of their own.
+ */
+template <typename Func>
+void ForEachPacketBatch(std::span<const ReceivedPacket> packets, Func&& func) {
+    auto begin = packets.begin();
+    while (begin != packets.end()) {
+        const PacketBatchType type = GetPacketBatchType(begin->packet);
+        auto end = std::next(begin);
+        if (type != PacketBatchType::Single) {
+            end = std::find_if(end, packets.end(), [type](const ReceivedPacket& received) {
+                return GetPacketBatchType(received.packet) != type;
+            });
+        }
+        func(type, std::span<const ReceivedPacket>{begin, end});
+        begin = end;
+    }
+}
+
+/**
+ * Packets received on the network thread, waiting to be taken by the emulation thread.
+ */
+class ReceivedPacketQueue {
+public:
+    /// Adds a packet to the queue, can be called from any thread.
+    void Push(const Network::WifiPacket& packet);
+
+    /**
+     * Replaces the contents of out_packets with the queued packets, in the order they were
+     * received. The storage of out_packets is reused by the queue, so that the steady stream of
+     * packets does not allocate.
+     */
+    void Take(std::vector<ReceivedPacket>& out_packets);
+
+    /// Drops all the queued packets.
+    void Clear();
+
+private:
+    std::mutex mutex;
+    std::vector<ReceivedPacket> packets;
+};
+
+} // namespace Service::NWM
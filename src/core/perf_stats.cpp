@@ -13,23 +13,49 @@
 #include <fmt/format.h>
 #include "common/file_util.h"
 #include "common/settings.h"
+#include "common/tracing.h"
 #include "core/core_timing.h"
+#include "core/hle/service/ipc_stats.h"
 #include "core/perf_stats.h"
 #include "video_core/gpu.h"
 
+#ifdef __linux__
+#include <cerrno>
+#include <ctime>
+#endif
+
 using namespace std::chrono_literals;
 using DoubleSecs = std::chrono::duration<double, std::chrono::seconds::period>;
 using std::chrono::duration_cast;
 using std::chrono::microseconds;
+using std::chrono::nanoseconds;
 
 constexpr double FRAME_LENGTH = 1.0 / SCREEN_REFRESH_RATE;
 // Purposefully ignore the first five frames, as there's a significant amount of overhead in
 // booting that we shouldn't account for
 constexpr std::size_t IgnoreFrames = 5;
 
+// Upper bound of the frame lengths kept for the frame time distribution, in case the stats are
+// never reset
+constexpr std::size_t MaxFrameLengths = 4096;
+
+// Bounds of the margin spun through before a frame limiting deadline
+constexpr nanoseconds MinSpinMargin = 100us;
+constexpr nanoseconds MaxSpinMargin = 2ms;
+
+// Host presents further apart or closer than this are not considered part of a steady refresh
+constexpr nanoseconds MinPresentInterval = 4ms;
+constexpr nanoseconds MaxPresentInterval = 50ms;
+// Presents older than this are too stale to predict the next ones from
+constexpr nanoseconds MaxPresentAge = 250ms;
+
+constexpr Common::Tracing::Category FrameCategory{"PerfStats", "Frame"};
+
 namespace Core {
 
-PerfStats::PerfStats(u64 title_id) : title_id(title_id) {}
+PerfStats::PerfStats(u64 title_id) : title_id(title_id) {
+    frame_lengths.reserve(MaxFrameLengths);
+}
 
 PerfStats::~PerfStats() {
     if (!Settings::values.record_frame_times || title_id == 0) {
@@ -43,9 +69,12 @@ PerfStats::~PerfStats() {
     const std::string& path = FileUtil::GetUserPath(FileUtil::UserPath::LogDir);
     // %F Date format expanded is "%Y-%m-%d"
     const std::string filename =
-        fmt::format("{}/{:%F-%H-%M}_{:016X}.csv", path, *std::localtime(&t), title_id);
-    FileUtil::IOFile file(filename, "w");
+        fmt::format("{}/{:%F-%H-%M}_{:016X}", path, *std::localtime(&t), title_id);
+    FileUtil::IOFile file(filename + ".csv", "w");
     file.WriteString(stream.str());
+
+    FileUtil::IOFile ipc_stats_file(filename + "_ipc.json", "w");
+    ipc_stats_file.WriteString(Service::IPCStats::DumpJson());
 }
 
 void PerfStats::BeginSVCProcessing() {
@@ -98,11 +127,20 @@ void PerfStats::EndSystemFrame() {
     accumulated_frametime += frame_time;
     system_frames += 1;
 
+    if (Common::Tracing::IsRecording()) {
+        const u64 trace_end = Common::Tracing::Now();
+        const auto trace_duration = duration_cast<std::chrono::nanoseconds>(frame_time).count();
+        Common::Tracing::RecordComplete(FrameCategory, trace_end - trace_duration, trace_end);
+    }
+
     // TODO: Track previous frame times in a less stupid way. -OS
     previous_previous_frame_length = previous_frame_length;
 
     previous_frame_length = frame_end - previous_frame_end;
     previous_frame_end = frame_end;
+    if (frame_lengths.size() < MaxFrameLengths) {
+        frame_lengths.push_back(duration_cast<DoubleSecs>(previous_frame_length).count());
+    }
 }
 
 void PerfStats::EndGameFrame() {
@@ -165,6 +203,45 @@ PerfStats::Results PerfStats::GetAndResetStats(microseconds current_system_time_
     last_stats.emulation_speed = system_us_per_second.count() / 1'000'000.0;
     last_stats.artic_transmitted = static_cast<double>(artic_transmitted) / interval;
     last_stats.artic_events.raw = artic_events.raw | prev_artic_event.raw;
+    last_stats.input_latency =
+        input_changes ? (duration_cast<DoubleSecs>(accumulated_input_latency).count() /
+                         static_cast<double>(input_changes))
+                      : 0;
+    last_stats.max_input_latency = duration_cast<DoubleSecs>(max_input_latency).count();
+    last_stats.uds_frames = static_cast<double>(uds_frames) / interval;
+    last_stats.uds_queue_delay =
+        uds_frames ? (duration_cast<DoubleSecs>(accumulated_uds_delay).count() /
+                      static_cast<double>(uds_frames))
+                   : 0;
+    last_stats.max_uds_queue_delay = duration_cast<DoubleSecs>(max_uds_delay).count();
+    // The audio counters start over when the DSP is created again
+    const auto audio_counted = [](u64 total, u64 total_at_reset) {
+        return total >= total_at_reset ? total - total_at_reset : total;
+    };
+    last_stats.audio_underruns =
+        static_cast<double>(audio_counted(audio_underruns, reset_audio_underruns)) / interval;
+    last_stats.audio_dropped_frames =
+        static_cast<double>(audio_counted(audio_dropped_frames, reset_audio_dropped_frames)) /
+        interval;
+    last_stats.audio_latency = duration_cast<DoubleSecs>(audio_latency).count();
+    if (!frame_lengths.empty()) {
+        const double count = static_cast<double>(frame_lengths.size());
+        const double mean =
+            std::accumulate(frame_lengths.begin(), frame_lengths.end(), 0.0) / count;
+        last_stats.frametime_variance =
+            std::accumulate(frame_lengths.begin(), frame_lengths.end(), 0.0,
+                            [mean](double sum, double length) {
+                                return sum + (length - mean) * (length - mean);
+                            }) /
+            count;
+        // The lengths are discarded below, so they can be partially sorted in place
+        const auto p99 = frame_lengths.begin() + (frame_lengths.size() * 99) / 100;
+        std::nth_element(frame_lengths.begin(), p99, frame_lengths.end());
+        last_stats.frametime_p99 = *p99;
+    } else {
+        last_stats.frametime_variance = 0;
+        last_stats.frametime_p99 = 0;
+    }
 
     // Reset counters
     reset_point = now;
@@ -178,10 +255,44 @@ PerfStats::Results PerfStats::GetAndResetStats(microseconds current_system_time_
     game_frames = 0;
     artic_transmitted = 0;
     prev_artic_event.raw &= artic_events.raw;
+    accumulated_input_latency = Clock::duration::zero();
+    max_input_latency = Clock::duration::zero();
+    input_changes = 0;
+    uds_frames = 0;
+    accumulated_uds_delay = Clock::duration::zero();
+    max_uds_delay = Clock::duration::zero();
+    reset_audio_underruns = audio_underruns;
+    reset_audio_dropped_frames = audio_dropped_frames;
+    frame_lengths.clear();
 
     return last_stats;
 }
 
+void PerfStats::AddInputLatency(nanoseconds latency) {
+    std::scoped_lock lock{object_mutex};
+
+    const auto duration = duration_cast<Clock::duration>(latency);
+    accumulated_input_latency += duration;
+    max_input_latency = std::max(max_input_latency, duration);
+    ++input_changes;
+}
+
+void PerfStats::AddUDSFrames(u32 frames, nanoseconds total_delay, nanoseconds max_delay) {
+    std::scoped_lock lock{object_mutex};
+
+    uds_frames += frames;
+    accumulated_uds_delay += duration_cast<Clock::duration>(total_delay);
+    max_uds_delay = std::max(max_uds_delay, duration_cast<Clock::duration>(max_delay));
+}
+
+void PerfStats::SetAudioOutputStats(u64 underruns, u64 dropped_frames, nanoseconds latency) {
+    std::scoped_lock lock{object_mutex};
+
+    audio_underruns = underruns;
+    audio_dropped_frames = dropped_frames;
+    audio_latency = duration_cast<Clock::duration>(latency);
+}
+
 PerfStats::Results PerfStats::GetLastStats() {
     std::scoped_lock lock{object_mutex};
 
@@ -232,15 +343,29 @@ void FrameLimiter::DoFrameLimiting(microseconds current_system_time_us) {
     // percent. High values means it'll take longer after a slow frame to recover and start limiting
     const microseconds max_lag_time_us = duration_cast<microseconds>(
         std::chrono::duration<double, std::chrono::microseconds::period>(25ms / sleep_scale));
-    frame_limiting_delta_err += duration_cast<microseconds>(
+    // Walltime the emulated time since the last invocation should take at the current speed
+    const microseconds frame_period = duration_cast<microseconds>(
         std::chrono::duration<double, std::chrono::microseconds::period>(
             (current_system_time_us - previous_system_time_us) / sleep_scale));
+    frame_limiting_delta_err += frame_period;
     frame_limiting_delta_err -= duration_cast<microseconds>(now - previous_walltime);
     frame_limiting_delta_err =
         std::clamp(frame_limiting_delta_err, -max_lag_time_us, max_lag_time_us);
 
     if (frame_limiting_delta_err > microseconds::zero()) {
-        std::this_thread::sleep_for(frame_limiting_delta_err);
+        const auto deadline = now + frame_limiting_delta_err;
+        switch (Settings::values.frame_pacing.GetValue()) {
+        case Settings::FramePacing::Sleep:
+            std::this_thread::sleep_for(frame_limiting_delta_err);
+            break;
+        case Settings::FramePacing::VSyncAligned:
+            SleepUntil(AlignToPresent(deadline, frame_period));
+            break;
+        case Settings::FramePacing::Precise:
+        default:
+            SleepUntil(deadline);
+            break;
+        }
         auto now_after_sleep = Clock::now();
         frame_limiting_delta_err -= duration_cast<microseconds>(now_after_sleep - now);
         now = now_after_sleep;
@@ -250,6 +375,69 @@ void FrameLimiter::DoFrameLimiting(microseconds current_system_time_us) {
     previous_walltime = now;
 }
 
+void FrameLimiter::OnPresent() {
+    const auto now = Clock::now();
+
+    std::scoped_lock lock{present_mutex};
+    const auto interval = now - last_present;
+    last_present = now;
+    if (interval < MinPresentInterval || interval > MaxPresentInterval) {
+        return;
+    }
+    present_period = present_period == Clock::duration::zero()
+                         ? interval
+                         : (present_period * 15 + interval) / 16;
+}
+
+void FrameLimiter::SleepUntil(Clock::time_point deadline) {
+    const auto sleep_deadline = deadline - spin_margin;
+    if (Clock::now() < sleep_deadline) {
+#ifdef __linux__
+        // steady_clock is CLOCK_MONOTONIC here, so its time points can be slept to directly. An
+        // absolute deadline doesn't drift when the sleep is interrupted by a signal.
+        const auto deadline_ns = duration_cast<nanoseconds>(sleep_deadline.time_since_epoch());
+        const timespec ts{
+            .tv_sec = static_cast<std::time_t>(deadline_ns.count() / 1'000'000'000),
+            .tv_nsec = static_cast<long>(deadline_ns.count() % 1'000'000'000),
+        };
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+        }
+#else
+        std::this_thread::sleep_until(sleep_deadline);
+#endif
+        // Keep the margin at about twice the usual wake-up latency of the OS
+        const auto oversleep = std::max(Clock::now() - sleep_deadline, Clock::duration::zero());
+        average_oversleep = (average_oversleep * 7 + oversleep) / 8;
+        spin_margin = std::clamp<Clock::duration>(average_oversleep * 2, MinSpinMargin,
+                                                  MaxSpinMargin);
+    }
+
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+FrameLimiter::Clock::time_point FrameLimiter::AlignToPresent(Clock::time_point deadline,
+                                                             Clock::duration frame_period) {
+    std::scoped_lock lock{present_mutex};
+
+    // Only line up with the host refresh when it is within 2% of the emulated one, otherwise the
+    // alignment would pull the emulated speed towards the host refresh rate.
+    if (present_period == Clock::duration::zero() ||
+        std::chrono::abs(present_period - frame_period) * 50 > frame_period ||
+        deadline < last_present || deadline - last_present > MaxPresentAge) {
+        return deadline;
+    }
+
+    // Host presents are predicted one period apart from the last one. Wake up at the nearest
+    // one, so that the frame is ready well before the present after it.
+    auto offset = (deadline - last_present) % present_period;
+    if (offset > present_period / 2) {
+        offset -= present_period;
+    }
+    return deadline - offset;
+}
+
 bool FrameLimiter::IsFrameAdvancing() const {
     return frame_advancing_enabled;
 }
@@ -9,6 +9,7 @@
 #include <chrono>
 #include <cstddef>
 #include <mutex>
+#include <vector>
 #include "common/bit_field.h"
 #include "common/common_types.h"
 #include "common/thread.h"
@@ -73,6 +74,27 @@ public:
         double artic_transmitted = 0;
         /// Artic base events
         PerfArticEvents artic_events{};
+        /// Mean walltime in seconds from an input device change to the HID update latching it
+        double input_latency = 0;
+        /// Longest walltime in seconds from an input device change to the HID update latching it
+        double max_input_latency = 0;
+        /// Variance in seconds squared of the walltime between system frames, including pacing
+        double frametime_variance = 0;
+        /// 99th percentile in seconds of the walltime between system frames, including pacing
+        double frametime_p99 = 0;
+        /// Local wireless frames handed to the emulated system per second
+        double uds_frames = 0;
+        /// Mean walltime in seconds the local wireless frames waited for their delivery
+        double uds_queue_delay = 0;
+        /// Longest walltime in seconds a local wireless frame waited for its delivery
+        double max_uds_queue_delay = 0;
+        /// Times per second the audio output ran dry
+        double audio_underruns = 0;
+        /// Audio frames per second dropped because the output was full or skipped to lower the
+        /// latency
+        double audio_dropped_frames = 0;
+        /// Walltime in seconds of the audio queued for the output, at the end of the interval
+        double audio_latency = 0;
     };
 
     void BeginSVCProcessing();
@@ -112,6 +134,19 @@ public:
         artic_transmitted += bytes;
     }
 
+    /// Records the walltime between an input device change and the HID update latching it.
+    void AddInputLatency(std::chrono::nanoseconds latency);
+
+    /// Records a batch of local wireless frames and how long they waited to be delivered.
+    void AddUDSFrames(u32 frames, std::chrono::nanoseconds total_delay,
+                      std::chrono::nanoseconds max_delay);
+
+    /**
+     * Records the counters of the audio output, which count from the creation of the DSP. The
+     * statistics report how much they grew since last reset.
+     */
+    void SetAudioOutputStats(u64 underruns, u64 dropped_frames, std::chrono::nanoseconds latency);
+
     void ReportPerfArticEvent(PerfArticEventBits event, bool set) {
         if (set) {
             artic_events.Set(event, set);
@@ -150,6 +185,31 @@ private:
 
     PerfArticEvents prev_artic_event;
 
+    /// Cumulative input latency of the input changes latched since last reset
+    Clock::duration accumulated_input_latency = Clock::duration::zero();
+    /// Longest input latency since last reset
+    Clock::duration max_input_latency = Clock::duration::zero();
+    /// Number of input changes latched since last reset
+    u32 input_changes = 0;
+
+    /// Number of local wireless frames delivered since last reset
+    u32 uds_frames = 0;
+    /// Cumulative time the local wireless frames waited for their delivery since last reset
+    Clock::duration accumulated_uds_delay = Clock::duration::zero();
+    /// Longest time a local wireless frame waited for its delivery since last reset
+    Clock::duration max_uds_delay = Clock::duration::zero();
+
+    /// Audio output counters as of the last update
+    u64 audio_underruns = 0;
+    u64 audio_dropped_frames = 0;
+    Clock::duration audio_latency = Clock::duration::zero();
+    /// Audio output counters as of the last reset
+    u64 reset_audio_underruns = 0;
+    u64 reset_audio_dropped_frames = 0;
+
+    /// Visible durations in seconds of the system frames since last reset
+    std::vector<double> frame_lengths;
+
     /// Point when the previous system frame ended
     Clock::time_point previous_frame_end = reset_point;
     /// Point when the current system frame began
@@ -177,10 +237,13 @@ private:
 
 class FrameLimiter {
 public:
-    using Clock = std::chrono::high_resolution_clock;
+    using Clock = std::chrono::steady_clock;
 
     void DoFrameLimiting(std::chrono::microseconds current_system_time_us);
 
+    /// Records that the host presented a frame to the display. Thread-safe.
+    void OnPresent();
+
     bool IsFrameAdvancing() const;
     /**
      * Sets whether frame advancing is enabled or not.
@@ -192,6 +255,12 @@ public:
     void WaitOnce();
 
 private:
+    /// Sleeps until the deadline, spinning for the last stretch that the OS may oversleep
+    void SleepUntil(Clock::time_point deadline);
+
+    /// Moves the deadline to the nearest predicted host present, if the host refresh matches
+    Clock::time_point AlignToPresent(Clock::time_point deadline, Clock::duration frame_period);
+
     /// Emulated system time (in microseconds) at the last limiter invocation
     std::chrono::microseconds previous_system_time_us{0};
     /// Walltime at the last limiter invocation
@@ -200,6 +269,17 @@ private:
     /// Accumulated difference between walltime and emulated time
     std::chrono::microseconds frame_limiting_delta_err{0};
 
+    /// Time before the deadline at which sleeping stops and spinning begins
+    Clock::duration spin_margin = std::chrono::milliseconds{1};
+    /// Moving average of how late the OS woke the limiter up from a sleep
+    Clock::duration average_oversleep = Clock::duration::zero();
+
+    std::mutex present_mutex;
+    /// Walltime of the last host present
+    Clock::time_point last_present{};
+    /// Moving average of the interval between host presents, zero if unknown
+    Clock::duration present_period = Clock::duration::zero();
+
     /// Whether to use frame advancing (i.e. frame by frame)
     std::atomic_bool frame_advancing_enabled;
 
@@ -8,12 +8,25 @@
 
 namespace Core::RPC {
 
-Packet::Packet(const PacketHeader& header_, u8* data,
-               std::function<void(Packet&)> send_reply_callback_)
-    : header{header_}, send_reply_callback{std::move(send_reply_callback_)} {
-    std::memcpy(packet_data.data(), data, std::min(header.packet_size, MAX_PACKET_DATA_SIZE));
+Packet::Packet(const PacketHeader& header_, const u8* data,
+               std::function<void(Packet&)> send_reply_callback_, u32 max_data_size_,
+               std::weak_ptr<void> client_)
+    : header{header_}, max_data_size{max_data_size_},
+      send_reply_callback{std::move(send_reply_callback_)}, client{std::move(client_)} {
+    const u32 size = std::min(header.packet_size, max_data_size);
+    packet_data.resize(std::max(size, MAX_PACKET_DATA_SIZE));
+    if (size > 0) {
+        std::memcpy(packet_data.data(), data, size);
+    }
 }
 
 Packet::~Packet() = default;
 
+std::span<u8> Packet::ReservePacketData(u32 size) {
+    if (size > packet_data.size()) {
+        packet_data.resize(std::min(size, max_data_size));
+    }
+    return packet_data;
+}
+
 }; // namespace Core::RPC
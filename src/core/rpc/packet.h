@@ -6,7 +6,9 @@
 
 #include <array>
 #include <functional>
+#include <memory>
 #include <span>
+#include <vector>
 #include "common/common_types.h"
 
 namespace Core::RPC {
@@ -17,6 +19,13 @@ enum class PacketType : u32 {
     WriteMemory = 2,
     ProcessList = 3,
     SetGetProcess = 4,
+    Trace = 5,
+    BulkReadMemory = 6,
+    ScatterReadMemory = 7,
+    Subscribe = 8,
+    Unsubscribe = 9,
+    SubscriptionUpdate = 10,
+    MemorySearch = 11,
 };
 
 struct PacketHeader {
@@ -42,10 +51,20 @@ constexpr u32 MAX_PACKET_SIZE = MIN_PACKET_SIZE + MAX_PACKET_DATA_SIZE;
 constexpr u32 MAX_READ_SIZE = MAX_PACKET_DATA_SIZE;
 constexpr u32 MAX_PROCESSES_IN_LIST = (MAX_PACKET_DATA_SIZE - sizeof(u32)) / sizeof(ProcessInfo);
 
+/// Stream connections send the same packets as the UDP server, prefixed by their header, but
+/// allow much larger data so that big memory regions can be read with a single request.
+constexpr u32 MAX_STREAM_PACKET_DATA_SIZE = 32 * 1024 * 1024;
+
 class Packet {
 public:
-    explicit Packet(const PacketHeader& header, u8* data,
-                    std::function<void(Packet&)> send_reply_callback);
+    /**
+     * @param max_data_size Largest reply the transport is able to send.
+     * @param client Connection the packet was received from, which stays alive as long as the
+     * client is connected. Only set by transports that can send packets to the client at any time.
+     */
+    explicit Packet(const PacketHeader& header, const u8* data,
+                    std::function<void(Packet&)> send_reply_callback,
+                    u32 max_data_size = MAX_PACKET_DATA_SIZE, std::weak_ptr<void> client = {});
     ~Packet();
 
     u32 GetVersion() const {
@@ -68,10 +87,25 @@ public:
         return header;
     }
 
-    std::span<u8, MAX_PACKET_DATA_SIZE> GetPacketData() {
+    std::span<u8> GetPacketData() {
         return packet_data;
     }
 
+    u32 GetMaxDataSize() const {
+        return max_data_size;
+    }
+
+    /// Grows the packet data to hold a reply of the given size, which must fit GetMaxDataSize.
+    std::span<u8> ReservePacketData(u32 size);
+
+    const std::weak_ptr<void>& GetClient() const {
+        return client;
+    }
+
+    const std::function<void(Packet&)>& GetSendReplyCallback() const {
+        return send_reply_callback;
+    }
+
     void SetPacketDataSize(u32 size) {
         header.packet_size = size;
     }
@@ -82,9 +116,11 @@ public:
 
 private:
     struct PacketHeader header;
-    std::array<u8, MAX_PACKET_DATA_SIZE> packet_data;
+    std::vector<u8> packet_data;
+    u32 max_data_size;
 
     std::function<void(Packet&)> send_reply_callback;
+    std::weak_ptr<void> client;
 };
 
 } // namespace Core::RPC
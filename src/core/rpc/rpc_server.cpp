@@ -2,45 +2,255 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <ctime>
+#include <utility>
+#include <fmt/chrono.h>
+#include <fmt/format.h>
+#include "common/file_util.h"
 #include "common/logging/log.h"
+#include "common/tracing.h"
 #include "core/core.h"
+#include "core/cheats/cheats.h"
+#include "core/core_timing.h"
 #include "core/hle/kernel/process.h"
 #include "core/memory.h"
 #include "core/rpc/packet.h"
 #include "core/rpc/rpc_server.h"
+#include "video_core/gpu.h"
 
 namespace Core::RPC {
 
-RPCServer::RPCServer(Core::System& system_) : system{system_} {
+namespace {
+
+/// Largest memory region that can be subscribed to, so that a full update fits a packet
+constexpr u32 MAX_SUBSCRIPTION_SIZE = MAX_STREAM_PACKET_DATA_SIZE / 2;
+
+/// Combined size of the regions a single client can subscribe to
+constexpr u64 MAX_SUBSCRIBED_BYTES_PER_CLIENT = MAX_SUBSCRIPTION_SIZE;
+
+/// Combined size of the regions all clients can subscribe to, as they are all read every frame
+constexpr u64 MAX_SUBSCRIBED_BYTES = MAX_SUBSCRIBED_BYTES_PER_CLIENT * 4;
+
+/// Granularity at which the changes of a subscribed region are detected
+constexpr u32 SUBSCRIPTION_BLOCK_SIZE = 64;
+
+} // Anonymous namespace
+
+RPCServer::RPCServer(Core::System& system_)
+    : system{system_}, subscription_budget{MAX_SUBSCRIBED_BYTES_PER_CLIENT, MAX_SUBSCRIBED_BYTES} {
     LOG_INFO(RPC_Server, "Starting RPC server.");
+    subscription_event = system.CoreTiming().RegisterEvent(
+        "RPCServer::subscription_event",
+        [this](u64, s64 cycles_late) { UpdateSubscriptions(cycles_late); });
+    system.CoreTiming().ScheduleEvent(VideoCore::FRAME_TICKS, subscription_event);
+
     request_handler_thread =
         std::jthread([this](std::stop_token stop_token) { HandleRequestsLoop(stop_token); });
 }
 
-RPCServer::~RPCServer() = default;
+RPCServer::~RPCServer() {
+    Stop();
+}
+
+void RPCServer::Stop() {
+    system.CoreTiming().UnscheduleEvent(subscription_event, 0);
+
+    if (request_handler_thread.joinable()) {
+        LOG_INFO(RPC_Server, "Stopping RPC server.");
+        request_queue.Push(nullptr); // Notify the request handler to end
+        request_handler_thread.join();
+    }
+
+    // The subscriptions hold callbacks into the connections of their clients.
+    std::scoped_lock lock{subscriptions_mutex};
+    subscriptions.clear();
+}
+
+bool RPCServer::ReadGuestMemory(u32 process_id, u32 address, std::span<u8> data) {
+    // Note: Memory read occurs asynchronously from the state of the emulator
+    if (process_id == 0xFFFFFFFF) {
+        system.Memory().ReadBlock(address, data.data(), data.size());
+        return true;
+    }
+
+    auto process = system.Kernel().GetProcessById(process_id);
+    if (!process) {
+        LOG_ERROR(RPC_Server, "Selected process does not exist.");
+        return false;
+    }
+    system.Memory().ReadBlock(*process, address, data.data(), data.size());
+    return true;
+}
 
 void RPCServer::HandleReadMemory(Packet& packet, u32 address, u32 data_size) {
     if (data_size > MAX_READ_SIZE) {
         return;
     }
-    u32 read_size = data_size;
 
-    // Note: Memory read occurs asynchronously from the state of the emulator
     if (selected_pid == 0xFFFFFFFF) {
         LOG_ERROR(RPC_Server, "No target process selected, memory access may be invalid.");
-        system.Memory().ReadBlock(address, packet.GetPacketData().data(), data_size);
-    } else {
-        auto process = system.Kernel().GetProcessById(selected_pid);
-        if (process) {
-            system.Memory().ReadBlock(*process, address, packet.GetPacketData().data(), data_size);
+    }
+    const bool success =
+        ReadGuestMemory(selected_pid, address, packet.GetPacketData().first(data_size));
+
+    packet.SetPacketDataSize(success ? data_size : 0);
+    packet.SendReply();
+}
+
+void RPCServer::HandleBulkReadMemory(Packet& packet, u32 address, u32 data_size) {
+    const auto data = packet.ReservePacketData(data_size).first(data_size);
+    const bool success = ReadGuestMemory(selected_pid, address, data);
+
+    packet.SetPacketDataSize(success ? data_size : 0);
+    packet.SendReply();
+}
+
+void RPCServer::HandleScatterReadMemory(Packet& packet, std::span<const u8> regions) {
+    // Copy the regions first, the reply overwrites them.
+    std::vector<std::pair<u32, u32>> requested_regions(regions.size() / (sizeof(u32) * 2));
+    u64 total_size = 0;
+    for (std::size_t i = 0; i < requested_regions.size(); ++i) {
+        auto& [address, size] = requested_regions[i];
+        std::memcpy(&address, regions.data() + i * sizeof(u32) * 2, sizeof(u32));
+        std::memcpy(&size, regions.data() + i * sizeof(u32) * 2 + sizeof(u32), sizeof(u32));
+        total_size += size;
+    }
+
+    u32 written_bytes = 0;
+    if (total_size <= packet.GetMaxDataSize()) {
+        const auto data = packet.ReservePacketData(static_cast<u32>(total_size));
+        for (const auto& [address, size] : requested_regions) {
+            if (!ReadGuestMemory(selected_pid, address, data.subspan(written_bytes, size))) {
+                written_bytes = 0;
+                break;
+            }
+            written_bytes += size;
+        }
+    }
+
+    packet.SetPacketDataSize(written_bytes);
+    packet.SendReply();
+}
+
+void RPCServer::HandleSubscribe(Packet& packet, u32 address, u32 data_size) {
+    // Updates can only be pushed to clients of stream connections
+    if (data_size == 0 || data_size > MAX_SUBSCRIPTION_SIZE || packet.GetClient().expired()) {
+        packet.SetPacketDataSize(0);
+        packet.SendReply();
+        return;
+    }
+
+    // Reply before the update thread can see the subscription, so that the client receives the
+    // subscription id before its first update.
+    std::scoped_lock lock{subscriptions_mutex};
+    if (!subscription_budget.Acquire(packet.GetClient(), data_size)) {
+        LOG_WARNING(RPC_Server, "Rejected subscription of {} bytes, {} bytes already subscribed",
+                    data_size, subscription_budget.GetTotalBytes());
+        packet.SetPacketDataSize(0);
+        packet.SendReply();
+        return;
+    }
+    const u32 id = next_subscription_id++;
+    subscriptions.push_back(Subscription{
+        .id = id,
+        .process_id = selected_pid,
+        .address = address,
+        .sent_data = {},
+        .current_data = std::vector<u8>(data_size),
+        .client = packet.GetClient(),
+        .send_callback = packet.GetSendReplyCallback(),
+    });
+
+    std::memcpy(packet.GetPacketData().data(), &id, sizeof(id));
+    packet.SetPacketDataSize(sizeof(id));
+    packet.SendReply();
+}
+
+void RPCServer::HandleUnsubscribe(Packet& packet, u32 subscription_id) {
+    {
+        std::scoped_lock lock{subscriptions_mutex};
+        const auto& client = packet.GetClient();
+        std::erase_if(subscriptions, [&](const Subscription& subscription) {
+            const bool same_client = !subscription.client.owner_before(client) &&
+                                     !client.owner_before(subscription.client);
+            if (subscription.id != subscription_id || !same_client) {
+                return false;
+            }
+            const auto size = static_cast<u32>(subscription.current_data.size());
+            subscription_budget.Release(client, size);
+            return true;
+        });
+    }
+
+    packet.SetPacketDataSize(0);
+    packet.SendReply();
+}
+
+void RPCServer::UpdateSubscriptions(s64 cycles_late) {
+    {
+        std::scoped_lock lock{subscriptions_mutex};
+        // Drop the subscriptions of the clients that disconnected.
+        std::erase_if(subscriptions, [this](const Subscription& subscription) {
+            if (!subscription.client.expired()) {
+                return false;
+            }
+            const auto size = static_cast<u32>(subscription.current_data.size());
+            subscription_budget.Release(subscription.client, size);
+            return true;
+        });
+        for (auto& subscription : subscriptions) {
+            SendSubscriptionUpdate(subscription);
+        }
+    }
+    system.CoreTiming().ScheduleEvent(VideoCore::FRAME_TICKS - cycles_late, subscription_event);
+}
+
+void RPCServer::SendSubscriptionUpdate(Subscription& subscription) {
+    auto& current_data = subscription.current_data;
+    if (!ReadGuestMemory(subscription.process_id, subscription.address, current_data)) {
+        return;
+    }
+
+    // Collect the runs of changed blocks, the first update sends the whole region.
+    const bool first_update = subscription.sent_data.empty();
+    const u32 size = static_cast<u32>(current_data.size());
+    std::vector<std::pair<u32, u32>> runs;
+    u32 update_size = 0;
+    for (u32 offset = 0; offset < size; offset += SUBSCRIPTION_BLOCK_SIZE) {
+        const u32 block_size = std::min(SUBSCRIPTION_BLOCK_SIZE, size - offset);
+        if (!first_update && std::memcmp(current_data.data() + offset,
+                                         subscription.sent_data.data() + offset, block_size) == 0) {
+            continue;
+        }
+        if (!runs.empty() && runs.back().first + runs.back().second == offset) {
+            runs.back().second += block_size;
         } else {
-            LOG_ERROR(RPC_Server, "Selected process does not exist.");
-            read_size = 0;
+            runs.emplace_back(offset, block_size);
+            update_size += sizeof(u32) * 2;
         }
+        update_size += block_size;
+    }
+    if (runs.empty()) {
+        return;
     }
 
-    packet.SetPacketDataSize(read_size);
+    // Each run is sent as its address and size, followed by its contents.
+    const PacketHeader header{CURRENT_VERSION, subscription.id, PacketType::SubscriptionUpdate, 0};
+    Packet packet{header, nullptr, subscription.send_callback, MAX_STREAM_PACKET_DATA_SIZE};
+    u8* out_data = packet.ReservePacketData(update_size).data();
+    for (const auto& [offset, run_size] : runs) {
+        const u32 run_address = subscription.address + offset;
+        std::memcpy(out_data, &run_address, sizeof(u32));
+        std::memcpy(out_data + sizeof(u32), &run_size, sizeof(u32));
+        std::memcpy(out_data + sizeof(u32) * 2, current_data.data() + offset, run_size);
+        out_data += sizeof(u32) * 2 + run_size;
+    }
+    packet.SetPacketDataSize(update_size);
     packet.SendReply();
+
+    std::swap(subscription.sent_data, current_data);
+    current_data.resize(size);
 }
 
 void RPCServer::HandleWriteMemory(Packet& packet, u32 address, std::span<const u8> data) {
@@ -115,6 +325,90 @@ void RPCServer::HandleSetGetProcess(Packet& packet, u32 operation, u32 process_i
     packet.SendReply();
 }
 
+void RPCServer::HandleTrace(Packet& packet, u32 operation, u32 events_per_thread) {
+    u32 written_bytes = 0;
+
+    switch (operation) {
+    case 0:
+        // Stop
+        Common::Tracing::Stop();
+        break;
+    case 1:
+        // Start
+        Common::Tracing::Start(events_per_thread != 0 ? events_per_thread
+                                                      : Common::Tracing::DefaultEventsPerThread);
+        break;
+    default: {
+        // Dump, the trace is written to the log directory and its path is sent back
+        const std::time_t t = std::time(nullptr);
+        const std::string path =
+            fmt::format("{}/trace_{:%F-%H-%M-%S}.json",
+                        FileUtil::GetUserPath(FileUtil::UserPath::LogDir), *std::localtime(&t));
+        if (Common::Tracing::Dump(path)) {
+            written_bytes =
+                static_cast<u32>(std::min<std::size_t>(path.size(), MAX_PACKET_DATA_SIZE));
+            std::memcpy(packet.GetPacketData().data(), path.data(), written_bytes);
+        }
+        break;
+    }
+    }
+
+    packet.SetPacketDataSize(written_bytes);
+    packet.SendReply();
+}
+
+void RPCServer::HandleMemorySearch(Packet& packet, u32 operation, u32 argument,
+                                   std::span<const u8> operands) {
+    auto& scanner = system.CheatEngine().GetMemoryScanner();
+    u32 written_bytes = 0;
+    const auto reply_count = [&packet, &written_bytes](std::size_t count) {
+        const auto value = static_cast<u32>(std::min<std::size_t>(count, 0xFFFFFFFF));
+        std::memcpy(packet.GetPacketData().data(), &value, sizeof(value));
+        written_bytes = sizeof(value);
+    };
+
+    switch (operation) {
+    case 0: {
+        // Start, the argument is the value type
+        u32 process_id = selected_pid;
+        if (process_id == 0xFFFFFFFF) {
+            const auto process = system.Kernel().GetCurrentProcess();
+            process_id = process ? process->process_id : 0xFFFFFFFF;
+        }
+        reply_count(scanner.Start(process_id, static_cast<Cheats::ScanValueType>(argument)));
+        break;
+    }
+    case 1: {
+        // Scan, the argument is the comparison and the operands follow the arguments
+        Cheats::ScanFilter filter{static_cast<Cheats::ScanComparison>(argument), 0, 0};
+        std::memcpy(&filter.first, operands.data(), sizeof(u32));
+        std::memcpy(&filter.second, operands.data() + sizeof(u32), sizeof(u32));
+        reply_count(scanner.Scan(filter));
+        break;
+    }
+    case 2: {
+        // Results, the argument is the index of the first candidate to send
+        const std::size_t max_results = packet.GetMaxDataSize() / (sizeof(u32) * 2);
+        const auto results = scanner.GetResults(argument, max_results);
+        const auto data =
+            packet.ReservePacketData(static_cast<u32>(results.size() * sizeof(u32) * 2));
+        for (const auto& result : results) {
+            const u32 entry[2] = {result.address, result.value};
+            std::memcpy(data.data() + written_bytes, entry, sizeof(entry));
+            written_bytes += sizeof(entry);
+        }
+        break;
+    }
+    default:
+        // Reset
+        scanner.Reset();
+        break;
+    }
+
+    packet.SetPacketDataSize(written_bytes);
+    packet.SendReply();
+}
+
 bool RPCServer::ValidatePacket(const PacketHeader& packet_header) {
     if (packet_header.version <= CURRENT_VERSION) {
         switch (packet_header.packet_type) {
@@ -122,6 +416,12 @@ bool RPCServer::ValidatePacket(const PacketHeader& packet_header) {
         case PacketType::WriteMemory:
         case PacketType::ProcessList:
         case PacketType::SetGetProcess:
+        case PacketType::Trace:
+        case PacketType::BulkReadMemory:
+        case PacketType::ScatterReadMemory:
+        case PacketType::Subscribe:
+        case PacketType::Unsubscribe:
+        case PacketType::MemorySearch:
             if (packet_header.packet_size >= (sizeof(u32) * 2)) {
                 return true;
             }
@@ -166,6 +466,51 @@ void RPCServer::HandleSingleRequest(std::unique_ptr<Packet> request_packet) {
             HandleSetGetProcess(*request_packet, arg1, arg2);
             success = true;
             break;
+        case PacketType::Trace:
+            // Starts take the number of events kept for each thread
+            if (arg1 != 1 || arg2 <= Common::Tracing::MaxEventsPerThread) {
+                HandleTrace(*request_packet, arg1, arg2);
+                success = true;
+            }
+            break;
+        case PacketType::BulkReadMemory:
+            if (arg2 > 0 && arg2 <= request_packet->GetMaxDataSize()) {
+                HandleBulkReadMemory(*request_packet, arg1, arg2);
+                success = true;
+            }
+            break;
+        case PacketType::ScatterReadMemory: {
+            // The regions follow the arguments, as pairs of address and size
+            const u64 regions_size = u64{arg1} * sizeof(u32) * 2;
+            if (regions_size <= request_packet->GetPacketDataSize() - sizeof(u32) * 2) {
+                const auto regions = packet_data.subspan(sizeof(u32) * 2, regions_size);
+                HandleScatterReadMemory(*request_packet, regions);
+                success = true;
+            }
+            break;
+        }
+        case PacketType::Subscribe:
+            HandleSubscribe(*request_packet, arg1, arg2);
+            success = true;
+            break;
+        case PacketType::Unsubscribe:
+            HandleUnsubscribe(*request_packet, arg1);
+            success = true;
+            break;
+        case PacketType::MemorySearch: {
+            // Starts take a value type, scans take a comparison followed by two operands
+            const bool valid_start =
+                arg1 != 0 || arg2 <= static_cast<u32>(Cheats::ScanValueType::Float);
+            const bool valid_scan =
+                arg1 != 1 || (arg2 <= static_cast<u32>(Cheats::ScanComparison::Unchanged) &&
+                              request_packet->GetPacketDataSize() >= sizeof(u32) * 4);
+            if (valid_start && valid_scan) {
+                HandleMemorySearch(*request_packet, arg1, arg2,
+                                   packet_data.subspan(sizeof(u32) * 2));
+                success = true;
+            }
+            break;
+        }
         default:
             break;
         }
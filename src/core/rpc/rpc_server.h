@@ -5,13 +5,18 @@
 #pragma once
 
 #include <condition_variable>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <span>
+#include <vector>
 #include "common/polyfill_thread.h"
 #include "common/threadsafe_queue.h"
+#include "core/rpc/subscription_budget.h"
 
 namespace Core {
 class System;
+struct TimingEventType;
 }
 
 namespace Core::RPC {
@@ -26,20 +31,57 @@ public:
 
     void QueueRequest(std::unique_ptr<RPC::Packet> request);
 
+    /// Stops the subscription updates and the request handler thread, once the queued requests
+    /// are handled. Nothing is sent to the clients afterwards.
+    void Stop();
+
 private:
     void HandleReadMemory(Packet& packet, u32 address, u32 data_size);
     void HandleWriteMemory(Packet& packet, u32 address, std::span<const u8> data);
     void HandleProcessList(Packet& packet, u32 start_index, u32 max_amount);
     void HandleSetGetProcess(Packet& packet, u32 operation, u32 process_id);
+    void HandleTrace(Packet& packet, u32 operation, u32 events_per_thread);
+    void HandleBulkReadMemory(Packet& packet, u32 address, u32 data_size);
+    void HandleScatterReadMemory(Packet& packet, std::span<const u8> regions);
+    void HandleSubscribe(Packet& packet, u32 address, u32 data_size);
+    void HandleUnsubscribe(Packet& packet, u32 subscription_id);
+    void HandleMemorySearch(Packet& packet, u32 operation, u32 argument,
+                            std::span<const u8> operands);
     bool ValidatePacket(const PacketHeader& packet_header);
     void HandleSingleRequest(std::unique_ptr<Packet> request);
     void HandleRequestsLoop(std::stop_token stop_token);
 
+    /// Reads guest memory of the given process, or of the current process if none was selected.
+    bool ReadGuestMemory(u32 process_id, u32 address, std::span<u8> data);
+
+    /// Sends the changes of the subscribed regions to their clients, called once per frame.
+    void UpdateSubscriptions(s64 cycles_late);
+
 private:
+    /// Memory region whose changes are pushed to a stream client every frame
+    struct Subscription {
+        u32 id;
+        u32 process_id;
+        u32 address;
+        /// Contents of the region sent to the client, empty until the first update
+        std::vector<u8> sent_data;
+        std::vector<u8> current_data;
+        std::weak_ptr<void> client;
+        std::function<void(Packet&)> send_callback;
+    };
+
+    void SendSubscriptionUpdate(Subscription& subscription);
+
     Core::System& system;
-    Common::SPSCQueue<std::unique_ptr<Packet>, true> request_queue;
+    Common::MPSCQueue<std::unique_ptr<Packet>, true> request_queue;
     std::jthread request_handler_thread;
     u32 selected_pid = 0xFFFFFFFF;
+
+    std::mutex subscriptions_mutex;
+    std::vector<Subscription> subscriptions;
+    SubscriptionBudget subscription_budget;
+    u32 next_subscription_id = 1;
+    Core::TimingEventType* subscription_event;
 };
 
 } // namespace Core::RPC
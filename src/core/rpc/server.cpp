@@ -6,6 +6,7 @@
 #include "core/rpc/packet.h"
 #include "core/rpc/rpc_server.h"
 #include "core/rpc/server.h"
+#include "core/rpc/tcp_server.h"
 #include "core/rpc/udp_server.h"
 
 namespace Core::RPC {
@@ -20,21 +21,25 @@ Server::Server(Core::System& system_) : rpc_server{system_} {
     } catch (...) {
         LOG_ERROR(RPC_Server, "Error starting UDP server");
     }
+
+    try {
+        tcp_server = std::make_unique<TCPServer>(callback);
+    } catch (...) {
+        LOG_ERROR(RPC_Server, "Error starting TCP server");
+    }
 }
 
 Server::~Server() {
+    // Stop handling requests and pushing updates first, those reply through the transports.
+    rpc_server.Stop();
     udp_server.reset();
-    NewRequestCallback(nullptr); // Notify the RPC server to end
+    tcp_server.reset();
 }
 
 void Server::NewRequestCallback(std::unique_ptr<RPC::Packet> new_request) {
-    if (new_request) {
-        LOG_INFO(RPC_Server, "Received request version={} id={} type={} size={}",
-                 new_request->GetVersion(), new_request->GetId(), new_request->GetPacketType(),
-                 new_request->GetPacketDataSize());
-    } else {
-        LOG_INFO(RPC_Server, "Received end packet");
-    }
+    LOG_DEBUG(RPC_Server, "Received request version={} id={} type={} size={}",
+              new_request->GetVersion(), new_request->GetId(), new_request->GetPacketType(),
+              new_request->GetPacketDataSize());
     rpc_server.QueueRequest(std::move(new_request));
 }
 
@@ -14,6 +14,7 @@ class System;
 namespace Core::RPC {
 
 class UDPServer;
+class TCPServer;
 class Packet;
 
 class Server {
@@ -26,6 +27,7 @@ public:
 private:
     RPCServer rpc_server;
     std::unique_ptr<UDPServer> udp_server;
+    std::unique_ptr<TCPServer> tcp_server;
 };
 
 } // namespace Core::RPC
@@ -0,0 +1,46 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/assert.h"
+#include "core/rpc/subscription_budget.h"
+
+namespace Core::RPC {
+
+SubscriptionBudget::SubscriptionBudget(u64 max_bytes_per_client_, u64 max_total_bytes_)
+    : max_bytes_per_client{max_bytes_per_client_}, max_total_bytes{max_total_bytes_} {}
+
+SubscriptionBudget::~SubscriptionBudget() = default;
+
+bool SubscriptionBudget::Acquire(const std::weak_ptr<void>& client, u32 size) {
+    if (total_bytes + size > max_total_bytes) {
+        return false;
+    }
+    u64& bytes = client_bytes[client];
+    if (bytes + size > max_bytes_per_client) {
+        if (bytes == 0) {
+            client_bytes.erase(client);
+        }
+        return false;
+    }
+    bytes += size;
+    total_bytes += size;
+    return true;
+}
+
+void SubscriptionBudget::Release(const std::weak_ptr<void>& client, u32 size) {
+    const auto it = client_bytes.find(client);
+    ASSERT(it != client_bytes.end() && it->second >= size);
+    it->second -= size;
+    total_bytes -= size;
+    if (it->second == 0) {
+        client_bytes.erase(it);
+    }
+}
+
+u64 SubscriptionBudget::GetClientBytes(const std::weak_ptr<void>& client) const {
+    const auto it = client_bytes.find(client);
+    return it != client_bytes.end() ? it->second : 0;
+}
+
+} // namespace Core::RPC
@@ -0,0 +1,47 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include "common/common_types.h"
+
+namespace Core::RPC {
+
+/**
+ * Accounts for the memory subscribed to by the stream clients. Every subscribed byte is copied
+ * and compared once per frame, so the combined size is bounded both per client and in total.
+ */
+class SubscriptionBudget {
+public:
+    explicit SubscriptionBudget(u64 max_bytes_per_client, u64 max_total_bytes);
+    ~SubscriptionBudget();
+
+    /**
+     * Reserves size bytes for a new subscription of the client.
+     * @returns false if the reservation would exceed one of the limits.
+     */
+    bool Acquire(const std::weak_ptr<void>& client, u32 size);
+
+    /// Gives the bytes of a removed subscription back to the budget.
+    void Release(const std::weak_ptr<void>& client, u32 size);
+
+    /// Returns the bytes currently subscribed to by the client.
+    u64 GetClientBytes(const std::weak_ptr<void>& client) const;
+
+    /// Returns the bytes currently subscribed to by all clients.
+    u64 GetTotalBytes() const {
+        return total_bytes;
+    }
+
+private:
+    u64 max_bytes_per_client;
+    u64 max_total_bytes;
+    u64 total_bytes{};
+    /// Clients are compared by owner so that entries stay ordered after they disconnect
+    std::map<std::weak_ptr<void>, u64, std::owner_less<std::weak_ptr<void>>> client_bytes;
+};
+
+} // namespace Core::RPC
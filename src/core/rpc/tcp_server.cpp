@@ -0,0 +1,155 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <deque>
+#include <thread>
+#include <vector>
+#include <boost/asio.hpp>
+#include "common/common_types.h"
+#include "common/logging/log.h"
+#include "core/rpc/packet.h"
+#include "core/rpc/tcp_server.h"
+
+namespace Core::RPC {
+
+using boost::asio::ip::tcp;
+
+namespace {
+
+class Connection : public std::enable_shared_from_this<Connection> {
+public:
+    explicit Connection(tcp::socket socket_,
+                        const std::function<void(std::unique_ptr<Packet>)>& new_request_callback_)
+        : socket(std::move(socket_)), new_request_callback(new_request_callback_) {}
+
+    void Start() {
+        ReadHeader();
+    }
+
+    /// Queues a packet to be sent to the client, can be called from any thread.
+    void Send(Packet& packet) {
+        const auto data = packet.GetPacketData().first(packet.GetPacketDataSize());
+        std::vector<u8> buffer(MIN_PACKET_SIZE + data.size());
+        std::memcpy(buffer.data(), &packet.GetHeader(), MIN_PACKET_SIZE);
+        std::memcpy(buffer.data() + MIN_PACKET_SIZE, data.data(), data.size());
+
+        boost::asio::post(socket.get_executor(),
+                          [self = shared_from_this(), buffer = std::move(buffer)]() mutable {
+                              self->write_queue.push_back(std::move(buffer));
+                              if (self->write_queue.size() == 1) {
+                                  self->WriteNext();
+                              }
+                          });
+    }
+
+private:
+    void ReadHeader() {
+        boost::asio::async_read(
+            socket, boost::asio::buffer(&header, sizeof(header)),
+            [self = shared_from_this()](const boost::system::error_code& error, std::size_t) {
+                if (error) {
+                    // The connection is released with its last pending operation.
+                    return;
+                }
+                if (self->header.packet_size > MAX_STREAM_PACKET_DATA_SIZE) {
+                    LOG_WARNING(RPC_Server, "Received message with wrong size: {}",
+                                self->header.packet_size);
+                    return;
+                }
+                self->request_data.resize(self->header.packet_size);
+                self->ReadData();
+            });
+    }
+
+    void ReadData() {
+        boost::asio::async_read(
+            socket, boost::asio::buffer(request_data),
+            [self = shared_from_this()](const boost::system::error_code& error, std::size_t) {
+                if (error) {
+                    return;
+                }
+                const std::weak_ptr<Connection> weak_self = self;
+                auto send_reply_callback = [weak_self](Packet& reply_packet) {
+                    if (const auto connection = weak_self.lock()) {
+                        connection->Send(reply_packet);
+                    }
+                };
+                self->new_request_callback(std::make_unique<Packet>(
+                    self->header, self->request_data.data(), std::move(send_reply_callback),
+                    MAX_STREAM_PACKET_DATA_SIZE, weak_self));
+                self->ReadHeader();
+            });
+    }
+
+    void WriteNext() {
+        boost::asio::async_write(
+            socket, boost::asio::buffer(write_queue.front()),
+            [self = shared_from_this()](const boost::system::error_code& error, std::size_t) {
+                if (error) {
+                    LOG_WARNING(RPC_Server, "Failed to send reply: {}", error.message());
+                    self->write_queue.clear();
+                    return;
+                }
+                self->write_queue.pop_front();
+                if (!self->write_queue.empty()) {
+                    self->WriteNext();
+                }
+            });
+    }
+
+    tcp::socket socket;
+    std::function<void(std::unique_ptr<Packet>)> new_request_callback;
+    PacketHeader header{};
+    std::vector<u8> request_data;
+    std::deque<std::vector<u8>> write_queue;
+};
+
+} // Anonymous namespace
+
+class TCPServer::Impl {
+public:
+    explicit Impl(std::function<void(std::unique_ptr<Packet>)> new_request_callback)
+        // Use the same port as the UDP server
+        : acceptor(io_context, tcp::endpoint(tcp::v4(), 45987)),
+          new_request_callback(std::move(new_request_callback)) {
+
+        StartAccept();
+        worker_thread = std::thread([this] { io_context.run(); });
+    }
+
+    ~Impl() {
+        io_context.stop();
+        worker_thread.join();
+    }
+
+private:
+    void StartAccept() {
+        acceptor.async_accept([this](const boost::system::error_code& error, tcp::socket socket) {
+            if (error) {
+                LOG_WARNING(RPC_Server, "Failed to accept connection: {}", error.message());
+            } else {
+                LOG_INFO(RPC_Server, "Accepted stream connection");
+                // Replies are latency sensitive, do not wait to coalesce them.
+                boost::system::error_code option_error;
+                socket.set_option(tcp::no_delay(true), option_error);
+                std::make_shared<Connection>(std::move(socket), new_request_callback)->Start();
+            }
+            StartAccept();
+        });
+    }
+
+    std::thread worker_thread;
+
+    boost::asio::io_context io_context;
+    tcp::acceptor acceptor;
+
+    std::function<void(std::unique_ptr<Packet>)> new_request_callback;
+};
+
+TCPServer::TCPServer(std::function<void(std::unique_ptr<Packet>)> new_request_callback)
+    : impl(std::make_unique<Impl>(new_request_callback)) {}
+
+TCPServer::~TCPServer() = default;
+
+} // namespace Core::RPC
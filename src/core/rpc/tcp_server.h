@@ -0,0 +1,25 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+
+namespace Core::RPC {
+
+class Packet;
+
+/// Accepts stream connections, on which each packet is its header followed by its data.
+class TCPServer {
+public:
+    explicit TCPServer(std::function<void(std::unique_ptr<Packet>)> new_request_callback);
+    ~TCPServer();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+} // namespace Core::RPC
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include "input_common/analog_from_button.h"
 
 namespace InputCommon {
@@ -51,6 +52,14 @@ public:
                                y * coef * (x == 0 ? 1.0f : SQRT_HALF));
     }
 
+    Input::Clock::time_point GetLastChangeTime() const override {
+        return std::max({up->GetLastChangeTime(), down->GetLastChangeTime(),
+                         left->GetLastChangeTime(), right->GetLastChangeTime(),
+                         up_left->GetLastChangeTime(), up_right->GetLastChangeTime(),
+                         down_left->GetLastChangeTime(), down_right->GetLastChangeTime(),
+                         modifier->GetLastChangeTime()});
+    }
+
 private:
     Button up;
     Button down;
@@ -132,6 +132,7 @@ void Adapter::UpdateStateButtons(std::size_t port, u8 b1, u8 b2) {
         PadButton::TriggerR,
         PadButton::TriggerL,
     };
+    const u16 previous_buttons = pads[port].buttons;
     pads[port].buttons = 0;
     for (std::size_t i = 0; i < b1_buttons.size(); ++i) {
         if ((b1 & (1U << i)) != 0) {
@@ -148,6 +149,9 @@ void Adapter::UpdateStateButtons(std::size_t port, u8 b1, u8 b2) {
             pads[port].last_button = b2_buttons[j];
         }
     }
+    if (pads[port].buttons != previous_buttons) {
+        pads[port].last_change = Input::Clock::now();
+    }
 }
 
 void Adapter::UpdateStateAxes(std::size_t port, const AdapterPayload& adapter_payload) {
@@ -167,8 +171,11 @@ void Adapter::UpdateStateAxes(std::size_t port, const AdapterPayload& adapter_pa
         if (pads[port].axis_origin[index] == 255) {
             pads[port].axis_origin[index] = axis_value;
         }
-        pads[port].axis_values[index] =
-            static_cast<s16>(axis_value - pads[port].axis_origin[index]);
+        const auto value = static_cast<s16>(axis_value - pads[port].axis_origin[index]);
+        if (pads[port].axis_values[index] != value) {
+            pads[port].axis_values[index] = value;
+            pads[port].last_change = Input::Clock::now();
+        }
     }
 }
 
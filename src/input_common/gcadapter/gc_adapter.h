@@ -6,12 +6,14 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <functional>
 #include <mutex>
 #include <thread>
 #include <vector>
 #include "common/common_types.h"
 #include "common/threadsafe_queue.h"
+#include "core/frontend/input.h"
 
 struct libusb_context;
 struct libusb_device;
@@ -73,6 +75,8 @@ struct GCController {
     PadButton last_button{};
     std::array<s16, 6> axis_values{};
     std::array<u8, 6> axis_origin{};
+    /// When the buttons or the axes last changed
+    std::atomic<Input::Clock::time_point> last_change{};
 };
 
 class Adapter {
@@ -47,6 +47,10 @@ public:
         return false;
     }
 
+    Input::Clock::time_point GetLastChangeTime() const override {
+        return gcadapter->GetPadState(port).last_change;
+    }
+
 private:
     const int port;
     const int button;
@@ -72,6 +76,10 @@ public:
         return false;
     }
 
+    Input::Clock::time_point GetLastChangeTime() const override {
+        return gcadapter->GetPadState(port).last_change;
+    }
+
 private:
     const u32 port;
     const u32 axis;
@@ -208,6 +216,10 @@ public:
         return {0.0f, 0.0f};
     }
 
+    Input::Clock::time_point GetLastChangeTime() const override {
+        return gcadapter->GetPadState(port).last_change;
+    }
+
 private:
     const u32 port;
     const u32 axis_x;
@@ -11,26 +11,38 @@
 
 namespace InputCommon {
 
+struct KeyButtonPair {
+    explicit KeyButtonPair(int key_code_) : key_code(key_code_) {}
+
+    void SetStatus(bool pressed) {
+        if (status.exchange(pressed) != pressed) {
+            last_change.store(Input::Clock::now());
+        }
+    }
+
+    int key_code;
+    std::atomic<bool> status{false};
+    std::atomic<Input::Clock::time_point> last_change{};
+};
+
 class KeyButton final : public Input::ButtonDevice {
 public:
-    explicit KeyButton(std::atomic<bool>& status_) : status(status_) {}
+    explicit KeyButton(const KeyButtonPair& pair_) : pair(pair_) {}
 
     ~KeyButton() override = default;
 
     bool GetStatus() const override {
-        return status.load();
+        return pair.status.load();
+    }
+
+    Input::Clock::time_point GetLastChangeTime() const override {
+        return pair.last_change.load();
     }
 
     friend class KeyButtonList;
 
 private:
-    std::atomic<bool>& status;
-};
-
-struct KeyButtonPair {
-    explicit KeyButtonPair(int key_code_) : key_code(key_code_) {}
-    int key_code;
-    std::atomic<bool> status{false};
+    const KeyButtonPair& pair;
 };
 
 class KeyButtonList {
@@ -50,14 +62,14 @@ public:
         std::lock_guard guard{mutex};
         for (KeyButtonPair& pair : list) {
             if (pair.key_code == key_code)
-                pair.status.store(pressed);
+                pair.SetStatus(pressed);
         }
     }
 
     void ChangeAllKeyStatus(bool pressed) {
         std::lock_guard guard{mutex};
         for (KeyButtonPair& pair : list) {
-            pair.status.store(pressed);
+            pair.SetStatus(pressed);
         }
     }
 
@@ -71,7 +83,7 @@ Keyboard::Keyboard() : key_button_list{std::make_shared<KeyButtonList>()} {}
 std::unique_ptr<Input::ButtonDevice> Keyboard::Create(const Common::ParamPackage& params) {
     int key_code = params.Get("code", 0);
     auto& pair = key_button_list->AddKeyButton(key_code);
-    return std::make_unique<KeyButton>(pair.status);
+    return std::make_unique<KeyButton>(pair);
 }
 
 void Keyboard::PressKey(int key_code) {
@@ -185,6 +185,7 @@ public:
     void SetButton(int button, bool value) {
         std::lock_guard lock{mutex};
         state.buttons[button] = value;
+        state.last_change = Input::Clock::now();
     }
 
     bool GetButton(int button) const {
@@ -195,6 +196,7 @@ public:
     void SetAxis(int axis, Sint16 value) {
         std::lock_guard lock{mutex};
         state.axes[axis] = value;
+        state.last_change = Input::Clock::now();
     }
 
     float GetAxis(int axis) const {
@@ -222,6 +224,7 @@ public:
     void SetHat(int hat, Uint8 direction) {
         std::lock_guard lock{mutex};
         state.hats[hat] = direction;
+        state.last_change = Input::Clock::now();
     }
 
     bool GetHatDirection(int hat, Uint8 direction) const {
@@ -246,6 +249,12 @@ public:
         return std::make_tuple(state.accel, state.gyro);
     }
 
+    /// When the last button, axis or hat event was received
+    Input::Clock::time_point GetLastChangeTime() const {
+        std::lock_guard lock{mutex};
+        return state.last_change;
+    }
+
     /**
      * The guid of the joystick
      */
@@ -280,6 +289,7 @@ private:
         std::unordered_map<int, Uint8> hats;
         Common::Vec3<float> accel;
         Common::Vec3<float> gyro;
+        Input::Clock::time_point last_change;
     } state;
     std::string guid;
     int port;
@@ -616,6 +626,10 @@ public:
         return joystick->GetButton(button);
     }
 
+    Input::Clock::time_point GetLastChangeTime() const override {
+        return joystick->GetLastChangeTime();
+    }
+
 private:
     std::shared_ptr<SDLJoystick> joystick;
     int button;
@@ -630,6 +644,10 @@ public:
         return joystick->GetHatDirection(hat, direction);
     }
 
+    Input::Clock::time_point GetLastChangeTime() const override {
+        return joystick->GetLastChangeTime();
+    }
+
 private:
     std::shared_ptr<SDLJoystick> joystick;
     int hat;
@@ -650,6 +668,10 @@ public:
         return axis_value < threshold;
     }
 
+    Input::Clock::time_point GetLastChangeTime() const override {
+        return joystick->GetLastChangeTime();
+    }
+
 private:
     std::shared_ptr<SDLJoystick> joystick;
     int axis;
@@ -672,6 +694,10 @@ public:
         return std::make_tuple<float, float>(0.0f, 0.0f);
     }
 
+    Input::Clock::time_point GetLastChangeTime() const override {
+        return joystick->GetLastChangeTime();
+    }
+
 private:
     std::shared_ptr<SDLJoystick> joystick;
     const int axis_x;
@@ -855,10 +881,11 @@ SDLState::SDLState() {
     initialized = true;
     if (start_thread) {
         poll_thread = std::thread([this] {
-            using namespace std::chrono_literals;
+            // Waiting for the events pumps them as soon as they come, rather than at a fixed
+            // interval. The event watcher handles them as they are pumped.
+            SDL_Event event;
             while (initialized) {
-                SDL_PumpEvents();
-                std::this_thread::sleep_for(10ms);
+                SDL_WaitEventTimeout(&event, 100);
             }
         });
     }
@@ -195,7 +195,11 @@ void Client::OnPadData(Response::PadData data) {
                 static_cast<float>(max_y - min_y);
         }
 
-        status->touch_status = {x, y, is_active};
+        const std::tuple<float, float, bool> touch_status{x, y, is_active};
+        if (status->touch_status != touch_status) {
+            status->touch_status = touch_status;
+            status->touch_last_change = Input::Clock::now();
+        }
     }
 }
 
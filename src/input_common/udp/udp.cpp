@@ -21,6 +21,11 @@ public:
         return status->touch_status;
     }
 
+    Input::Clock::time_point GetLastChangeTime() const override {
+        std::lock_guard guard(status->update_mutex);
+        return status->touch_last_change;
+    }
+
 private:
     std::shared_ptr<DeviceStatus> status;
 };
@@ -8,11 +8,66 @@
 #include <arpa/inet.h>
 #endif
 #include <cstring>
+#include <mutex>
 #include <string>
+#include "enet/enet.h"
 #include "network/packet.h"
 
 namespace Network {
 
+namespace {
+
+/// Buffers kept for reuse, enough for the packets in flight of a busy room
+constexpr std::size_t MaxPooledBuffers = 64;
+/// Buffers that grew larger than this are freed instead of kept for reuse
+constexpr std::size_t MaxPooledCapacity = 64 * 1024;
+/// Capacity of new buffers, enough for a full 802.11 frame and the headers around it
+constexpr std::size_t InitialCapacity = 2048;
+
+class BufferPool {
+public:
+    std::unique_ptr<Packet::Buffer> Acquire() {
+        {
+            std::scoped_lock lock{mutex};
+            if (!buffers.empty()) {
+                auto buffer = std::move(buffers.back());
+                buffers.pop_back();
+                return buffer;
+            }
+        }
+        auto buffer = std::make_unique<Packet::Buffer>();
+        buffer->reserve(InitialCapacity);
+        return buffer;
+    }
+
+    void Release(std::unique_ptr<Packet::Buffer> buffer) {
+        if (!buffer || buffer->capacity() > MaxPooledCapacity) {
+            return;
+        }
+        buffer->clear();
+        std::scoped_lock lock{mutex};
+        if (buffers.size() < MaxPooledBuffers) {
+            buffers.push_back(std::move(buffer));
+        }
+    }
+
+private:
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Packet::Buffer>> buffers;
+};
+
+BufferPool& GetBufferPool() {
+    static BufferPool pool;
+    return pool;
+}
+
+void ReleaseENetPacketBuffer(ENetPacket* enet_packet) {
+    GetBufferPool().Release(
+        std::unique_ptr<Packet::Buffer>(static_cast<Packet::Buffer*>(enet_packet->userData)));
+}
+
+} // Anonymous namespace
+
 #ifndef htonll
 u64 htonll(u64 x) {
     return ((1 == htonl(1)) ? (x) : ((uint64_t)htonl((x) & 0xFFFFFFFF) << 32) | htonl((x) >> 32));
@@ -25,29 +80,40 @@ u64 ntohll(u64 x) {
 }
 #endif
 
+Packet::Packet(const void* in_data, std::size_t size_in_bytes)
+    : wrapped_data{static_cast<const char*>(in_data)}, wrapped_size{size_in_bytes} {}
+
+Packet::~Packet() {
+    GetBufferPool().Release(std::move(buffer));
+}
+
 void Packet::Append(const void* in_data, std::size_t size_in_bytes) {
     if (in_data && (size_in_bytes > 0)) {
-        std::size_t start = data.size();
-        data.resize(start + size_in_bytes);
-        std::memcpy(&data[start], in_data, size_in_bytes);
+        MakeWritable();
+        const char* bytes = static_cast<const char*>(in_data);
+        buffer->insert(buffer->end(), bytes, bytes + size_in_bytes);
     }
 }
 
 void Packet::Read(void* out_data, std::size_t size_in_bytes) {
     if (out_data && CheckSize(size_in_bytes)) {
-        std::memcpy(out_data, &data[read_pos], size_in_bytes);
+        std::memcpy(out_data, Bytes() + read_pos, size_in_bytes);
         read_pos += size_in_bytes;
     }
 }
 
 void Packet::Clear() {
-    data.clear();
+    if (buffer) {
+        buffer->clear();
+    }
+    wrapped_data = nullptr;
+    wrapped_size = 0;
     read_pos = 0;
     is_valid = true;
 }
 
 const void* Packet::GetData() const {
-    return !data.empty() ? &data[0] : nullptr;
+    return GetDataSize() > 0 ? Bytes() : nullptr;
 }
 
 void Packet::IgnoreBytes(u32 length) {
@@ -55,17 +121,31 @@ void Packet::IgnoreBytes(u32 length) {
 }
 
 std::size_t Packet::GetDataSize() const {
-    return data.size();
+    return buffer ? buffer->size() : wrapped_size;
 }
 
 bool Packet::EndOfPacket() const {
-    return read_pos >= data.size();
+    return read_pos >= GetDataSize();
 }
 
 Packet::operator bool() const {
     return is_valid;
 }
 
+ENetPacket* Packet::ToENetPacket() {
+    MakeWritable();
+    ENetPacket* enet_packet =
+        enet_packet_create(buffer->data(), buffer->size(),
+                           ENET_PACKET_FLAG_RELIABLE | ENET_PACKET_FLAG_NO_ALLOCATE);
+    if (!enet_packet) {
+        return nullptr;
+    }
+    enet_packet->userData = buffer.release();
+    enet_packet->freeCallback = ReleaseENetPacketBuffer;
+    Clear();
+    return enet_packet;
+}
+
 Packet& Packet::operator>>(bool& out_data) {
     u8 value;
     if (*this >> value) {
@@ -143,7 +223,7 @@ Packet& Packet::operator>>(char* out_data) {
 
     if ((length > 0) && CheckSize(length)) {
         // Then extract characters
-        std::memcpy(out_data, &data[read_pos], length);
+        std::memcpy(out_data, Bytes() + read_pos, length);
         out_data[length] = '\0';
 
         // Update reading position
@@ -161,7 +241,7 @@ Packet& Packet::operator>>(std::string& out_data) {
     out_data.clear();
     if ((length > 0) && CheckSize(length)) {
         // Then extract characters
-        out_data.assign(&data[read_pos], length);
+        out_data.assign(Bytes() + read_pos, length);
 
         // Update reading position
         read_pos += length;
@@ -255,9 +335,20 @@ Packet& Packet::operator<<(const std::string& in_data) {
 }
 
 bool Packet::CheckSize(std::size_t size) {
-    is_valid = is_valid && (read_pos + size <= data.size());
+    is_valid = is_valid && (read_pos + size <= GetDataSize());
 
     return is_valid;
 }
 
+void Packet::MakeWritable() {
+    if (!buffer) {
+        buffer = GetBufferPool().Acquire();
+    }
+    if (wrapped_data) {
+        buffer->assign(wrapped_data, wrapped_data + wrapped_size);
+        wrapped_data = nullptr;
+        wrapped_size = 0;
+    }
+}
+
 } // namespace Network
@@ -5,16 +5,42 @@
 #pragma once
 
 #include <array>
+#include <memory>
+#include <type_traits>
 #include <vector>
 #include "common/common_types.h"
 
+typedef struct _ENetPacket ENetPacket;
+
 namespace Network {
 
-/// A class that serializes data for network transfer. It also handles endianess
+/// Whether values of the type are serialized as they are, so arrays of them can be copied at once
+template <typename T>
+constexpr bool IsByte = sizeof(T) == 1 && std::is_integral_v<T> && !std::is_same_v<T, bool>;
+
+/**
+ * A class that serializes data for network transfer. It also handles endianess.
+ * The storage of written packets comes from a pool, and received data can be read in place.
+ */
 class Packet {
 public:
+    using Buffer = std::vector<char>;
+
     Packet() = default;
-    ~Packet() = default;
+    ~Packet();
+
+    /**
+     * Creates a packet that reads the given data in place. The data must outlive the packet, and
+     * is only copied if something is appended to the packet.
+     * @param data        Pointer to the sequence of bytes to read
+     * @param size_in_bytes Number of bytes to read
+     */
+    Packet(const void* data, std::size_t size_in_bytes);
+
+    Packet(Packet&&) noexcept = default;
+    Packet& operator=(Packet&&) noexcept = default;
+    Packet(const Packet&) = delete;
+    Packet& operator=(const Packet&) = delete;
 
     /**
      * Append data to the end of the packet
@@ -64,6 +90,13 @@ public:
 
     explicit operator bool() const;
 
+    /**
+     * Creates a reliable ENet packet that takes over the storage of this packet instead of
+     * copying it. The storage goes back to the pool once ENet is done with it. This packet is
+     * empty afterwards.
+     */
+    ENetPacket* ToENetPacket();
+
     /// Overloads of operator >> to read data from the packet
     Packet& operator>>(bool& out_data);
     Packet& operator>>(s8& out_data);
@@ -111,10 +144,20 @@ private:
      */
     bool CheckSize(std::size_t size);
 
+    /// Makes the data of the packet owned and writable, copying it if it was read in place
+    void MakeWritable();
+
+    /// Returns the start of the data stored in the packet
+    const char* Bytes() const {
+        return buffer ? buffer->data() : wrapped_data;
+    }
+
     // Member data
-    std::vector<char> data;   ///< Data stored in the packet
-    std::size_t read_pos = 0; ///< Current reading position in the packet
-    bool is_valid = true;     ///< Reading state of the packet
+    std::unique_ptr<Buffer> buffer;     ///< Data stored in the packet, taken from the pool
+    const char* wrapped_data = nullptr; ///< Data read in place, if the packet wraps a buffer
+    std::size_t wrapped_size = 0;       ///< Size of the data read in place
+    std::size_t read_pos = 0;           ///< Current reading position in the packet
+    bool is_valid = true;               ///< Reading state of the packet
 };
 
 template <typename T>
@@ -122,6 +165,17 @@ Packet& Packet::operator>>(std::vector<T>& out_data) {
     // First extract the size
     u32 size = 0;
     *this >> size;
+
+    // Bytes need no conversion, so they are extracted at once
+    if constexpr (IsByte<T>) {
+        out_data.clear();
+        if (CheckSize(size)) {
+            out_data.resize(size);
+            Read(out_data.data(), size);
+        }
+        return *this;
+    }
+
     out_data.resize(size);
 
     // Then extract the data
@@ -135,6 +189,11 @@ Packet& Packet::operator>>(std::vector<T>& out_data) {
 
 template <typename T, std::size_t S>
 Packet& Packet::operator>>(std::array<T, S>& out_data) {
+    if constexpr (IsByte<T>) {
+        Read(out_data.data(), S);
+        return *this;
+    }
+
     for (std::size_t i = 0; i < out_data.size(); ++i) {
         T character;
         *this >> character;
@@ -148,6 +207,12 @@ Packet& Packet::operator<<(const std::vector<T>& in_data) {
     // First insert the size
     *this << static_cast<u32>(in_data.size());
 
+    // Bytes need no conversion, so they are inserted at once
+    if constexpr (IsByte<T>) {
+        Append(in_data.data(), in_data.size());
+        return *this;
+    }
+
     // Then insert the data
     for (std::size_t i = 0; i < in_data.size(); ++i) {
         *this << in_data[i];
@@ -157,6 +222,11 @@ Packet& Packet::operator<<(const std::vector<T>& in_data) {
 
 template <typename T, std::size_t S>
 Packet& Packet::operator<<(const std::array<T, S>& in_data) {
+    if constexpr (IsByte<T>) {
+        Append(in_data.data(), S);
+        return *this;
+    }
+
     for (std::size_t i = 0; i < in_data.size(); ++i) {
         *this << in_data[i];
     }
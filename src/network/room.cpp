@@ -4,11 +4,16 @@
 
 #include <algorithm>
 #include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
 #include <mutex>
 #include <random>
 #include <regex>
+#include <shared_mutex>
 #include <sstream>
 #include <thread>
+#include <unordered_map>
 #include "common/logging/log.h"
 #include "enet/enet.h"
 #include "network/packet.h"
@@ -43,9 +48,30 @@ public:
         ENetPeer* peer; ///< The remote peer.
     };
     using MemberList = std::vector<Member>;
-    MemberList members;              ///< Information about the members of this room
-    mutable std::mutex member_mutex; ///< Mutex for locking the members list
-    /// This should be a std::shared_mutex as soon as C++17 is supported
+    MemberList members;                     ///< Information about the members of this room
+    mutable std::shared_mutex member_mutex; ///< Mutex for locking the members list
+
+    struct MacAddressHash {
+        std::size_t operator()(const MacAddress& address) const {
+            u64 value = 0;
+            std::memcpy(&value, address.data(), address.size());
+            return std::hash<u64>{}(value);
+        }
+    };
+    /// Peers of the members by their MAC address, guarded by member_mutex
+    std::unordered_map<MacAddress, ENetPeer*, MacAddressHash> peers_by_mac;
+
+    /// Mutex for the ENet host, which is not thread-safe. It must be taken before member_mutex
+    /// when both are needed, and is held by the room thread while it handles events.
+    std::mutex host_mutex;
+
+    struct PendingJoin {
+        ENetEvent event;        ///< The receive event of the join request
+        enet_uint32 connect_id; ///< Connection ID of the peer when the request was received
+    };
+    std::deque<PendingJoin> pending_joins; ///< Join requests waiting to be answered
+    std::mutex pending_joins_mutex;        ///< Mutex for the pending join requests
+    std::condition_variable pending_joins_cv;
 
     UsernameBanList username_ban_list; ///< List of banned usernames
     IPBanList ip_ban_list;             ///< List of banned IP addresses
@@ -57,6 +83,9 @@ public:
     /// Thread that receives and dispatches network packets
     std::unique_ptr<std::thread> room_thread;
 
+    /// Thread that answers join requests, as verifying a user may query the web service
+    std::unique_ptr<std::thread> join_thread;
+
     /// Verification backend of the room
     std::unique_ptr<VerifyUser::Backend> verify_backend;
 
@@ -64,12 +93,33 @@ public:
     void ServerLoop();
     void StartLoop();
 
+    /// Dispatches an event received by the room thread.
+    void HandleEvent(const ENetEvent& event);
+
+    /// Thread function that will answer join requests until the room is destroyed.
+    void JoinLoop();
+
+    /**
+     * Queues a join request for the join thread, which takes ownership of the packet.
+     */
+    void QueueJoinRequest(const ENetEvent& event);
+
     /**
      * Parses and answers a room join request from a client.
      * Validates the uniqueness of the username and assigns the MAC address
      * that the client will use for the remainder of the connection.
      */
-    void HandleJoinRequest(const ENetEvent* event);
+    void HandleJoinRequest(const PendingJoin& join);
+
+    /**
+     * Returns whether the peer is still connected over the connection with the given ID.
+     */
+    bool IsSameConnection(const ENetPeer* peer, enet_uint32 connect_id) const;
+
+    /**
+     * Removes a member from the room. member_mutex must be held exclusively.
+     */
+    void EraseMember(MemberList::iterator member);
 
     /**
      * Parses and answers a kick request from a client.
@@ -117,6 +167,8 @@ public:
      */
     bool HasModPermission(const ENetPeer* client) const;
 
+    // All the functions below that send packets expect host_mutex to be held.
+
     /**
      * Sends a ID_ROOM_IS_FULL message telling the client that the room is full.
      */
@@ -222,7 +274,8 @@ public:
     MacAddress GenerateMacAddress();
 
     /**
-     * Broadcasts this packet to all members except the sender.
+     * Relays this packet to its destination member, or to all members except the sender if it is
+     * a broadcast. The received packet is queued on the peers as is, without copying it.
      * @param event The ENet event containing the data
      */
     void HandleWifiPacket(const ENetEvent* event);
@@ -249,66 +302,137 @@ public:
 // RoomImpl
 void Room::RoomImpl::ServerLoop() {
     while (state != State::Closed) {
-        ENetEvent event;
-        if (enet_host_service(server, &event, 16) > 0) {
-            switch (event.type) {
-            case ENET_EVENT_TYPE_RECEIVE:
-                switch (event.packet->data[0]) {
-                case IdJoinRequest:
-                    HandleJoinRequest(&event);
-                    break;
-                case IdSetGameInfo:
-                    HandleGameNamePacket(&event);
-                    break;
-                case IdWifiPacket:
-                    HandleWifiPacket(&event);
-                    break;
-                case IdChatMessage:
-                    HandleChatPacket(&event);
-                    break;
-                // Moderation
-                case IdModKick:
-                    HandleModKickPacket(&event);
-                    break;
-                case IdModBan:
-                    HandleModBanPacket(&event);
-                    break;
-                case IdModUnban:
-                    HandleModUnbanPacket(&event);
-                    break;
-                case IdModGetBanList:
-                    HandleModGetBanListPacket(&event);
-                    break;
-                }
-                enet_packet_destroy(event.packet);
-                break;
-            case ENET_EVENT_TYPE_DISCONNECT:
-                HandleClientDisconnection(event.peer);
-                break;
-            case ENET_EVENT_TYPE_NONE:
-            case ENET_EVENT_TYPE_CONNECT:
-                break;
+        {
+            std::scoped_lock lock(host_mutex);
+            ENetEvent event;
+            int result = enet_host_service(server, &event, 0);
+            while (result > 0) {
+                HandleEvent(event);
+                result = enet_host_check_events(server, &event);
             }
+            // Relayed packets are only queued on the peers, send them all at once
+            enet_host_flush(server);
         }
+        // Wait for packets without holding the host, so that join requests can be answered
+        enet_uint32 condition = ENET_SOCKET_WAIT_RECEIVE | ENET_SOCKET_WAIT_INTERRUPT;
+        enet_socket_wait(server->socket, &condition, 16);
+    }
+
+    {
+        std::scoped_lock lock(pending_joins_mutex);
     }
+    pending_joins_cv.notify_all();
+    join_thread->join();
+    join_thread.reset();
+
     // Close the connection to all members:
+    std::scoped_lock lock(host_mutex);
     SendCloseMessage();
 }
 
 void Room::RoomImpl::StartLoop() {
     room_thread = std::make_unique<std::thread>(&Room::RoomImpl::ServerLoop, this);
+    join_thread = std::make_unique<std::thread>(&Room::RoomImpl::JoinLoop, this);
+}
+
+void Room::RoomImpl::HandleEvent(const ENetEvent& event) {
+    switch (event.type) {
+    case ENET_EVENT_TYPE_RECEIVE:
+        switch (event.packet->data[0]) {
+        case IdJoinRequest:
+            QueueJoinRequest(event);
+            return;
+        case IdSetGameInfo:
+            HandleGameNamePacket(&event);
+            break;
+        case IdWifiPacket:
+            HandleWifiPacket(&event);
+            break;
+        case IdChatMessage:
+            HandleChatPacket(&event);
+            break;
+        // Moderation
+        case IdModKick:
+            HandleModKickPacket(&event);
+            break;
+        case IdModBan:
+            HandleModBanPacket(&event);
+            break;
+        case IdModUnban:
+            HandleModUnbanPacket(&event);
+            break;
+        case IdModGetBanList:
+            HandleModGetBanListPacket(&event);
+            break;
+        }
+        // Relayed packets are destroyed by ENet once they have been sent to every peer
+        if (event.packet->referenceCount == 0) {
+            enet_packet_destroy(event.packet);
+        }
+        break;
+    case ENET_EVENT_TYPE_DISCONNECT:
+        HandleClientDisconnection(event.peer);
+        break;
+    case ENET_EVENT_TYPE_NONE:
+    case ENET_EVENT_TYPE_CONNECT:
+        break;
+    }
+}
+
+void Room::RoomImpl::JoinLoop() {
+    while (true) {
+        PendingJoin join;
+        {
+            std::unique_lock lock(pending_joins_mutex);
+            pending_joins_cv.wait(lock, [this] {
+                return !pending_joins.empty() || state == State::Closed;
+            });
+            if (state == State::Closed) {
+                for (const auto& pending_join : pending_joins) {
+                    enet_packet_destroy(pending_join.event.packet);
+                }
+                pending_joins.clear();
+                return;
+            }
+            join = pending_joins.front();
+            pending_joins.pop_front();
+        }
+        HandleJoinRequest(join);
+        enet_packet_destroy(join.event.packet);
+    }
 }
 
-void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
+void Room::RoomImpl::QueueJoinRequest(const ENetEvent& event) {
     {
-        std::lock_guard lock(member_mutex);
+        std::scoped_lock lock(pending_joins_mutex);
+        pending_joins.push_back({event, event.peer->connectID});
+    }
+    pending_joins_cv.notify_one();
+}
+
+bool Room::RoomImpl::IsSameConnection(const ENetPeer* peer, enet_uint32 connect_id) const {
+    return peer->state == ENET_PEER_STATE_CONNECTED && peer->connectID == connect_id;
+}
+
+void Room::RoomImpl::EraseMember(MemberList::iterator member) {
+    peers_by_mac.erase(member->mac_address);
+    members.erase(member);
+}
+
+void Room::RoomImpl::HandleJoinRequest(const PendingJoin& join) {
+    const ENetEvent* event = &join.event;
+    std::unique_lock host_lock(host_mutex);
+    if (!IsSameConnection(event->peer, join.connect_id)) {
+        return; // The client left while its request was queued
+    }
+    {
+        std::shared_lock lock(member_mutex);
         if (members.size() >= room_information.member_slots) {
             SendRoomIsFull(event->peer);
             return;
         }
     }
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet{event->packet->data, event->packet->dataLength};
     packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
     std::string nickname;
     packet >> nickname;
@@ -371,7 +495,14 @@ void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
         std::lock_guard lock(verify_UID_mutex);
         uid = verify_UID;
     }
+    // The verification may query the web service, so don't hold up the room thread meanwhile.
+    // Only this thread adds members, so the checks above still hold afterwards.
+    host_lock.unlock();
     member.user_data = verify_backend->LoadUserData(uid, token);
+    host_lock.lock();
+    if (!IsSameConnection(event->peer, join.connect_id)) {
+        return;
+    }
 
     if (nickname == room_information.host_username) {
         member.user_data.moderator = true;
@@ -407,6 +538,7 @@ void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
 
     {
         std::lock_guard lock(member_mutex);
+        peers_by_mac.emplace(member.mac_address, member.peer);
         members.push_back(std::move(member));
     }
 
@@ -425,8 +557,7 @@ void Room::RoomImpl::HandleModKickPacket(const ENetEvent* event) {
         return;
     }
 
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet{event->packet->data, event->packet->dataLength};
     packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
 
     std::string nickname;
@@ -453,7 +584,7 @@ void Room::RoomImpl::HandleModKickPacket(const ENetEvent* event) {
         ip = ip_raw;
 
         enet_peer_disconnect(target_member->peer, 0);
-        members.erase(target_member);
+        EraseMember(target_member);
     }
 
     // Announce the change to all clients.
@@ -467,8 +598,7 @@ void Room::RoomImpl::HandleModBanPacket(const ENetEvent* event) {
         return;
     }
 
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet{event->packet->data, event->packet->dataLength};
     packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
 
     std::string nickname;
@@ -496,7 +626,7 @@ void Room::RoomImpl::HandleModBanPacket(const ENetEvent* event) {
         ip = ip_raw;
 
         enet_peer_disconnect(target_member->peer, 0);
-        members.erase(target_member);
+        EraseMember(target_member);
     }
 
     {
@@ -528,8 +658,7 @@ void Room::RoomImpl::HandleModUnbanPacket(const ENetEvent* event) {
         return;
     }
 
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet{event->packet->data, event->packet->dataLength};
     packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
 
     std::string address;
@@ -575,28 +704,27 @@ bool Room::RoomImpl::IsValidNickname(const std::string& nickname) const {
     if (!std::regex_match(nickname, nickname_regex))
         return false;
 
-    std::lock_guard lock(member_mutex);
+    std::shared_lock lock(member_mutex);
     return std::all_of(members.begin(), members.end(),
                        [&nickname](const auto& member) { return member.nickname != nickname; });
 }
 
 bool Room::RoomImpl::IsValidMacAddress(const MacAddress& address) const {
     // A MAC address is valid if it is not already taken by anybody else in the room.
-    std::lock_guard lock(member_mutex);
-    return std::all_of(members.begin(), members.end(),
-                       [&address](const auto& member) { return member.mac_address != address; });
+    std::shared_lock lock(member_mutex);
+    return !peers_by_mac.contains(address);
 }
 
 bool Room::RoomImpl::IsValidConsoleId(const std::string& console_id_hash) const {
     // A Console ID is valid if it is not already taken by anybody else in the room.
-    std::lock_guard lock(member_mutex);
+    std::shared_lock lock(member_mutex);
     return std::all_of(members.begin(), members.end(), [&console_id_hash](const auto& member) {
         return member.console_id_hash != console_id_hash;
     });
 }
 
 bool Room::RoomImpl::HasModPermission(const ENetPeer* client) const {
-    std::lock_guard lock(member_mutex);
+    std::shared_lock lock(member_mutex);
     const auto sending_member =
         std::find_if(members.begin(), members.end(),
                      [client](const auto& member) { return member.peer == client; });
@@ -619,8 +747,7 @@ void Room::RoomImpl::SendNameCollision(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdNameCollision);
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = packet.ToENetPacket();
     enet_peer_send(client, 0, enet_packet);
     enet_host_flush(server);
 }
@@ -629,8 +756,7 @@ void Room::RoomImpl::SendMacCollision(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdMacCollision);
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = packet.ToENetPacket();
     enet_peer_send(client, 0, enet_packet);
     enet_host_flush(server);
 }
@@ -639,8 +765,7 @@ void Room::RoomImpl::SendConsoleIdCollision(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdConsoleIdCollision);
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = packet.ToENetPacket();
     enet_peer_send(client, 0, enet_packet);
     enet_host_flush(server);
 }
@@ -649,8 +774,7 @@ void Room::RoomImpl::SendWrongPassword(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdWrongPassword);
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = packet.ToENetPacket();
     enet_peer_send(client, 0, enet_packet);
     enet_host_flush(server);
 }
@@ -659,8 +783,7 @@ void Room::RoomImpl::SendRoomIsFull(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdRoomIsFull);
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = packet.ToENetPacket();
     enet_peer_send(client, 0, enet_packet);
     enet_host_flush(server);
 }
@@ -670,8 +793,7 @@ void Room::RoomImpl::SendVersionMismatch(ENetPeer* client) {
     packet << static_cast<u8>(IdVersionMismatch);
     packet << network_version;
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = packet.ToENetPacket();
     enet_peer_send(client, 0, enet_packet);
     enet_host_flush(server);
 }
@@ -680,8 +802,7 @@ void Room::RoomImpl::SendJoinSuccess(ENetPeer* client, MacAddress mac_address) {
     Packet packet;
     packet << static_cast<u8>(IdJoinSuccess);
     packet << mac_address;
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = packet.ToENetPacket();
     enet_peer_send(client, 0, enet_packet);
     enet_host_flush(server);
 }
@@ -690,8 +811,7 @@ void Room::RoomImpl::SendJoinSuccessAsMod(ENetPeer* client, MacAddress mac_addre
     Packet packet;
     packet << static_cast<u8>(IdJoinSuccessAsMod);
     packet << mac_address;
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = packet.ToENetPacket();
     enet_peer_send(client, 0, enet_packet);
     enet_host_flush(server);
 }
@@ -700,8 +820,7 @@ void Room::RoomImpl::SendUserKicked(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdHostKicked);
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = packet.ToENetPacket();
     enet_peer_send(client, 0, enet_packet);
     enet_host_flush(server);
 }
@@ -710,8 +829,7 @@ void Room::RoomImpl::SendUserBanned(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdHostBanned);
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = packet.ToENetPacket();
     enet_peer_send(client, 0, enet_packet);
     enet_host_flush(server);
 }
@@ -720,8 +838,7 @@ void Room::RoomImpl::SendModPermissionDenied(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdModPermissionDenied);
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = packet.ToENetPacket();
     enet_peer_send(client, 0, enet_packet);
     enet_host_flush(server);
 }
@@ -730,8 +847,7 @@ void Room::RoomImpl::SendModNoSuchUser(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdModNoSuchUser);
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = packet.ToENetPacket();
     enet_peer_send(client, 0, enet_packet);
     enet_host_flush(server);
 }
@@ -745,8 +861,7 @@ void Room::RoomImpl::SendModBanListResponse(ENetPeer* client) {
         packet << ip_ban_list;
     }
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = packet.ToENetPacket();
     enet_peer_send(client, 0, enet_packet);
     enet_host_flush(server);
 }
@@ -754,10 +869,9 @@ void Room::RoomImpl::SendModBanListResponse(ENetPeer* client) {
 void Room::RoomImpl::SendCloseMessage() {
     Packet packet;
     packet << static_cast<u8>(IdCloseRoom);
-    std::lock_guard lock(member_mutex);
+    std::shared_lock lock(member_mutex);
     if (!members.empty()) {
-        ENetPacket* enet_packet =
-            enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+        ENetPacket* enet_packet = packet.ToENetPacket();
         for (auto& member : members) {
             enet_peer_send(member.peer, 0, enet_packet);
         }
@@ -775,10 +889,9 @@ void Room::RoomImpl::SendStatusMessage(StatusMessageTypes type, const std::strin
     packet << static_cast<u8>(type);
     packet << nickname;
     packet << username;
-    std::lock_guard lock(member_mutex);
+    std::shared_lock lock(member_mutex);
     if (!members.empty()) {
-        ENetPacket* enet_packet =
-            enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+        ENetPacket* enet_packet = packet.ToENetPacket();
         for (auto& member : members) {
             enet_peer_send(member.peer, 0, enet_packet);
         }
@@ -817,9 +930,9 @@ void Room::RoomImpl::BroadcastRoomInformation() {
     packet << room_information.preferred_game;
     packet << room_information.host_username;
 
-    packet << static_cast<u32>(members.size());
     {
-        std::lock_guard lock(member_mutex);
+        std::shared_lock lock(member_mutex);
+        packet << static_cast<u32>(members.size());
         for (const auto& member : members) {
             packet << member.nickname;
             packet << member.mac_address;
@@ -831,8 +944,7 @@ void Room::RoomImpl::BroadcastRoomInformation() {
         }
     }
 
-    ENetPacket* enet_packet =
-        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = packet.ToENetPacket();
     enet_host_broadcast(server, 0, enet_packet);
     enet_host_flush(server);
 }
@@ -850,56 +962,41 @@ MacAddress Room::RoomImpl::GenerateMacAddress() {
 }
 
 void Room::RoomImpl::HandleWifiPacket(const ENetEvent* event) {
-    Packet in_packet;
-    in_packet.Append(event->packet->data, event->packet->dataLength);
-    in_packet.IgnoreBytes(sizeof(u8));         // Message type
-    in_packet.IgnoreBytes(sizeof(u8));         // WifiPacket Type
-    in_packet.IgnoreBytes(sizeof(u8));         // WifiPacket Channel
-    in_packet.IgnoreBytes(sizeof(MacAddress)); // WifiPacket Transmitter Address
+    // Message type, WifiPacket type, WifiPacket channel and WifiPacket transmitter address
+    constexpr std::size_t DestinationOffset = 3 * sizeof(u8) + sizeof(MacAddress);
+    if (event->packet->dataLength < DestinationOffset + sizeof(MacAddress)) {
+        return;
+    }
     MacAddress destination_address;
-    in_packet >> destination_address;
+    std::memcpy(destination_address.data(), event->packet->data + DestinationOffset,
+                sizeof(MacAddress));
 
-    Packet out_packet;
-    out_packet.Append(event->packet->data, event->packet->dataLength);
-    ENetPacket* enet_packet = enet_packet_create(out_packet.GetData(), out_packet.GetDataSize(),
-                                                 ENET_PACKET_FLAG_RELIABLE);
+    // ENet packets are reference counted, so the received one is queued on every destination
+    ENetPacket* enet_packet = event->packet;
 
+    std::shared_lock lock(member_mutex);
     if (destination_address == BroadcastMac) { // Send the data to everyone except the sender
-        std::lock_guard lock(member_mutex);
-        bool sent_packet = false;
         for (const auto& member : members) {
             if (member.peer != event->peer) {
-                sent_packet = true;
                 enet_peer_send(member.peer, 0, enet_packet);
             }
         }
-
-        if (!sent_packet) {
-            enet_packet_destroy(enet_packet);
-        }
     } else { // Send the data only to the destination client
-        std::lock_guard lock(member_mutex);
-        auto member = std::find_if(members.begin(), members.end(),
-                                   [destination_address](const Member& member) -> bool {
-                                       return member.mac_address == destination_address;
-                                   });
-        if (member != members.end()) {
-            enet_peer_send(member->peer, 0, enet_packet);
+        const auto peer = peers_by_mac.find(destination_address);
+        if (peer != peers_by_mac.end()) {
+            enet_peer_send(peer->second, 0, enet_packet);
         } else {
             LOG_ERROR(Network,
                       "Attempting to send to unknown MAC address: "
                       "{:02X}:{:02X}:{:02X}:{:02X}:{:02X}:{:02X}",
                       destination_address[0], destination_address[1], destination_address[2],
                       destination_address[3], destination_address[4], destination_address[5]);
-            enet_packet_destroy(enet_packet);
         }
     }
-    enet_host_flush(server);
 }
 
 void Room::RoomImpl::HandleChatPacket(const ENetEvent* event) {
-    Packet in_packet;
-    in_packet.Append(event->packet->data, event->packet->dataLength);
+    Packet in_packet{event->packet->data, event->packet->dataLength};
 
     in_packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
     std::string message;
@@ -908,7 +1005,7 @@ void Room::RoomImpl::HandleChatPacket(const ENetEvent* event) {
         return member.peer == event->peer;
     };
 
-    std::lock_guard lock(member_mutex);
+    std::shared_lock lock(member_mutex);
     const auto sending_member = std::find_if(members.begin(), members.end(), CompareNetworkAddress);
     if (sending_member == members.end()) {
         return; // Received a chat message from a unknown sender
@@ -923,8 +1020,7 @@ void Room::RoomImpl::HandleChatPacket(const ENetEvent* event) {
     out_packet << sending_member->user_data.username;
     out_packet << message;
 
-    ENetPacket* enet_packet = enet_packet_create(out_packet.GetData(), out_packet.GetDataSize(),
-                                                 ENET_PACKET_FLAG_RELIABLE);
+    ENetPacket* enet_packet = out_packet.ToENetPacket();
     bool sent_packet = false;
     for (const auto& member : members) {
         if (member.peer != event->peer) {
@@ -948,8 +1044,7 @@ void Room::RoomImpl::HandleChatPacket(const ENetEvent* event) {
 }
 
 void Room::RoomImpl::HandleGameNamePacket(const ENetEvent* event) {
-    Packet in_packet;
-    in_packet.Append(event->packet->data, event->packet->dataLength);
+    Packet in_packet{event->packet->data, event->packet->dataLength};
 
     in_packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
     GameInfo game_info;
@@ -996,7 +1091,7 @@ void Room::RoomImpl::HandleClientDisconnection(ENetPeer* client) {
             enet_address_get_host_ip(&member->peer->address, ip_raw, sizeof(ip_raw) - 1);
             ip = ip_raw;
 
-            members.erase(member);
+            EraseMember(member);
         }
     }
 
@@ -1069,7 +1164,7 @@ Room::BanList Room::GetBanList() const {
 
 std::vector<Room::Member> Room::GetRoomMemberList() const {
     std::vector<Room::Member> member_list;
-    std::lock_guard lock(room_impl->member_mutex);
+    std::shared_lock lock(room_impl->member_mutex);
     for (const auto& member_impl : room_impl->members) {
         Member member;
         member.nickname = member_impl.nickname;
@@ -1105,6 +1200,7 @@ void Room::Destroy() {
     {
         std::lock_guard lock(room_impl->member_mutex);
         room_impl->members.clear();
+        room_impl->peers_by_mac.clear();
     }
     room_impl->room_information.member_slots = 0;
     room_impl->room_information.name.clear();
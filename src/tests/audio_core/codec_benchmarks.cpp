@@ -0,0 +1,165 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstring>
+#include <vector>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "audio_core/audio_types.h"
+#include "audio_core/codec.h"
+#include "audio_core/hle/common.h"
+#include "audio_core/interpolate.h"
+
+namespace {
+
+using Sample = AudioCore::StereoBuffer16::Sample;
+
+/// Length in samples of the buffers, a typical streaming buffer length
+constexpr std::size_t BufferLength = 4096;
+
+std::vector<u8> MakePCM16Buffer(std::size_t sample_count) {
+    std::vector<u8> data(sample_count * sizeof(s16) * 2);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<u8>(i * 7);
+    }
+    return data;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("StereoBuffer16 interpolation consumes the decoded samples", "[audio_core]") {
+    constexpr std::size_t sample_count = 300;
+    std::vector<u8> data(sample_count * sizeof(s16));
+    for (std::size_t i = 0; i < sample_count; ++i) {
+        const auto sample = static_cast<s16>(i);
+        std::memcpy(data.data() + i * sizeof(s16), &sample, sizeof(s16));
+    }
+
+    AudioCore::StereoBuffer16 buffer;
+    AudioCore::Codec::DecodePCM16(1, data.data(), sample_count, buffer.Reset(sample_count));
+    REQUIRE(buffer.size() == sample_count);
+
+    AudioCore::AudioInterp::State state;
+    AudioCore::StereoFrame16 frame{};
+    std::size_t outputi = 0;
+    AudioCore::AudioInterp::None(state, buffer, 1.0f, frame, outputi);
+
+    // There is a two-sample predelay, filled by the initial history.
+    REQUIRE(outputi == frame.size());
+    REQUIRE(frame[0] == Sample{0, 0});
+    REQUIRE(frame[1] == Sample{0, 0});
+    REQUIRE(frame[2] == Sample{0, 0});
+    REQUIRE(frame[3] == Sample{1, 1});
+    REQUIRE(buffer.size() == sample_count - frame.size() + 1);
+
+    // The history carries over to the next frame.
+    outputi = 0;
+    AudioCore::AudioInterp::None(state, buffer, 1.0f, frame, outputi);
+    REQUIRE(outputi == sample_count - frame.size());
+    REQUIRE(frame[0] == Sample{158, 158});
+    REQUIRE(buffer.empty());
+}
+
+TEST_CASE("Polyphase interpolation reproduces the input at the native rate", "[audio_core]") {
+    constexpr std::size_t sample_count = 300;
+    AudioCore::StereoBuffer16 buffer;
+    auto samples = buffer.Reset(sample_count);
+    for (std::size_t i = 0; i < sample_count; ++i) {
+        const auto value = static_cast<s16>(i * 100);
+        samples[i] = Sample{value, static_cast<s16>(-value)};
+    }
+
+    AudioCore::AudioInterp::State state;
+    AudioCore::StereoFrame16 frame{};
+    std::size_t outputi = 0;
+    AudioCore::AudioInterp::Polyphase(state, buffer, 1.0f, frame, outputi);
+
+    REQUIRE(outputi == frame.size());
+    for (std::size_t i = 2; i < frame.size(); ++i) {
+        const auto value = static_cast<s16>((i - 2) * 100);
+        REQUIRE(frame[i] == Sample{value, static_cast<s16>(-value)});
+    }
+}
+
+TEST_CASE("Vectorized interpolation matches the scalar one", "[audio_core]") {
+    const std::vector<u8> pcm16 = MakePCM16Buffer(BufferLength);
+
+    for (const float rate : {0.37f, 1.0f, 1.61f, 2.9f}) {
+        AudioCore::StereoBuffer16 buffer;
+        AudioCore::StereoBuffer16 scalar_buffer;
+        AudioCore::AudioInterp::State state;
+        AudioCore::AudioInterp::State scalar_state;
+        AudioCore::Codec::DecodePCM16(2, pcm16.data(), BufferLength, buffer.Reset(BufferLength));
+        AudioCore::Codec::DecodePCM16(2, pcm16.data(), BufferLength,
+                                      scalar_buffer.Reset(BufferLength));
+
+        while (!buffer.empty()) {
+            AudioCore::StereoFrame16 frame{};
+            AudioCore::StereoFrame16 scalar_frame{};
+            std::size_t outputi = 0;
+            std::size_t scalar_outputi = 0;
+            AudioCore::AudioInterp::Linear(state, buffer, rate, frame, outputi);
+            AudioCore::AudioInterp::Scalar::Linear(scalar_state, scalar_buffer, rate,
+                                                   scalar_frame, scalar_outputi);
+            REQUIRE(outputi == scalar_outputi);
+            REQUIRE(frame == scalar_frame);
+            REQUIRE(buffer.size() == scalar_buffer.size());
+        }
+    }
+}
+
+TEST_CASE("Audio decoding and interpolation benchmarks", "[audio_core][.benchmark]") {
+    const std::vector<u8> pcm16 = MakePCM16Buffer(BufferLength);
+    const std::vector<u8> adpcm(BufferLength / 14 * 8 + 8, 0x17);
+    const std::array<s16, 16> coefficients{0x400, -0x200, 0x300, -0x100};
+
+    std::array<AudioCore::StereoBuffer16, AudioCore::HLE::num_sources> buffers;
+    std::array<AudioCore::AudioInterp::State, AudioCore::HLE::num_sources> states{};
+    AudioCore::StereoFrame16 frame{};
+
+    BENCHMARK("Decode PCM16 buffers of all sources") {
+        for (auto& buffer : buffers) {
+            AudioCore::Codec::DecodePCM16(2, pcm16.data(), BufferLength,
+                                          buffer.Reset(BufferLength));
+        }
+        return buffers[0].size();
+    };
+
+    BENCHMARK("Decode ADPCM buffers of all sources") {
+        AudioCore::Codec::ADPCMState adpcm_state{};
+        for (auto& buffer : buffers) {
+            AudioCore::Codec::DecodeADPCM(
+                adpcm.data(), BufferLength, coefficients, adpcm_state,
+                buffer.Reset(AudioCore::Codec::ADPCMOutputSize(BufferLength)));
+        }
+        return adpcm_state.yn1;
+    };
+
+    BENCHMARK("Decode and resample a frame of all sources") {
+        for (std::size_t i = 0; i < buffers.size(); ++i) {
+            auto& buffer = buffers[i];
+            if (buffer.size() < AudioCore::samples_per_frame * 2) {
+                AudioCore::Codec::DecodePCM16(2, pcm16.data(), BufferLength,
+                                              buffer.Reset(BufferLength));
+            }
+            std::size_t outputi = 0;
+            AudioCore::AudioInterp::Linear(states[i], buffer, 1.3f, frame, outputi);
+        }
+        return frame[0][0];
+    };
+
+    BENCHMARK("Decode and resample a frame of all sources with polyphase") {
+        for (std::size_t i = 0; i < buffers.size(); ++i) {
+            auto& buffer = buffers[i];
+            if (buffer.size() < AudioCore::samples_per_frame * 2) {
+                AudioCore::Codec::DecodePCM16(2, pcm16.data(), BufferLength,
+                                              buffer.Reset(BufferLength));
+            }
+            std::size_t outputi = 0;
+            AudioCore::AudioInterp::Polyphase(states[i], buffer, 1.3f, frame, outputi);
+        }
+        return frame[0][0];
+    };
+}
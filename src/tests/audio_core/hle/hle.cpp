@@ -26,7 +26,7 @@ TEST_CASE("DSP LLE vs HLE", "[audio_core][hle]") {
         Kernel::New3dsHwCapabilities{false, false, Kernel::New3dsMemoryMode::Legacy});
 
     AudioCore::DspHle hle(system, hle_memory, hle_core_timing);
-    AudioCore::DspLle lle(system, lle_memory, lle_core_timing, true);
+    AudioCore::DspLle lle(system, lle_memory, lle_core_timing, AudioCore::LleThreading::Lockstep);
 
     // Initialise LLE
     {
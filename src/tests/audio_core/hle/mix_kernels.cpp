@@ -0,0 +1,114 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstring>
+#include <random>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include "audio_core/hle/mix_kernels.h"
+
+namespace {
+
+using namespace AudioCore;
+using namespace AudioCore::HLE;
+
+struct Inputs {
+    StereoFrame16 stereo;
+    QuadFrame32 quad;
+    std::array<float, 4> gains;
+    float gain;
+};
+
+Inputs MakeInputs(std::mt19937& random) {
+    Inputs inputs;
+    std::uniform_int_distribution<s32> sample{-32768, 32767};
+    // Mixes of many sources exceed the 16-bit range, which exercises the saturation.
+    std::uniform_int_distribution<s32> mix_sample{-1'000'000, 1'000'000};
+    std::uniform_real_distribution<float> gain{-2.0f, 2.0f};
+    for (auto& frame : inputs.stereo) {
+        frame = {static_cast<s16>(sample(random)), static_cast<s16>(sample(random))};
+    }
+    for (auto& frame : inputs.quad) {
+        for (auto& channel : frame) {
+            channel = mix_sample(random);
+        }
+    }
+    for (auto& channel_gain : inputs.gains) {
+        channel_gain = gain(random);
+    }
+    inputs.gain = gain(random);
+    return inputs;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("Vectorized mixing kernels match the scalar ones", "[audio_core][hle]") {
+    std::mt19937 random{42};
+    for (int i = 0; i < 100; i++) {
+        const Inputs inputs = MakeInputs(random);
+
+        QuadFrame32 quad = inputs.quad;
+        QuadFrame32 scalar_quad = inputs.quad;
+        MixKernels::MixStereoIntoQuad(quad, inputs.stereo, inputs.gains);
+        MixKernels::Scalar::MixStereoIntoQuad(scalar_quad, inputs.stereo, inputs.gains);
+        REQUIRE(quad == scalar_quad);
+
+        StereoFrame16 stereo = inputs.stereo;
+        StereoFrame16 scalar_stereo = inputs.stereo;
+        MixKernels::DownmixStereoInto(stereo, inputs.quad, inputs.gain);
+        MixKernels::Scalar::DownmixStereoInto(scalar_stereo, inputs.quad, inputs.gain);
+        REQUIRE(stereo == scalar_stereo);
+
+        stereo = inputs.stereo;
+        scalar_stereo = inputs.stereo;
+        MixKernels::DownmixMonoInto(stereo, inputs.quad, inputs.gain);
+        MixKernels::Scalar::DownmixMonoInto(scalar_stereo, inputs.quad, inputs.gain);
+        REQUIRE(stereo == scalar_stereo);
+
+        s32 planar[4][samples_per_frame];
+        s32 scalar_planar[4][samples_per_frame];
+        MixKernels::ToPlanar(planar, inputs.quad);
+        MixKernels::Scalar::ToPlanar(scalar_planar, inputs.quad);
+        REQUIRE(std::memcmp(planar, scalar_planar, sizeof(planar)) == 0);
+
+        MixKernels::FromPlanar(quad, planar);
+        REQUIRE(quad == inputs.quad);
+    }
+}
+
+TEST_CASE("Mixing kernel benchmarks", "[audio_core][hle][.benchmark]") {
+    std::mt19937 random{42};
+    const Inputs inputs = MakeInputs(random);
+    QuadFrame32 quad{};
+    StereoFrame16 stereo{};
+
+    BENCHMARK("Mix 24 sources into a quadraphonic mix") {
+        for (int source = 0; source < 24; source++) {
+            MixKernels::MixStereoIntoQuad(quad, inputs.stereo, inputs.gains);
+        }
+        return quad[0][0];
+    };
+
+    BENCHMARK("Mix 24 sources into a quadraphonic mix (scalar)") {
+        for (int source = 0; source < 24; source++) {
+            MixKernels::Scalar::MixStereoIntoQuad(quad, inputs.stereo, inputs.gains);
+        }
+        return quad[0][0];
+    };
+
+    BENCHMARK("Downmix three mixes to stereo") {
+        for (int mix = 0; mix < 3; mix++) {
+            MixKernels::DownmixStereoInto(stereo, inputs.quad, inputs.gain);
+        }
+        return stereo[0][0];
+    };
+
+    BENCHMARK("Downmix three mixes to stereo (scalar)") {
+        for (int mix = 0; mix < 3; mix++) {
+            MixKernels::Scalar::DownmixStereoInto(stereo, inputs.quad, inputs.gain);
+        }
+        return stereo[0][0];
+    };
+}
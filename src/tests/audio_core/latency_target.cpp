@@ -0,0 +1,111 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include "audio_core/latency_target.h"
+
+using AudioCore::LatencyTarget;
+
+namespace {
+
+constexpr std::size_t CallbackFrames = 512;
+
+/// Runs callbacks that fill their whole buffer, for at least the specified number of frames
+void RunFilled(LatencyTarget& latency, std::size_t frames) {
+    for (std::size_t i = 0; i < frames; i += CallbackFrames) {
+        REQUIRE(!latency.Update(CallbackFrames, CallbackFrames, true));
+    }
+}
+
+} // Anonymous namespace
+
+TEST_CASE("LatencyTarget counts underruns", "[audio_core]") {
+    LatencyTarget latency;
+    const bool adaptive = GENERATE(false, true);
+
+    // Only the first starved callback is an underrun, not the next ones while the emulation is
+    // paused.
+    REQUIRE(!latency.Update(CallbackFrames, CallbackFrames, adaptive));
+    REQUIRE(latency.Update(100, CallbackFrames, adaptive));
+    REQUIRE(!latency.Update(0, CallbackFrames, adaptive));
+    REQUIRE(!latency.Update(0, CallbackFrames, adaptive));
+    REQUIRE(!latency.Update(CallbackFrames, CallbackFrames, adaptive));
+    REQUIRE(latency.Update(0, CallbackFrames, adaptive));
+
+    // Changing the sink forgets the starved callback.
+    latency.Reset();
+    REQUIRE(latency.Update(0, CallbackFrames, adaptive));
+
+    if (!adaptive) {
+        REQUIRE(latency.GetTarget() == LatencyTarget::MinTarget);
+    }
+}
+
+TEST_CASE("LatencyTarget adapts to underruns", "[audio_core]") {
+    LatencyTarget latency;
+    REQUIRE(latency.GetTarget() == LatencyTarget::MinTarget);
+
+    SECTION("raises the target by a step per underrun") {
+        REQUIRE(latency.Update(0, CallbackFrames, true));
+        REQUIRE(latency.GetTarget() == LatencyTarget::MinTarget + LatencyTarget::Step);
+        REQUIRE(!latency.Update(0, CallbackFrames, true));
+        REQUIRE(latency.GetTarget() == LatencyTarget::MinTarget + LatencyTarget::Step);
+
+        REQUIRE(!latency.Update(CallbackFrames, CallbackFrames, true));
+        REQUIRE(latency.Update(0, CallbackFrames, true));
+        REQUIRE(latency.GetTarget() == LatencyTarget::MinTarget + 2 * LatencyTarget::Step);
+    }
+
+    SECTION("clamps the target") {
+        for (int i = 0; i < 100; i++) {
+            latency.Update(0, CallbackFrames, true);
+            latency.Update(CallbackFrames, CallbackFrames, true);
+        }
+        REQUIRE(latency.GetTarget() == LatencyTarget::MaxTarget);
+    }
+
+    SECTION("lowers the target after a period without underruns") {
+        latency.Update(0, CallbackFrames, true);
+        latency.Update(CallbackFrames, CallbackFrames, true);
+        latency.Update(0, CallbackFrames, true);
+        REQUIRE(latency.GetTarget() == LatencyTarget::MinTarget + 2 * LatencyTarget::Step);
+
+        RunFilled(latency, LatencyTarget::DecreasePeriod - CallbackFrames);
+        REQUIRE(latency.GetTarget() == LatencyTarget::MinTarget + 2 * LatencyTarget::Step);
+        RunFilled(latency, CallbackFrames);
+        REQUIRE(latency.GetTarget() == LatencyTarget::MinTarget + LatencyTarget::Step);
+
+        // An underrun restarts the period.
+        RunFilled(latency, LatencyTarget::DecreasePeriod - CallbackFrames);
+        latency.Update(0, CallbackFrames, true);
+        REQUIRE(latency.GetTarget() == LatencyTarget::MinTarget + 2 * LatencyTarget::Step);
+        RunFilled(latency, LatencyTarget::DecreasePeriod);
+        RunFilled(latency, LatencyTarget::DecreasePeriod);
+        REQUIRE(latency.GetTarget() == LatencyTarget::MinTarget);
+
+        // The target does not go below the minimum.
+        RunFilled(latency, LatencyTarget::DecreasePeriod);
+        REQUIRE(latency.GetTarget() == LatencyTarget::MinTarget);
+    }
+}
+
+TEST_CASE("LatencyTarget excess frames", "[audio_core]") {
+    LatencyTarget latency;
+    constexpr std::size_t Target = LatencyTarget::MinTarget;
+
+    // The frames of this callback and one step of slack are kept.
+    REQUIRE(latency.GetExcessFrames(0, CallbackFrames) == 0);
+    REQUIRE(latency.GetExcessFrames(Target + CallbackFrames, CallbackFrames) == 0);
+    REQUIRE(
+        latency.GetExcessFrames(Target + CallbackFrames + LatencyTarget::Step, CallbackFrames) == 0);
+    REQUIRE(latency.GetExcessFrames(Target + CallbackFrames + LatencyTarget::Step + 1,
+                                    CallbackFrames) == LatencyTarget::Step + 1);
+    REQUIRE(latency.GetExcessFrames(Target + CallbackFrames + 1000, CallbackFrames) == 1000);
+
+    // A higher target keeps more frames.
+    latency.Update(0, CallbackFrames, true);
+    REQUIRE(latency.GetExcessFrames(Target + CallbackFrames + 1000, CallbackFrames) ==
+            1000 - LatencyTarget::Step);
+}
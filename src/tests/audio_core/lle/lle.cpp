@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
 #include <fmt/core.h>
 
 #include "audio_core/hle/decoder.h"
@@ -19,7 +20,9 @@ TEST_CASE("DSP LLE Sanity", "[audio_core][lle]") {
     Memory::MemorySystem memory{system};
     Core::Timing core_timing(1, 100);
 
-    AudioCore::DspLle lle(system, memory, core_timing, true);
+    const auto threading =
+        GENERATE(AudioCore::LleThreading::Lockstep, AudioCore::LleThreading::RunAhead);
+    AudioCore::DspLle lle(system, memory, core_timing, threading);
     {
         FileUtil::SetUserPath();
         // dspaudio.cdc can be dumped from Pokemon X & Y, It can be found in the romfs at
@@ -124,8 +124,10 @@ void ServiceFixture::InitDspCore(Settings::AudioEmulation dsp_core) {
     if (dsp_core == Settings::AudioEmulation::HLE) {
         dsp = std::make_unique<AudioCore::DspHle>(system, memory, core_timing);
     } else {
-        dsp = std::make_unique<AudioCore::DspLle>(
-            system, memory, core_timing, dsp_core == Settings::AudioEmulation::LLEMultithreaded);
+        const auto threading = dsp_core == Settings::AudioEmulation::LLEMultithreaded
+                                   ? AudioCore::LleThreading::Lockstep
+                                   : AudioCore::LleThreading::None;
+        dsp = std::make_unique<AudioCore::DspLle>(system, memory, core_timing, threading);
     }
     dsp->SetInterruptHandler([this](Service::DSP::InterruptType type, AudioCore::DspPipe pipe) {
         interrupts_fired[static_cast<u32>(type)][static_cast<u32>(pipe)] = 1;
@@ -0,0 +1,39 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "common/ring_buffer.h"
+
+TEST_CASE("RingBuffer Discard", "[common]") {
+    Common::RingBuffer<s16, 8, 2> buffer;
+    const std::array<s16, 12> frames{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+
+    SECTION("drops the oldest slots") {
+        REQUIRE(buffer.Push(frames.data(), 6) == 6);
+        REQUIRE(buffer.Discard(2) == 2);
+        REQUIRE(buffer.Size() == 4);
+        REQUIRE(buffer.Pop(1) == std::vector<s16>{4, 5});
+    }
+
+    SECTION("stops at the filled slots") {
+        REQUIRE(buffer.Push(frames.data(), 3) == 3);
+        REQUIRE(buffer.Discard(5) == 3);
+        REQUIRE(buffer.Size() == 0);
+        REQUIRE(buffer.Discard(1) == 0);
+        REQUIRE(buffer.Pop().empty());
+    }
+
+    SECTION("frees the slots for pushing") {
+        REQUIRE(buffer.Push(frames.data(), 6) == 6);
+        REQUIRE(buffer.Push(frames.data(), 6) == 2);
+        REQUIRE(buffer.Discard(4) == 4);
+
+        // The next push wraps around the end of the storage
+        REQUIRE(buffer.Push(frames.data() + 6, 3) == 3);
+        REQUIRE(buffer.Size() == 7);
+        REQUIRE(buffer.Pop() == std::vector<s16>{8, 9, 10, 11, 0, 1, 2, 3, 6, 7, 8, 9, 10, 11});
+    }
+}
@@ -0,0 +1,103 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "common/common_types.h"
+#include "common/file_util.h"
+#include "common/zstd_compression.h"
+
+namespace {
+
+constexpr std::size_t FrameSize = 4096;
+// Not a multiple of the frame size, so the last frame is a short one
+constexpr std::size_t DataSize = FrameSize * 16 + 123;
+
+std::string TempPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+/// Writes compressible but position dependent data, and compresses it into a seekable file.
+std::vector<u8> MakeCompressedFile(const std::string& raw_path, const std::string& z3ds_path) {
+    std::vector<u8> data(DataSize);
+    for (std::size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<u8>((i / 7) ^ (i >> 12));
+    }
+    {
+        FileUtil::IOFile raw(raw_path, "wb");
+        REQUIRE(raw.WriteBytes(data.data(), data.size()) == data.size());
+    }
+    REQUIRE(FileUtil::CompressZ3DSFile(raw_path, z3ds_path, {'T', 'E', 'S', 'T'}, FrameSize));
+    return data;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("Z3DSReadIOFile random reads", "[common]") {
+    const std::string raw_path = TempPath("citra_z3ds_test.bin");
+    const std::string z3ds_path = TempPath("citra_z3ds_test.z3ds");
+    const std::vector<u8> data = MakeCompressedFile(raw_path, z3ds_path);
+
+    FileUtil::Z3DSReadIOFile file(std::make_unique<FileUtil::IOFile>(z3ds_path, "rb"));
+    REQUIRE(file.IsGood());
+    REQUIRE(file.GetSize() == DataSize);
+
+    // Room for two frames only, so the random reads keep evicting frames
+    file.SetCacheBudget(FrameSize * 2);
+
+    const auto check_read = [&](std::size_t offset, std::size_t length) {
+        std::vector<u8> out(length);
+        const std::size_t expected = std::min(length, DataSize - std::min(offset, DataSize));
+        REQUIRE(file.ReadAtBytes(out.data(), length, offset) == expected);
+        REQUIRE(std::equal(out.begin(), out.begin() + expected, data.begin() + offset));
+    };
+
+    SECTION("reads crossing frame boundaries") {
+        check_read(FrameSize - 10, 20);
+        check_read(FrameSize * 3 - 1, FrameSize * 2 + 2);
+        check_read(DataSize - 50, 100);
+    }
+
+    SECTION("whole frame reads bypass the cache") {
+        check_read(FrameSize * 5, FrameSize);
+        REQUIRE(file.GetCacheStats().bypasses == 1);
+        REQUIRE(file.GetCacheStats().cached_bytes == 0);
+    }
+
+    SECTION("random reads with eviction") {
+        std::mt19937 rng{0x23D5};
+        std::uniform_int_distribution<std::size_t> offset_dist{0, DataSize - 1};
+        std::uniform_int_distribution<std::size_t> length_dist{1, FrameSize * 3};
+        for (int i = 0; i < 500; i++) {
+            check_read(offset_dist(rng), length_dist(rng));
+        }
+
+        const auto stats = file.GetCacheStats();
+        REQUIRE(stats.misses > 0);
+        REQUIRE(stats.evictions > 0);
+        REQUIRE(stats.cached_bytes <= FrameSize * 2);
+    }
+
+    SECTION("sequential reads") {
+        std::vector<u8> out(DataSize);
+        std::size_t done = 0;
+        while (done < DataSize) {
+            const std::size_t length = std::min<std::size_t>(1000, DataSize - done);
+            REQUIRE(file.ReadBytes(out.data() + done, length) == length);
+            done += length;
+        }
+        REQUIRE(out == data);
+    }
+
+    file.Close();
+    FileUtil::Delete(raw_path);
+    FileUtil::Delete(z3ds_path);
+}
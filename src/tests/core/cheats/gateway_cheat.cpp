@@ -0,0 +1,303 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <catch2/catch_test_macros.hpp>
+#include "core/cheats/gateway_cheat.h"
+#include "core/core.h"
+#include "core/core_timing.h"
+#include "core/hle/kernel/process.h"
+#include "core/memory.h"
+
+using Cheats::GatewayCheat;
+
+namespace {
+
+constexpr VAddr Base = Memory::HEAP_VADDR;
+
+/// Process with a single page of memory mapped at the start of the heap
+class CheatFixture {
+public:
+    CheatFixture()
+        : memory{system},
+          kernel{memory, timing, [] {}, Kernel::MemoryMode::Prod, 1,
+                 Kernel::New3dsHwCapabilities{false, false, Kernel::New3dsMemoryMode::Legacy}},
+          process{kernel.CreateProcess(kernel.CreateCodeSet("", 0))} {
+        const MemoryRef block{std::make_shared<BufferMem>(Memory::CITRA_PAGE_SIZE)};
+        const auto result = process->vm_manager.MapBackingMemory(
+            Base, block, static_cast<u32>(block.GetSize()), Kernel::MemoryState::Private);
+        REQUIRE(result.Code() == ResultSuccess);
+    }
+
+    void Run(std::initializer_list<const char*> lines, u32 pad_state = 0) {
+        std::string code;
+        for (const char* line : lines) {
+            code += line;
+            code += '\n';
+        }
+        const GatewayCheat cheat{"test", code, ""};
+        cheat.Execute(memory, *process, pad_state);
+    }
+
+    u32 Read32(u32 offset) {
+        return memory.Read32(*process, Base + offset);
+    }
+
+    u16 Read16(u32 offset) {
+        return memory.Read16(*process, Base + offset);
+    }
+
+    u8 Read8(u32 offset) {
+        return memory.Read8(*process, Base + offset);
+    }
+
+    void Write32(u32 offset, u32 value) {
+        memory.Write32(*process, Base + offset, value);
+    }
+
+private:
+    Core::Timing timing{1, 100};
+    Core::System system;
+    Memory::MemorySystem memory;
+    Kernel::KernelSystem kernel;
+    std::shared_ptr<Kernel::Process> process;
+};
+
+} // Anonymous namespace
+
+TEST_CASE("GatewayCheat writes", "[core][cheats]") {
+    CheatFixture fixture;
+    fixture.Run({
+        "08000000 12345678",
+        "18000004 0000ABCD",
+        "28000006 000000EF",
+    });
+    REQUIRE(fixture.Read32(0x0) == 0x12345678);
+    REQUIRE(fixture.Read16(0x4) == 0xABCD);
+    REQUIRE(fixture.Read8(0x6) == 0xEF);
+    REQUIRE(fixture.Read8(0x7) == 0);
+}
+
+TEST_CASE("GatewayCheat conditions", "[core][cheats]") {
+    CheatFixture fixture;
+    fixture.Write32(0x10, 0x12340064);
+
+    // Each condition guards a write of the flag, the operand is compared with the memory value.
+    const auto condition_passes = [&](const char* condition) {
+        fixture.Write32(0x20, 0);
+        fixture.Run({condition, "08000020 00000001", "D0000000 00000000"});
+        return fixture.Read32(0x20) == 1;
+    };
+
+    SECTION("32 bit") {
+        REQUIRE(condition_passes("38000010 12340065"));
+        REQUIRE(!condition_passes("38000010 12340064"));
+        REQUIRE(condition_passes("48000010 12340063"));
+        REQUIRE(!condition_passes("48000010 12340064"));
+        REQUIRE(condition_passes("58000010 12340064"));
+        REQUIRE(!condition_passes("58000010 00000064"));
+        REQUIRE(condition_passes("68000010 00000064"));
+        REQUIRE(!condition_passes("68000010 12340064"));
+    }
+
+    SECTION("16 bit with mask") {
+        // The upper half of the operand masks out bits of the memory value
+        REQUIRE(condition_passes("78000010 00000065"));
+        REQUIRE(!condition_passes("78000010 00000064"));
+        REQUIRE(condition_passes("78000010 FF0000FF"));
+        REQUIRE(condition_passes("88000010 00000063"));
+        REQUIRE(!condition_passes("88000010 00000064"));
+        REQUIRE(condition_passes("98000010 00000064"));
+        REQUIRE(condition_passes("98000010 FFFF0000"));
+        REQUIRE(!condition_passes("98000010 00000065"));
+        REQUIRE(condition_passes("A8000010 00000065"));
+        REQUIRE(!condition_passes("A8000010 00000064"));
+    }
+
+    SECTION("joker") {
+        fixture.Write32(0x20, 0);
+        fixture.Run({"DD000000 00000003", "08000020 00000001", "D0000000 00000000"}, 0x7);
+        REQUIRE(fixture.Read32(0x20) == 1);
+
+        fixture.Write32(0x20, 0);
+        fixture.Run({"DD000000 00000003", "08000020 00000001", "D0000000 00000000"}, 0x1);
+        REQUIRE(fixture.Read32(0x20) == 0);
+    }
+}
+
+TEST_CASE("GatewayCheat nested conditions", "[core][cheats]") {
+    CheatFixture fixture;
+    fixture.Write32(0x10, 1);
+    fixture.Write32(0x14, 2);
+
+    SECTION("end if") {
+        fixture.Run({
+            "58000010 00000001", // if [0x10] == 1, passes
+            "58000014 00000003", //     if [0x14] == 3, fails
+            "08000020 00000001", //         skipped
+            "D0000000 00000000", //     end if
+            "08000024 00000001", //     runs
+            "D0000000 00000000", // end if
+            "58000014 00000005", // if [0x14] == 5, fails
+            "58000010 00000001", //     if [0x10] == 1, skipped
+            "08000028 00000001", //         skipped
+            "D0000000 00000000", //     end if
+            "0800002C 00000001", //     skipped
+            "D0000000 00000000", // end if
+            "08000030 00000001", // runs
+        });
+        REQUIRE(fixture.Read32(0x20) == 0);
+        REQUIRE(fixture.Read32(0x24) == 1);
+        REQUIRE(fixture.Read32(0x28) == 0);
+        REQUIRE(fixture.Read32(0x2C) == 0);
+        REQUIRE(fixture.Read32(0x30) == 1);
+    }
+
+    SECTION("full terminator") {
+        // D2 ends all the conditions at once and resets the offset
+        fixture.Run({
+            "D3000000 00000100",
+            "58000010 00000003", // if [0x10 + offset] == 3, fails
+            "58000010 00000001", //     skipped
+            "08000020 00000001", //         skipped
+            "D2000000 00000000", // end all
+            "08000024 00000001", // runs without offset
+        });
+        REQUIRE(fixture.Read32(0x120) == 0);
+        REQUIRE(fixture.Read32(0x124) == 0);
+        REQUIRE(fixture.Read32(0x24) == 1);
+    }
+}
+
+TEST_CASE("GatewayCheat offset and data registers", "[core][cheats]") {
+    CheatFixture fixture;
+    fixture.Write32(0x30, 0xAABBCCDD);
+
+    SECTION("loads and incrementive writes") {
+        fixture.Run({
+            "D3000000 08000000", // offset = base
+            "D9000000 00000030", // reg = word [base + 0x30]
+            "D6000000 00000040", // word [base + 0x40] = reg, offset += 4
+            "DA000000 0000002C", // reg = half [base + 0x30]
+            "D7000000 00000040", // half [base + 0x44] = reg, offset += 2
+            "DB000000 0000002A", // reg = byte [base + 0x30]
+            "D8000000 00000040", // byte [base + 0x46] = reg, offset += 1
+        });
+        REQUIRE(fixture.Read32(0x40) == 0xAABBCCDD);
+        REQUIRE(fixture.Read16(0x44) == 0xCCDD);
+        REQUIRE(fixture.Read8(0x46) == 0xDD);
+        REQUIRE(fixture.Read8(0x47) == 0);
+    }
+
+    SECTION("arithmetic") {
+        fixture.Run({
+            "D5000000 00000010", // reg = 0x10
+            "D4000000 00000005", // reg += 5
+            "D3000000 08000000", // offset = base
+            "DC000000 00000050", // offset += 0x50
+            "D6000000 00000000", // word [base + 0x50] = reg
+        });
+        REQUIRE(fixture.Read32(0x50) == 0x15);
+    }
+
+    SECTION("load offset") {
+        fixture.Write32(0x60, Base + 0x100);
+        fixture.Run({
+            "B8000060 00000000", // offset = word [base + 0x60]
+            "00000008 00000077", // word [offset + 8] = 0x77
+        });
+        REQUIRE(fixture.Read32(0x108) == 0x77);
+    }
+}
+
+TEST_CASE("GatewayCheat loops", "[core][cheats]") {
+    CheatFixture fixture;
+
+    // The loop count is compared before being incremented, so the block runs count + 1 times.
+    SECTION("end loop") {
+        fixture.Run({
+            "D3000000 08000000",
+            "D5000000 00000007",
+            "C0000000 00000003",
+            "D8000000 00000080", // byte [base + 0x80 + i] = reg
+            "D4000000 00000001", // reg += 1
+            "D1000000 00000000",
+            "D8000000 00000080", // runs once after the loop
+        });
+        REQUIRE(fixture.Read32(0x80) == 0x0A090807);
+        REQUIRE(fixture.Read8(0x84) == 0x0B);
+        REQUIRE(fixture.Read8(0x85) == 0);
+    }
+
+    SECTION("full terminator") {
+        fixture.Run({
+            "D3000000 08000000",
+            "D5000000 00000011",
+            "C0000000 00000001",
+            "D8000000 00000090", // byte [base + 0x90 + i] = reg
+            "D2000000 00000000",
+        });
+        REQUIRE(fixture.Read16(0x90) == 0x1111);
+        REQUIRE(fixture.Read8(0x92) == 0);
+    }
+
+    SECTION("skipped body") {
+        fixture.Write32(0x10, 1);
+        fixture.Run({
+            "D3000000 08000000",
+            "C0000000 00000002",
+            "00000010 00000002", // if word [offset + 0x10] == 2, fails in every iteration
+            "D8000000 000000A0",
+            "D0000000 00000000",
+            "DC000000 00000001", // offset += 1 in every iteration
+            "D1000000 00000000",
+            "D6000000 000000A0", // word [base + 0xA0 + 3] = 0
+            "D5000000 00000042",
+            "D8000000 000000A0", // byte [base + 0xA7] = 0x42
+        });
+        REQUIRE(fixture.Read32(0xA0) == 0);
+        REQUIRE(fixture.Read8(0xA7) == 0x42);
+    }
+}
+
+TEST_CASE("GatewayCheat patches", "[core][cheats]") {
+    CheatFixture fixture;
+    fixture.Write32(0x108, 0xFFFFFFFF);
+
+    // The data lines hold the first word and then the second one, in little endian, and do not
+    // run as instructions.
+    fixture.Run({
+        "E8000100 0000000A",
+        "44332211 88776655",
+        "08000200 00000001",
+        "0800020C 00000001",
+    });
+    REQUIRE(fixture.Read32(0x100) == 0x44332211);
+    REQUIRE(fixture.Read32(0x104) == 0x88776655);
+    REQUIRE(fixture.Read32(0x108) == 0xFFFF0200);
+    REQUIRE(fixture.Read32(0x200) == 0);
+    REQUIRE(fixture.Read32(0x20C) == 1);
+}
+
+TEST_CASE("GatewayCheat invalid lines", "[core][cheats]") {
+    REQUIRE(GatewayCheat::CheatLine{"08000000 12345678"}.valid);
+    REQUIRE(!GatewayCheat::CheatLine{"0800000 12345678"}.valid);
+    REQUIRE(!GatewayCheat::CheatLine{"08000000 123456789"}.valid);
+    REQUIRE(!GatewayCheat::CheatLine{"XY000000 12345678"}.valid);
+
+    // Invalid lines and unknown types are ignored, the other lines still run.
+    CheatFixture fixture;
+    fixture.Run({
+        "0800000 12345678",
+        "08000000 00000001",
+        "XY000000 12345678",
+        "F8000004 00000001",
+        "08000008 00000001",
+    });
+    REQUIRE(fixture.Read32(0x0) == 1);
+    REQUIRE(fixture.Read32(0x4) == 0);
+    REQUIRE(fixture.Read32(0x8) == 1);
+}
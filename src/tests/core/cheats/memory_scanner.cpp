@@ -0,0 +1,131 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include "core/cheats/memory_scanner.h"
+
+using Cheats::ScanComparison;
+using Cheats::ScanFilter;
+using Cheats::ScanValueType;
+
+namespace {
+
+constexpr std::size_t MaxBlockSize = Cheats::Detail::ScanBlockValues * sizeof(u32);
+
+using Block = std::array<u8, MaxBlockSize>;
+
+std::size_t ValueSize(ScanValueType type) {
+    switch (type) {
+    case ScanValueType::U8:
+        return sizeof(u8);
+    case ScanValueType::U16:
+        return sizeof(u16);
+    default:
+        return sizeof(u32);
+    }
+}
+
+void StoreValue(Block& block, std::size_t index, ScanValueType type, u32 bits) {
+    const std::size_t size = ValueSize(type);
+    std::memcpy(block.data() + index * size, &bits, size);
+}
+
+/// Operands and values that lie on the edges of the comparisons
+std::vector<u32> SpecialValues(ScanValueType type) {
+    switch (type) {
+    case ScanValueType::U8:
+        return {0, 1, 0x7F, 0x80, 0xFE, 0xFF};
+    case ScanValueType::U16:
+        return {0, 1, 0x7FFF, 0x8000, 0xFFFE, 0xFFFF};
+    case ScanValueType::U32:
+        return {0, 1, 0x7FFFFFFF, 0x80000000, 0xFFFFFFFE, 0xFFFFFFFF};
+    case ScanValueType::Float:
+        return {
+            std::bit_cast<u32>(0.0f),
+            std::bit_cast<u32>(-0.0f),
+            std::bit_cast<u32>(1.5f),
+            std::bit_cast<u32>(-1.5f),
+            std::bit_cast<u32>(std::numeric_limits<float>::infinity()),
+            std::bit_cast<u32>(std::numeric_limits<float>::quiet_NaN()),
+            std::bit_cast<u32>(std::numeric_limits<float>::max()),
+        };
+    }
+    return {};
+}
+
+} // Anonymous namespace
+
+TEST_CASE("MemoryScanner vectorized comparisons match the scalar ones", "[core][cheats]") {
+    const auto type = GENERATE(ScanValueType::U8, ScanValueType::U16, ScanValueType::U32,
+                               ScanValueType::Float);
+    const auto comparison = GENERATE(ScanComparison::Equal, ScanComparison::Range,
+                                     ScanComparison::Changed, ScanComparison::Unchanged);
+
+    std::mt19937 rng{static_cast<u32>(type) * 4 + static_cast<u32>(comparison)};
+    const auto special = SpecialValues(type);
+    const auto pick_special = [&] { return special[rng() % special.size()]; };
+
+    for (int iteration = 0; iteration < 256; ++iteration) {
+        ScanFilter filter{comparison, pick_special(), pick_special()};
+        if (iteration % 2 == 0) {
+            filter.first = static_cast<u32>(rng());
+            filter.second = static_cast<u32>(rng());
+        }
+
+        // Mix random values with the operands and edge values, and change some of them.
+        Block current{};
+        Block previous{};
+        for (std::size_t i = 0; i < Cheats::Detail::ScanBlockValues; ++i) {
+            u32 value = static_cast<u32>(rng());
+            switch (rng() % 4) {
+            case 0:
+                value = filter.first;
+                break;
+            case 1:
+                value = pick_special();
+                break;
+            default:
+                break;
+            }
+            StoreValue(current, i, type, value);
+            StoreValue(previous, i, type, rng() % 2 == 0 ? value : static_cast<u32>(rng()));
+        }
+
+        const u64 expected =
+            Cheats::Detail::MatchBlockScalar(type, filter, current.data(), previous.data());
+        const u64 result =
+            Cheats::Detail::MatchBlock(type, filter, current.data(), previous.data());
+        INFO("iteration " << iteration << ", operands " << filter.first << " " << filter.second);
+        REQUIRE(result == expected);
+    }
+}
+
+TEST_CASE("MemoryScanner scalar comparisons", "[core][cheats]") {
+    Block current{};
+    Block previous{};
+    StoreValue(current, 0, ScanValueType::U16, 0x1234);
+    StoreValue(current, 1, ScanValueType::U16, 0x8000);
+    StoreValue(current, 2, ScanValueType::U16, 0xFFFF);
+    StoreValue(previous, 0, ScanValueType::U16, 0x1234);
+
+    const auto match = [&](ScanComparison comparison, u32 first, u32 second) {
+        const ScanFilter filter{comparison, first, second};
+        return Cheats::Detail::MatchBlockScalar(ScanValueType::U16, filter, current.data(),
+                                                previous.data()) &
+               0x7;
+    };
+
+    REQUIRE(match(ScanComparison::Equal, 0x8000, 0) == 0b010);
+    // The operands of ranges are accepted in any order and compared as unsigned values
+    REQUIRE(match(ScanComparison::Range, 0xFFFF, 0x7FFF) == 0b110);
+    REQUIRE(match(ScanComparison::Range, 0, 0x1234) == 0b001);
+    REQUIRE(match(ScanComparison::Changed, 0, 0) == 0b110);
+    REQUIRE(match(ScanComparison::Unchanged, 0, 0) == 0b001);
+}
@@ -0,0 +1,126 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+// The test talks to the stub through a loopback socket, which only uses the BSD socket API.
+#ifndef _WIN32
+
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+#include <arpa/inet.h>
+#include <fmt/format.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <catch2/catch_test_macros.hpp>
+#include "core/core.h"
+#include "core/gdbstub/gdbstub.h"
+
+namespace {
+
+constexpr u16 TestPort = 24690;
+
+std::string MakePacket(const std::string& data) {
+    u8 checksum = 0;
+    for (const char c : data) {
+        checksum += static_cast<u8>(c);
+    }
+    return fmt::format("${}#{:02x}", data, checksum);
+}
+
+/// Client end of a connection with the gdbstub server
+class GdbClient {
+public:
+    GdbClient() {
+        GDBStub::SetServerPort(TestPort);
+        GDBStub::ToggleServer(true);
+        auto server = std::async(std::launch::async, [] { GDBStub::Init(); });
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(TestPort);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        // The server starts listening asynchronously, retry until it accepts the connection.
+        for (int attempt = 0; attempt < 100; attempt++) {
+            socket_fd = socket(AF_INET, SOCK_STREAM, 0);
+            if (connect(socket_fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0) {
+                break;
+            }
+            close(socket_fd);
+            socket_fd = -1;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        server.wait();
+    }
+
+    ~GdbClient() {
+        GDBStub::ToggleServer(false);
+        if (socket_fd != -1) {
+            close(socket_fd);
+        }
+    }
+
+    bool IsConnected() const {
+        return socket_fd != -1 && GDBStub::IsConnected();
+    }
+
+    /// Sends a command and lets the stub handle it, returning everything the stub answered.
+    std::string Request(const std::string& command) {
+        const std::string packet = MakePacket(command);
+        send(socket_fd, packet.data(), packet.size(), 0);
+
+        std::string reply;
+        for (int attempt = 0; attempt < 100 && !IsCompleteReply(reply); attempt++) {
+            GDBStub::HandlePacket(Core::System::GetInstance());
+
+            fd_set fds;
+            FD_ZERO(&fds);
+            FD_SET(socket_fd, &fds);
+            timeval timeout{0, 10000};
+            if (select(socket_fd + 1, &fds, nullptr, nullptr, &timeout) > 0) {
+                char buffer[256];
+                const auto size = recv(socket_fd, buffer, sizeof(buffer), 0);
+                if (size <= 0) {
+                    break;
+                }
+                reply.append(buffer, static_cast<std::size_t>(size));
+            }
+        }
+        return reply;
+    }
+
+private:
+    /// Whether the reply holds an acknowledgement and a packet with its checksum
+    static bool IsCompleteReply(const std::string& reply) {
+        const auto end = reply.find('#');
+        return end != std::string::npos && reply.size() >= end + 3;
+    }
+
+    int socket_fd = -1;
+};
+
+/// Acknowledgement of the command followed by the reply packet
+std::string Reply(const std::string& data) {
+    return '+' + MakePacket(data);
+}
+
+} // Anonymous namespace
+
+TEST_CASE("GDBStub rejects huge memory lengths", "[core][gdbstub]") {
+    GdbClient client;
+    REQUIRE(client.IsConnected());
+
+    // The hex replies would not fit the packet buffer, and most lengths wrap around in 32 bits
+    // once doubled for the hex encoding.
+    REQUIRE(client.Request("m0,80000000") == Reply("E01"));
+    REQUIRE(client.Request("m0,ffffffff") == Reply("E01"));
+    REQUIRE(client.Request("m0,7fff") == Reply("E01"));
+    REQUIRE(client.Request("x0,ffffffff") == Reply("E01"));
+    REQUIRE(client.Request("M0,80000000:00") == Reply("E01"));
+}
+
+#endif
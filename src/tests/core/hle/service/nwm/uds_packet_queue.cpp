@@ -0,0 +1,146 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <span>
+#include <utility>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "core/hle/service/nwm/nwm_uds.h"
+#include "core/hle/service/nwm/uds_data.h"
+#include "core/hle/service/nwm/uds_packet_queue.h"
+
+using Service::NWM::PacketBatchType;
+using Service::NWM::ReceivedPacket;
+using PacketType = Network::WifiPacket::PacketType;
+
+namespace {
+
+/// Data frame with only an LLC header of the specified EtherType
+std::vector<u8> MakeDataFrame(Service::NWM::EtherType ether_type) {
+    Service::NWM::LLCHeader header{};
+    header.protocol = ether_type;
+    std::vector<u8> data(sizeof(header));
+    std::memcpy(data.data(), &header, sizeof(header));
+    return data;
+}
+
+/// Packet tagged with its position in the sequence through the channel field
+ReceivedPacket MakePacket(PacketType type, u8 tag, std::vector<u8> data = {}) {
+    ReceivedPacket received{};
+    received.packet.type = type;
+    received.packet.data = std::move(data);
+    received.packet.channel = tag;
+    return received;
+}
+
+ReceivedPacket MakeSecureData(u8 tag) {
+    return MakePacket(PacketType::Data, tag,
+                      Service::NWM::GenerateDataPayload({}, 1, 0xFFFF, 2, tag));
+}
+
+ReceivedPacket MakeEAPoL(u8 tag) {
+    return MakePacket(PacketType::Data, tag, MakeDataFrame(Service::NWM::EtherType::EAPoL));
+}
+
+struct Batch {
+    PacketBatchType type;
+    std::vector<u8> tags;
+};
+
+std::vector<Batch> SplitBatches(std::span<const ReceivedPacket> packets) {
+    std::vector<Batch> batches;
+    Service::NWM::ForEachPacketBatch(
+        packets, [&batches](PacketBatchType type, std::span<const ReceivedPacket> batch) {
+            auto& tags = batches.emplace_back(Batch{type, {}}).tags;
+            for (const auto& received : batch) {
+                tags.push_back(received.packet.channel);
+            }
+        });
+    return batches;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("UDS packet batch types", "[core][nwm]") {
+    REQUIRE(Service::NWM::GetPacketBatchType(MakePacket(PacketType::Beacon, 0).packet) ==
+            PacketBatchType::Beacon);
+    REQUIRE(Service::NWM::GetPacketBatchType(MakeSecureData(0).packet) ==
+            PacketBatchType::SecureData);
+    REQUIRE(Service::NWM::GetPacketBatchType(MakeEAPoL(0).packet) == PacketBatchType::Single);
+    REQUIRE(Service::NWM::GetPacketBatchType(MakePacket(PacketType::NodeMap, 0).packet) ==
+            PacketBatchType::Single);
+}
+
+TEST_CASE("UDS packet batches", "[core][nwm]") {
+    SECTION("empty") {
+        REQUIRE(SplitBatches({}).empty());
+    }
+
+    SECTION("consecutive frames of a kind") {
+        const std::vector<ReceivedPacket> packets{
+            MakePacket(PacketType::Beacon, 0),
+            MakePacket(PacketType::Beacon, 1),
+            MakeSecureData(2),
+            MakeSecureData(3),
+            MakeSecureData(4),
+            MakeEAPoL(5),
+            MakePacket(PacketType::Authentication, 6),
+            MakePacket(PacketType::Authentication, 7),
+            MakeSecureData(8),
+            MakePacket(PacketType::Beacon, 9),
+        };
+        const auto batches = SplitBatches(packets);
+
+        // Every frame is delivered once, in the order it was received.
+        REQUIRE(batches.size() == 7);
+        REQUIRE(batches[0].type == PacketBatchType::Beacon);
+        REQUIRE(batches[0].tags == std::vector<u8>{0, 1});
+        REQUIRE(batches[1].type == PacketBatchType::SecureData);
+        REQUIRE(batches[1].tags == std::vector<u8>{2, 3, 4});
+        REQUIRE(batches[2].type == PacketBatchType::Single);
+        REQUIRE(batches[2].tags == std::vector<u8>{5});
+        REQUIRE(batches[3].type == PacketBatchType::Single);
+        REQUIRE(batches[3].tags == std::vector<u8>{6});
+        REQUIRE(batches[4].type == PacketBatchType::Single);
+        REQUIRE(batches[4].tags == std::vector<u8>{7});
+        REQUIRE(batches[5].type == PacketBatchType::SecureData);
+        REQUIRE(batches[5].tags == std::vector<u8>{8});
+        REQUIRE(batches[6].type == PacketBatchType::Beacon);
+        REQUIRE(batches[6].tags == std::vector<u8>{9});
+    }
+}
+
+TEST_CASE("UDS received packet queue", "[core][nwm]") {
+    Service::NWM::ReceivedPacketQueue queue;
+    std::vector<ReceivedPacket> packets;
+
+    queue.Take(packets);
+    REQUIRE(packets.empty());
+
+    queue.Push(MakePacket(PacketType::Beacon, 0).packet);
+    queue.Push(MakeSecureData(1).packet);
+    queue.Push(MakePacket(PacketType::NodeMap, 2).packet);
+    queue.Take(packets);
+    REQUIRE(packets.size() == 3);
+    for (std::size_t i = 0; i < packets.size(); i++) {
+        REQUIRE(packets[i].packet.channel == i);
+    }
+    REQUIRE(packets[0].received_time <= packets[1].received_time);
+    REQUIRE(packets[1].received_time <= packets[2].received_time);
+
+    // Taking again only returns the packets pushed since the last take.
+    queue.Push(MakePacket(PacketType::Beacon, 3).packet);
+    queue.Take(packets);
+    REQUIRE(packets.size() == 1);
+    REQUIRE(packets[0].packet.channel == 3);
+
+    queue.Take(packets);
+    REQUIRE(packets.empty());
+
+    queue.Push(MakePacket(PacketType::Beacon, 4).packet);
+    queue.Clear();
+    queue.Take(packets);
+    REQUIRE(packets.empty());
+}
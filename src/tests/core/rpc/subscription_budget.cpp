@@ -0,0 +1,76 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#ifdef ENABLE_SCRIPTING
+
+#include <memory>
+#include <catch2/catch_test_macros.hpp>
+#include "core/rpc/subscription_budget.h"
+
+using Core::RPC::SubscriptionBudget;
+
+TEST_CASE("SubscriptionBudget limits", "[core][rpc]") {
+    SubscriptionBudget budget{1000, 1500};
+    const auto client_a = std::make_shared<int>();
+    const auto client_b = std::make_shared<int>();
+    const std::weak_ptr<void> a = client_a;
+    const std::weak_ptr<void> b = client_b;
+
+    SECTION("per client limit") {
+        REQUIRE(budget.Acquire(a, 600));
+        REQUIRE(budget.Acquire(a, 400));
+        REQUIRE(!budget.Acquire(a, 1));
+        REQUIRE(budget.GetClientBytes(a) == 1000);
+
+        // Other clients have their own share
+        REQUIRE(budget.Acquire(b, 100));
+        REQUIRE(budget.GetTotalBytes() == 1100);
+    }
+
+    SECTION("total limit") {
+        REQUIRE(budget.Acquire(a, 1000));
+        REQUIRE(!budget.Acquire(b, 600));
+        REQUIRE(budget.GetClientBytes(b) == 0);
+        REQUIRE(budget.Acquire(b, 500));
+        REQUIRE(budget.GetTotalBytes() == 1500);
+    }
+
+    SECTION("oversized subscription") {
+        REQUIRE(!budget.Acquire(a, 0xFFFFFFFF));
+        REQUIRE(budget.GetClientBytes(a) == 0);
+        REQUIRE(budget.GetTotalBytes() == 0);
+    }
+
+    SECTION("release") {
+        REQUIRE(budget.Acquire(a, 1000));
+        REQUIRE(budget.Acquire(b, 500));
+        budget.Release(a, 600);
+        REQUIRE(budget.GetClientBytes(a) == 400);
+        REQUIRE(budget.Acquire(b, 500));
+        REQUIRE(!budget.Acquire(a, 101));
+        budget.Release(b, 1000);
+        REQUIRE(budget.GetClientBytes(b) == 0);
+        REQUIRE(budget.GetTotalBytes() == 400);
+    }
+
+    SECTION("disconnected client") {
+        REQUIRE(budget.Acquire(a, 800));
+        std::weak_ptr<void> expired;
+        {
+            auto client_c = std::make_shared<int>();
+            expired = client_c;
+            REQUIRE(budget.Acquire(expired, 700));
+        }
+        REQUIRE(expired.expired());
+        REQUIRE(budget.GetClientBytes(expired) == 700);
+        REQUIRE(!budget.Acquire(b, 100));
+
+        // The subscriptions of a disconnected client are released through its expired pointer
+        budget.Release(expired, 700);
+        REQUIRE(budget.GetTotalBytes() == 800);
+        REQUIRE(budget.Acquire(b, 700));
+    }
+}
+
+#endif
@@ -0,0 +1,68 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <string>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "network/packet.h"
+
+namespace Network {
+
+TEST_CASE("Packet round trips values", "[network]") {
+    const std::vector<u8> payload{1, 2, 3, 4, 5};
+    const std::array<u8, 6> mac{0x00, 0x1F, 0x32, 0xAA, 0xBB, 0xCC};
+    const std::vector<std::string> names{"first", "second"};
+
+    Packet packet;
+    packet << static_cast<u8>(7) << static_cast<u32>(0x12345678) << mac << payload << names;
+
+    u8 type{};
+    u32 value{};
+    std::array<u8, 6> out_mac{};
+    std::vector<u8> out_payload;
+    std::vector<std::string> out_names;
+    packet >> type >> value >> out_mac >> out_payload >> out_names;
+
+    REQUIRE(packet);
+    REQUIRE(packet.EndOfPacket());
+    REQUIRE(type == 7);
+    REQUIRE(value == 0x12345678);
+    REQUIRE(out_mac == mac);
+    REQUIRE(out_payload == payload);
+    REQUIRE(out_names == names);
+}
+
+TEST_CASE("Packet reads wrapped data in place", "[network]") {
+    Packet source;
+    source << static_cast<u8>(3) << std::vector<u8>{9, 8, 7};
+
+    Packet packet{source.GetData(), source.GetDataSize()};
+    REQUIRE(packet.GetData() == source.GetData());
+
+    u8 type{};
+    std::vector<u8> payload;
+    packet >> type >> payload;
+    REQUIRE(packet);
+    REQUIRE(type == 3);
+    REQUIRE(payload == std::vector<u8>{9, 8, 7});
+
+    // Appending copies the wrapped data first
+    packet << static_cast<u8>(1);
+    REQUIRE(packet.GetData() != source.GetData());
+    REQUIRE(packet.GetDataSize() == source.GetDataSize() + 1);
+}
+
+TEST_CASE("Packet rejects truncated byte vectors", "[network]") {
+    Packet source;
+    source << static_cast<u32>(1000) << static_cast<u8>(1);
+
+    Packet packet{source.GetData(), source.GetDataSize()};
+    std::vector<u8> payload;
+    packet >> payload;
+    REQUIRE_FALSE(packet);
+    REQUIRE(payload.empty());
+}
+
+} // namespace Network
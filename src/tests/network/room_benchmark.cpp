@@ -0,0 +1,256 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+// Measures the WiFi packet relay of a Room. A number of RoomMember clients join a room over
+// loopback and send packets to each other at a fixed rate, a share of them being broadcasts. The
+// delivery ratio and the latency from sending to receiving each packet are reported.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <fmt/format.h>
+
+#include "common/common_types.h"
+#include "network/network.h"
+#include "network/room.h"
+#include "network/room_member.h"
+#include "network/verify_user.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr u32 DefaultMembers = 16;
+constexpr u32 DefaultSeconds = 5;
+constexpr u32 DefaultRate = 200;
+constexpr u32 DefaultPayload = 512;
+constexpr u32 DefaultBroadcastPercent = 25;
+constexpr u16 DefaultPort = Network::DefaultRoomPort + 1;
+constexpr u32 TrafficSeed = 0x3D5;
+
+constexpr auto JoinTimeout = std::chrono::seconds{10};
+/// Time given to the packets still in flight after the last one was sent
+constexpr auto DrainTime = std::chrono::seconds{1};
+
+struct Options {
+    u32 members = DefaultMembers;
+    u32 seconds = DefaultSeconds;
+    u32 rate = DefaultRate;
+    u32 payload = DefaultPayload;
+    u32 broadcast_percent = DefaultBroadcastPercent;
+    u16 port = DefaultPort;
+};
+
+/// A room member and the packets it received. Only the thread of the member writes the latencies.
+struct Client {
+    Network::RoomMember member;
+    Network::RoomMember::CallbackHandle<Network::WifiPacket> wifi_handle;
+    std::vector<double> latencies_us;
+    std::atomic<u64> received{};
+};
+
+std::unique_ptr<Client> JoinClient(u32 index, const Options& options) {
+    auto client = std::make_unique<Client>();
+    // Room for most of the traffic, so the callback seldom allocates
+    client->latencies_us.reserve(std::min<std::size_t>(
+        static_cast<std::size_t>(options.rate) * options.members * options.seconds, 1 << 16));
+    client->wifi_handle = client->member.BindOnWifiPacketReceived(
+        [client = client.get()](const Network::WifiPacket& packet) {
+            if (packet.data.size() < sizeof(s64)) {
+                return;
+            }
+            s64 sent_ns;
+            std::memcpy(&sent_ns, packet.data.data(), sizeof(sent_ns));
+            const auto sent = Clock::time_point{std::chrono::nanoseconds{sent_ns}};
+            client->latencies_us.push_back(
+                std::chrono::duration<double, std::micro>(Clock::now() - sent).count());
+            client->received.fetch_add(1, std::memory_order_relaxed);
+        });
+    client->member.Join(fmt::format("bench{:03}", index), fmt::format("{:016X}", index),
+                        "127.0.0.1", options.port);
+    return client;
+}
+
+bool WaitForJoins(const std::vector<std::unique_ptr<Client>>& clients) {
+    const auto deadline = Clock::now() + JoinTimeout;
+    while (Clock::now() < deadline) {
+        const bool all_joined = std::all_of(clients.begin(), clients.end(), [](const auto& client) {
+            return client->member.GetState() == Network::RoomMember::State::Joined;
+        });
+        if (all_joined) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+    return false;
+}
+
+/// Sends packets from every client in turn at the requested rate, returns the expected deliveries
+u64 GenerateTraffic(const std::vector<std::unique_ptr<Client>>& clients, const Options& options) {
+    std::mt19937 rng{TrafficSeed};
+    std::uniform_int_distribution<u32> percent{0, 99};
+    std::uniform_int_distribution<std::size_t> other{0, clients.size() - 2};
+
+    Network::WifiPacket packet{};
+    packet.type = Network::WifiPacket::PacketType::Data;
+    packet.channel = 1;
+    packet.data.resize(std::max<std::size_t>(options.payload, sizeof(s64)));
+
+    const auto interval = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / (static_cast<double>(options.rate) * clients.size())));
+    const auto end = Clock::now() + std::chrono::seconds{options.seconds};
+    auto next_send = Clock::now();
+    u64 expected = 0;
+    for (std::size_t sender = 0; next_send < end; sender = (sender + 1) % clients.size()) {
+        std::this_thread::sleep_until(next_send);
+        next_send += interval;
+
+        packet.transmitter_address = clients[sender]->member.GetMacAddress();
+        if (percent(rng) < options.broadcast_percent) {
+            packet.destination_address = Network::BroadcastMac;
+            expected += clients.size() - 1;
+        } else {
+            // Pick any client but the sender
+            std::size_t destination = other(rng);
+            destination += destination >= sender ? 1 : 0;
+            packet.destination_address = clients[destination]->member.GetMacAddress();
+            expected += 1;
+        }
+        const s64 sent_ns = Clock::now().time_since_epoch().count();
+        std::memcpy(packet.data.data(), &sent_ns, sizeof(sent_ns));
+        clients[sender]->member.SendWifiPacket(packet);
+    }
+    return expected;
+}
+
+void PrintHelp(const char* argv0) {
+    fmt::print("Usage: {} [options]\n"
+               "-m, --members N      Room members sending packets (default {})\n"
+               "-t, --time N         Seconds to send packets for (default {})\n"
+               "-r, --rate N         Packets sent per member and second (default {})\n"
+               "-s, --size N         Payload size of the packets in bytes (default {})\n"
+               "-b, --broadcast N    Percentage of broadcast packets (default {})\n"
+               "-p, --port N         Port of the room (default {})\n"
+               "-h, --help           Display this help and exit\n",
+               argv0, DefaultMembers, DefaultSeconds, DefaultRate, DefaultPayload,
+               DefaultBroadcastPercent, DefaultPort);
+}
+
+std::optional<Options> ParseOptions(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        const std::string_view arg{argv[i]};
+        if (arg == "-h" || arg == "--help") {
+            PrintHelp(argv[0]);
+            std::exit(0);
+        }
+        if (i + 1 >= argc) {
+            fmt::print(stderr, "Missing value for {}\n", arg);
+            return std::nullopt;
+        }
+        const int value = std::atoi(argv[++i]);
+        if (arg == "-m" || arg == "--members") {
+            options.members =
+                std::clamp(value, 2, static_cast<int>(Network::MaxConcurrentConnections));
+        } else if (arg == "-t" || arg == "--time") {
+            options.seconds = std::max(value, 1);
+        } else if (arg == "-r" || arg == "--rate") {
+            options.rate = std::max(value, 1);
+        } else if (arg == "-s" || arg == "--size") {
+            options.payload = std::clamp(value, 0, 65536);
+        } else if (arg == "-b" || arg == "--broadcast") {
+            options.broadcast_percent = std::clamp(value, 0, 100);
+        } else if (arg == "-p" || arg == "--port") {
+            options.port = static_cast<u16>(value);
+        } else {
+            fmt::print(stderr, "Unknown option {}\n", arg);
+            return std::nullopt;
+        }
+    }
+    return options;
+}
+
+} // Anonymous namespace
+
+int main(int argc, char** argv) {
+    const auto options = ParseOptions(argc, argv);
+    if (!options) {
+        PrintHelp(argv[0]);
+        return 1;
+    }
+
+    if (!Network::Init()) {
+        return 1;
+    }
+
+    Network::Room room;
+    if (!room.Create("Relay benchmark", "", "127.0.0.1", options->port, "", options->members, "",
+                     "", 0, std::make_unique<Network::VerifyUser::NullBackend>())) {
+        fmt::print(stderr, "Unable to create a room on port {}\n", options->port);
+        Network::Shutdown();
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<Client>> clients;
+    for (u32 i = 0; i < options->members; i++) {
+        clients.push_back(JoinClient(i, *options));
+    }
+
+    int result = 0;
+    if (WaitForJoins(clients)) {
+        fmt::print("{} members, {} packets/s each of {} bytes, {}% broadcast, {} s\n\n",
+                   options->members, options->rate, options->payload, options->broadcast_percent,
+                   options->seconds);
+
+        const auto start = Clock::now();
+        const u64 expected = GenerateTraffic(clients, *options);
+        const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        std::this_thread::sleep_for(DrainTime);
+
+        // Leaving joins the member threads, so the latencies can be read afterwards
+        for (auto& client : clients) {
+            client->member.Leave();
+        }
+
+        std::vector<double> latencies;
+        u64 received = 0;
+        for (const auto& client : clients) {
+            received += client->received.load();
+            latencies.insert(latencies.end(), client->latencies_us.begin(),
+                             client->latencies_us.end());
+        }
+        std::sort(latencies.begin(), latencies.end());
+        const auto percentile = [&latencies](double p) {
+            if (latencies.empty()) {
+                return 0.0;
+            }
+            const auto index = static_cast<std::size_t>(p * (latencies.size() - 1) + 0.5);
+            return latencies[index];
+        };
+
+        fmt::print("{:>12} {:>12} {:>10} {:>12} {:>10} {:>10} {:>10}\n", "expected", "received",
+                   "delivered", "packets/s", "p50 us", "p99 us", "max us");
+        fmt::print("{:>12} {:>12} {:>9.2f}% {:>12.0f} {:>10.0f} {:>10.0f} {:>10.0f}\n", expected,
+                   received, expected ? 100.0 * received / expected : 0.0, received / elapsed,
+                   percentile(0.5), percentile(0.99), latencies.empty() ? 0.0 : latencies.back());
+    } else {
+        fmt::print(stderr, "Not all members could join the room\n");
+        result = 1;
+    }
+
+    clients.clear();
+    room.Destroy();
+    Network::Shutdown();
+    return result;
+}
@@ -0,0 +1,603 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+// Measures the CPU cost of the shader generators over a corpus of shader configs. The corpus is
+// either loaded from an OpenGL transferable shader cache or synthesized from a fixed seed, so runs
+// are comparable between builds.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fmt/format.h>
+#include <nihstro/inline_assembly.h>
+
+#include "common/common_types.h"
+#include "common/file_util.h"
+#include "video_core/pica/regs_internal.h"
+#include "video_core/pica/shader_setup.h"
+#include "video_core/shader/generator/glsl_fs_shader_gen.h"
+#include "video_core/shader/generator/glsl_shader_gen.h"
+#include "video_core/shader/generator/pica_fs_config.h"
+#include "video_core/shader/generator/profile.h"
+#include "video_core/shader/generator/shader_gen.h"
+#ifdef ENABLE_OPENGL
+#include "video_core/renderer_opengl/gl_shader_disk_cache.h"
+#endif
+#ifdef ENABLE_VULKAN
+#include "video_core/renderer_vulkan/vk_shader_util.h"
+#include "video_core/shader/generator/spv_fs_shader_gen.h"
+#include "video_core/shader/generator/spv_shader_gen.h"
+#endif
+
+namespace {
+
+using Pica::Shader::FSConfig;
+using Pica::Shader::Profile;
+using Pica::Shader::Generator::PicaVSConfig;
+
+using DestRegister = nihstro::DestRegister;
+using OpCode = nihstro::OpCode;
+using SourceRegister = nihstro::SourceRegister;
+using Type = nihstro::InlineAsm::Type;
+
+using Clock = std::chrono::steady_clock;
+
+constexpr u32 DefaultIterations = 10;
+constexpr u32 DefaultSynthesizedConfigs = 500;
+constexpr u32 CorpusSeed = 0x3D5;
+
+struct VertexShaderEntry {
+    std::shared_ptr<Pica::ShaderSetup> setup;
+    PicaVSConfig config;
+};
+
+struct Corpus {
+    std::vector<FSConfig> fragment_configs;
+    std::vector<VertexShaderEntry> vertex_shaders;
+};
+
+struct Options {
+    u32 iterations = DefaultIterations;
+    u32 synthesized_configs = DefaultSynthesizedConfigs;
+    bool glslang = false;
+    std::string cache_path;
+    std::string csv_path;
+};
+
+/// Profile of a desktop Vulkan device, the configuration most users run the generators with
+Profile MakeProfile() {
+    Profile profile{};
+    profile.has_separable_shaders = true;
+    profile.has_clip_planes = true;
+    profile.has_geometry_shader = true;
+    profile.has_custom_border_color = true;
+    profile.has_logic_op = true;
+    profile.is_vulkan = true;
+    return profile;
+}
+
+std::shared_ptr<Pica::ShaderSetup> CompileShaderSetup(
+    std::initializer_list<nihstro::InlineAsm> code) {
+    const auto shbin = nihstro::InlineAsm::CompileToRawBinary(code);
+
+    auto setup = std::make_shared<Pica::ShaderSetup>();
+    std::transform(shbin.program.begin(), shbin.program.end(), setup->program_code.begin(),
+                   [](const auto& x) { return x.hex; });
+    std::transform(shbin.swizzle_table.begin(), shbin.swizzle_table.end(),
+                   setup->swizzle_data.begin(), [](const auto& x) { return x.hex; });
+    return setup;
+}
+
+/// Vertex programs covering the instruction mix of typical titles
+std::vector<std::shared_ptr<Pica::ShaderSetup>> MakeVertexPrograms() {
+    const auto v0 = SourceRegister::MakeInput(0);
+    const auto v1 = SourceRegister::MakeInput(1);
+    const auto v2 = SourceRegister::MakeInput(2);
+    const auto v3 = SourceRegister::MakeInput(3);
+    const auto c0 = SourceRegister::MakeFloat(0);
+    const auto c1 = SourceRegister::MakeFloat(1);
+    const auto c2 = SourceRegister::MakeFloat(2);
+    const auto c3 = SourceRegister::MakeFloat(3);
+    const auto c8 = SourceRegister::MakeFloat(8);
+    const auto c9 = SourceRegister::MakeFloat(9);
+    const auto c16 = SourceRegister::MakeFloat(16);
+    const auto r0 = SourceRegister::MakeTemporary(0);
+    const auto r1 = SourceRegister::MakeTemporary(1);
+    const auto r2 = SourceRegister::MakeTemporary(2);
+    const auto r3 = SourceRegister::MakeTemporary(3);
+    const auto o0 = DestRegister::MakeOutput(0);
+    const auto o1 = DestRegister::MakeOutput(1);
+    const auto o2 = DestRegister::MakeOutput(2);
+
+    std::vector<std::shared_ptr<Pica::ShaderSetup>> programs;
+
+    // Passthrough
+    programs.push_back(CompileShaderSetup({
+        {OpCode::Id::MOV, o0, v0},
+        {OpCode::Id::MOV, o1, v1},
+        {OpCode::Id::MOV, o2, v2},
+        {OpCode::Id::END},
+    }));
+
+    // Position transform
+    programs.push_back(CompileShaderSetup({
+        {OpCode::Id::DP4, r0, v0, c0},
+        {OpCode::Id::DP4, r1, v0, c1},
+        {OpCode::Id::DP4, r2, v0, c2},
+        {OpCode::Id::DP4, r3, v0, c3},
+        {OpCode::Id::ADD, r0, r0, r1},
+        {OpCode::Id::MUL, r1, r2, r3},
+        {OpCode::Id::MOV, o0, r0},
+        {OpCode::Id::MOV, o1, v1},
+        {OpCode::Id::MOV, o2, v2},
+        {OpCode::Id::END},
+    }));
+
+    // Per vertex lighting
+    programs.push_back(CompileShaderSetup({
+        {OpCode::Id::DP3, r0, v3, v3},
+        {OpCode::Id::RSQ, r1, r0},
+        {OpCode::Id::MUL, r2, v3, r1},
+        {OpCode::Id::DP3, r3, r2, c8},
+        {OpCode::Id::MAX, r3, r3, c9},
+        {OpCode::Id::LG2, r1, r3},
+        {OpCode::Id::MUL, r1, r1, c9},
+        {OpCode::Id::EX2, r1, r1},
+        {OpCode::Id::ADD, r2, r3, r1},
+        {OpCode::Id::MIN, r2, r2, c8},
+        {OpCode::Id::DP4, r0, v0, c0},
+        {OpCode::Id::SGE, r3, r0, c9},
+        {OpCode::Id::SLT, r1, r0, c9},
+        {OpCode::Id::FLR, r3, r3},
+        {OpCode::Id::RCP, r1, r1},
+        {OpCode::Id::MOV, o0, r0},
+        {OpCode::Id::MOV, o1, r2},
+        {OpCode::Id::MOV, o2, v2},
+        {OpCode::Id::END},
+    }));
+
+    // Skinning through the address register
+    programs.push_back(CompileShaderSetup({
+        {OpCode::Id::MOVA, DestRegister{}, "x", v3, "x", SourceRegister{}, "",
+         nihstro::InlineAsm::RelativeAddress::A1},
+        {OpCode::Id::MOV, r0, "xyzw", c16, "xyzw", SourceRegister{}, "",
+         nihstro::InlineAsm::RelativeAddress::A1},
+        {OpCode::Id::DP4, r1, v0, r0},
+        {OpCode::Id::MUL, r2, r1, c1},
+        {OpCode::Id::ADD, r2, r2, c2},
+        {OpCode::Id::MOV, o0, r2},
+        {OpCode::Id::MOV, o1, v1},
+        {OpCode::Id::MOV, o2, v2},
+        {OpCode::Id::END},
+    }));
+
+    // Nested loops
+    programs.push_back(CompileShaderSetup({
+        // clang-format off
+        {OpCode::Id::MOV, r0, v0},
+        {OpCode::Id::LOOP, 0},
+            {OpCode::Id::ADD, r0, r0, v1},
+            {OpCode::Id::LOOP, 1},
+                {OpCode::Id::MUL, r1, r0, c3},
+                {OpCode::Id::ADD, r0, r0, r1},
+            {Type::EndLoop},
+        {Type::EndLoop},
+        {OpCode::Id::MOV, o0, r0},
+        {OpCode::Id::MOV, o1, v1},
+        {OpCode::Id::MOV, o2, v2},
+        {OpCode::Id::END},
+        // clang-format on
+    }));
+
+    return programs;
+}
+
+u32 MakeOutputMap(u32 x, u32 y, u32 z, u32 w) {
+    return x | (y << 8) | (z << 16) | (w << 24);
+}
+
+/// Synthesizes fragment configs by randomizing the registers the fragment shaders depend on
+std::vector<FSConfig> SynthesizeFragmentConfigs(u32 count, const Profile& profile) {
+    using TevStageConfig = Pica::TexturingRegs::TevStageConfig;
+    using Source = TevStageConfig::Source;
+    using ColorModifier = TevStageConfig::ColorModifier;
+    using LightingRegs = Pica::LightingRegs;
+
+    constexpr std::array sources{
+        Source::PrimaryColor,   Source::PrimaryFragmentColor, Source::SecondaryFragmentColor,
+        Source::Texture0,       Source::Texture1,             Source::Texture2,
+        Source::PreviousBuffer, Source::Constant,             Source::Previous,
+    };
+    constexpr std::array color_modifiers{
+        ColorModifier::SourceColor,        ColorModifier::OneMinusSourceColor,
+        ColorModifier::SourceAlpha,        ColorModifier::OneMinusSourceAlpha,
+        ColorModifier::SourceRed,          ColorModifier::OneMinusSourceRed,
+        ColorModifier::SourceGreen,        ColorModifier::OneMinusSourceGreen,
+        ColorModifier::SourceBlue,         ColorModifier::OneMinusSourceBlue,
+    };
+    constexpr std::array fog_modes{
+        Pica::TexturingRegs::FogMode::None,
+        Pica::TexturingRegs::FogMode::Fog,
+        Pica::TexturingRegs::FogMode::Gas,
+    };
+    constexpr std::array lighting_configs{
+        LightingRegs::LightingConfig::Config0, LightingRegs::LightingConfig::Config1,
+        LightingRegs::LightingConfig::Config2, LightingRegs::LightingConfig::Config3,
+        LightingRegs::LightingConfig::Config4, LightingRegs::LightingConfig::Config5,
+        LightingRegs::LightingConfig::Config6, LightingRegs::LightingConfig::Config7,
+    };
+
+    std::mt19937 rng{CorpusSeed};
+    const auto random = [&rng](u32 max) {
+        return std::uniform_int_distribution<u32>{0, max}(rng);
+    };
+    const auto pick = [&random](const auto& values) {
+        return values[random(static_cast<u32>(values.size() - 1))];
+    };
+
+    std::vector<FSConfig> configs;
+    configs.reserve(count);
+    for (u32 i = 0; i < count; i++) {
+        auto regs = std::make_unique<Pica::RegsInternal>();
+        auto& texturing = regs->texturing;
+
+        const std::array stages{&texturing.tev_stage0, &texturing.tev_stage1,
+                                &texturing.tev_stage2, &texturing.tev_stage3,
+                                &texturing.tev_stage4, &texturing.tev_stage5};
+        const u32 num_stages = random(static_cast<u32>(stages.size()));
+        for (u32 stage_index = 0; stage_index < num_stages; stage_index++) {
+            TevStageConfig& stage = *stages[stage_index];
+            stage.color_source1.Assign(pick(sources));
+            stage.color_source2.Assign(pick(sources));
+            stage.color_source3.Assign(pick(sources));
+            stage.alpha_source1.Assign(pick(sources));
+            stage.alpha_source2.Assign(pick(sources));
+            stage.alpha_source3.Assign(pick(sources));
+            stage.color_modifier1.Assign(pick(color_modifiers));
+            stage.color_modifier2.Assign(pick(color_modifiers));
+            stage.color_modifier3.Assign(pick(color_modifiers));
+            stage.alpha_modifier1.Assign(static_cast<TevStageConfig::AlphaModifier>(random(7)));
+            stage.alpha_modifier2.Assign(static_cast<TevStageConfig::AlphaModifier>(random(7)));
+            stage.alpha_modifier3.Assign(static_cast<TevStageConfig::AlphaModifier>(random(7)));
+            stage.color_op.Assign(static_cast<TevStageConfig::Operation>(random(9)));
+            stage.alpha_op.Assign(static_cast<TevStageConfig::Operation>(random(9)));
+            stage.color_scale.Assign(random(2));
+            stage.alpha_scale.Assign(random(2));
+        }
+        texturing.tev_combiner_buffer_input.update_mask_rgb.Assign(random(0xF));
+        texturing.tev_combiner_buffer_input.update_mask_a.Assign(random(0xF));
+        texturing.fog_mode.Assign(pick(fog_modes));
+        texturing.texture0.type.Assign(
+            static_cast<Pica::TexturingRegs::TextureConfig::TextureType>(random(5)));
+
+        auto& output_merger = regs->framebuffer.output_merger;
+        output_merger.alpha_test.enable.Assign(random(1));
+        output_merger.alpha_test.func.Assign(
+            static_cast<Pica::FramebufferRegs::CompareFunc>(random(7)));
+
+        auto& lighting = regs->lighting;
+        lighting.disable.Assign(random(1));
+        lighting.max_light_index.Assign(random(7));
+        lighting.config0.config.Assign(pick(lighting_configs));
+        lighting.config0.enable_primary_alpha.Assign(random(1));
+        lighting.config0.enable_secondary_alpha.Assign(random(1));
+        lighting.config0.clamp_highlights.Assign(random(1));
+        lighting.config1.raw = static_cast<u32>(rng());
+        lighting.lut_input.d0.Assign(static_cast<LightingRegs::LightingLutInput>(random(5)));
+        lighting.lut_input.d1.Assign(static_cast<LightingRegs::LightingLutInput>(random(5)));
+        lighting.lut_input.fr.Assign(static_cast<LightingRegs::LightingLutInput>(random(5)));
+
+        configs.emplace_back(*regs, Pica::Shader::UserConfig{}, profile);
+    }
+    return configs;
+}
+
+/// Pairs every vertex program with the output layouts and options the pipeline caches vary
+std::vector<VertexShaderEntry> SynthesizeVertexShaders() {
+    using Semantic = Pica::RasterizerRegs::VSOutputAttributes::Semantic;
+
+    std::vector<VertexShaderEntry> shaders;
+    for (const auto& setup : MakeVertexPrograms()) {
+        for (u32 variant = 0; variant < 8; variant++) {
+            const bool use_clip_planes = (variant & 1) != 0;
+            const bool use_geometry_shader = (variant & 2) != 0;
+            const bool accurate_mul = (variant & 4) != 0;
+
+            auto regs = std::make_unique<Pica::RegsInternal>();
+            regs->vs.output_mask.Assign(0x7);
+            regs->rasterizer.vs_output_total.Assign(3);
+            regs->rasterizer.vs_output_attributes[0].raw = MakeOutputMap(
+                Semantic::POSITION_X, Semantic::POSITION_Y, Semantic::POSITION_Z,
+                Semantic::POSITION_W);
+            regs->rasterizer.vs_output_attributes[1].raw = MakeOutputMap(
+                Semantic::COLOR_R, Semantic::COLOR_G, Semantic::COLOR_B, Semantic::COLOR_A);
+            regs->rasterizer.vs_output_attributes[2].raw =
+                MakeOutputMap(Semantic::TEXCOORD0_U, Semantic::TEXCOORD0_V, Semantic::INVALID,
+                              Semantic::INVALID);
+
+            shaders.push_back(
+                {setup, PicaVSConfig{*regs, *setup, use_clip_planes, use_geometry_shader,
+                                     accurate_mul}});
+        }
+    }
+    return shaders;
+}
+
+#ifdef ENABLE_OPENGL
+std::optional<Corpus> LoadCorpus(const std::string& path, const Profile& profile) {
+    FileUtil::IOFile file{path, "rb"};
+    if (!file.IsOpen()) {
+        fmt::print(stderr, "Unable to open {}\n", path);
+        return std::nullopt;
+    }
+    const auto raws = OpenGL::ShaderDiskCache::ReadTransferableFile(file);
+    if (!raws) {
+        fmt::print(stderr, "{} is not a valid transferable shader cache\n", path);
+        return std::nullopt;
+    }
+
+    Corpus corpus;
+    for (const OpenGL::ShaderDiskCacheRaw& raw : *raws) {
+        const Pica::RegsInternal& regs = raw.GetRawShaderConfig();
+        switch (raw.GetProgramType()) {
+        case Pica::Shader::Generator::ProgramType::FS:
+            corpus.fragment_configs.emplace_back(regs, Pica::Shader::UserConfig{}, profile);
+            break;
+        case Pica::Shader::Generator::ProgramType::VS: {
+            const auto& code = raw.GetProgramCode();
+            if (code.size() < Pica::MAX_PROGRAM_CODE_LENGTH + Pica::MAX_SWIZZLE_DATA_LENGTH) {
+                continue;
+            }
+            auto setup = std::make_shared<Pica::ShaderSetup>();
+            std::copy_n(code.begin(), Pica::MAX_PROGRAM_CODE_LENGTH, setup->program_code.begin());
+            std::copy_n(code.begin() + Pica::MAX_PROGRAM_CODE_LENGTH,
+                        Pica::MAX_SWIZZLE_DATA_LENGTH, setup->swizzle_data.begin());
+            const bool use_geometry_shader = !regs.lighting.disable;
+            corpus.vertex_shaders.push_back(
+                {setup, PicaVSConfig{regs, *setup, true, use_geometry_shader, false}});
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    return corpus;
+}
+#endif
+
+/// Collects the time spent on each config of the corpus by one stage of the pipeline
+class StageTimings {
+public:
+    explicit StageTimings(std::string name_) : name{std::move(name_)} {}
+
+    /**
+     * Runs func for every config of the corpus and keeps the median of the iterations.
+     * @param func Returns false when the generator failed on the config.
+     */
+    void Measure(std::size_t num_configs, u32 iterations,
+                 const std::function<bool(std::size_t)>& func) {
+        std::vector<double> runs(iterations);
+        config_usecs.reserve(num_configs);
+        for (std::size_t config = 0; config < num_configs; config++) {
+            bool success = true;
+            for (u32 i = 0; i < iterations; i++) {
+                const auto start = Clock::now();
+                success &= func(config);
+                const auto end = Clock::now();
+                runs[i] = std::chrono::duration<double, std::micro>(end - start).count();
+            }
+            std::nth_element(runs.begin(), runs.begin() + iterations / 2, runs.end());
+            config_usecs.push_back(runs[iterations / 2]);
+            failures += success ? 0 : 1;
+        }
+    }
+
+    void PrintSummary() const {
+        if (config_usecs.empty()) {
+            return;
+        }
+        std::vector<double> sorted = config_usecs;
+        std::sort(sorted.begin(), sorted.end());
+        const auto percentile = [&sorted](double p) {
+            const auto index = static_cast<std::size_t>(p * (sorted.size() - 1) + 0.5);
+            return sorted[index];
+        };
+        double total{};
+        for (const double usec : sorted) {
+            total += usec;
+        }
+        fmt::print("{:<24} {:>7} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f} {:>7}\n", name,
+                   sorted.size(), total / 1000.0, percentile(0.5), percentile(0.9),
+                   percentile(0.99), sorted.back(), failures);
+    }
+
+    void WriteCsv(std::FILE* file) const {
+        for (std::size_t config = 0; config < config_usecs.size(); config++) {
+            fmt::print(file, "{},{},{:.3f}\n", name, config, config_usecs[config]);
+        }
+    }
+
+private:
+    std::string name;
+    std::vector<double> config_usecs;
+    u32 failures{};
+};
+
+std::vector<StageTimings> RunBenchmarks(const Corpus& corpus, const Profile& profile,
+                                        const Options& options) {
+    namespace Generator = Pica::Shader::Generator;
+    const auto& fs_configs = corpus.fragment_configs;
+    const auto& vs_entries = corpus.vertex_shaders;
+    const u32 iterations = options.iterations;
+    std::vector<StageTimings> stages;
+
+    stages.emplace_back("GLSL fragment");
+    stages.back().Measure(fs_configs.size(), iterations, [&](std::size_t i) {
+        return !Generator::GLSL::GenerateFragmentShader(fs_configs[i], profile).empty();
+    });
+
+    stages.emplace_back("GLSL vertex");
+    stages.back().Measure(vs_entries.size(), iterations, [&](std::size_t i) {
+        const auto& entry = vs_entries[i];
+        return !Generator::GLSL::GenerateVertexShader(*entry.setup, entry.config, true).empty();
+    });
+
+#ifdef ENABLE_VULKAN
+    stages.emplace_back("SPIR-V fragment");
+    stages.back().Measure(fs_configs.size(), iterations, [&](std::size_t i) {
+        if (fs_configs[i].UsesSpirvIncompatibleConfig()) {
+            return true;
+        }
+        return !Generator::SPIRV::GenerateFragmentShader(fs_configs[i], profile).empty();
+    });
+
+    stages.emplace_back("SPIR-V vertex");
+    stages.back().Measure(vs_entries.size(), iterations, [&](std::size_t i) {
+        const auto& entry = vs_entries[i];
+        return !Generator::SPIRV::GenerateVertexShader(*entry.setup, entry.config).empty();
+    });
+
+    if (options.glslang) {
+        // Generate the sources up front so only the compilation is measured
+        std::vector<std::string> fs_sources;
+        for (const auto& config : fs_configs) {
+            fs_sources.push_back(Generator::GLSL::GenerateFragmentShader(config, profile));
+        }
+        std::vector<std::string> vs_sources;
+        for (const auto& entry : vs_entries) {
+            vs_sources.push_back(
+                Generator::GLSL::GenerateVertexShader(*entry.setup, entry.config, true));
+        }
+
+        stages.emplace_back("glslang fragment");
+        stages.back().Measure(fs_sources.size(), iterations, [&](std::size_t i) {
+            return !Vulkan::CompileToSPV(fs_sources[i], vk::ShaderStageFlagBits::eFragment)
+                        .empty();
+        });
+
+        stages.emplace_back("glslang vertex");
+        stages.back().Measure(vs_sources.size(), iterations, [&](std::size_t i) {
+            return !vs_sources[i].empty() &&
+                   !Vulkan::CompileToSPV(vs_sources[i], vk::ShaderStageFlagBits::eVertex).empty();
+        });
+    }
+#endif
+
+    return stages;
+}
+
+void PrintHelp(const char* argv0) {
+    fmt::print("Usage: {} [options] [transferable shader cache]\n"
+               "-n, --iterations N   Generations of each config, the median is kept (default {})\n"
+               "-s, --synthesize N   Fragment configs to synthesize without a cache (default {})\n"
+               "-g, --glslang        Also measure the glslang compilation of the GLSL output\n"
+               "-c, --csv PATH       Write the timings of every config to a CSV file\n"
+               "-h, --help           Display this help and exit\n",
+               argv0, DefaultIterations, DefaultSynthesizedConfigs);
+}
+
+std::optional<Options> ParseOptions(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        const std::string_view arg{argv[i]};
+        const auto next_value = [&]() -> std::optional<std::string_view> {
+            if (i + 1 >= argc) {
+                fmt::print(stderr, "Missing value for {}\n", arg);
+                return std::nullopt;
+            }
+            return std::string_view{argv[++i]};
+        };
+
+        if (arg == "-h" || arg == "--help") {
+            PrintHelp(argv[0]);
+            std::exit(0);
+        } else if (arg == "-g" || arg == "--glslang") {
+            options.glslang = true;
+        } else if (arg == "-n" || arg == "--iterations") {
+            const auto value = next_value();
+            if (!value) {
+                return std::nullopt;
+            }
+            options.iterations = std::max(std::atoi(value->data()), 1);
+        } else if (arg == "-s" || arg == "--synthesize") {
+            const auto value = next_value();
+            if (!value) {
+                return std::nullopt;
+            }
+            options.synthesized_configs = std::max(std::atoi(value->data()), 0);
+        } else if (arg == "-c" || arg == "--csv") {
+            const auto value = next_value();
+            if (!value) {
+                return std::nullopt;
+            }
+            options.csv_path = *value;
+        } else if (!arg.starts_with('-') && options.cache_path.empty()) {
+            options.cache_path = arg;
+        } else {
+            fmt::print(stderr, "Unknown option {}\n", arg);
+            return std::nullopt;
+        }
+    }
+    return options;
+}
+
+} // Anonymous namespace
+
+int main(int argc, char** argv) {
+    const auto options = ParseOptions(argc, argv);
+    if (!options) {
+        PrintHelp(argv[0]);
+        return 1;
+    }
+
+    const Profile profile = MakeProfile();
+    Corpus corpus;
+    if (!options->cache_path.empty()) {
+#ifdef ENABLE_OPENGL
+        auto loaded = LoadCorpus(options->cache_path, profile);
+        if (!loaded) {
+            return 1;
+        }
+        corpus = std::move(*loaded);
+#else
+        fmt::print(stderr, "Loading shader caches requires a build with the OpenGL renderer\n");
+        return 1;
+#endif
+    } else {
+        corpus.fragment_configs = SynthesizeFragmentConfigs(options->synthesized_configs, profile);
+        corpus.vertex_shaders = SynthesizeVertexShaders();
+    }
+
+    fmt::print("Corpus: {} fragment configs, {} vertex shaders, {} iterations per config\n\n",
+               corpus.fragment_configs.size(), corpus.vertex_shaders.size(), options->iterations);
+    fmt::print("{:<24} {:>7} {:>10} {:>10} {:>10} {:>10} {:>10} {:>7}\n", "stage", "configs",
+               "total ms", "p50 us", "p90 us", "p99 us", "max us", "failed");
+
+    const auto stages = RunBenchmarks(corpus, profile, *options);
+    for (const auto& stage : stages) {
+        stage.PrintSummary();
+    }
+
+    if (!options->csv_path.empty()) {
+        std::FILE* file = std::fopen(options->csv_path.c_str(), "w");
+        if (!file) {
+            fmt::print(stderr, "Unable to open {} for writing\n", options->csv_path);
+            return 1;
+        }
+        fmt::print(file, "stage,config,usec\n");
+        for (const auto& stage : stages) {
+            stage.WriteCsv(file);
+        }
+        std::fclose(file);
+    }
+    return 0;
+}
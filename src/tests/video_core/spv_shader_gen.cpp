@@ -0,0 +1,205 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#ifdef ENABLE_VULKAN
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <nihstro/inline_assembly.h>
+#include <spirv-tools/libspirv.hpp>
+#include "video_core/pica/regs_internal.h"
+#include "video_core/pica/shader_setup.h"
+#include "video_core/shader/generator/shader_gen.h"
+#include "video_core/shader/generator/spv_shader_gen.h"
+
+using DestRegister = nihstro::DestRegister;
+using OpCode = nihstro::OpCode;
+using SourceRegister = nihstro::SourceRegister;
+using FlowOp = nihstro::Instruction::FlowControlType::Op;
+
+using Pica::Shader::Generator::PicaFixedGSConfig;
+using Pica::Shader::Generator::PicaVSConfig;
+
+namespace {
+
+std::unique_ptr<Pica::ShaderSetup> CompileShaderSetup(
+    std::initializer_list<nihstro::InlineAsm> code) {
+    const auto shbin = nihstro::InlineAsm::CompileToRawBinary(code);
+
+    auto shader = std::make_unique<Pica::ShaderSetup>();
+    std::transform(shbin.program.begin(), shbin.program.end(), shader->program_code.begin(),
+                   [](const auto& x) { return x.hex; });
+    std::transform(shbin.swizzle_table.begin(), shbin.swizzle_table.end(),
+                   shader->swizzle_data.begin(), [](const auto& x) { return x.hex; });
+    return shader;
+}
+
+// nihstro does not support the flow control instructions, so they are encoded by hand and
+// patched over NOP placeholders.
+u32 FlowControl(OpCode::Id opcode, u32 dest_offset, u32 num_instructions) {
+    nihstro::Instruction instr = {};
+    instr.opcode = nihstro::OpCode(opcode);
+    instr.flow_control.dest_offset = dest_offset;
+    instr.flow_control.num_instructions = num_instructions;
+    return instr.hex;
+}
+
+u32 Condition(OpCode::Id opcode, u32 dest_offset, u32 num_instructions, FlowOp op) {
+    nihstro::Instruction instr;
+    instr.hex = FlowControl(opcode, dest_offset, num_instructions);
+    instr.flow_control.op = op;
+    instr.flow_control.refx = 1;
+    instr.flow_control.refy = 0;
+    return instr.hex;
+}
+
+u32 UniformFlowControl(OpCode::Id opcode, u32 dest_offset, u32 num_instructions, u32 uniform) {
+    nihstro::Instruction instr;
+    instr.hex = FlowControl(opcode, dest_offset, num_instructions);
+    instr.flow_control.bool_uniform_id = uniform;
+    return instr.hex;
+}
+
+u32 Loop(u32 last_instruction, u32 int_uniform) {
+    nihstro::Instruction instr;
+    instr.hex = FlowControl(OpCode::Id::LOOP, last_instruction, 0);
+    instr.flow_control.int_uniform_id = int_uniform;
+    return instr.hex;
+}
+
+u32 MakeOutputMap(u32 x, u32 y, u32 z, u32 w) {
+    return x | (y << 8) | (z << 16) | (w << 24);
+}
+
+/// Registers with a position and color output, as most titles configure them
+std::unique_ptr<Pica::RegsInternal> MakeRegs() {
+    using Semantic = Pica::RasterizerRegs::VSOutputAttributes::Semantic;
+
+    auto regs = std::make_unique<Pica::RegsInternal>();
+    regs->vs.output_mask.Assign(0x3);
+    regs->rasterizer.vs_output_total.Assign(2);
+    regs->rasterizer.vs_output_attributes[0].raw = MakeOutputMap(
+        Semantic::POSITION_X, Semantic::POSITION_Y, Semantic::POSITION_Z, Semantic::POSITION_W);
+    regs->rasterizer.vs_output_attributes[1].raw =
+        MakeOutputMap(Semantic::COLOR_R, Semantic::COLOR_G, Semantic::COLOR_B, Semantic::COLOR_A);
+    return regs;
+}
+
+void RequireValidSpirv(const std::vector<u32>& code) {
+    REQUIRE(!code.empty());
+
+    std::string messages;
+    spvtools::SpirvTools tools{SPV_ENV_VULKAN_1_1};
+    tools.SetMessageConsumer([&messages](spv_message_level_t, const char*, const spv_position_t&,
+                                         const char* message) {
+        messages += message;
+        messages += '\n';
+    });
+    const bool valid = tools.Validate(code);
+    INFO(messages);
+    REQUIRE(valid);
+}
+
+void RequireValidVertexShader(Pica::ShaderSetup& setup) {
+    const auto regs = MakeRegs();
+    for (u32 variant = 0; variant < 8; variant++) {
+        const bool use_clip_planes = (variant & 1) != 0;
+        const bool use_geometry_shader = (variant & 2) != 0;
+        const bool accurate_mul = (variant & 4) != 0;
+        const PicaVSConfig config{*regs, setup, use_clip_planes, use_geometry_shader,
+                                  accurate_mul};
+        RequireValidSpirv(Pica::Shader::Generator::SPIRV::GenerateVertexShader(setup, config));
+    }
+}
+
+const auto v0 = SourceRegister::MakeInput(0);
+const auto v1 = SourceRegister::MakeInput(1);
+const auto c0 = SourceRegister::MakeFloat(0);
+const auto c1 = SourceRegister::MakeFloat(1);
+const auto c2 = SourceRegister::MakeFloat(2);
+const auto r0 = SourceRegister::MakeTemporary(0);
+const auto r1 = SourceRegister::MakeTemporary(1);
+const auto o0 = DestRegister::MakeOutput(0);
+const auto o1 = DestRegister::MakeOutput(1);
+
+} // Anonymous namespace
+
+TEST_CASE("SPIR-V vertex shader with JMP labels", "[video_core][shader]") {
+    auto setup = CompileShaderSetup({
+        {OpCode::Id::MOV, r0, v0},     // 0
+        {OpCode::Id::NOP},             // 1: jmpc x, 4
+        {OpCode::Id::ADD, r0, r0, v1}, // 2
+        {OpCode::Id::NOP},             // 3: jmpu b0, 6
+        {OpCode::Id::MUL, r0, r0, v1}, // 4
+        {OpCode::Id::NOP},             // 5: jmpc x || y, 7
+        {OpCode::Id::ADD, r0, r0, c0}, // 6
+        {OpCode::Id::MOV, o0, r0},     // 7
+        {OpCode::Id::MOV, o1, v1},     // 8
+        {OpCode::Id::END},             // 9
+    });
+    setup->program_code[1] = Condition(OpCode::Id::JMPC, 4, 0, FlowOp::JustX);
+    setup->program_code[3] = UniformFlowControl(OpCode::Id::JMPU, 6, 0, 0);
+    setup->program_code[5] = Condition(OpCode::Id::JMPC, 7, 0, FlowOp::Or);
+
+    RequireValidVertexShader(*setup);
+}
+
+TEST_CASE("SPIR-V vertex shader with nested LOOP, CALL and IF", "[video_core][shader]") {
+    auto setup = CompileShaderSetup({
+        {OpCode::Id::MOV, r0, v0},     // 0
+        {OpCode::Id::NOP},             // 1: loop i0, body 2-10
+        {OpCode::Id::NOP},             // 2: ifu b1, else 4
+        {OpCode::Id::ADD, r0, r0, v1}, // 3
+        {OpCode::Id::MUL, r0, r0, c0}, // 4
+        {OpCode::Id::NOP},             // 5: loop i1, body 6-9
+        {OpCode::Id::NOP},             // 6: callc x && y, 14-15
+        {OpCode::Id::NOP},             // 7: ifc x, else 9
+        {OpCode::Id::ADD, r1, r1, r0}, // 8
+        {OpCode::Id::MUL, r1, r1, c1}, // 9
+        {OpCode::Id::ADD, r0, r0, r1}, // 10
+        {OpCode::Id::MOV, o0, r0},     // 11
+        {OpCode::Id::MOV, o1, r1},     // 12
+        {OpCode::Id::END},             // 13
+        {OpCode::Id::ADD, r0, r0, c1}, // 14
+        {OpCode::Id::MAX, r0, r0, c2}, // 15
+        {OpCode::Id::END},             // 16
+    });
+    setup->program_code[1] = Loop(10, 0);
+    setup->program_code[2] = UniformFlowControl(OpCode::Id::IFU, 4, 1, 1);
+    setup->program_code[5] = Loop(9, 1);
+    setup->program_code[6] = Condition(OpCode::Id::CALLC, 14, 2, FlowOp::And);
+    setup->program_code[7] = Condition(OpCode::Id::IFC, 9, 1, FlowOp::JustX);
+
+    RequireValidVertexShader(*setup);
+}
+
+TEST_CASE("SPIR-V vertex shader with DPH and DPHI", "[video_core][shader]") {
+    auto setup = CompileShaderSetup({
+        {OpCode::Id::DPH, r0, v0, c0}, // 0
+        {OpCode::Id::DPH, r1, c1, v1}, // 1: re-encoded as DPHI
+        {OpCode::Id::ADD, r0, r0, r1}, // 2
+        {OpCode::Id::MOV, o0, r0},     // 3
+        {OpCode::Id::MOV, o1, v1},     // 4
+        {OpCode::Id::END},             // 5
+    });
+    nihstro::Instruction dphi;
+    dphi.hex = setup->program_code[1];
+    dphi.opcode = nihstro::OpCode(OpCode::Id::DPHI);
+    setup->program_code[1] = dphi.hex;
+
+    RequireValidVertexShader(*setup);
+}
+
+TEST_CASE("SPIR-V fixed geometry shader", "[video_core][shader]") {
+    const auto regs = MakeRegs();
+    const bool use_clip_planes = GENERATE(false, true);
+    const PicaFixedGSConfig config{*regs, use_clip_planes};
+    RequireValidSpirv(Pica::Shader::Generator::SPIRV::GenerateFixedGeometryShader(config));
+}
+
+#endif
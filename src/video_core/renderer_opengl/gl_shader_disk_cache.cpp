@@ -145,37 +145,55 @@ std::optional<std::vector<ShaderDiskCacheRaw>> ShaderDiskCache::LoadTransferable
     }
 
     // Version is valid, load the shaders
+    auto raws = ReadTransferableEntries(transferable_file);
+    if (!raws) {
+        LOG_ERROR(Render_OpenGL, "Failed to read transferable file - removing");
+        InvalidateAll();
+        return std::nullopt;
+    }
+    for (const ShaderDiskCacheRaw& entry : *raws) {
+        transferable.emplace(entry.GetUniqueIdentifier(), ShaderDiskCacheRaw{});
+    }
+
+    LOG_INFO(Render_OpenGL, "Found a transferable disk cache with {} entries", raws->size());
+    return raws;
+}
+
+std::optional<std::vector<ShaderDiskCacheRaw>> ShaderDiskCache::ReadTransferableFile(
+    FileUtil::IOFile& file) {
+    u32 version{};
+    if (file.ReadBytes(&version, sizeof(version)) != sizeof(version) || version != NativeVersion) {
+        LOG_ERROR(Render_OpenGL, "Transferable shader cache has an unsupported version");
+        return std::nullopt;
+    }
+    return ReadTransferableEntries(file);
+}
+
+std::optional<std::vector<ShaderDiskCacheRaw>> ShaderDiskCache::ReadTransferableEntries(
+    FileUtil::IOFile& file) {
     std::vector<ShaderDiskCacheRaw> raws;
-    while (transferable_file.Tell() < transferable_file.GetSize()) {
+    while (file.Tell() < file.GetSize()) {
         TransferableEntryKind kind{};
-        if (transferable_file.ReadBytes(&kind, sizeof(u32)) != sizeof(u32)) {
-            LOG_ERROR(Render_OpenGL, "Failed to read transferable file - removing");
-            InvalidateAll();
+        if (file.ReadBytes(&kind, sizeof(u32)) != sizeof(u32)) {
             return std::nullopt;
         }
 
         switch (kind) {
         case TransferableEntryKind::Raw: {
             ShaderDiskCacheRaw entry;
-            if (!entry.Load(transferable_file)) {
-                LOG_ERROR(Render_OpenGL, "Failed to load transferable raw entry - removing");
-                InvalidateAll();
+            if (!entry.Load(file)) {
+                LOG_ERROR(Render_OpenGL, "Failed to load transferable raw entry");
                 return std::nullopt;
             }
-            transferable.emplace(entry.GetUniqueIdentifier(), ShaderDiskCacheRaw{});
             raws.push_back(std::move(entry));
             break;
         }
         default:
-            LOG_ERROR(Render_OpenGL, "Unknown transferable shader cache entry kind={} - removing",
-                      kind);
-            InvalidateAll();
+            LOG_ERROR(Render_OpenGL, "Unknown transferable shader cache entry kind={}", kind);
             return std::nullopt;
         }
     }
-
-    LOG_INFO(Render_OpenGL, "Found a transferable disk cache with {} entries", raws.size());
-    return {std::move(raws)};
+    return raws;
 }
 
 std::pair<std::unordered_map<u64, ShaderDiskCacheDecompiled>, ShaderDumpsMap>
@@ -93,6 +93,11 @@ public:
     /// Loads transferable cache. If file has a old version or on failure, it deletes the file.
     std::optional<std::vector<ShaderDiskCacheRaw>> LoadTransferable();
 
+    /// Reads all entries of a transferable cache file without touching it on failure. Used by
+    /// tools that consume the cache of a title outside of the emulator.
+    static std::optional<std::vector<ShaderDiskCacheRaw>> ReadTransferableFile(
+        FileUtil::IOFile& file);
+
     /// Loads current game's precompiled cache. Invalidates on failure.
     std::pair<ShaderDecompiledMap, ShaderDumpsMap> LoadPrecompiled(bool compressed);
 
@@ -121,6 +126,10 @@ public:
     u64 GetProgramID() const;
 
 private:
+    /// Reads the transferable entries following the version header. Returns empty on failure.
+    static std::optional<std::vector<ShaderDiskCacheRaw>> ReadTransferableEntries(
+        FileUtil::IOFile& file);
+
     /// Loads the transferable cache. Returns empty on failure.
     std::optional<std::pair<ShaderDecompiledMap, ShaderDumpsMap>> LoadPrecompiledFile(
         FileUtil::IOFile& file, bool compressed);
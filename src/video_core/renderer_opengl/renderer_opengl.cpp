@@ -890,6 +890,10 @@ void RendererOpenGL::TryPresent(int timeout_ms, bool is_secondary) {
     glFlush();
 
     glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    if (!is_secondary) {
+        system.frame_limiter.OnPresent();
+    }
 }
 
 void RendererOpenGL::PrepareVideoDumping() {
@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cstring>
 #include "common/color.h"
 #include "core/core.h"
 #include "video_core/gpu.h"
@@ -10,10 +12,61 @@
 
 namespace SwRenderer {
 
+namespace {
+
+/// Side of the square blocks the framebuffer is rotated in
+constexpr u32 ROTATE_TILE_SIZE = 8;
+
+template <Pica::PixelFormat format>
+Common::Vec4<u8> DecodePixel(const u8* pixel) {
+    if constexpr (format == Pica::PixelFormat::RGBA8) {
+        return Common::Color::DecodeRGBA8(pixel);
+    } else if constexpr (format == Pica::PixelFormat::RGB8) {
+        return Common::Color::DecodeRGB8(pixel);
+    } else if constexpr (format == Pica::PixelFormat::RGB565) {
+        return Common::Color::DecodeRGB565(pixel);
+    } else if constexpr (format == Pica::PixelFormat::RGB5A1) {
+        return Common::Color::DecodeRGB5A1(pixel);
+    } else {
+        return Common::Color::DecodeRGBA4(pixel);
+    }
+}
+
+/**
+ * Converts the framebuffer to RGBA8 while rotating it by 90 degrees, as the LCD framebuffers
+ * are stored sideways. The copy is done in square blocks so that both the strided reads and the
+ * strided writes of a block stay within a few cache lines.
+ */
+template <Pica::PixelFormat format>
+void RotateFramebuffer(const u8* source, ScreenInfo& info) {
+    constexpr u32 bpp = Pica::BytesPerPixel(format);
+    const u32 width = info.width;
+    const u32 height = info.height;
+    const u32 source_stride = width * bpp;
+    u8* dest = info.pixels.data();
+
+    for (u32 x0 = 0; x0 < width; x0 += ROTATE_TILE_SIZE) {
+        const u32 x_end = std::min(x0 + ROTATE_TILE_SIZE, width);
+        for (u32 y0 = 0; y0 < height; y0 += ROTATE_TILE_SIZE) {
+            const u32 y_end = std::min(y0 + ROTATE_TILE_SIZE, height);
+            for (u32 x = x0; x < x_end; x++) {
+                const u8* column = source + (width - x) * bpp;
+                u8* row = dest + x * height * 4;
+                for (u32 y = y0; y < y_end; y++) {
+                    const auto color = DecodePixel<format>(column + y * source_stride);
+                    std::memcpy(row + y * 4, color.AsArray(), sizeof(color));
+                }
+            }
+        }
+    }
+}
+
+} // Anonymous namespace
+
 RendererSoftware::RendererSoftware(Core::System& system, Pica::PicaCore& pica_,
                                    Frontend::EmuWindow& window)
     : VideoCore::RendererBase{system, window, nullptr}, memory{system.Memory()}, pica{pica_},
-      rasterizer{memory, pica} {}
+      rasterizer{memory, pica}, screen_workers{3, "SwRenderer screens"} {}
 
 RendererSoftware::~RendererSoftware() = default;
 
@@ -21,6 +74,7 @@ void RendererSoftware::SwapBuffers() {
     system.perf_stats->StartSwap();
     PrepareRenderTarget();
     system.perf_stats->EndSwap();
+    rasterizer.TickFrame();
     EndFrame();
 }
 
@@ -30,8 +84,9 @@ void RendererSoftware::PrepareRenderTarget() {
         const u32 fb_id = i == 2 ? 1 : 0;
 
         const auto color_fill = fb_id == 0 ? regs_lcd.color_fill_top : regs_lcd.color_fill_bottom;
-        LoadFBToScreenInfo(i, color_fill);
+        screen_workers.QueueWork([this, i, color_fill] { LoadFBToScreenInfo(i, color_fill); });
     }
+    screen_workers.WaitForRequests();
 }
 
 void RendererSoftware::LoadFBToScreenInfo(int i, const Pica::ColorFill& color_fill) {
@@ -49,34 +104,29 @@ void RendererSoftware::LoadFBToScreenInfo(int i, const Pica::ColorFill& color_fi
     info.width = pixel_stride;
     info.pixels.resize(info.width * info.height * 4);
 
-    for (u32 y = 0; y < info.height; y++) {
-        for (u32 x = 0; x < info.width; x++) {
-            const u8* pixel = framebuffer_data + (y * pixel_stride + pixel_stride - x) * bpp;
-            Common::Vec4 color = [&] {
-                if (color_fill.is_enabled) {
-                    return Common::Vec4<u8>(color_fill.color_r, color_fill.color_g,
-                                            color_fill.color_b, 255);
-                }
+    if (color_fill.is_enabled) {
+        const auto color = Common::Vec4<u8>(color_fill.color_r, color_fill.color_g,
+                                             color_fill.color_b, 255);
+        u32 value;
+        std::memcpy(&value, color.AsArray(), sizeof(value));
+        u32* dest = reinterpret_cast<u32*>(info.pixels.data());
+        std::fill_n(dest, info.width * info.height, value);
+        return;
+    }
 
-                switch (framebuffer.color_format) {
-                case Pica::PixelFormat::RGBA8:
-                    return Common::Color::DecodeRGBA8(pixel);
-                case Pica::PixelFormat::RGB8:
-                    return Common::Color::DecodeRGB8(pixel);
-                case Pica::PixelFormat::RGB565:
-                    return Common::Color::DecodeRGB565(pixel);
-                case Pica::PixelFormat::RGB5A1:
-                    return Common::Color::DecodeRGB5A1(pixel);
-                case Pica::PixelFormat::RGBA4:
-                    return Common::Color::DecodeRGBA4(pixel);
-                }
-                UNREACHABLE();
-            }();
-            const u32 output_offset = (x * info.height + y) * 4;
-            u8* dest = info.pixels.data() + output_offset;
-            std::memcpy(dest, color.AsArray(), sizeof(color));
-        }
+    switch (framebuffer.color_format) {
+    case Pica::PixelFormat::RGBA8:
+        return RotateFramebuffer<Pica::PixelFormat::RGBA8>(framebuffer_data, info);
+    case Pica::PixelFormat::RGB8:
+        return RotateFramebuffer<Pica::PixelFormat::RGB8>(framebuffer_data, info);
+    case Pica::PixelFormat::RGB565:
+        return RotateFramebuffer<Pica::PixelFormat::RGB565>(framebuffer_data, info);
+    case Pica::PixelFormat::RGB5A1:
+        return RotateFramebuffer<Pica::PixelFormat::RGB5A1>(framebuffer_data, info);
+    case Pica::PixelFormat::RGBA4:
+        return RotateFramebuffer<Pica::PixelFormat::RGBA4>(framebuffer_data, info);
     }
+    UNREACHABLE();
 }
 
 } // namespace SwRenderer
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "common/thread_worker.h"
 #include "video_core/renderer_base.h"
 #include "video_core/renderer_software/sw_rasterizer.h"
 
@@ -45,6 +46,7 @@ private:
     Pica::PicaCore& pica;
     RasterizerSoftware rasterizer;
     std::array<ScreenInfo, 3> screen_infos{};
+    Common::ThreadWorker screen_workers;
 };
 
 } // namespace SwRenderer
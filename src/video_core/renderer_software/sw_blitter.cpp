@@ -2,6 +2,12 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <span>
+#include <thread>
+#include <utility>
 #include "common/alignment.h"
 #include "common/color.h"
 #include "common/vector_math.h"
@@ -13,26 +19,154 @@
 
 namespace SwRenderer {
 
-static Common::Vec4<u8> DecodePixel(Pica::PixelFormat input_format, const u8* src_pixel) {
-    switch (input_format) {
-    case Pica::PixelFormat::RGBA8:
+namespace {
+
+/// Number of output pixels from which a display transfer is split across the worker threads
+constexpr u32 PARALLEL_TRANSFER_PIXELS = 32 * 1024;
+
+/// Size of the block memory fills are replicated with, a multiple of every fill pattern size
+constexpr std::size_t FILL_BLOCK_SIZE = 192;
+
+template <Pica::PixelFormat format>
+Common::Vec4<u8> DecodePixel(const u8* src_pixel) {
+    if constexpr (format == Pica::PixelFormat::RGBA8) {
         return Common::Color::DecodeRGBA8(src_pixel);
-    case Pica::PixelFormat::RGB8:
+    } else if constexpr (format == Pica::PixelFormat::RGB8) {
         return Common::Color::DecodeRGB8(src_pixel);
-    case Pica::PixelFormat::RGB565:
+    } else if constexpr (format == Pica::PixelFormat::RGB565) {
         return Common::Color::DecodeRGB565(src_pixel);
-    case Pica::PixelFormat::RGB5A1:
+    } else if constexpr (format == Pica::PixelFormat::RGB5A1) {
         return Common::Color::DecodeRGB5A1(src_pixel);
-    case Pica::PixelFormat::RGBA4:
+    } else {
         return Common::Color::DecodeRGBA4(src_pixel);
-    default:
-        LOG_ERROR(HW_GPU, "Unknown source framebuffer format {:x}", input_format);
-        return {0, 0, 0, 0};
     }
 }
 
+template <Pica::PixelFormat format>
+void EncodePixel(const Common::Vec4<u8>& color, u8* dst_pixel) {
+    if constexpr (format == Pica::PixelFormat::RGBA8) {
+        Common::Color::EncodeRGBA8(color, dst_pixel);
+    } else if constexpr (format == Pica::PixelFormat::RGB8) {
+        Common::Color::EncodeRGB8(color, dst_pixel);
+    } else if constexpr (format == Pica::PixelFormat::RGB565) {
+        Common::Color::EncodeRGB565(color, dst_pixel);
+    } else if constexpr (format == Pica::PixelFormat::RGB5A1) {
+        Common::Color::EncodeRGB5A1(color, dst_pixel);
+    } else {
+        Common::Color::EncodeRGBA4(color, dst_pixel);
+    }
+}
+
+/// Parameters of a display transfer shared by all the rows being converted
+struct TransferParams {
+    const u8* src_pointer;
+    u8* dst_pointer;
+    u32 input_width;
+    u32 output_width;
+    u32 output_height;
+    u32 horizontal_scale;
+    u32 vertical_scale;
+    Pica::DisplayTransferConfig::ScalingMode scaling;
+    bool input_linear;
+    bool dont_swizzle;
+    bool flip_vertically;
+};
+
+/**
+ * Converts the output rows [y_begin, y_end) of a display transfer. The layout and the formats
+ * are resolved once per row instead of once per pixel, leaving a tight loop the compiler
+ * can unroll for each pair of formats.
+ */
+template <Pica::PixelFormat input_format, Pica::PixelFormat output_format>
+void ConvertRows(const TransferParams& params, u32 y_begin, u32 y_end) {
+    constexpr u32 src_bytes_per_pixel = Pica::BytesPerPixel(input_format);
+    constexpr u32 dst_bytes_per_pixel = Pica::BytesPerPixel(output_format);
+
+    const bool src_tiled = !params.input_linear;
+    const bool dst_tiled = params.input_linear != params.dont_swizzle;
+    const u32 src_stride = params.input_width * src_bytes_per_pixel;
+    const u32 dst_stride = params.output_width * dst_bytes_per_pixel;
+
+    for (u32 y = y_begin; y < y_end; ++y) {
+        // Calculate the row of the input image based on the current output row and the scale
+        const u32 input_y = y << params.vertical_scale;
+        const u32 output_y = params.flip_vertically ? params.output_height - y - 1 : y;
+
+        const u8* src_row = params.src_pointer +
+                            (src_tiled ? (input_y & ~7) : input_y) * src_stride;
+        u8* dst_row = params.dst_pointer + (dst_tiled ? (output_y & ~7) : output_y) * dst_stride;
+
+        for (u32 x = 0; x < params.output_width; ++x) {
+            const u32 input_x = x << params.horizontal_scale;
+            const u8* src_pixel =
+                src_row + (src_tiled ? VideoCore::GetMortonOffset(input_x, input_y,
+                                                                  src_bytes_per_pixel)
+                                     : input_x * src_bytes_per_pixel);
+            u8* dst_pixel =
+                dst_row + (dst_tiled ? VideoCore::GetMortonOffset(x, output_y, dst_bytes_per_pixel)
+                                     : x * dst_bytes_per_pixel);
+
+            Common::Vec4<u8> src_color = DecodePixel<input_format>(src_pixel);
+            if (params.scaling == Pica::DisplayTransferConfig::ScaleX) {
+                const Common::Vec4<u8> pixel =
+                    DecodePixel<input_format>(src_pixel + src_bytes_per_pixel);
+                src_color = ((src_color + pixel) / 2).Cast<u8>();
+            } else if (params.scaling == Pica::DisplayTransferConfig::ScaleXY) {
+                const Common::Vec4<u8> pixel1 =
+                    DecodePixel<input_format>(src_pixel + 1 * src_bytes_per_pixel);
+                const Common::Vec4<u8> pixel2 =
+                    DecodePixel<input_format>(src_pixel + 2 * src_bytes_per_pixel);
+                const Common::Vec4<u8> pixel3 =
+                    DecodePixel<input_format>(src_pixel + 3 * src_bytes_per_pixel);
+                src_color = (((src_color + pixel1) + (pixel2 + pixel3)) / 4).Cast<u8>();
+            }
+
+            EncodePixel<output_format>(src_color, dst_pixel);
+        }
+    }
+}
+
+using ConvertRowsFunc = void (*)(const TransferParams&, u32, u32);
+
+template <Pica::PixelFormat input_format, std::size_t... output_formats>
+constexpr std::array<ConvertRowsFunc, sizeof...(output_formats)> MakeConvertRowsRow(
+    std::index_sequence<output_formats...>) {
+    return {ConvertRows<input_format, static_cast<Pica::PixelFormat>(output_formats)>...};
+}
+
+template <std::size_t... input_formats>
+constexpr auto MakeConvertRowsTable(std::index_sequence<input_formats...>) {
+    return std::array{MakeConvertRowsRow<static_cast<Pica::PixelFormat>(input_formats)>(
+        std::make_index_sequence<sizeof...(input_formats)>{})...};
+}
+
+/// Row conversion kernels indexed by input and output format
+constexpr auto CONVERT_ROWS_TABLE = MakeConvertRowsTable(std::make_index_sequence<5>{});
+
+/**
+ * Fills [dst, dst + size) by repeating pattern. The pattern is first replicated into a block
+ * so that the bulk of the fill is made of large copies instead of one store per element.
+ */
+void FillPattern(u8* dst, std::size_t size, std::span<const u8> pattern) {
+    ASSERT(FILL_BLOCK_SIZE % pattern.size() == 0);
+    std::array<u8, FILL_BLOCK_SIZE> block;
+    for (std::size_t i = 0; i < FILL_BLOCK_SIZE; i += pattern.size()) {
+        std::memcpy(block.data() + i, pattern.data(), pattern.size());
+    }
+
+    std::size_t offset = 0;
+    for (; offset + FILL_BLOCK_SIZE <= size; offset += FILL_BLOCK_SIZE) {
+        std::memcpy(dst + offset, block.data(), FILL_BLOCK_SIZE);
+    }
+    std::memcpy(dst + offset, block.data(), size - offset);
+}
+
+} // Anonymous namespace
+
 SwBlitter::SwBlitter(Memory::MemorySystem& memory_, VideoCore::RasterizerInterface* rasterizer_)
-    : memory{memory_}, rasterizer{rasterizer_} {}
+    : memory{memory_}, rasterizer{rasterizer_},
+      num_workers{std::clamp(std::thread::hardware_concurrency(), 2U, 4U)},
+      workers{num_workers, "SwBlitter workers"} {}
 
 SwBlitter::~SwBlitter() = default;
 
@@ -188,108 +322,38 @@ void SwBlitter::DisplayTransfer(const Pica::DisplayTransferConfig& config) {
     rasterizer->FlushRegion(config.GetPhysicalInputAddress(), input_size);
     rasterizer->InvalidateRegion(config.GetPhysicalOutputAddress(), output_size);
 
-    for (u32 y = 0; y < output_height; ++y) {
-        for (u32 x = 0; x < output_width; ++x) {
-            Common::Vec4<u8> src_color;
-
-            // Calculate the [x,y] position of the input image
-            // based on the current output position and the scale
-            const u32 input_x = x << horizontal_scale;
-            const u32 input_y = y << vertical_scale;
-
-            u32 output_y;
-            if (config.flip_vertically) {
-                // Flip the y value of the output data,
-                // we do this after calculating the [x,y] position of the input image
-                // to account for the scaling options.
-                output_y = output_height - y - 1;
-            } else {
-                output_y = y;
-            }
-
-            const u32 dst_bytes_per_pixel = BytesPerPixel(config.output_format);
-            const u32 src_bytes_per_pixel = BytesPerPixel(config.input_format);
-            u32 src_offset;
-            u32 dst_offset;
-
-            if (config.input_linear) {
-                if (!config.dont_swizzle) {
-                    // Interpret the input as linear and the output as tiled
-                    u32 coarse_y = output_y & ~7;
-                    u32 stride = output_width * dst_bytes_per_pixel;
-
-                    src_offset = (input_x + input_y * config.input_width) * src_bytes_per_pixel;
-                    dst_offset = VideoCore::GetMortonOffset(x, output_y, dst_bytes_per_pixel) +
-                                 coarse_y * stride;
-                } else {
-                    // Both input and output are linear
-                    src_offset = (input_x + input_y * config.input_width) * src_bytes_per_pixel;
-                    dst_offset = (x + output_y * output_width) * dst_bytes_per_pixel;
-                }
-            } else {
-                if (!config.dont_swizzle) {
-                    // Interpret the input as tiled and the output as linear
-                    const u32 coarse_y = input_y & ~7;
-                    const u32 stride = config.input_width * src_bytes_per_pixel;
-
-                    src_offset = VideoCore::GetMortonOffset(input_x, input_y, src_bytes_per_pixel) +
-                                 coarse_y * stride;
-                    dst_offset = (x + output_y * output_width) * dst_bytes_per_pixel;
-                } else {
-                    // Both input and output are tiled
-                    const u32 out_coarse_y = output_y & ~7;
-                    const u32 out_stride = output_width * dst_bytes_per_pixel;
-
-                    const u32 in_coarse_y = input_y & ~7;
-                    const u32 in_stride = config.input_width * src_bytes_per_pixel;
-
-                    src_offset = VideoCore::GetMortonOffset(input_x, input_y, src_bytes_per_pixel) +
-                                 in_coarse_y * in_stride;
-                    dst_offset = VideoCore::GetMortonOffset(x, output_y, dst_bytes_per_pixel) +
-                                 out_coarse_y * out_stride;
-                }
-            }
-
-            const u8* src_pixel = src_pointer + src_offset;
-            src_color = DecodePixel(config.input_format, src_pixel);
-            if (config.scaling == config.ScaleX) {
-                const auto pixel =
-                    DecodePixel(config.input_format, src_pixel + src_bytes_per_pixel);
-                src_color = ((src_color + pixel) / 2).Cast<u8>();
-            } else if (config.scaling == config.ScaleXY) {
-                const auto pixel1 =
-                    DecodePixel(config.input_format, src_pixel + 1 * src_bytes_per_pixel);
-                const auto pixel2 =
-                    DecodePixel(config.input_format, src_pixel + 2 * src_bytes_per_pixel);
-                const auto pixel3 =
-                    DecodePixel(config.input_format, src_pixel + 3 * src_bytes_per_pixel);
-                src_color = (((src_color + pixel1) + (pixel2 + pixel3)) / 4).Cast<u8>();
-            }
+    const TransferParams params = {
+        .src_pointer = src_pointer,
+        .dst_pointer = dst_pointer,
+        .input_width = config.input_width,
+        .output_width = output_width,
+        .output_height = output_height,
+        .horizontal_scale = horizontal_scale,
+        .vertical_scale = vertical_scale,
+        .scaling = config.scaling,
+        .input_linear = config.input_linear != 0,
+        .dont_swizzle = config.dont_swizzle != 0,
+        .flip_vertically = config.flip_vertically != 0,
+    };
+    const auto convert_rows = CONVERT_ROWS_TABLE[static_cast<u32>(config.input_format.Value())]
+                                                [static_cast<u32>(config.output_format.Value())];
+
+    // Transfers that read back their own output depend on the order pixels are written in.
+    const bool overlapping = src_addr < dst_addr + output_size && dst_addr < src_addr + input_size;
+    if (overlapping || output_width * output_height < PARALLEL_TRANSFER_PIXELS) {
+        convert_rows(params, 0, output_height);
+        return;
+    }
 
-            u8* dst_pixel = dst_pointer + dst_offset;
-            switch (config.output_format) {
-            case Pica::PixelFormat::RGBA8:
-                Common::Color::EncodeRGBA8(src_color, dst_pixel);
-                break;
-            case Pica::PixelFormat::RGB8:
-                Common::Color::EncodeRGB8(src_color, dst_pixel);
-                break;
-            case Pica::PixelFormat::RGB565:
-                Common::Color::EncodeRGB565(src_color, dst_pixel);
-                break;
-            case Pica::PixelFormat::RGB5A1:
-                Common::Color::EncodeRGB5A1(src_color, dst_pixel);
-                break;
-            case Pica::PixelFormat::RGBA4:
-                Common::Color::EncodeRGBA4(src_color, dst_pixel);
-                break;
-            default:
-                LOG_ERROR(HW_GPU, "Unknown destination framebuffer format {:x}",
-                          static_cast<u32>(config.output_format.Value()));
-                break;
-            }
-        }
+    // Split the rows in bands of whole tiles so that no tile is shared between two workers.
+    const u32 num_tile_rows = Common::AlignUp(output_height, 8) / 8;
+    const u32 num_bands = std::min<u32>(static_cast<u32>(num_workers), num_tile_rows);
+    const u32 band_height = Common::AlignUp(num_tile_rows, num_bands) / num_bands * 8;
+    for (u32 y = 0; y < output_height; y += band_height) {
+        const u32 y_end = std::min(y + band_height, output_height);
+        workers.QueueWork([convert_rows, &params, y, y_end] { convert_rows(params, y, y_end); });
     }
+    workers.WaitForRequests();
 }
 
 void SwBlitter::MemoryFill(const Pica::MemoryFillConfig& config) {
@@ -318,28 +382,25 @@ void SwBlitter::MemoryFill(const Pica::MemoryFillConfig& config) {
 
     rasterizer->InvalidateRegion(start_addr, end_addr - start_addr);
 
+    // Elements are written as long as they start before the end address, so fills whose size is
+    // not a multiple of the element size write past it just like the hardware loop does.
+    const std::size_t size = end - start;
     if (config.fill_24bit) {
         // Fill with 24-bit values
-        for (u8* ptr = start; ptr < end; ptr += 3) {
-            ptr[0] = config.value_24bit_r;
-            ptr[1] = config.value_24bit_g;
-            ptr[2] = config.value_24bit_b;
-        }
+        const std::array<u8, 3> value = {static_cast<u8>(config.value_24bit_r),
+                                         static_cast<u8>(config.value_24bit_g),
+                                         static_cast<u8>(config.value_24bit_b)};
+        FillPattern(start, Common::AlignUp(size, value.size()), value);
     } else if (config.fill_32bit) {
         // Fill with 32-bit values
-        if (end > start) {
-            const u32 value = config.value_32bit;
-            const std::size_t len = (end - start) / sizeof(u32);
-            for (std::size_t i = 0; i < len; ++i) {
-                std::memcpy(&start[i * sizeof(u32)], &value, sizeof(u32));
-            }
-        }
+        const u32 value = config.value_32bit;
+        FillPattern(start, Common::AlignDown(size, sizeof(u32)),
+                    {reinterpret_cast<const u8*>(&value), sizeof(u32)});
     } else {
         // Fill with 16-bit values
-        const u16 value_16bit = config.value_16bit.Value();
-        for (u8* ptr = start; ptr < end; ptr += sizeof(u16)) {
-            std::memcpy(ptr, &value_16bit, sizeof(u16));
-        }
+        const u16 value = config.value_16bit.Value();
+        FillPattern(start, Common::AlignUp(size, sizeof(u16)),
+                    {reinterpret_cast<const u8*>(&value), sizeof(u16)});
     }
 }
 
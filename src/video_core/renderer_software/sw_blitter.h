@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "common/thread_worker.h"
+
 namespace Pica {
 struct DisplayTransferConfig;
 struct MemoryFillConfig;
@@ -33,6 +35,8 @@ public:
 private:
     Memory::MemorySystem& memory;
     VideoCore::RasterizerInterface* rasterizer;
+    std::size_t num_workers;
+    Common::ThreadWorker workers;
 };
 
 } // namespace SwRenderer
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <boost/container/static_vector.hpp>
 #include "common/logging/log.h"
 #include "common/microprofile.h"
@@ -103,7 +104,37 @@ private:
 RasterizerSoftware::RasterizerSoftware(Memory::MemorySystem& memory_, Pica::PicaCore& pica_)
     : memory{memory_}, pica{pica_}, regs{pica.regs.internal},
       num_sw_threads{std::max(std::thread::hardware_concurrency(), 2U)},
-      sw_workers{num_sw_threads, "SwRenderer workers"}, fb{memory, regs.framebuffer} {}
+      sw_workers{num_sw_threads, "SwRenderer workers"}, fb{memory, regs.framebuffer},
+      texture_cache{memory} {}
+
+void RasterizerSoftware::FlushRegion(PAddr addr, u32 size) {
+    // Decoded textures are never written back to guest memory, so there is nothing to flush.
+}
+
+void RasterizerSoftware::InvalidateRegion(PAddr addr, u32 size) {
+    texture_cache.InvalidateRegion(addr, size);
+    textures_bound = false;
+}
+
+void RasterizerSoftware::FlushAndInvalidateRegion(PAddr addr, u32 size) {
+    texture_cache.InvalidateRegion(addr, size);
+    textures_bound = false;
+}
+
+void RasterizerSoftware::ClearAll(bool flush) {
+    texture_cache.InvalidateAll();
+    textures_bound = false;
+}
+
+void RasterizerSoftware::TickFrame() {
+    texture_cache.TickFrame();
+    textures_bound = false;
+}
+
+void RasterizerSoftware::DrawTriangles() {
+    // The texture configuration may change before the next draw, look it up again.
+    textures_bound = false;
+}
 
 void RasterizerSoftware::AddTriangle(const Pica::OutputVertex& v0, const Pica::OutputVertex& v1,
                                      const Pica::OutputVertex& v2) {
@@ -298,6 +329,9 @@ void RasterizerSoftware::ProcessTriangle(const Vertex& v0, const Vertex& v1, con
     const auto textures = regs.texturing.GetTextures();
     const auto tev_stages = regs.texturing.GetTevStages();
 
+    // Resolve the decoded textures here, the scanline workers only read from them.
+    BindDrawTextures();
+
     fb.Bind();
 
     // Enter rasterization loop, starting at the center of the topleft bounding box corner.
@@ -408,7 +442,7 @@ void RasterizerSoftware::ProcessTriangle(const Vertex& v0, const Vertex& v1, con
 
                 // Sample bound texture units.
                 const f24 tc0_w = get_interpolated_attribute(v0.tc0_w, v1.tc0_w, v2.tc0_w);
-                const auto texture_color = TextureColor(uv, textures, tc0_w);
+                const auto texture_color = TextureColor(uv, textures, bound_textures, tc0_w);
 
                 Common::Vec4<u8> primary_fragment_color = {0, 0, 0, 0};
                 Common::Vec4<u8> secondary_fragment_color = {0, 0, 0, 0};
@@ -471,9 +505,55 @@ void RasterizerSoftware::ProcessTriangle(const Vertex& v0, const Vertex& v1, con
     sw_workers.WaitForRequests();
 }
 
+void RasterizerSoftware::BindDrawTextures() {
+    if (textures_bound) {
+        return;
+    }
+    InvalidateRenderTargets();
+    bound_textures = BindTextures(regs.texturing.GetTextures());
+    textures_bound = true;
+}
+
+RasterizerSoftware::BoundTextures RasterizerSoftware::BindTextures(
+    std::span<const Pica::TexturingRegs::FullTextureConfig, 3> textures) {
+    BoundTextures bound_textures{};
+    for (u32 i = 0; i < 3; ++i) {
+        const auto& texture = textures[i];
+        if (!texture.enabled || texture.config.address == 0) {
+            continue;
+        }
+
+        auto info = TextureInfo::FromPicaRegister(texture.config, texture.format);
+        const auto type = texture.config.type.Value();
+        const bool is_cube = i == 0 && (type == TexturingRegs::TextureConfig::TextureCube ||
+                                        type == TexturingRegs::TextureConfig::ShadowCube);
+        const u32 num_faces = is_cube ? 6 : 1;
+        for (u32 face = 0; face < num_faces; ++face) {
+            if (is_cube) {
+                info.physical_address = regs.texturing.GetCubePhysicalAddress(
+                    static_cast<TexturingRegs::CubeFace>(face));
+            }
+            bound_textures[i][face] = {info.physical_address, texture_cache.GetTexture(info)};
+        }
+    }
+    return bound_textures;
+}
+
+void RasterizerSoftware::InvalidateRenderTargets() {
+    const auto& framebuffer = regs.framebuffer.framebuffer;
+    const u32 num_pixels = framebuffer.GetWidth() * framebuffer.GetHeight();
+    const u32 color_size =
+        num_pixels * Pica::BytesPerPixel(Pica::PixelFormat(framebuffer.color_format.Value()));
+    const u32 depth_size =
+        num_pixels * FramebufferRegs::BytesPerDepthPixel(framebuffer.depth_format);
+    texture_cache.InvalidateRegion(framebuffer.GetColorBufferPhysicalAddress(), color_size);
+    texture_cache.InvalidateRegion(framebuffer.GetDepthBufferPhysicalAddress(), depth_size);
+}
+
 std::array<Common::Vec4<u8>, 4> RasterizerSoftware::TextureColor(
     std::span<const Common::Vec2<f24>, 3> uv,
-    std::span<const Pica::TexturingRegs::FullTextureConfig, 3> textures, f24 tc0_w) const {
+    std::span<const Pica::TexturingRegs::FullTextureConfig, 3> textures,
+    const BoundTextures& bound_textures, f24 tc0_w) const {
     std::array<Common::Vec4<u8>, 4> texture_color{};
     for (u32 i = 0; i < 3; ++i) {
         const auto& texture = textures[i];
@@ -554,14 +634,20 @@ std::array<Common::Vec4<u8>, 4> RasterizerSoftware::TextureColor(
             // NOTE: This may not be the right place for the inversion.
             // TODO: Check if this applies to ETC textures, too.
             s = GetWrappedTexCoord(texture.config.wrap_s, s, texture.config.width);
-            t = texture.config.height - 1 -
-                GetWrappedTexCoord(texture.config.wrap_t, t, texture.config.height);
-
-            const u8* texture_data = memory.GetPhysicalPointer(texture_address);
-            const auto info = TextureInfo::FromPicaRegister(texture.config, texture.format);
+            t = GetWrappedTexCoord(texture.config.wrap_t, t, texture.config.height);
 
+            const auto bound = std::ranges::find(bound_textures[i], texture_address,
+                                                 &BoundTexture::address);
             // TODO: Apply the min and mag filters to the texture
-            texture_color[i] = LookupTexture(texture_data, s, t, info);
+            if (bound != bound_textures[i].end() && bound->texture) [[likely]] {
+                // Decoded textures are already stored from the bottom row up.
+                texture_color[i] = bound->texture->Texel(s, t);
+            } else {
+                t = texture.config.height - 1 - t;
+                const u8* texture_data = memory.GetPhysicalPointer(texture_address);
+                const auto info = TextureInfo::FromPicaRegister(texture.config, texture.format);
+                texture_color[i] = LookupTexture(texture_data, s, t, info);
+            }
         }
 
         if (i == 0 && (texture.config.type == TexturingRegs::TextureConfig::Shadow2D ||
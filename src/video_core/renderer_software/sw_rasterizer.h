@@ -10,6 +10,7 @@
 #include "video_core/rasterizer_interface.h"
 #include "video_core/renderer_software/sw_clipper.h"
 #include "video_core/renderer_software/sw_framebuffer.h"
+#include "video_core/renderer_software/sw_texture_cache.h"
 
 namespace Pica {
 struct RegsInternal;
@@ -26,14 +27,26 @@ public:
 
     void AddTriangle(const Pica::OutputVertex& v0, const Pica::OutputVertex& v1,
                      const Pica::OutputVertex& v2) override;
-    void DrawTriangles() override {}
+    void DrawTriangles() override;
     void FlushAll() override {}
-    void FlushRegion(PAddr addr, u32 size) override {}
-    void InvalidateRegion(PAddr addr, u32 size) override {}
-    void FlushAndInvalidateRegion(PAddr addr, u32 size) override {}
-    void ClearAll(bool flush) override {}
+    void FlushRegion(PAddr addr, u32 size) override;
+    void InvalidateRegion(PAddr addr, u32 size) override;
+    void FlushAndInvalidateRegion(PAddr addr, u32 size) override;
+    void ClearAll(bool flush) override;
+
+    /// Notifies the rasterizer that the current frame has been presented.
+    void TickFrame();
 
 private:
+    /// Decoded texture sampled from the provided address, null when sampling guest memory.
+    struct BoundTexture {
+        PAddr address;
+        const DecodedTexture* texture;
+    };
+
+    /// Decoded textures bound to each texture unit, cube maps use one entry per face.
+    using BoundTextures = std::array<std::array<BoundTexture, 6>, 3>;
+
     /// Computes the screen coordinates of the provided vertex.
     void MakeScreenCoords(Vertex& vtx);
 
@@ -41,10 +54,21 @@ private:
     void ProcessTriangle(const Vertex& v0, const Vertex& v1, const Vertex& v2,
                          bool reversed = false);
 
+    /// Looks up the decoded textures sampled by the current draw, once per draw call.
+    void BindDrawTextures();
+
+    /// Looks up the decoded textures sampled by the provided texture units.
+    BoundTextures BindTextures(
+        std::span<const Pica::TexturingRegs::FullTextureConfig, 3> textures);
+
+    /// Invalidates the decoded textures overlapping the bound render targets.
+    void InvalidateRenderTargets();
+
     /// Returns the texture color of the currently processed pixel.
     std::array<Common::Vec4<u8>, 4> TextureColor(
         std::span<const Common::Vec2<f24>, 3> uv,
-        std::span<const Pica::TexturingRegs::FullTextureConfig, 3> textures, f24 tc0_w) const;
+        std::span<const Pica::TexturingRegs::FullTextureConfig, 3> textures,
+        const BoundTextures& bound_textures, f24 tc0_w) const;
 
     /// Returns the final pixel color with blending or logic ops applied.
     Common::Vec4<u8> PixelColor(u16 x, u16 y, Common::Vec4<u8> combiner_output) const;
@@ -72,6 +96,9 @@ private:
     std::size_t num_sw_threads;
     Common::ThreadWorker sw_workers;
     Framebuffer fb;
+    TextureCache texture_cache;
+    BoundTextures bound_textures{};
+    bool textures_bound{};
 };
 
 } // namespace SwRenderer
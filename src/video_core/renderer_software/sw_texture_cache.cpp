@@ -0,0 +1,167 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <limits>
+#include "common/hash.h"
+#include "common/microprofile.h"
+#include "core/memory.h"
+#include "video_core/rasterizer_cache/texture_codec.h"
+#include "video_core/renderer_software/sw_texture_cache.h"
+
+namespace SwRenderer {
+
+using Pica::Texture::TextureInfo;
+
+MICROPROFILE_DEFINE(GPU_TextureDecode, "GPU", "Texture Decode", MP_RGB(150, 100, 50));
+
+namespace {
+
+/// Number of frames a texture may stay unused before being evicted
+constexpr u64 MaxIdleFrames = 120;
+
+/// Upper bound of the memory used by decoded textures
+constexpr std::size_t MaxCachedBytes = 128 * 1024 * 1024;
+
+} // Anonymous namespace
+
+std::size_t TextureCache::KeyHash::operator()(const Key& key) const noexcept {
+    return Common::ComputeHash64(&key, sizeof(Key));
+}
+
+TextureCache::TextureCache(Memory::MemorySystem& memory_) : memory{memory_} {}
+
+TextureCache::~TextureCache() = default;
+
+const DecodedTexture* TextureCache::GetTexture(const TextureInfo& info) {
+    // The morton decoders operate on whole tiles and do not know about the formats past ETC1A4.
+    const u32 format = static_cast<u32>(info.format);
+    if (format > static_cast<u32>(Pica::TexturingRegs::TextureFormat::ETC1A4) ||
+        info.width == 0 || info.height == 0 || info.width % 8 != 0 || info.height % 8 != 0) {
+        return nullptr;
+    }
+
+    const Key key{info.physical_address, info.width, info.height, format};
+    const u32 size = static_cast<u32>(info.stride * info.height / 8);
+
+    auto [it, is_new] = textures.try_emplace(key);
+    Entry& entry = it->second;
+    if (is_new) {
+        if (!Decode(info, size, entry)) {
+            textures.erase(it);
+            return nullptr;
+        }
+        cached_bytes += entry.texture.texels.size() * sizeof(Common::Vec4<u8>);
+        cached_begin = std::min(cached_begin, key.address);
+        cached_end = std::max(cached_end, entry.end);
+    } else {
+        // The guest may have rewritten the texture without telling us, check it on every lookup.
+        const MemoryRef source = memory.GetPhysicalRef(key.address);
+        if (!source || source.GetSize() < size) {
+            textures.erase(it);
+            UpdateBounds();
+            return nullptr;
+        }
+        const u64 hash = Common::ComputeHash64(source.GetPtr(), size);
+        if (hash != entry.hash && !Decode(info, size, entry)) {
+            textures.erase(it);
+            UpdateBounds();
+            return nullptr;
+        }
+    }
+
+    entry.last_frame = frame;
+    return &entry.texture;
+}
+
+bool TextureCache::Decode(const TextureInfo& info, u32 size, Entry& entry) {
+    MICROPROFILE_SCOPE(GPU_TextureDecode);
+
+    MemoryRef source = memory.GetPhysicalRef(info.physical_address);
+    if (!source || source.GetSize() < size) {
+        return false;
+    }
+
+    const u32 format = static_cast<u32>(info.format);
+    const auto decode = format < 5 ? VideoCore::UNSWIZZLE_TABLE_CONVERTED[format]
+                                   : VideoCore::UNSWIZZLE_TABLE[format];
+
+    auto& texture = entry.texture;
+    texture.width = info.width;
+    texture.height = info.height;
+    texture.texels.resize(info.width * info.height);
+
+    const auto tiled = source.GetWriteBytes(size);
+    const std::span linear{reinterpret_cast<u8*>(texture.texels.data()),
+                           texture.texels.size() * sizeof(Common::Vec4<u8>)};
+    decode(info.width, info.height, 0, size, linear, tiled);
+
+    entry.end = info.physical_address + size;
+    entry.hash = Common::ComputeHash64(tiled.data(), tiled.size());
+    return true;
+}
+
+void TextureCache::InvalidateRegion(PAddr addr, u32 size) {
+    const PAddr end = addr + size;
+    if (textures.empty() || end <= cached_begin || addr >= cached_end) {
+        return;
+    }
+
+    const std::size_t erased = std::erase_if(textures, [&](const auto& pair) {
+        const auto& [key, entry] = pair;
+        return key.address < end && addr < entry.end;
+    });
+    if (erased > 0) {
+        UpdateBounds();
+    }
+}
+
+void TextureCache::InvalidateAll() {
+    textures.clear();
+    UpdateBounds();
+}
+
+void TextureCache::TickFrame() {
+    ++frame;
+
+    const std::size_t erased = std::erase_if(textures, [this](const auto& pair) {
+        return frame - pair.second.last_frame > MaxIdleFrames;
+    });
+    if (erased == 0 && cached_bytes <= MaxCachedBytes) {
+        return;
+    }
+    UpdateBounds();
+
+    // Drop the least recently used textures until the cache fits the budget again.
+    if (cached_bytes > MaxCachedBytes) {
+        std::vector<decltype(textures)::iterator> candidates;
+        candidates.reserve(textures.size());
+        for (auto it = textures.begin(); it != textures.end(); ++it) {
+            candidates.push_back(it);
+        }
+        std::ranges::sort(candidates, {}, [](const auto& it) { return it->second.last_frame; });
+
+        for (const auto& it : candidates) {
+            if (cached_bytes <= MaxCachedBytes) {
+                break;
+            }
+            cached_bytes -= it->second.texture.texels.size() * sizeof(Common::Vec4<u8>);
+            textures.erase(it);
+        }
+        UpdateBounds();
+    }
+}
+
+void TextureCache::UpdateBounds() {
+    cached_bytes = 0;
+    cached_begin = std::numeric_limits<PAddr>::max();
+    cached_end = 0;
+    for (const auto& [key, entry] : textures) {
+        cached_bytes += entry.texture.texels.size() * sizeof(Common::Vec4<u8>);
+        cached_begin = std::min(cached_begin, key.address);
+        cached_end = std::max(cached_end, entry.end);
+    }
+}
+
+} // namespace SwRenderer
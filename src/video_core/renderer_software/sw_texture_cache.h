@@ -0,0 +1,96 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <limits>
+#include <unordered_map>
+#include <vector>
+#include "common/common_types.h"
+#include "common/vector_math.h"
+#include "video_core/texture/texture_decode.h"
+
+namespace Memory {
+class MemorySystem;
+}
+
+namespace SwRenderer {
+
+/// A guest texture decoded to linear RGBA8, with rows stored from bottom to top.
+struct DecodedTexture {
+    u32 width;
+    u32 height;
+    std::vector<Common::Vec4<u8>> texels;
+
+    /// Returns the texel at the provided wrapped coordinates, t counted from the bottom row.
+    [[nodiscard]] Common::Vec4<u8> Texel(u32 s, u32 t) const {
+        return texels[t * width + s];
+    }
+};
+
+/**
+ * Caches the decoded contents of guest textures so that sampling does not need to
+ * unswizzle and convert a texel on every lookup.
+ *
+ * Entries are dropped on explicit invalidations. Since the software renderer does not track
+ * CPU writes to guest memory, an entry is also revalidated against a hash of its source data
+ * on every lookup, which the rasterizer performs once per draw call.
+ */
+class TextureCache {
+public:
+    explicit TextureCache(Memory::MemorySystem& memory);
+    ~TextureCache();
+
+    /**
+     * Returns the decoded texture described by info, decoding it if needed.
+     * @returns nullptr if the texture cannot be decoded and must be sampled from guest memory.
+     */
+    const DecodedTexture* GetTexture(const Pica::Texture::TextureInfo& info);
+
+    /// Drops all textures overlapping the provided region.
+    void InvalidateRegion(PAddr addr, u32 size);
+
+    /// Drops all textures.
+    void InvalidateAll();
+
+    /// Marks the end of a frame, evicting textures that were not used for a while.
+    void TickFrame();
+
+private:
+    struct Key {
+        PAddr address;
+        u32 width;
+        u32 height;
+        u32 format;
+
+        bool operator==(const Key&) const = default;
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const noexcept;
+    };
+
+    struct Entry {
+        PAddr end;
+        u64 hash;
+        u64 last_frame;
+        DecodedTexture texture;
+    };
+
+    /// Decodes the guest texture into entry, returns false if the memory is not backed.
+    bool Decode(const Pica::Texture::TextureInfo& info, u32 size, Entry& entry);
+
+    /// Recomputes the range covered by the cached textures.
+    void UpdateBounds();
+
+private:
+    Memory::MemorySystem& memory;
+    std::unordered_map<Key, Entry, KeyHash> textures;
+    std::size_t cached_bytes{};
+    PAddr cached_begin{std::numeric_limits<PAddr>::max()};
+    PAddr cached_end{};
+    u64 frame{};
+};
+
+} // namespace SwRenderer
@@ -162,6 +162,7 @@ struct Shader : public Common::AsyncHandle {
     vk::ShaderModule module;
     vk::Device device;
     std::string program;
+    u64 spirv_hash{};
 };
 
 class GraphicsPipeline : public Common::AsyncHandle {
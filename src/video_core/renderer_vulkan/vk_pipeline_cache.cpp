@@ -2,10 +2,12 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <bit>
 #include <boost/container/static_vector.hpp>
 
 #include "common/common_paths.h"
 #include "common/file_util.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "common/scope_exit.h"
@@ -23,6 +25,7 @@
 #include "video_core/shader/generator/glsl_fs_shader_gen.h"
 #include "video_core/shader/generator/glsl_shader_gen.h"
 #include "video_core/shader/generator/spv_fs_shader_gen.h"
+#include "video_core/shader/generator/spv_shader_gen.h"
 
 using namespace Pica::Shader::Generator;
 using Pica::Shader::FSConfig;
@@ -56,6 +59,14 @@ AttribLoadFlags MakeAttribLoadFlag(Pica::PipelineRegs::VertexAttributeFormat for
     }
 }
 
+/// Recreates a shader key from the bytes stored in the shader disk cache
+template <typename T>
+T KeyFromBytes(std::span<const u8> bytes) {
+    std::array<u8, sizeof(T)> storage;
+    std::memcpy(storage.data(), bytes.data(), sizeof(T));
+    return std::bit_cast<T>(storage);
+}
+
 constexpr std::array<vk::DescriptorSetLayoutBinding, 6> BUFFER_BINDINGS = {{
     {0, vk::DescriptorType::eUniformBufferDynamic, 1, vk::ShaderStageFlagBits::eVertex},
     {1, vk::DescriptorType::eUniformBufferDynamic, 1,
@@ -92,7 +103,8 @@ PipelineCache::PipelineCache(const Instance& instance_, Scheduler& scheduler_,
           DescriptorHeap{instance, scheduler.GetMasterSemaphore(), UTILITY_BINDINGS, 32}},
       trivial_vertex_shader{
           instance, vk::ShaderStageFlagBits::eVertex,
-          GLSL::GenerateTrivialVertexShader(instance.IsShaderClipDistanceSupported(), true)} {
+          GLSL::GenerateTrivialVertexShader(instance.IsShaderClipDistanceSupported(), true)},
+      shader_disk_cache{GetShaderCacheDir()} {
     scheduler.RegisterOnDispatch([this] { update_queue.Flush(); });
     profile = Pica::Shader::Profile{
         .has_separable_shaders = true,
@@ -157,6 +169,7 @@ void PipelineCache::LoadDiskCache(const std::atomic_bool& stop_loading,
                 }
             }
         }
+        LoadShaderDiskCache(stop_loading, callback);
         if (callback) {
             callback(VideoCore::LoadCallbackStage::Complete, 0, 0);
         }
@@ -410,26 +423,73 @@ bool PipelineCache::UseProgrammableVertexShader(const Pica::RegsInternal& regs,
 
     const auto [it, new_config] = programmable_vertex_map.try_emplace(config);
     if (new_config) {
-        auto program = GLSL::GenerateVertexShader(setup, config, true);
-        if (program.empty()) {
+        const vk::Device device = instance.GetDevice();
+        Shader* shader{};
+        bool new_program{};
+
+        const bool use_spirv = Settings::values.spirv_vertex_shader_gen.GetValue();
+        const SpirvGenerator generator =
+            use_spirv ? SpirvGenerator::Direct : SpirvGenerator::Glslang;
+        if (use_spirv) {
+            auto code = SPIRV::GenerateVertexShader(setup, config);
+            if (!code.empty()) {
+                // Configs that translate to the same code share the shader module
+                const u64 spirv_hash =
+                    Common::ComputeHash64(code.data(), code.size() * sizeof(u32));
+                auto [iter, inserted] =
+                    programmable_vertex_spv_cache.try_emplace(spirv_hash, instance);
+                shader = &iter->second;
+                new_program = inserted;
+                if (new_program) {
+                    shader->spirv_hash = spirv_hash;
+                    workers.QueueWork([this, device, config, code = std::move(code), shader] {
+                        shader->module = CompileSPV(code, device);
+                        shader_disk_cache.Save(ProgramType::VS, SpirvGenerator::Direct,
+                                               ShaderDiskCache::KeyBytes(config), code);
+                        shader->MarkDone();
+                    });
+                }
+            }
+        } else {
+            auto program = GLSL::GenerateVertexShader(setup, config, true);
+            if (!program.empty()) {
+                auto [iter, inserted] = programmable_vertex_cache.try_emplace(program, instance);
+                shader = &iter->second;
+                new_program = inserted;
+                if (new_program) {
+                    shader->program = std::move(program);
+                    workers.QueueWork([this, device, config, shader] {
+                        const auto code =
+                            CompileToSPV(shader->program, vk::ShaderStageFlagBits::eVertex);
+                        if (!code.empty()) {
+                            shader->module = CompileSPV(code, device);
+                            shader->spirv_hash = shader_disk_cache.Save(
+                                ProgramType::VS, SpirvGenerator::Glslang,
+                                ShaderDiskCache::KeyBytes(config), code);
+                        }
+                        shader->MarkDone();
+                    });
+                }
+            }
+        }
+
+        if (!shader) {
             LOG_ERROR(Render_Vulkan, "Failed to retrieve programmable vertex shader");
             programmable_vertex_map[config] = nullptr;
             return false;
         }
 
-        auto [iter, new_program] = programmable_vertex_cache.try_emplace(program, instance);
-        auto& shader = iter->second;
-
-        if (new_program) {
-            shader.program = std::move(program);
-            const vk::Device device = instance.GetDevice();
-            workers.QueueWork([device, &shader] {
-                shader.module = Compile(shader.program, vk::ShaderStageFlagBits::eVertex, device);
-                shader.MarkDone();
+        if (!new_program) {
+            // The program is shared with another config, only its key needs to be stored.
+            // Work is processed in order, so the shader is already being compiled by now.
+            workers.QueueWork([this, config, generator, shader] {
+                shader->WaitDone();
+                shader_disk_cache.SaveKey(ProgramType::VS, generator,
+                                          ShaderDiskCache::KeyBytes(config), shader->spirv_hash);
             });
         }
 
-        it->second = &shader;
+        it->second = shader;
     }
 
     Shader* const shader{it->second};
@@ -460,9 +520,22 @@ bool PipelineCache::UseFixedGeometryShader(const Pica::RegsInternal& regs) {
     auto& shader = it->second;
 
     if (new_shader) {
-        workers.QueueWork([gs_config, device = instance.GetDevice(), &shader]() {
-            const auto code = GLSL::GenerateFixedGeometryShader(gs_config, true);
-            shader.module = Compile(code, vk::ShaderStageFlagBits::eGeometry, device);
+        workers.QueueWork([this, gs_config, device = instance.GetDevice(), &shader]() {
+            const bool use_spirv = Settings::values.spirv_vertex_shader_gen.GetValue();
+            std::vector<u32> code;
+            if (use_spirv) {
+                code = SPIRV::GenerateFixedGeometryShader(gs_config);
+            } else {
+                const auto program = GLSL::GenerateFixedGeometryShader(gs_config, true);
+                code = CompileToSPV(program, vk::ShaderStageFlagBits::eGeometry);
+            }
+            if (!code.empty()) {
+                shader.module = CompileSPV(code, device);
+                shader_disk_cache.Save(ProgramType::GS,
+                                       use_spirv ? SpirvGenerator::Direct
+                                                 : SpirvGenerator::Glslang,
+                                       ShaderDiskCache::KeyBytes(gs_config), code);
+            }
             shader.MarkDone();
         });
     }
@@ -486,14 +559,21 @@ void PipelineCache::UseFragmentShader(const Pica::RegsInternal& regs,
 
     if (new_shader) {
         workers.QueueWork([fs_config, this, &shader]() {
-            const bool use_spirv = Settings::values.spirv_shader_gen.GetValue();
-            if (use_spirv && !fs_config.UsesSpirvIncompatibleConfig()) {
-                const std::vector code = SPIRV::GenerateFragmentShader(fs_config, profile);
-                shader.module = CompileSPV(code, instance.GetDevice());
+            const bool use_spirv = Settings::values.spirv_shader_gen.GetValue() &&
+                                   !fs_config.UsesSpirvIncompatibleConfig();
+            std::vector<u32> code;
+            if (use_spirv) {
+                code = SPIRV::GenerateFragmentShader(fs_config, profile);
             } else {
-                const std::string code = GLSL::GenerateFragmentShader(fs_config, profile);
-                shader.module =
-                    Compile(code, vk::ShaderStageFlagBits::eFragment, instance.GetDevice());
+                const std::string program = GLSL::GenerateFragmentShader(fs_config, profile);
+                code = CompileToSPV(program, vk::ShaderStageFlagBits::eFragment);
+            }
+            if (!code.empty()) {
+                shader.module = CompileSPV(code, instance.GetDevice());
+                shader_disk_cache.Save(ProgramType::FS,
+                                       use_spirv ? SpirvGenerator::Direct
+                                                 : SpirvGenerator::Glslang,
+                                       ShaderDiskCache::KeyBytes(fs_config), code);
             }
             shader.MarkDone();
         });
@@ -545,6 +625,104 @@ bool PipelineCache::IsCacheValid(std::span<const u8> data) const {
     return true;
 }
 
+void PipelineCache::LoadShaderDiskCache(const std::atomic_bool& stop_loading,
+                                        const VideoCore::DiskResourceLoadCallback& callback) {
+    if (!Settings::values.use_disk_shader_cache) {
+        return;
+    }
+
+    shader_disk_cache.Open(GetProgramID(), profile);
+    // The shader workers may still be saving shaders of the previous title, so only a copy of the
+    // entries is accessed here.
+    const std::vector<ShaderDiskCacheEntry> entries = shader_disk_cache.GetEntries();
+    if (entries.empty()) {
+        return;
+    }
+
+    // Only restore the shaders produced by the generator currently selected, otherwise toggling
+    // the settings would keep running the code of the other one.
+    const bool use_spirv = Settings::values.spirv_shader_gen.GetValue();
+    const SpirvGenerator vertex_generator = Settings::values.spirv_vertex_shader_gen.GetValue()
+                                                ? SpirvGenerator::Direct
+                                                : SpirvGenerator::Glslang;
+
+    const std::size_t num_shaders = entries.size();
+    if (callback) {
+        callback(VideoCore::LoadCallbackStage::Build, 0, num_shaders);
+    }
+
+    std::mutex callback_mutex;
+    std::size_t built_shaders = 0; // It doesn't have be atomic since it's used behind a mutex
+    const vk::Device device = instance.GetDevice();
+    const auto queue_build = [&](Shader& shader, std::shared_ptr<const std::vector<u32>> code) {
+        workers.QueueWork([&, code = std::move(code)] {
+            shader.module = CompileSPV(*code, device);
+            shader.MarkDone();
+            if (callback) {
+                std::scoped_lock lock{callback_mutex};
+                callback(VideoCore::LoadCallbackStage::Build, ++built_shaders, num_shaders);
+            }
+        });
+    };
+
+    for (const ShaderDiskCacheEntry& entry : entries) {
+        if (stop_loading) {
+            break;
+        }
+
+        auto code = shader_disk_cache.GetSpirv(entry.spirv_hash);
+        if (!code) {
+            continue;
+        }
+        switch (entry.program_type) {
+        case ProgramType::VS: {
+            if (entry.key.size() != sizeof(PicaVSConfig) || entry.generator != vertex_generator) {
+                break;
+            }
+            const auto config = KeyFromBytes<PicaVSConfig>(entry.key);
+            auto [it, new_shader] =
+                programmable_vertex_spv_cache.try_emplace(entry.spirv_hash, instance);
+            if (new_shader) {
+                it->second.spirv_hash = entry.spirv_hash;
+                queue_build(it->second, std::move(code));
+            }
+            programmable_vertex_map.try_emplace(config, &it->second);
+            break;
+        }
+        case ProgramType::GS: {
+            if (entry.key.size() != sizeof(PicaFixedGSConfig) ||
+                entry.generator != vertex_generator) {
+                break;
+            }
+            const auto gs_config = KeyFromBytes<PicaFixedGSConfig>(entry.key);
+            auto [it, new_shader] = fixed_geometry_shaders.try_emplace(gs_config, instance);
+            if (new_shader) {
+                queue_build(it->second, std::move(code));
+            }
+            break;
+        }
+        case ProgramType::FS: {
+            if (entry.key.size() != sizeof(FSConfig)) {
+                break;
+            }
+            const auto fs_config = KeyFromBytes<FSConfig>(entry.key);
+            const bool fs_use_spirv = use_spirv && !fs_config.UsesSpirvIncompatibleConfig();
+            if (entry.generator !=
+                (fs_use_spirv ? SpirvGenerator::Direct : SpirvGenerator::Glslang)) {
+                break;
+            }
+            auto [it, new_shader] = fragment_shaders.try_emplace(fs_config, instance);
+            if (new_shader) {
+                queue_build(it->second, std::move(code));
+            }
+            break;
+        }
+        }
+    }
+
+    workers.WaitForRequests();
+}
+
 bool PipelineCache::EnsureDirectories() const {
     const auto create_dir = [](const std::string& dir) {
         if (!FileUtil::CreateDir(dir)) {
@@ -556,7 +734,8 @@ bool PipelineCache::EnsureDirectories() const {
     };
 
     return create_dir(FileUtil::GetUserPath(FileUtil::UserPath::ShaderDir)) &&
-           create_dir(GetVulkanDir()) && create_dir(GetPipelineCacheDir());
+           create_dir(GetVulkanDir()) && create_dir(GetPipelineCacheDir()) &&
+           create_dir(GetShaderCacheDir());
 }
 
 std::string PipelineCache::GetVulkanDir() const {
@@ -567,6 +746,10 @@ std::string PipelineCache::GetPipelineCacheDir() const {
     return GetVulkanDir() + "pipeline" + DIR_SEP;
 }
 
+std::string PipelineCache::GetShaderCacheDir() const {
+    return GetVulkanDir() + "shaders" + DIR_SEP;
+}
+
 void PipelineCache::SwitchPipelineCache(u64 title_id, const std::atomic_bool& stop_loading,
                                         const VideoCore::DiskResourceLoadCallback& callback) {
     if (!Settings::values.use_disk_shader_cache || GetProgramID() == title_id) {
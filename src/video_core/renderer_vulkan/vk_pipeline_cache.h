@@ -10,6 +10,7 @@
 #include "video_core/rasterizer_interface.h"
 #include "video_core/renderer_vulkan/vk_graphics_pipeline.h"
 #include "video_core/renderer_vulkan/vk_resource_pool.h"
+#include "video_core/renderer_vulkan/vk_shader_disk_cache.h"
 #include "video_core/shader/generator/pica_fs_config.h"
 #include "video_core/shader/generator/profile.h"
 #include "video_core/shader/generator/shader_gen.h"
@@ -105,6 +106,10 @@ private:
     /// Returns true when the disk data can be used by the current driver
     bool IsCacheValid(std::span<const u8> cache_data) const;
 
+    /// Restores the shaders stored in the shader disk cache, building them in parallel
+    void LoadShaderDiskCache(const std::atomic_bool& stop_loading,
+                             const VideoCore::DiskResourceLoadCallback& callback);
+
     /// Create pipeline cache directories. Returns true on success.
     bool EnsureDirectories() const;
 
@@ -114,6 +119,9 @@ private:
     /// Returns the pipeline cache storage dir
     std::string GetPipelineCacheDir() const;
 
+    /// Returns the shader disk cache storage dir
+    std::string GetShaderCacheDir() const;
+
 private:
     const Instance& instance;
     Scheduler& scheduler;
@@ -137,9 +145,11 @@ private:
     std::array<Shader*, MAX_SHADER_STAGES> current_shaders;
     std::unordered_map<Pica::Shader::Generator::PicaVSConfig, Shader*> programmable_vertex_map;
     std::unordered_map<std::string, Shader> programmable_vertex_cache;
+    std::unordered_map<u64, Shader> programmable_vertex_spv_cache;
     std::unordered_map<Pica::Shader::Generator::PicaFixedGSConfig, Shader> fixed_geometry_shaders;
     std::unordered_map<Pica::Shader::FSConfig, Shader> fragment_shaders;
     Shader trivial_vertex_shader;
+    ShaderDiskCache shader_disk_cache;
 
     u64 current_program_id{0};
 };
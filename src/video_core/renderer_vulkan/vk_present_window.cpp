@@ -98,9 +98,10 @@ bool CanBlitToSwapchain(const vk::PhysicalDevice& physical_device, vk::Format fo
 } // Anonymous namespace
 
 PresentWindow::PresentWindow(Frontend::EmuWindow& emu_window_, const Instance& instance_,
-                             Scheduler& scheduler_, bool low_refresh_rate_)
+                             Scheduler& scheduler_, bool low_refresh_rate_,
+                             std::function<void()> present_callback_)
     : emu_window{emu_window_}, instance{instance_}, scheduler{scheduler_},
-      low_refresh_rate{low_refresh_rate_},
+      low_refresh_rate{low_refresh_rate_}, present_callback{std::move(present_callback_)},
       surface{CreateSurface(instance.GetInstance(), emu_window)}, next_surface{surface},
       swapchain{instance, emu_window.GetFramebufferLayout().width,
                 emu_window.GetFramebufferLayout().height, surface, low_refresh_rate_},
@@ -484,6 +485,10 @@ void PresentWindow::CopyToSwapchain(Frame* frame) {
     }
 
     swapchain.Present();
+
+    if (present_callback) {
+        present_callback();
+    }
 }
 
 vk::RenderPass PresentWindow::CreateRenderpass() {
@@ -4,6 +4,7 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <functional>
 #include <mutex>
 #include <queue>
 #include "common/polyfill_thread.h"
@@ -36,8 +37,10 @@ struct Frame {
 
 class PresentWindow final {
 public:
+    /// The present callback, if any, is invoked after each frame is handed to the swapchain.
     explicit PresentWindow(Frontend::EmuWindow& emu_window, const Instance& instance,
-                           Scheduler& scheduler, bool low_refresh_rate);
+                           Scheduler& scheduler, bool low_refresh_rate,
+                           std::function<void()> present_callback = {});
     ~PresentWindow();
 
     /// Waits for all queued frames to finish presenting.
@@ -75,6 +78,7 @@ private:
     const Instance& instance;
     Scheduler& scheduler;
     bool low_refresh_rate;
+    std::function<void()> present_callback;
     vk::SurfaceKHR surface;
     vk::SurfaceKHR next_surface{};
     Swapchain swapchain;
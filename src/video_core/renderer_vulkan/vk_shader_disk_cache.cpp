@@ -0,0 +1,251 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fmt/format.h>
+
+#include "common/hash.h"
+#include "common/logging/log.h"
+#include "common/scm_rev.h"
+#include "video_core/renderer_vulkan/vk_shader_disk_cache.h"
+
+namespace Vulkan {
+
+namespace {
+
+constexpr u32 CacheMagic = 0x43535056; // VPSC
+constexpr u32 CacheVersion = 2;
+
+// Upper bounds used to reject corrupted records before allocating
+constexpr u64 MaxKeySize = 4096;
+constexpr u64 MaxSpirvWords = 4 * 1024 * 1024;
+
+enum class RecordKind : u32 {
+    Spirv,
+    Key,
+};
+
+struct CacheHeader {
+    u32 magic;
+    u32 version;
+    std::array<char, 64> shader_cache_version;
+    u64 profile_hash;
+};
+
+CacheHeader MakeHeader(u64 profile_hash) {
+    CacheHeader header{};
+    header.magic = CacheMagic;
+    header.version = CacheVersion;
+    const std::size_t length =
+        std::min(std::strlen(Common::g_shader_cache_version), header.shader_cache_version.size());
+    std::memcpy(header.shader_cache_version.data(), Common::g_shader_cache_version, length);
+    header.profile_hash = profile_hash;
+    return header;
+}
+
+u64 KeyHash(ProgramType program_type, SpirvGenerator generator, std::span<const u8> key) {
+    return Common::ComputeHash64(key.data(), key.size()) ^ static_cast<u64>(program_type) ^
+           (static_cast<u64>(generator) << 32);
+}
+
+} // Anonymous namespace
+
+ShaderDiskCache::ShaderDiskCache(std::string cache_dir_) : cache_dir{std::move(cache_dir_)} {}
+
+ShaderDiskCache::~ShaderDiskCache() = default;
+
+void ShaderDiskCache::Open(u64 program_id, const Pica::Shader::Profile& profile) {
+    std::scoped_lock lock{mutex};
+    file.Close();
+    entries.clear();
+    spirv_blobs.clear();
+    stored_keys.clear();
+
+    if (program_id == 0) {
+        cache_path.clear();
+        return;
+    }
+
+    cache_path = fmt::format("{}{:016X}.bin", cache_dir, program_id);
+    profile_hash = Common::ComputeHash64(&profile, sizeof(profile));
+
+    if (!FileUtil::Exists(cache_path)) {
+        LOG_INFO(Render_Vulkan, "No shader cache found for title_id={:016X}", program_id);
+        WriteHeader();
+        return;
+    }
+
+    file = FileUtil::IOFile{cache_path, "rb"};
+    CacheHeader header{};
+    const CacheHeader expected = MakeHeader(profile_hash);
+    if (file.ReadBytes(&header, sizeof(header)) != sizeof(header) ||
+        std::memcmp(&header, &expected, sizeof(header)) != 0) {
+        LOG_INFO(Render_Vulkan, "Shader cache is outdated or invalid - removing");
+        Invalidate();
+        return;
+    }
+
+    if (!LoadRecords()) {
+        LOG_ERROR(Render_Vulkan, "Shader cache is corrupted - removing");
+        Invalidate();
+        return;
+    }
+
+    LOG_INFO(Render_Vulkan, "Loaded {} shader keys and {} SPIR-V modules for title_id={:016X}",
+             entries.size(), spirv_blobs.size(), program_id);
+
+    file = FileUtil::IOFile{cache_path, "ab"};
+}
+
+std::vector<ShaderDiskCacheEntry> ShaderDiskCache::GetEntries() const {
+    std::scoped_lock lock{mutex};
+    return entries;
+}
+
+std::shared_ptr<const std::vector<u32>> ShaderDiskCache::GetSpirv(u64 spirv_hash) const {
+    std::scoped_lock lock{mutex};
+    const auto it = spirv_blobs.find(spirv_hash);
+    if (it == spirv_blobs.end()) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+u64 ShaderDiskCache::Save(ProgramType program_type, SpirvGenerator generator,
+                          std::span<const u8> key, std::span<const u32> spirv) {
+    const u64 spirv_hash = Common::ComputeHash64(spirv.data(), spirv.size_bytes());
+
+    std::scoped_lock lock{mutex};
+    if (!IsUsable()) {
+        return spirv_hash;
+    }
+
+    const auto [it, new_blob] = spirv_blobs.try_emplace(spirv_hash);
+    if (new_blob) {
+        it->second = std::make_shared<const std::vector<u32>>(spirv.begin(), spirv.end());
+        const u64 num_words = spirv.size();
+        if (file.WriteObject(RecordKind::Spirv) != 1 || file.WriteObject(spirv_hash) != 1 ||
+            file.WriteObject(num_words) != 1 ||
+            file.WriteArray(spirv.data(), spirv.size()) != spirv.size()) {
+            LOG_ERROR(Render_Vulkan, "Failed to write SPIR-V to the shader cache");
+            return spirv_hash;
+        }
+    }
+
+    AppendKey(program_type, generator, key, spirv_hash);
+    file.Flush();
+    return spirv_hash;
+}
+
+void ShaderDiskCache::SaveKey(ProgramType program_type, SpirvGenerator generator,
+                              std::span<const u8> key, u64 spirv_hash) {
+    std::scoped_lock lock{mutex};
+    if (!IsUsable() || !spirv_blobs.contains(spirv_hash)) {
+        return;
+    }
+    AppendKey(program_type, generator, key, spirv_hash);
+    file.Flush();
+}
+
+void ShaderDiskCache::AppendKey(ProgramType program_type, SpirvGenerator generator,
+                                std::span<const u8> key, u64 spirv_hash) {
+    if (!stored_keys.insert(KeyHash(program_type, generator, key)).second) {
+        return;
+    }
+    const u64 key_size = key.size();
+    if (file.WriteObject(RecordKind::Key) != 1 || file.WriteObject(program_type) != 1 ||
+        file.WriteObject(generator) != 1 || file.WriteObject(key_size) != 1 ||
+        file.WriteArray(key.data(), key.size()) != key.size() ||
+        file.WriteObject(spirv_hash) != 1) {
+        LOG_ERROR(Render_Vulkan, "Failed to write shader key to the shader cache");
+    }
+}
+
+bool ShaderDiskCache::IsUsable() const {
+    return !cache_path.empty() && file.IsOpen();
+}
+
+bool ShaderDiskCache::LoadRecords() {
+    const u64 file_size = file.GetSize();
+    while (file.Tell() < file_size) {
+        RecordKind kind{};
+        if (file.ReadBytes(&kind, sizeof(kind)) != sizeof(kind)) {
+            return false;
+        }
+
+        switch (kind) {
+        case RecordKind::Spirv: {
+            u64 spirv_hash{};
+            u64 num_words{};
+            if (file.ReadBytes(&spirv_hash, sizeof(u64)) != sizeof(u64) ||
+                file.ReadBytes(&num_words, sizeof(u64)) != sizeof(u64) ||
+                num_words > MaxSpirvWords) {
+                return false;
+            }
+            std::vector<u32> code(num_words);
+            if (file.ReadArray(code.data(), num_words) != num_words) {
+                return false;
+            }
+            spirv_blobs.insert_or_assign(
+                spirv_hash, std::make_shared<const std::vector<u32>>(std::move(code)));
+            break;
+        }
+        case RecordKind::Key: {
+            ShaderDiskCacheEntry entry{};
+            u64 key_size{};
+            if (file.ReadBytes(&entry.program_type, sizeof(u32)) != sizeof(u32) ||
+                file.ReadBytes(&entry.generator, sizeof(u32)) != sizeof(u32) ||
+                file.ReadBytes(&key_size, sizeof(u64)) != sizeof(u64) || key_size > MaxKeySize) {
+                return false;
+            }
+            entry.key.resize(key_size);
+            if (file.ReadArray(entry.key.data(), key_size) != key_size ||
+                file.ReadBytes(&entry.spirv_hash, sizeof(u64)) != sizeof(u64)) {
+                return false;
+            }
+            if (stored_keys.insert(KeyHash(entry.program_type, entry.generator, entry.key))
+                    .second) {
+                entries.push_back(std::move(entry));
+            }
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+
+    // Keys always follow the code they reference, anything else means a damaged file
+    return std::ranges::all_of(entries, [this](const ShaderDiskCacheEntry& entry) {
+        return spirv_blobs.contains(entry.spirv_hash);
+    });
+}
+
+bool ShaderDiskCache::WriteHeader() {
+    file = FileUtil::IOFile{cache_path, "wb"};
+    if (!file.IsOpen()) {
+        LOG_ERROR(Render_Vulkan, "Unable to open shader cache {} for writing", cache_path);
+        return false;
+    }
+    const CacheHeader header = MakeHeader(profile_hash);
+    if (file.WriteObject(header) != 1) {
+        LOG_ERROR(Render_Vulkan, "Failed to write shader cache header");
+        file.Close();
+        return false;
+    }
+    file.Flush();
+    return true;
+}
+
+void ShaderDiskCache::Invalidate() {
+    entries.clear();
+    spirv_blobs.clear();
+    stored_keys.clear();
+    file.Close();
+    FileUtil::Delete(cache_path);
+    WriteHeader();
+}
+
+} // namespace Vulkan
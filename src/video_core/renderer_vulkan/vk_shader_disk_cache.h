@@ -0,0 +1,100 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "common/common_types.h"
+#include "common/file_util.h"
+#include "video_core/shader/generator/profile.h"
+#include "video_core/shader/generator/shader_gen.h"
+
+namespace Vulkan {
+
+using ProgramType = Pica::Shader::Generator::ProgramType;
+
+/// Path that produced the SPIR-V of a shader
+enum class SpirvGenerator : u32 {
+    Glslang, ///< GLSL generator compiled with glslang
+    Direct,  ///< Direct SPIR-V emitter
+};
+
+/// Describes a shader key as used by the pipeline cache, together with the SPIR-V it produced
+struct ShaderDiskCacheEntry {
+    ProgramType program_type;
+    SpirvGenerator generator;
+    std::vector<u8> key;
+    u64 spirv_hash;
+};
+
+/**
+ * Per title cache of the shader keys (PicaVSConfig, PicaFixedGSConfig and FSConfig) seen by the
+ * pipeline cache and the SPIR-V generated for them. Allows skipping shader generation and glslang
+ * compilation for every known shader on the next boot.
+ */
+class ShaderDiskCache {
+public:
+    explicit ShaderDiskCache(std::string cache_dir);
+    ~ShaderDiskCache();
+
+    /**
+     * Opens the cache file of the specified title and loads its contents.
+     * The cache is invalidated when it was generated with a different profile or emulator version.
+     */
+    void Open(u64 program_id, const Pica::Shader::Profile& profile);
+
+    /// Returns a copy of the loaded shader keys, as shaders may be saved concurrently
+    std::vector<ShaderDiskCacheEntry> GetEntries() const;
+
+    /// Returns the SPIR-V code identified by the provided hash, or nullptr if missing
+    std::shared_ptr<const std::vector<u32>> GetSpirv(u64 spirv_hash) const;
+
+    /// Saves a shader key and its SPIR-V code. Returns the hash identifying the SPIR-V code.
+    u64 Save(ProgramType program_type, SpirvGenerator generator, std::span<const u8> key,
+             std::span<const u32> spirv);
+
+    /// Saves a shader key that reuses already stored SPIR-V code.
+    void SaveKey(ProgramType program_type, SpirvGenerator generator, std::span<const u8> key,
+                 u64 spirv_hash);
+
+    template <typename T>
+    static std::span<const u8> KeyBytes(const T& key) {
+        static_assert(std::is_trivially_copyable_v<T>, "Shader key must be trivially copyable");
+        return {reinterpret_cast<const u8*>(&key), sizeof(T)};
+    }
+
+private:
+    bool IsUsable() const;
+
+    /// Reads all the records of the cache file. Returns false when the file is corrupted.
+    bool LoadRecords();
+
+    /// Writes the file header, truncating any existing contents
+    bool WriteHeader();
+
+    void Invalidate();
+
+    void AppendKey(ProgramType program_type, SpirvGenerator generator, std::span<const u8> key,
+                   u64 spirv_hash);
+
+    std::string cache_dir;
+    std::string cache_path;
+    u64 profile_hash{};
+    FileUtil::IOFile file;
+
+    mutable std::mutex mutex;
+    std::vector<ShaderDiskCacheEntry> entries;
+    std::unordered_map<u64, std::shared_ptr<const std::vector<u32>>> spirv_blobs;
+    std::unordered_set<u64> stored_keys;
+};
+
+} // namespace Vulkan
@@ -0,0 +1,1131 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <boost/container/small_vector.hpp>
+#include <fmt/format.h>
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "video_core/pica/shader_setup.h"
+#include "video_core/shader/generator/spv_shader_gen.h"
+
+namespace Pica::Shader::Generator::SPIRV {
+
+using nihstro::DestRegister;
+using nihstro::Instruction;
+using nihstro::OpCode;
+using nihstro::RegisterType;
+using nihstro::SourceRegister;
+using nihstro::SwizzlePattern;
+using VSOutputAttributes = Pica::RasterizerRegs::VSOutputAttributes;
+
+constexpr u32 SPIRV_VERSION_1_3 = 0x00010300;
+
+VertexStageModule::VertexStageModule() : Sirit::Module{SPIRV_VERSION_1_3} {
+    DefineArithmeticTypes();
+    DefineUniformStructs();
+}
+
+VertexStageModule::~VertexStageModule() = default;
+
+Id VertexStageModule::GetSemantic(const PicaGSConfigState& state, std::span<const Id> attributes,
+                                  VSOutputAttributes::Semantic semantic) {
+    const u32 slot = static_cast<u32>(semantic);
+    const u32 attrib = state.semantic_maps[slot].attribute_index;
+    const u32 comp = state.semantic_maps[slot].component_index;
+    if (attrib < state.gs_output_attributes && attrib < attributes.size()) {
+        return OpCompositeExtract(f32_id, attributes[attrib], comp);
+    }
+    return ConstF32(1.f);
+}
+
+Id VertexStageModule::GetVertexQuaternion(const PicaGSConfigState& state,
+                                          std::span<const Id> attributes) {
+    return OpCompositeConstruct(vec_ids.Get(4),
+                                GetSemantic(state, attributes, VSOutputAttributes::QUATERNION_X),
+                                GetSemantic(state, attributes, VSOutputAttributes::QUATERNION_Y),
+                                GetSemantic(state, attributes, VSOutputAttributes::QUATERNION_Z),
+                                GetSemantic(state, attributes, VSOutputAttributes::QUATERNION_W));
+}
+
+Id VertexStageModule::SanitizeVertex(Id vtx_pos) {
+    const Id z{OpCompositeExtract(f32_id, vtx_pos, 2)};
+    const Id w{OpCompositeExtract(f32_id, vtx_pos, 3)};
+    const Id ndc_z{OpFDiv(f32_id, z, w)};
+
+    const Id near_zero{OpLogicalAnd(bool_id, OpFOrdGreaterThan(bool_id, ndc_z, ConstF32(0.f)),
+                                    OpFOrdLessThan(bool_id, ndc_z, ConstF32(0.000001f)))};
+    const Id near_minus_one{
+        OpLogicalAnd(bool_id, OpFOrdLessThan(bool_id, ndc_z, ConstF32(-1.f)),
+                     OpFOrdGreaterThan(bool_id, ndc_z, ConstF32(-1.00001f)))};
+
+    Id sanitized_z{OpSelect(f32_id, near_zero, ConstF32(0.f), z)};
+    sanitized_z = OpSelect(f32_id, near_minus_one, OpFNegate(f32_id, w), sanitized_z);
+    return OpCompositeInsert(vec_ids.Get(4), sanitized_z, vtx_pos, 2);
+}
+
+void VertexStageModule::WriteVertex(const PicaGSConfigState& state,
+                                    std::span<const Id> attributes, Id normquat) {
+    const auto semantic = [&](VSOutputAttributes::Semantic slot) {
+        return GetSemantic(state, attributes, slot);
+    };
+
+    Id vtx_pos{OpCompositeConstruct(vec_ids.Get(4), semantic(VSOutputAttributes::POSITION_X),
+                                    semantic(VSOutputAttributes::POSITION_Y),
+                                    semantic(VSOutputAttributes::POSITION_Z),
+                                    semantic(VSOutputAttributes::POSITION_W))};
+    vtx_pos = SanitizeVertex(vtx_pos);
+
+    const Id flip_viewport{OpINotEqual(bool_id, GetVSDataMember(u32_id, 1), ConstU32(0u))};
+    const Id pos_y{OpCompositeExtract(f32_id, vtx_pos, 1)};
+    const Id flipped_y{OpSelect(f32_id, flip_viewport, OpFNegate(f32_id, pos_y), pos_y)};
+    vtx_pos = OpCompositeInsert(vec_ids.Get(4), flipped_y, vtx_pos, 1);
+
+    const Id pos_z{OpCompositeExtract(f32_id, vtx_pos, 2)};
+    const Id position{OpCompositeInsert(vec_ids.Get(4), OpFNegate(f32_id, pos_z), vtx_pos, 2)};
+    OpStore(gl_position_id, position);
+
+    if (gl_clip_distance_id.value != 0) {
+        const Id output_ptr{TypePointer(spv::StorageClass::Output, f32_id)};
+        // Fixed PICA clipping plane z <= 0
+        OpStore(OpAccessChain(output_ptr, gl_clip_distance_id, ConstS32(0)),
+                OpFNegate(f32_id, pos_z));
+        const Id enable_clip1{OpINotEqual(bool_id, GetVSDataMember(u32_id, 0), ConstU32(0u))};
+        const Id clip_coef{GetVSDataMember(vec_ids.Get(4), 2)};
+        OpStore(OpAccessChain(output_ptr, gl_clip_distance_id, ConstS32(1)),
+                OpSelect(f32_id, enable_clip1, OpDot(f32_id, clip_coef, vtx_pos), ConstF32(0.f)));
+    }
+
+    OpStore(normquat_id, normquat);
+
+    const Id vtx_color{OpCompositeConstruct(vec_ids.Get(4), semantic(VSOutputAttributes::COLOR_R),
+                                            semantic(VSOutputAttributes::COLOR_G),
+                                            semantic(VSOutputAttributes::COLOR_B),
+                                            semantic(VSOutputAttributes::COLOR_A))};
+    OpStore(primary_color_id, OpFMin(vec_ids.Get(4), OpFAbs(vec_ids.Get(4), vtx_color),
+                                     ConstF32(1.f, 1.f, 1.f, 1.f)));
+
+    OpStore(texcoord_id[0], OpCompositeConstruct(vec_ids.Get(2),
+                                                 semantic(VSOutputAttributes::TEXCOORD0_U),
+                                                 semantic(VSOutputAttributes::TEXCOORD0_V)));
+    OpStore(texcoord_id[1], OpCompositeConstruct(vec_ids.Get(2),
+                                                 semantic(VSOutputAttributes::TEXCOORD1_U),
+                                                 semantic(VSOutputAttributes::TEXCOORD1_V)));
+    OpStore(texcoord0_w_id, semantic(VSOutputAttributes::TEXCOORD0_W));
+    OpStore(view_id, OpCompositeConstruct(vec_ids.Get(3), semantic(VSOutputAttributes::VIEW_X),
+                                          semantic(VSOutputAttributes::VIEW_Y),
+                                          semantic(VSOutputAttributes::VIEW_Z)));
+    OpStore(texcoord_id[2], OpCompositeConstruct(vec_ids.Get(2),
+                                                 semantic(VSOutputAttributes::TEXCOORD2_U),
+                                                 semantic(VSOutputAttributes::TEXCOORD2_V)));
+}
+
+void VertexStageModule::AddVertexEntryPoint(spv::ExecutionModel model, Id main_func) {
+    AddEntryPoint(model, main_func, "main", interface_ids);
+}
+
+void VertexStageModule::DefineArithmeticTypes() {
+    void_id = Name(TypeVoid(), "void_id");
+    bool_id = Name(TypeBool(), "bool_id");
+    f32_id = Name(TypeFloat(32), "f32_id");
+    i32_id = Name(TypeSInt(32), "i32_id");
+    u32_id = Name(TypeUInt(32), "u32_id");
+
+    for (u32 size = 2; size <= 4; size++) {
+        const u32 i = size - 2;
+        vec_ids.ids[i] = Name(TypeVector(f32_id, size), fmt::format("vec{}_id", size));
+        ivec_ids.ids[i] = Name(TypeVector(i32_id, size), fmt::format("ivec{}_id", size));
+        uvec_ids.ids[i] = Name(TypeVector(u32_id, size), fmt::format("uvec{}_id", size));
+        bvec_ids.ids[i] = Name(TypeVector(bool_id, size), fmt::format("bvec{}_id", size));
+    }
+}
+
+void VertexStageModule::DefineUniformStructs() {
+    // Booleans are not allowed in uniform blocks, they are stored as u32 as in VSUniformData
+    const Id vs_data_struct_id{TypeStruct(u32_id, u32_id, vec_ids.Get(4))};
+    constexpr std::array vs_data_offsets{0u, 4u, 16u};
+    for (u32 i = 0; i < static_cast<u32>(vs_data_offsets.size()); i++) {
+        MemberDecorate(vs_data_struct_id, i, spv::Decoration::Offset, vs_data_offsets[i]);
+    }
+    Decorate(vs_data_struct_id, spv::Decoration::Block);
+
+    vs_data_id = AddGlobalVariable(TypePointer(spv::StorageClass::Uniform, vs_data_struct_id),
+                                   spv::StorageClass::Uniform);
+    Decorate(vs_data_id, spv::Decoration::DescriptorSet, 0);
+    Decorate(vs_data_id, spv::Decoration::Binding, 1);
+}
+
+void VertexStageModule::DefineInterface(bool use_clip_planes) {
+    primary_color_id = DefineOutput(vec_ids.Get(4), ATTRIBUTE_COLOR);
+    texcoord_id[0] = DefineOutput(vec_ids.Get(2), ATTRIBUTE_TEXCOORD0);
+    texcoord_id[1] = DefineOutput(vec_ids.Get(2), ATTRIBUTE_TEXCOORD1);
+    texcoord_id[2] = DefineOutput(vec_ids.Get(2), ATTRIBUTE_TEXCOORD2);
+    texcoord0_w_id = DefineOutput(f32_id, ATTRIBUTE_TEXCOORD0_W);
+    normquat_id = DefineOutput(vec_ids.Get(4), ATTRIBUTE_NORMQUAT);
+    view_id = DefineOutput(vec_ids.Get(3), ATTRIBUTE_VIEW);
+
+    gl_position_id = DefineVar(vec_ids.Get(4), spv::StorageClass::Output);
+    Decorate(gl_position_id, spv::Decoration::BuiltIn, spv::BuiltIn::Position);
+    // Apple Silicon GPU drivers optimize more aggressively, which can create
+    // too much variance and cause visual artifacting in games like Pokemon.
+#ifdef __APPLE__
+    Decorate(gl_position_id, spv::Decoration::Invariant);
+#endif
+    interface_ids.push_back(gl_position_id);
+
+    if (use_clip_planes) {
+        AddCapability(spv::Capability::ClipDistance);
+        gl_clip_distance_id =
+            DefineVar(TypeArray(f32_id, ConstU32(2u)), spv::StorageClass::Output);
+        Decorate(gl_clip_distance_id, spv::Decoration::BuiltIn, spv::BuiltIn::ClipDistance);
+        interface_ids.push_back(gl_clip_distance_id);
+    }
+}
+
+VertexModule::VertexModule(const Pica::ShaderSetup& setup_, const PicaVSConfig& config_)
+    : setup{setup_}, config{config_} {
+    AddCapability(spv::Capability::Shader);
+    SetMemoryModel(spv::AddressingModel::Logical, spv::MemoryModel::GLSL450);
+
+    // With a geometry shader the raw output attributes are passed instead
+    if (!config.state.use_geometry_shader) {
+        DefineInterface(config.state.use_clip_planes);
+    }
+
+    const Id ivec4_array_id{TypeArray(uvec_ids.Get(4), ConstU32(4u))};
+    const Id vec4_array_id{TypeArray(vec_ids.Get(4), ConstU32(96u))};
+    Decorate(ivec4_array_id, spv::Decoration::ArrayStride, 16u);
+    Decorate(vec4_array_id, spv::Decoration::ArrayStride, 16u);
+
+    const Id pica_data_struct_id{TypeStruct(u32_id, ivec4_array_id, vec4_array_id)};
+    constexpr std::array pica_data_offsets{0u, 16u, 80u};
+    for (u32 i = 0; i < static_cast<u32>(pica_data_offsets.size()); i++) {
+        MemberDecorate(pica_data_struct_id, i, spv::Decoration::Offset, pica_data_offsets[i]);
+    }
+    Decorate(pica_data_struct_id, spv::Decoration::Block);
+
+    pica_data_id = AddGlobalVariable(TypePointer(spv::StorageClass::Uniform, pica_data_struct_id),
+                                     spv::StorageClass::Uniform);
+    Decorate(pica_data_id, spv::Decoration::DescriptorSet, 0);
+    Decorate(pica_data_id, spv::Decoration::Binding, 0);
+
+    true_id = ConstantTrue(bool_id);
+    false_id = ConstantFalse(bool_id);
+
+    // Registers are private so every subroutine function can access them
+    for (u32 i = 0; i < 16; ++i) {
+        tmp_regs[i] = Name(DefineVar(vec_ids.Get(4), spv::StorageClass::Private),
+                           fmt::format("reg_tmp{}", i));
+    }
+    for (u32 i = 0; i < config.state.num_outputs; ++i) {
+        output_attrs[i] = Name(DefineVar(vec_ids.Get(4), spv::StorageClass::Private),
+                               fmt::format("vs_out_attr{}", i));
+    }
+    for (u32 i = 0; i < 2; ++i) {
+        conditional_code[i] = DefineVar(bool_id, spv::StorageClass::Private);
+    }
+    for (u32 i = 0; i < 3; ++i) {
+        address_registers[i] = DefineVar(i32_id, spv::StorageClass::Private);
+    }
+}
+
+VertexModule::~VertexModule() = default;
+
+void VertexModule::Generate() {
+    subroutines = ControlFlowAnalyzer(setup.program_code, config.state.main_offset)
+                      .MoveSubroutines();
+
+    const Subroutine& program_main = GetSubroutine(config.state.main_offset, PROGRAM_END);
+    EmitSubroutineTree(program_main);
+    EmitMain(program_main);
+}
+
+const Subroutine& VertexModule::GetSubroutine(u32 begin, u32 end) const {
+    auto iter = subroutines.find(Subroutine{begin, end});
+    ASSERT(iter != subroutines.end());
+    return *iter;
+}
+
+u32 VertexModule::NextOffset(u32 offset) const {
+    const Instruction instr = {setup.program_code[offset]};
+    const u32 dest_offset = instr.flow_control.dest_offset;
+    const u32 num_instructions = instr.flow_control.num_instructions;
+
+    switch (instr.opcode.Value()) {
+    case OpCode::Id::END:
+        return PROGRAM_END;
+    case OpCode::Id::CALL: {
+        const auto& call_sub = GetSubroutine(dest_offset, dest_offset + num_instructions);
+        return call_sub.exit_method == ExitMethod::AlwaysEnd ? PROGRAM_END : offset + 1;
+    }
+    case OpCode::Id::IFC:
+    case OpCode::Id::IFU: {
+        if (num_instructions == 0) {
+            return dest_offset;
+        }
+        const auto& if_sub = GetSubroutine(offset + 1, dest_offset);
+        const auto& else_sub = GetSubroutine(dest_offset, dest_offset + num_instructions);
+        if (if_sub.exit_method == ExitMethod::AlwaysEnd &&
+            else_sub.exit_method == ExitMethod::AlwaysEnd) {
+            return PROGRAM_END;
+        }
+        return dest_offset + num_instructions;
+    }
+    case OpCode::Id::LOOP: {
+        const auto& loop_sub = GetSubroutine(offset + 1, dest_offset + 1);
+        return loop_sub.exit_method == ExitMethod::AlwaysEnd ? PROGRAM_END : dest_offset + 1;
+    }
+    default:
+        return offset + 1;
+    }
+}
+
+u32 VertexModule::AnalyzeRange(u32 begin, u32 end, SubroutineInfo& info) const {
+    const auto add_callee = [&info, this](u32 sub_begin, u32 sub_end) {
+        info.callees.push_back(&GetSubroutine(sub_begin, sub_end));
+    };
+
+    u32 program_counter = begin;
+    while (program_counter < (begin > end ? PROGRAM_END : end)) {
+        const Instruction instr = {setup.program_code[program_counter]};
+        const u32 dest_offset = instr.flow_control.dest_offset;
+        const u32 num_instructions = instr.flow_control.num_instructions;
+
+        switch (instr.opcode.Value()) {
+        case OpCode::Id::JMPC:
+        case OpCode::Id::JMPU:
+            // Jumps terminate the case, execution continues at the next one
+            return program_counter + 1;
+        case OpCode::Id::CALL:
+        case OpCode::Id::CALLC:
+        case OpCode::Id::CALLU:
+            add_callee(dest_offset, dest_offset + num_instructions);
+            break;
+        case OpCode::Id::IFC:
+        case OpCode::Id::IFU:
+            add_callee(program_counter + 1, dest_offset);
+            if (num_instructions != 0) {
+                add_callee(dest_offset, dest_offset + num_instructions);
+            }
+            break;
+        case OpCode::Id::LOOP:
+            add_callee(program_counter + 1, dest_offset + 1);
+            info.loops.push_back(program_counter);
+            break;
+        default:
+            break;
+        }
+        program_counter = NextOffset(program_counter);
+    }
+    return program_counter;
+}
+
+VertexModule::SubroutineInfo VertexModule::AnalyzeSubroutine(const Subroutine& subroutine) const {
+    SubroutineInfo info{};
+    if (subroutine.labels.empty()) {
+        AnalyzeRange(subroutine.begin, subroutine.end, info);
+        return info;
+    }
+
+    // Split the code in cases at every label and after every jump.
+    // New labels are always after the current one, so the iteration visits them too.
+    info.labels = subroutine.labels;
+    info.labels.insert(subroutine.begin);
+    for (auto it = info.labels.begin(); it != info.labels.end(); ++it) {
+        const u32 label = *it;
+        const auto next_it = info.labels.upper_bound(label);
+        const u32 next_label = next_it == info.labels.end() ? subroutine.end : *next_it;
+
+        const u32 compile_end = AnalyzeRange(label, next_label, info);
+        if (compile_end != PROGRAM_END && compile_end != next_label) {
+            info.labels.insert(compile_end);
+        }
+    }
+    return info;
+}
+
+void VertexModule::EmitSubroutineTree(const Subroutine& subroutine) {
+    if (subroutine_funcs.contains({subroutine.begin, subroutine.end})) {
+        return;
+    }
+    const SubroutineInfo info = AnalyzeSubroutine(subroutine);
+
+    // Functions are emitted sequentially, so callees have to be defined before their callers
+    for (const Subroutine* callee : info.callees) {
+        EmitSubroutineTree(*callee);
+    }
+    EmitSubroutine(subroutine, info);
+}
+
+void VertexModule::EmitSubroutine(const Subroutine& subroutine, const SubroutineInfo& info) {
+    const Id func_type{TypeFunction(bool_id)};
+    const Id func{OpFunction(bool_id, spv::FunctionControlMask::MaskNone, func_type)};
+    Name(func, subroutine.GetName());
+    subroutine_funcs.emplace(std::make_pair(subroutine.begin, subroutine.end), func);
+    BeginBlock(OpLabel());
+
+    // Variables have to be declared in the first block of the function
+    loop_counters.clear();
+    for (const u32 loop_offset : info.loops) {
+        loop_counters.emplace(loop_offset, DefineVar<false>(u32_id, spv::StorageClass::Function));
+    }
+
+    if (info.labels.empty()) {
+        const u32 compile_end = CompileRange(subroutine.begin, subroutine.end);
+        if (!block_terminated) {
+            Return(compile_end == PROGRAM_END);
+        }
+        OpFunctionEnd();
+        return;
+    }
+
+    jmp_to_id = DefineVar<false>(u32_id, spv::StorageClass::Function);
+    OpStore(jmp_to_id, ConstU32(subroutine.begin));
+
+    const Id loop_header{OpLabel()};
+    const Id loop_body{OpLabel()};
+    const Id continue_label{OpLabel()};
+    const Id loop_merge{OpLabel()};
+    OpBranch(loop_header);
+    BeginBlock(loop_header);
+    OpLoopMerge(loop_merge, continue_label, spv::LoopControlMask::MaskNone);
+    OpBranch(loop_body);
+    BeginBlock(loop_body);
+
+    // Each label is a case of a switch over the jump target, mirroring the GLSL decompiler
+    boost::container::small_vector<Sirit::Literal, 16> literals;
+    boost::container::small_vector<Id, 16> case_labels;
+    for (const u32 label : info.labels) {
+        literals.emplace_back(label);
+        case_labels.push_back(OpLabel());
+    }
+    const Id default_label{OpLabel()};
+    switch_merge_label = OpLabel();
+    OpSelectionMerge(switch_merge_label, spv::SelectionControlMask::MaskNone);
+    OpSwitch(OpLoad(u32_id, jmp_to_id), default_label, literals, case_labels);
+
+    std::size_t case_index = 0;
+    for (auto it = info.labels.begin(); it != info.labels.end(); ++it, ++case_index) {
+        BeginBlock(case_labels[case_index]);
+
+        const auto next_it = std::next(it);
+        const u32 next_label = next_it == info.labels.end() ? subroutine.end : *next_it;
+        const u32 compile_end = CompileRange(*it, next_label);
+        if (block_terminated) {
+            continue;
+        }
+
+        if (compile_end == PROGRAM_END) {
+            Return(true);
+        } else if (compile_end != next_label) {
+            // This happens only when there is a label inside a IF/LOOP block
+            OpStore(jmp_to_id, ConstU32(compile_end));
+            BranchIfOpen(switch_merge_label);
+        } else if (next_it != info.labels.end()) {
+            OpStore(jmp_to_id, ConstU32(next_label));
+            BranchIfOpen(switch_merge_label);
+        } else {
+            Return(false);
+        }
+    }
+
+    BeginBlock(default_label);
+    Return(false);
+
+    BeginBlock(switch_merge_label);
+    OpBranch(continue_label);
+    BeginBlock(continue_label);
+    OpBranch(loop_header);
+
+    // The jump table loop is only left by returning
+    BeginBlock(loop_merge);
+    OpUnreachable();
+    OpFunctionEnd();
+}
+
+void VertexModule::EmitMain(const Subroutine& program_main) {
+    const Id main_type{TypeFunction(void_id)};
+    const Id main_func{OpFunction(void_id, spv::FunctionControlMask::MaskNone, main_type)};
+    AddLabel(OpLabel());
+
+    // Convert the used vertex attributes to float
+    for (u32 i = 0; i < 16; ++i) {
+        if (input_regs[i].value == 0) {
+            continue;
+        }
+        const auto flags = config.state.load_flags[i];
+        const bool is_float = True(flags & AttribLoadFlags::Float);
+        Id value{};
+        if (!is_float && True(flags & AttribLoadFlags::Sint)) {
+            value = OpConvertSToF(vec_ids.Get(4),
+                                  OpLoad(ivec_ids.Get(4), DefineInput(ivec_ids.Get(4), i)));
+        } else if (!is_float && True(flags & AttribLoadFlags::Uint)) {
+            value = OpConvertUToF(vec_ids.Get(4),
+                                  OpLoad(uvec_ids.Get(4), DefineInput(uvec_ids.Get(4), i)));
+        } else {
+            value = OpLoad(vec_ids.Get(4), DefineInput(vec_ids.Get(4), i));
+        }
+        if (True(flags & AttribLoadFlags::ZeroW)) {
+            value = OpCompositeInsert(vec_ids.Get(4), ConstF32(0.f), value, 3);
+        }
+        OpStore(input_regs[i], value);
+    }
+
+    const Id default_reg{ConstF32(0.f, 0.f, 0.f, 1.f)};
+    for (u32 i = 0; i < 16; ++i) {
+        OpStore(tmp_regs[i], default_reg);
+    }
+    for (u32 i = 0; i < config.state.num_outputs; ++i) {
+        OpStore(output_attrs[i], default_reg);
+    }
+    for (const Id cond : conditional_code) {
+        OpStore(cond, false_id);
+    }
+    for (const Id address_register : address_registers) {
+        OpStore(address_register, ConstS32(0));
+    }
+
+    OpFunctionCall(bool_id, subroutine_funcs.at({program_main.begin, program_main.end}));
+
+    std::array<Id, 16> attributes{};
+    for (u32 i = 0; i < config.state.num_outputs; ++i) {
+        attributes[i] = OpLoad(vec_ids.Get(4), output_attrs[i]);
+    }
+
+    if (config.state.use_geometry_shader) {
+        // The geometry shader assembles the vertex from the raw output attributes
+        for (u32 i = 0; i < config.state.num_outputs; ++i) {
+            OpStore(DefineOutput(vec_ids.Get(4), i), attributes[i]);
+        }
+    } else {
+        const std::span attribute_span{attributes.data(), config.state.num_outputs};
+        WriteVertex(config.state.gs_state, attribute_span,
+                    GetVertexQuaternion(config.state.gs_state, attribute_span));
+    }
+
+    OpReturn();
+    OpFunctionEnd();
+
+    AddVertexEntryPoint(spv::ExecutionModel::Vertex, main_func);
+}
+
+u32 VertexModule::CompileRange(u32 begin, u32 end) {
+    u32 program_counter;
+    for (program_counter = begin; program_counter < (begin > end ? PROGRAM_END : end);) {
+        program_counter = CompileInstr(program_counter);
+        if (block_terminated) {
+            break;
+        }
+    }
+    return program_counter;
+}
+
+void VertexModule::BeginBlock(Id label) {
+    AddLabel(label);
+    block_terminated = false;
+}
+
+void VertexModule::BranchIfOpen(Id label) {
+    if (!block_terminated) {
+        OpBranch(label);
+        block_terminated = true;
+    }
+}
+
+void VertexModule::Return(bool program_ended) {
+    OpReturnValue(program_ended ? true_id : false_id);
+    block_terminated = true;
+}
+
+void VertexModule::CallSubroutine(const Subroutine& subroutine) {
+    const Id func{subroutine_funcs.at({subroutine.begin, subroutine.end})};
+    const Id result{OpFunctionCall(bool_id, func)};
+    if (subroutine.exit_method == ExitMethod::AlwaysEnd) {
+        Return(true);
+    } else if (subroutine.exit_method == ExitMethod::Conditional) {
+        EmitIf(result, [this] { Return(true); });
+    }
+}
+
+Id VertexModule::EvaluateCondition(Instruction::FlowControlType flow_control) {
+    using Op = Instruction::FlowControlType::Op;
+
+    const auto get_result = [this](u32 index, bool ref) {
+        const Id cond{OpLoad(bool_id, conditional_code[index])};
+        return ref ? cond : OpLogicalNot(bool_id, cond);
+    };
+
+    switch (flow_control.op) {
+    case Op::JustX:
+        return get_result(0, flow_control.refx.Value());
+    case Op::JustY:
+        return get_result(1, flow_control.refy.Value());
+    case Op::Or:
+        return OpLogicalOr(bool_id, get_result(0, flow_control.refx.Value()),
+                           get_result(1, flow_control.refy.Value()));
+    case Op::And:
+        return OpLogicalAnd(bool_id, get_result(0, flow_control.refx.Value()),
+                            get_result(1, flow_control.refy.Value()));
+    default:
+        UNREACHABLE();
+        return false_id;
+    }
+}
+
+Id VertexModule::GetUniformBool(u32 index, bool invert_test) {
+    const Id masked{OpBitwiseAnd(u32_id, GetPicaDataMember(u32_id, ConstS32(0)),
+                                 ConstU32(1u << index))};
+    return invert_test ? OpIEqual(bool_id, masked, ConstU32(0u))
+                       : OpINotEqual(bool_id, masked, ConstU32(0u));
+}
+
+Id VertexModule::GetOffsetRegister(u32 base_index, Id offset) {
+    const Id in_range{OpLogicalAnd(bool_id, OpSGreaterThanEqual(bool_id, offset, ConstS32(-128)),
+                                   OpSLessThanEqual(bool_id, offset, ConstS32(127)))};
+    const Id fixed_offset{OpSelect(i32_id, in_range, offset, ConstS32(0))};
+    const Id base{ConstS32(static_cast<s32>(base_index))};
+    const Id index{OpBitcast(
+        u32_id, OpBitwiseAnd(i32_id, OpIAdd(i32_id, base, fixed_offset), ConstS32(0x7F)))};
+
+    // Clamp the index used for the access, out of range registers read as vec4(1.0)
+    const Id is_valid{OpULessThan(bool_id, index, ConstU32(96u))};
+    const Id safe_index{OpSelect(u32_id, is_valid, index, ConstU32(0u))};
+    const Id value{GetPicaDataMember(vec_ids.Get(4), ConstS32(2), safe_index)};
+    return OpSelect(vec_ids.Get(4), SplatBool(is_valid), value, ConstF32(1.f, 1.f, 1.f, 1.f));
+}
+
+Id VertexModule::GetSourceRegister(const SourceRegister& source_reg, u32 address_register_index) {
+    const u32 index = static_cast<u32>(source_reg.GetIndex());
+
+    switch (source_reg.GetRegisterType()) {
+    case RegisterType::Input:
+        ASSERT(index < 16);
+        if (input_regs[index].value == 0) {
+            input_regs[index] = Name(DefineVar(vec_ids.Get(4), spv::StorageClass::Private),
+                                     fmt::format("vs_in_reg{}", index));
+        }
+        return OpLoad(vec_ids.Get(4), input_regs[index]);
+    case RegisterType::Temporary:
+        return OpLoad(vec_ids.Get(4), tmp_regs[index]);
+    case RegisterType::FloatUniform:
+        if (address_register_index != 0) {
+            return GetOffsetRegister(
+                index, OpLoad(i32_id, address_registers[address_register_index - 1]));
+        }
+        return GetPicaDataMember(vec_ids.Get(4), ConstS32(2), ConstS32(index));
+    default:
+        UNREACHABLE();
+        return Id{};
+    }
+}
+
+Id VertexModule::GetSource(const SourceRegister& source_reg, u32 address_register_index,
+                           const SwizzlePattern& swizzle, u32 src_num) {
+    using SelectorGetter = SwizzlePattern::Selector (SwizzlePattern::*)(int) const;
+    static constexpr std::array<SelectorGetter, 3> selector_getters{
+        &SwizzlePattern::GetSelectorSrc1,
+        &SwizzlePattern::GetSelectorSrc2,
+        &SwizzlePattern::GetSelectorSrc3,
+    };
+    const SelectorGetter getter = selector_getters[src_num - 1];
+    bool negate{};
+    switch (src_num) {
+    case 1:
+        negate = swizzle.negate_src1;
+        break;
+    case 2:
+        negate = swizzle.negate_src2;
+        break;
+    default:
+        negate = swizzle.negate_src3;
+        break;
+    }
+
+    const Id reg{GetSourceRegister(source_reg, address_register_index)};
+    const Id value{OpVectorShuffle(vec_ids.Get(4), reg, reg,
+                                   static_cast<u32>((swizzle.*getter)(0)),
+                                   static_cast<u32>((swizzle.*getter)(1)),
+                                   static_cast<u32>((swizzle.*getter)(2)),
+                                   static_cast<u32>((swizzle.*getter)(3)))};
+    return negate ? OpFNegate(vec_ids.Get(4), value) : value;
+}
+
+Id VertexModule::GetOutputRegister(u32 index) {
+    ASSERT(index < 16);
+    const u32 attribute = config.state.output_map[index];
+    if (attribute < config.state.num_outputs) {
+        return output_attrs[attribute];
+    }
+    return Id{};
+}
+
+Id VertexModule::GetDestRegister(const DestRegister& dest_reg) {
+    const u32 index = static_cast<u32>(dest_reg.GetIndex());
+
+    switch (dest_reg.GetRegisterType()) {
+    case RegisterType::Output:
+        return GetOutputRegister(index);
+    case RegisterType::Temporary:
+        return tmp_regs[index];
+    default:
+        UNREACHABLE();
+        return Id{};
+    }
+}
+
+void VertexModule::SetDest(const SwizzlePattern& swizzle, Id reg, Id value, bool is_scalar) {
+    std::array<u32, 4> components{};
+    bool any_enabled = false;
+    for (u32 i = 0; i < 4; ++i) {
+        const bool enabled = swizzle.DestComponentEnabled(static_cast<int>(i));
+        components[i] = enabled ? 4 + i : i;
+        any_enabled |= enabled;
+    }
+    if (reg.value == 0 || !any_enabled) {
+        return;
+    }
+
+    if (is_scalar) {
+        value = OpCompositeConstruct(vec_ids.Get(4), value, value, value, value);
+    }
+    const Id old_value{OpLoad(vec_ids.Get(4), reg)};
+    OpStore(reg, OpVectorShuffle(vec_ids.Get(4), old_value, value, components[0], components[1],
+                                 components[2], components[3]));
+}
+
+Id VertexModule::SanitizeMul(Id lhs, Id rhs) {
+    const Id vec4_id{vec_ids.Get(4)};
+    const Id product{OpFMul(vec4_id, lhs, rhs)};
+    const Id zero{ConstF32(0.f, 0.f, 0.f, 0.f)};
+    const Id rhs_nan{OpSelect(vec4_id, OpIsNan(bvec_ids.Get(4), rhs), product, zero)};
+    const Id lhs_nan{OpSelect(vec4_id, OpIsNan(bvec_ids.Get(4), lhs), product, rhs_nan)};
+    return OpSelect(vec4_id, OpIsNan(bvec_ids.Get(4), product), lhs_nan, product);
+}
+
+u32 VertexModule::CompileInstr(u32 offset) {
+    const Instruction instr = {setup.program_code[offset]};
+    const OpCode opcode = instr.opcode.Value();
+    const bool sanitize_mul = config.state.sanitize_mul;
+    const Id vec4_id{vec_ids.Get(4)};
+
+    std::size_t swizzle_offset = opcode.GetInfo().type == OpCode::Type::MultiplyAdd
+                                     ? instr.mad.operand_desc_id
+                                     : instr.common.operand_desc_id;
+    const SwizzlePattern swizzle = {setup.swizzle_data[swizzle_offset]};
+
+    switch (opcode.GetInfo().type) {
+    case OpCode::Type::Arithmetic: {
+        const bool is_inverted = (0 != (opcode.GetInfo().subtype & OpCode::Info::SrcInversed));
+
+        const auto src1 = [&] {
+            return GetSource(instr.common.GetSrc1(is_inverted),
+                             !is_inverted * instr.common.address_register_index, swizzle, 1);
+        };
+        const auto src2 = [&] {
+            return GetSource(instr.common.GetSrc2(is_inverted),
+                             is_inverted * instr.common.address_register_index, swizzle, 2);
+        };
+        const auto dest_reg = [&] { return GetDestRegister(instr.common.dest.Value()); };
+
+        switch (opcode.EffectiveOpCode()) {
+        case OpCode::Id::ADD:
+            SetDest(swizzle, dest_reg(), OpFAdd(vec4_id, src1(), src2()), false);
+            break;
+        case OpCode::Id::MUL: {
+            const Id lhs{src1()};
+            const Id rhs{src2()};
+            SetDest(swizzle, dest_reg(),
+                    sanitize_mul ? SanitizeMul(lhs, rhs) : OpFMul(vec4_id, lhs, rhs), false);
+            break;
+        }
+        case OpCode::Id::FLR:
+            SetDest(swizzle, dest_reg(), OpFloor(vec4_id, src1()), false);
+            break;
+        case OpCode::Id::MAX: {
+            const Id lhs{src1()};
+            const Id rhs{src2()};
+            const Id result{sanitize_mul
+                                ? OpSelect(vec4_id, OpFOrdGreaterThan(bvec_ids.Get(4), lhs, rhs),
+                                           lhs, rhs)
+                                : OpFMax(vec4_id, lhs, rhs)};
+            SetDest(swizzle, dest_reg(), result, false);
+            break;
+        }
+        case OpCode::Id::MIN: {
+            const Id lhs{src1()};
+            const Id rhs{src2()};
+            const Id result{sanitize_mul
+                                ? OpSelect(vec4_id, OpFOrdLessThan(bvec_ids.Get(4), lhs, rhs),
+                                           lhs, rhs)
+                                : OpFMin(vec4_id, lhs, rhs)};
+            SetDest(swizzle, dest_reg(), result, false);
+            break;
+        }
+        case OpCode::Id::DP3:
+        case OpCode::Id::DP4:
+        case OpCode::Id::DPH:
+        case OpCode::Id::DPHI: {
+            const OpCode::Id effective = opcode.EffectiveOpCode();
+            Id lhs{src1()};
+            const Id rhs{src2()};
+            if (effective == OpCode::Id::DPH || effective == OpCode::Id::DPHI) {
+                // The homogeneous dot product treats src1.w as 1.0, as the interpreter does
+                lhs = OpCompositeInsert(vec4_id, ConstF32(1.f), lhs, 3);
+            }
+
+            Id dot{};
+            if (effective == OpCode::Id::DP3) {
+                const Id vec3_id{vec_ids.Get(3)};
+                if (sanitize_mul) {
+                    const Id product{SanitizeMul(lhs, rhs)};
+                    dot = OpDot(f32_id, OpVectorShuffle(vec3_id, product, product, 0, 1, 2),
+                                ConstF32(1.f, 1.f, 1.f));
+                } else {
+                    dot = OpDot(f32_id, OpVectorShuffle(vec3_id, lhs, lhs, 0, 1, 2),
+                                OpVectorShuffle(vec3_id, rhs, rhs, 0, 1, 2));
+                }
+            } else if (sanitize_mul) {
+                dot = OpDot(f32_id, SanitizeMul(lhs, rhs), ConstF32(1.f, 1.f, 1.f, 1.f));
+            } else {
+                dot = OpDot(f32_id, lhs, rhs);
+            }
+            SetDest(swizzle, dest_reg(), dot, true);
+            break;
+        }
+        case OpCode::Id::RCP:
+        case OpCode::Id::RSQ: {
+            const bool is_rcp = opcode.EffectiveOpCode() == OpCode::Id::RCP;
+            const Id x{OpCompositeExtract(f32_id, src1(), 0)};
+            const auto write = [&] {
+                const Id result{is_rcp ? OpFDiv(f32_id, ConstF32(1.f), x)
+                                       : OpInverseSqrt(f32_id, x)};
+                SetDest(swizzle, dest_reg(), result, true);
+            };
+            if (sanitize_mul) {
+                write();
+                break;
+            }
+            // When accurate multiplication is OFF, NaN are not really handled. This is a
+            // workaround to cheaply avoid NaN. Fixes graphical issues in Ocarina of Time.
+            const Id condition{is_rcp ? OpFUnordNotEqual(bool_id, x, ConstF32(0.f))
+                                      : OpFOrdGreaterThan(bool_id, x, ConstF32(0.f))};
+            EmitIf(condition, write);
+            break;
+        }
+        case OpCode::Id::MOVA: {
+            const Id value{src1()};
+            for (u32 i = 0; i < 2; ++i) {
+                if (swizzle.DestComponentEnabled(static_cast<int>(i))) {
+                    OpStore(address_registers[i],
+                            OpConvertFToS(i32_id, OpCompositeExtract(f32_id, value, i)));
+                }
+            }
+            break;
+        }
+        case OpCode::Id::MOV:
+            SetDest(swizzle, dest_reg(), src1(), false);
+            break;
+        case OpCode::Id::SGE:
+        case OpCode::Id::SGEI:
+        case OpCode::Id::SLT:
+        case OpCode::Id::SLTI: {
+            const OpCode::Id effective = opcode.EffectiveOpCode();
+            const bool is_sge = effective == OpCode::Id::SGE || effective == OpCode::Id::SGEI;
+            const Id lhs{src1()};
+            const Id rhs{src2()};
+            const Id result{is_sge ? OpFOrdGreaterThanEqual(bvec_ids.Get(4), lhs, rhs)
+                                   : OpFOrdLessThan(bvec_ids.Get(4), lhs, rhs)};
+            SetDest(swizzle, dest_reg(),
+                    OpSelect(vec4_id, result, ConstF32(1.f, 1.f, 1.f, 1.f),
+                             ConstF32(0.f, 0.f, 0.f, 0.f)),
+                    false);
+            break;
+        }
+        case OpCode::Id::CMP: {
+            using CompareOp = Instruction::Common::CompareOpType::Op;
+            const Id lhs{src1()};
+            const Id rhs{src2()};
+            const auto compare = [&](CompareOp op, u32 component) -> Id {
+                const Id a{OpCompositeExtract(f32_id, lhs, component)};
+                const Id b{OpCompositeExtract(f32_id, rhs, component)};
+                switch (op) {
+                case CompareOp::Equal:
+                    return OpFOrdEqual(bool_id, a, b);
+                case CompareOp::NotEqual:
+                    return OpFUnordNotEqual(bool_id, a, b);
+                case CompareOp::LessThan:
+                    return OpFOrdLessThan(bool_id, a, b);
+                case CompareOp::LessEqual:
+                    return OpFOrdLessThanEqual(bool_id, a, b);
+                case CompareOp::GreaterThan:
+                    return OpFOrdGreaterThan(bool_id, a, b);
+                case CompareOp::GreaterEqual:
+                    return OpFOrdGreaterThanEqual(bool_id, a, b);
+                default:
+                    LOG_ERROR(HW_GPU, "Unknown compare mode {:x}", op);
+                    return Id{};
+                }
+            };
+
+            const Id result_x{compare(instr.common.compare_op.x.Value(), 0)};
+            const Id result_y{compare(instr.common.compare_op.y.Value(), 1)};
+            if (result_x.value != 0 && result_y.value != 0) {
+                OpStore(conditional_code[0], result_x);
+                OpStore(conditional_code[1], result_y);
+            }
+            break;
+        }
+        case OpCode::Id::EX2:
+            SetDest(swizzle, dest_reg(),
+                    OpExp2(f32_id, OpCompositeExtract(f32_id, src1(), 0)), true);
+            break;
+        case OpCode::Id::LG2:
+            SetDest(swizzle, dest_reg(),
+                    OpLog2(f32_id, OpCompositeExtract(f32_id, src1(), 0)), true);
+            break;
+        default:
+            LOG_ERROR(HW_GPU, "Unhandled arithmetic instruction: 0x{:02x} ({}): 0x{:08x}",
+                      (int)opcode.EffectiveOpCode(), opcode.GetInfo().name, instr.hex);
+            throw DecompileFail("Unhandled instruction");
+        }
+        break;
+    }
+
+    case OpCode::Type::MultiplyAdd: {
+        if ((opcode.EffectiveOpCode() != OpCode::Id::MAD) &&
+            (opcode.EffectiveOpCode() != OpCode::Id::MADI)) {
+            LOG_ERROR(HW_GPU, "Unhandled multiply-add instruction: 0x{:02x} ({}): 0x{:08x}",
+                      (int)opcode.EffectiveOpCode(), opcode.GetInfo().name, instr.hex);
+            throw DecompileFail("Unhandled instruction");
+        }
+
+        const bool is_inverted = (opcode.EffectiveOpCode() == OpCode::Id::MADI);
+        const Id src1{GetSource(instr.mad.GetSrc1(is_inverted), 0, swizzle, 1)};
+        const Id src2{GetSource(instr.mad.GetSrc2(is_inverted),
+                                !is_inverted * instr.mad.address_register_index, swizzle, 2)};
+        const Id src3{GetSource(instr.mad.GetSrc3(is_inverted),
+                                is_inverted * instr.mad.address_register_index, swizzle, 3)};
+
+        const u32 dest_index = static_cast<u32>(instr.mad.dest.Value().GetIndex());
+        const Id dest_reg{(instr.mad.dest.Value() < 0x10)   ? GetOutputRegister(dest_index)
+                          : (instr.mad.dest.Value() < 0x20) ? tmp_regs[dest_index]
+                                                            : Id{}};
+
+        const Id product{sanitize_mul ? SanitizeMul(src1, src2) : OpFMul(vec4_id, src1, src2)};
+        SetDest(swizzle, dest_reg, OpFAdd(vec4_id, product, src3), false);
+        break;
+    }
+
+    default: {
+        const u32 dest_offset = instr.flow_control.dest_offset;
+        const u32 num_instructions = instr.flow_control.num_instructions;
+
+        switch (opcode) {
+        case OpCode::Id::END:
+            Return(true);
+            break;
+
+        case OpCode::Id::JMPC:
+        case OpCode::Id::JMPU: {
+            Id condition{};
+            if (opcode == OpCode::Id::JMPC) {
+                condition = EvaluateCondition(instr.flow_control);
+            } else {
+                const bool invert_test = num_instructions & 1;
+                condition = GetUniformBool(instr.flow_control.bool_uniform_id, invert_test);
+            }
+
+            // Leave the case selecting either the jump target or the next instruction
+            OpStore(jmp_to_id, OpSelect(u32_id, condition, ConstU32(dest_offset),
+                                        ConstU32(offset + 1)));
+            BranchIfOpen(switch_merge_label);
+            return offset + 1;
+        }
+
+        case OpCode::Id::CALL:
+        case OpCode::Id::CALLC:
+        case OpCode::Id::CALLU: {
+            const auto& call_sub = GetSubroutine(dest_offset, dest_offset + num_instructions);
+            if (opcode == OpCode::Id::CALL) {
+                CallSubroutine(call_sub);
+                break;
+            }
+
+            const Id condition{opcode == OpCode::Id::CALLC
+                                   ? EvaluateCondition(instr.flow_control)
+                                   : GetUniformBool(instr.flow_control.bool_uniform_id)};
+            EmitIf(condition, [&] { CallSubroutine(call_sub); });
+            break;
+        }
+
+        case OpCode::Id::NOP:
+            break;
+
+        case OpCode::Id::IFC:
+        case OpCode::Id::IFU: {
+            const Id condition{opcode == OpCode::Id::IFC
+                                   ? EvaluateCondition(instr.flow_control)
+                                   : GetUniformBool(instr.flow_control.bool_uniform_id)};
+
+            const u32 else_offset = dest_offset;
+            const u32 endif_offset = dest_offset + num_instructions;
+            const auto& if_sub = GetSubroutine(offset + 1, else_offset);
+
+            if (num_instructions == 0) {
+                EmitIf(condition, [&] { CallSubroutine(if_sub); });
+                break;
+            }
+
+            const auto& else_sub = GetSubroutine(else_offset, endif_offset);
+            const Id then_label{OpLabel()};
+            const Id else_label{OpLabel()};
+            const Id merge_label{OpLabel()};
+            OpSelectionMerge(merge_label, spv::SelectionControlMask::MaskNone);
+            OpBranchConditional(condition, then_label, else_label);
+            BeginBlock(then_label);
+            CallSubroutine(if_sub);
+            BranchIfOpen(merge_label);
+            BeginBlock(else_label);
+            CallSubroutine(else_sub);
+            BranchIfOpen(merge_label);
+            BeginBlock(merge_label);
+            break;
+        }
+
+        case OpCode::Id::LOOP: {
+            const u32 int_uniform = instr.flow_control.int_uniform_id.Value();
+            const auto get_int_uniform = [&](u32 component) {
+                return GetPicaDataMember(u32_id, ConstS32(1), ConstS32(int_uniform),
+                                         ConstU32(component));
+            };
+            OpStore(address_registers[2], OpBitcast(i32_id, get_int_uniform(1)));
+
+            const Id loop_counter{loop_counters.at(offset)};
+            OpStore(loop_counter, ConstU32(0u));
+
+            const Id header_label{OpLabel()};
+            const Id body_label{OpLabel()};
+            const Id continue_label{OpLabel()};
+            const Id merge_label{OpLabel()};
+            OpBranch(header_label);
+            BeginBlock(header_label);
+            OpLoopMerge(merge_label, continue_label, spv::LoopControlMask::MaskNone);
+            const Id condition{OpULessThanEqual(bool_id, OpLoad(u32_id, loop_counter),
+                                                get_int_uniform(0))};
+            OpBranchConditional(condition, body_label, merge_label);
+
+            BeginBlock(body_label);
+            CallSubroutine(GetSubroutine(offset + 1, dest_offset + 1));
+            BranchIfOpen(continue_label);
+
+            BeginBlock(continue_label);
+            const Id address_register{OpLoad(i32_id, address_registers[2])};
+            OpStore(address_registers[2],
+                    OpIAdd(i32_id, address_register, OpBitcast(i32_id, get_int_uniform(2))));
+            OpStore(loop_counter, OpIAdd(u32_id, OpLoad(u32_id, loop_counter), ConstU32(1u)));
+            OpBranch(header_label);
+
+            BeginBlock(merge_label);
+            break;
+        }
+
+        case OpCode::Id::EMIT:
+        case OpCode::Id::SETEMIT:
+            LOG_ERROR(HW_GPU, "Geometry shader operation detected in vertex shader");
+            break;
+
+        default:
+            LOG_ERROR(HW_GPU, "Unhandled instruction: 0x{:02x} ({}): 0x{:08x}",
+                      (int)opcode.EffectiveOpCode(), opcode.GetInfo().name, instr.hex);
+            throw DecompileFail("Unhandled instruction");
+        }
+        break;
+    }
+    }
+
+    const u32 next_offset = NextOffset(offset);
+    if (next_offset == PROGRAM_END && !block_terminated) {
+        // Every path of the instruction ended the program, the merge block is unreachable
+        OpUnreachable();
+        block_terminated = true;
+    }
+    return next_offset;
+}
+
+GeometryModule::GeometryModule(const PicaFixedGSConfig& config_)
+    : config{config_} {
+    AddCapability(spv::Capability::Shader);
+    AddCapability(spv::Capability::Geometry);
+    SetMemoryModel(spv::AddressingModel::Logical, spv::MemoryModel::GLSL450);
+    DefineInterface(config.state.use_clip_planes);
+
+    const Id attribute_array_id{TypeArray(vec_ids.Get(4), ConstU32(3u))};
+    for (u32 i = 0; i < config.state.vs_output_attributes; ++i) {
+        vs_out_attrs.push_back(DefineInput(attribute_array_id, i));
+    }
+}
+
+GeometryModule::~GeometryModule() = default;
+
+void GeometryModule::Generate() {
+    const Id main_type{TypeFunction(void_id)};
+    const Id main_func{OpFunction(void_id, spv::FunctionControlMask::MaskNone, main_type)};
+    AddLabel(OpLabel());
+
+    const PicaGSConfigState& state = config.state;
+    const Id input_ptr{TypePointer(spv::StorageClass::Input, vec_ids.Get(4))};
+    std::array<std::vector<Id>, 3> attributes;
+    for (u32 vtx = 0; vtx < 3; ++vtx) {
+        for (u32 i = 0; i < state.gs_output_attributes; ++i) {
+            attributes[vtx].push_back(
+                i < vs_out_attrs.size()
+                    ? OpLoad(vec_ids.Get(4), OpAccessChain(input_ptr, vs_out_attrs[i],
+                                                           ConstS32(static_cast<s32>(vtx))))
+                    : ConstF32(0.f, 0.f, 0.f, 0.f));
+        }
+    }
+
+    const Id first_quat{GetVertexQuaternion(state, attributes[0])};
+    for (u32 vtx = 0; vtx < 3; ++vtx) {
+        Id normquat{first_quat};
+        if (vtx != 0) {
+            // Flip quaternions facing the opposite direction of the first one
+            const Id vtx_quat{GetVertexQuaternion(state, attributes[vtx])};
+            const Id quats_opposite{
+                OpFOrdLessThan(bool_id, OpDot(f32_id, first_quat, vtx_quat), ConstF32(0.f))};
+            normquat = OpSelect(vec_ids.Get(4), SplatBool(quats_opposite),
+                                OpFNegate(vec_ids.Get(4), vtx_quat), vtx_quat);
+        }
+        WriteVertex(state, attributes[vtx], normquat);
+        OpEmitVertex();
+    }
+    OpEndPrimitive();
+
+    OpReturn();
+    OpFunctionEnd();
+
+    AddVertexEntryPoint(spv::ExecutionModel::Geometry, main_func);
+    AddExecutionMode(main_func, spv::ExecutionMode::Triangles);
+    AddExecutionMode(main_func, spv::ExecutionMode::OutputTriangleStrip);
+    AddExecutionMode(main_func, spv::ExecutionMode::OutputVertices, 3u);
+    AddExecutionMode(main_func, spv::ExecutionMode::Invocations, 1u);
+}
+
+std::vector<u32> GenerateVertexShader(const Pica::ShaderSetup& setup, const PicaVSConfig& config) {
+    try {
+        VertexModule module{setup, config};
+        module.Generate();
+        return module.Assemble();
+    } catch (const DecompileFail& exception) {
+        LOG_INFO(HW_GPU, "Shader decompilation failed: {}", exception.what());
+        return {};
+    }
+}
+
+std::vector<u32> GenerateFixedGeometryShader(const PicaFixedGSConfig& config) {
+    GeometryModule module{config};
+    module.Generate();
+    return module.Assemble();
+}
+
+} // namespace Pica::Shader::Generator::SPIRV
@@ -0,0 +1,299 @@
+// Copyright Citra Emulator Project / Azahar Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <map>
+#include <set>
+#include <span>
+#include <vector>
+#include <nihstro/shader_bytecode.h>
+#include <sirit/sirit.h>
+
+#include "video_core/pica/regs_rasterizer.h"
+#include "video_core/shader/generator/pica_control_flow.h"
+#include "video_core/shader/generator/shader_gen.h"
+#include "video_core/shader/generator/spv_fs_shader_gen.h"
+
+namespace Pica::Shader::Generator::SPIRV {
+
+/// Common state of the vertex pipeline modules: arithmetic types, the vs_data uniform block and
+/// the output interface consumed by the fragment shader.
+class VertexStageModule : public Sirit::Module {
+protected:
+    VertexStageModule();
+    ~VertexStageModule();
+
+    /// Defines the outputs read by the fragment shader and the position built-ins
+    void DefineInterface(bool use_clip_planes);
+
+    /// Writes a vertex to the output interface from its output attribute values
+    void WriteVertex(const PicaGSConfigState& state, std::span<const Id> attributes, Id normquat);
+
+    /// Returns the quaternion of a vertex from its output attribute values
+    [[nodiscard]] Id GetVertexQuaternion(const PicaGSConfigState& state,
+                                         std::span<const Id> attributes);
+
+    /// Returns the value of the output attribute mapped to the provided semantic
+    [[nodiscard]] Id GetSemantic(const PicaGSConfigState& state, std::span<const Id> attributes,
+                                 Pica::RasterizerRegs::VSOutputAttributes::Semantic semantic);
+
+    /// Snaps depth values that are slightly outside the clip volume back inside
+    [[nodiscard]] Id SanitizeVertex(Id vtx_pos);
+
+    /// Loads the member specified from the vs_data uniform struct
+    [[nodiscard]] Id GetVSDataMember(Id type, u32 member) {
+        const Id uniform_ptr{TypePointer(spv::StorageClass::Uniform, type)};
+        return OpLoad(type, OpAccessChain(uniform_ptr, vs_data_id, ConstS32(member)));
+    }
+
+    /// Defines a input variable
+    [[nodiscard]] Id DefineInput(Id type, u32 location) {
+        const Id input_id{DefineVar(type, spv::StorageClass::Input)};
+        Decorate(input_id, spv::Decoration::Location, location);
+        interface_ids.push_back(input_id);
+        return input_id;
+    }
+
+    /// Defines a output variable
+    [[nodiscard]] Id DefineOutput(Id type, u32 location) {
+        const Id output_id{DefineVar(type, spv::StorageClass::Output)};
+        Decorate(output_id, spv::Decoration::Location, location);
+        interface_ids.push_back(output_id);
+        return output_id;
+    }
+
+    template <bool global = true>
+    [[nodiscard]] Id DefineVar(Id type, spv::StorageClass storage_class) {
+        const Id pointer_type_id{TypePointer(storage_class, type)};
+        return global ? AddGlobalVariable(pointer_type_id, storage_class)
+                      : AddLocalVariable(pointer_type_id, storage_class);
+    }
+
+    /// Returns the id of a unsigned integer constant of value
+    [[nodiscard]] Id ConstU32(u32 value) {
+        return Constant(u32_id, value);
+    }
+
+    /// Returns the id of a signed integer constant of value
+    [[nodiscard]] Id ConstS32(s32 value) {
+        return Constant(i32_id, value);
+    }
+
+    /// Returns the id of a float constant of value
+    [[nodiscard]] Id ConstF32(f32 value) {
+        return Constant(f32_id, value);
+    }
+
+    template <typename... Args>
+    [[nodiscard]] Id ConstF32(Args... values) {
+        constexpr u32 size = static_cast<u32>(sizeof...(values));
+        static_assert(size >= 2 && size <= 4);
+        const std::array constituents{Constant(f32_id, values)...};
+        return ConstantComposite(vec_ids.Get(size), constituents);
+    }
+
+    /// Broadcasts a scalar boolean to a bvec4, used to select between vectors
+    [[nodiscard]] Id SplatBool(Id value) {
+        return OpCompositeConstruct(bvec_ids.Get(4), value, value, value, value);
+    }
+
+    /// Adds the entry point and the built-in interface, must be called after main is emitted
+    void AddVertexEntryPoint(spv::ExecutionModel model, Id main_func);
+
+private:
+    void DefineArithmeticTypes();
+    void DefineUniformStructs();
+
+protected:
+    Id void_id{};
+    Id bool_id{};
+    Id f32_id{};
+    Id i32_id{};
+    Id u32_id{};
+
+    VectorIds vec_ids{};
+    VectorIds ivec_ids{};
+    VectorIds uvec_ids{};
+    VectorIds bvec_ids{};
+
+    Id vs_data_id{};
+    std::vector<Id> interface_ids;
+
+    Id primary_color_id{};
+    Id texcoord_id[3]{};
+    Id texcoord0_w_id{};
+    Id normquat_id{};
+    Id view_id{};
+    Id gl_position_id{};
+    Id gl_clip_distance_id{};
+};
+
+/// Translates a PICA vertex shader program to a SPIR-V vertex shader without going through GLSL.
+class VertexModule : public VertexStageModule {
+public:
+    explicit VertexModule(const Pica::ShaderSetup& setup, const PicaVSConfig& config);
+    ~VertexModule();
+
+    /**
+     * Emits SPIR-V bytecode corresponding to the PICA program.
+     * @throws DecompileFail if the program uses unsupported control flow or instructions.
+     */
+    void Generate();
+
+private:
+    /// Control flow information of a subroutine required before its body is emitted
+    struct SubroutineInfo {
+        std::set<u32> labels;                   ///< Entry points of the jump table cases
+        std::vector<u32> loops;                 ///< Offsets of the LOOP instructions
+        std::vector<const Subroutine*> callees; ///< Subroutines called by this one
+    };
+
+    /// Gets the Subroutine object corresponding to the specified address.
+    const Subroutine& GetSubroutine(u32 begin, u32 end) const;
+
+    /// Returns the offset of the instruction executed after the one at the provided offset
+    u32 NextOffset(u32 offset) const;
+
+    /// Walks the code of a subroutine the same way it is compiled, collecting its info
+    SubroutineInfo AnalyzeSubroutine(const Subroutine& subroutine) const;
+
+    /// Walks a range of instructions, stopping after the first jump
+    u32 AnalyzeRange(u32 begin, u32 end, SubroutineInfo& info) const;
+
+    /// Emits the subroutine and all of its callees, callees first
+    void EmitSubroutineTree(const Subroutine& subroutine);
+
+    /// Emits a subroutine as a function returning true when the program ended
+    void EmitSubroutine(const Subroutine& subroutine, const SubroutineInfo& info);
+
+    /// Emits the shader entry point
+    void EmitMain(const Subroutine& program_main);
+
+    /**
+     * Compiles a range of instructions from PICA to SPIR-V.
+     * @return the offset of the next instruction to compile. PROGRAM_END if the program
+     * terminates.
+     */
+    u32 CompileRange(u32 begin, u32 end);
+
+    /// Compiles a single instruction, returning the offset of the next instruction to execute
+    u32 CompileInstr(u32 offset);
+
+    /// Adds code that calls a subroutine.
+    void CallSubroutine(const Subroutine& subroutine);
+
+    /// Generates condition evaluation code for the flow control instruction.
+    [[nodiscard]] Id EvaluateCondition(nihstro::Instruction::FlowControlType flow_control);
+
+    /// Generates code testing a bool uniform
+    [[nodiscard]] Id GetUniformBool(u32 index, bool invert_test = false);
+
+    /// Loads a source register, applying the address register offset if any
+    [[nodiscard]] Id GetSourceRegister(const nihstro::SourceRegister& source_reg,
+                                       u32 address_register_index);
+
+    /// Loads a swizzled and optionally negated source operand
+    [[nodiscard]] Id GetSource(const nihstro::SourceRegister& source_reg,
+                               u32 address_register_index, const nihstro::SwizzlePattern& swizzle,
+                               u32 src_num);
+
+    /// Returns the pointer to a destination register, or an empty id if the write is discarded
+    [[nodiscard]] Id GetDestRegister(const nihstro::DestRegister& dest_reg);
+
+    /// Returns the pointer to a output register, or an empty id if the write is discarded
+    [[nodiscard]] Id GetOutputRegister(u32 index);
+
+    /// Stores the enabled components of value to the destination register
+    void SetDest(const nihstro::SwizzlePattern& swizzle, Id reg, Id value, bool is_scalar);
+
+    /// Loads the float uniform at base_index + offset, out of range indices return vec4(1.0)
+    [[nodiscard]] Id GetOffsetRegister(u32 base_index, Id offset);
+
+    /// Multiplies two vectors with the PICA semantics of 0 * inf = 0
+    [[nodiscard]] Id SanitizeMul(Id lhs, Id rhs);
+
+    /// Loads the member specified from the vs_pica_data uniform struct
+    template <typename... Ids>
+    [[nodiscard]] Id GetPicaDataMember(Id type, Ids... ids) {
+        const Id uniform_ptr{TypePointer(spv::StorageClass::Uniform, type)};
+        return OpLoad(type, OpAccessChain(uniform_ptr, pica_data_id, ids...));
+    }
+
+    /// Starts a new block
+    void BeginBlock(Id label);
+
+    /// Branches to the label if the current block has not been terminated yet
+    void BranchIfOpen(Id label);
+
+    /// Returns from the current function
+    void Return(bool program_ended);
+
+    /// Emits a selection construct executing the provided callable when condition is true
+    template <typename Func>
+    void EmitIf(Id condition, Func&& func) {
+        const Id then_label{OpLabel()};
+        const Id merge_label{OpLabel()};
+        OpSelectionMerge(merge_label, spv::SelectionControlMask::MaskNone);
+        OpBranchConditional(condition, then_label, merge_label);
+        BeginBlock(then_label);
+        func();
+        BranchIfOpen(merge_label);
+        BeginBlock(merge_label);
+    }
+
+private:
+    const Pica::ShaderSetup& setup;
+    const PicaVSConfig& config;
+    std::set<Subroutine> subroutines;
+    std::map<std::pair<u32, u32>, Id> subroutine_funcs;
+
+    Id pica_data_id{};
+    std::array<Id, 16> input_regs{};
+    std::array<Id, 16> tmp_regs{};
+    std::array<Id, 16> output_attrs{};
+    std::array<Id, 2> conditional_code{};
+    std::array<Id, 3> address_registers{};
+
+    Id true_id{};
+    Id false_id{};
+
+    // State of the function being emitted
+    bool block_terminated{};
+    Id switch_merge_label{};
+    Id jmp_to_id{};
+    std::map<u32, Id> loop_counters;
+};
+
+/// Emits the fixed function geometry shader used to pass through triangles
+class GeometryModule : public VertexStageModule {
+public:
+    explicit GeometryModule(const PicaFixedGSConfig& config);
+    ~GeometryModule();
+
+    /// Emits SPIR-V bytecode corresponding to the provided geometry configuration
+    void Generate();
+
+private:
+    const PicaFixedGSConfig& config;
+    std::vector<Id> vs_out_attrs;
+};
+
+/**
+ * Generates the SPIR-V vertex shader program for the provided PICA vertex shader
+ * @param setup PICA vertex shader program and swizzle data
+ * @param config PicaVSConfig object generated for the current Pica state
+ * @returns SPIR-V code of the shader, empty if the program could not be translated
+ */
+std::vector<u32> GenerateVertexShader(const Pica::ShaderSetup& setup, const PicaVSConfig& config);
+
+/**
+ * Generates the SPIR-V fixed geometry shader program for the provided configuration
+ * @param config PicaFixedGSConfig object generated for the current Pica state
+ * @returns SPIR-V code of the shader
+ */
+std::vector<u32> GenerateFixedGeometryShader(const PicaFixedGSConfig& config);
+
+} // namespace Pica::Shader::Generator::SPIRV